@@ -5,6 +5,8 @@
 #include <string.h>
 #include <limits.h>
 
+#include <unistd.h>
+
 #include <perf_counter.h>
 
 #include <nnpack.h>
@@ -122,6 +124,8 @@ struct options {
 	size_t threads;
 	size_t iterations;
 	bool threadpool;
+	bool thread_scaling;
+	bool scheduler;
 };
 
 static void print_options_help(const char* program_name) {
@@ -139,6 +143,8 @@ static void print_options_help(const char* program_name) {
 "  -b   --batch              The size of a minibatch (default: 1)\n"
 "  -p   --padding            Implicit input padding (default: 0)\n"
 "  -t   --threads            The number of threads (default: all; 0 to disable threadpool)\n"
+"  -ts  --thread-scaling     Measure time with 1, 2, 4, ... threads up to the number of threads\n"
+"  -s   --scheduler          Run on a scheduler job with all workers instead of a threadpool (NUMA-aware)\n"
 "  -i   --iterations         # iterations (default: 3)\n",
 		program_name);
 }
@@ -157,6 +163,8 @@ static struct options parse_options(int argc, char** argv) {
 		.threads = 0,
 		.iterations = 3,
 		.threadpool = true,
+		.thread_scaling = false,
+		.scheduler = false,
 	};
 	for (int argi = 1; argi < argc; argi += 1) {
 		if ((strcmp(argv[argi], "--batch") == 0) || (strcmp(argv[argi], "-b") == 0)) {
@@ -320,6 +328,10 @@ static struct options parse_options(int argc, char** argv) {
 				options.threadpool = false;
 			}
 			argi += 1;
+		} else if ((strcmp(argv[argi], "--thread-scaling") == 0) || (strcmp(argv[argi], "-ts") == 0)) {
+			options.thread_scaling = true;
+		} else if ((strcmp(argv[argi], "--scheduler") == 0) || (strcmp(argv[argi], "-s") == 0)) {
+			options.scheduler = true;
 		} else if ((strcmp(argv[argi], "--iterations") == 0) || (strcmp(argv[argi], "-i") == 0)) {
 			if (argi + 1 == argc) {
 				fprintf(stderr, "Error: expected iterations value\n");
@@ -347,6 +359,10 @@ static struct options parse_options(int argc, char** argv) {
 		fprintf(stderr, "Error: inference requires unit batch size\n");
 		exit(EXIT_FAILURE);
 	}
+	if (options.thread_scaling && (!options.threadpool || options.scheduler)) {
+		fprintf(stderr, "Error: thread scaling requires a threadpool\n");
+		exit(EXIT_FAILURE);
+	}
 	if (options.input_channels == 0) {
 		fprintf(stderr, "Error: the number of input channels is not specified\n");
 		print_options_help(argv[0]);
@@ -445,12 +461,57 @@ int main(int argc, char** argv) {
 	memset(bias, 0, output_channels * sizeof(float));
 
 	pthreadpool_t threadpool = NULL;
-	if (options.threadpool) {
+	nnp_scheduler_t scheduler = NULL;
+	nnp_scheduler_job_t scheduler_job = NULL;
+	if (options.scheduler) {
+		/* The job gets all workers, which are bound to NUMA nodes, and convolution places its buffers on the nodes */
+		const size_t threads = (options.threads != 0) ? options.threads : (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+		if (nnp_scheduler_create(threads, &scheduler) != nnp_status_success ||
+			nnp_scheduler_begin_job(scheduler, 1, threads, &scheduler_job) != nnp_status_success)
+		{
+			fprintf(stderr, "Error: failed to create a scheduler with %zu threads\n", threads);
+			exit(EXIT_FAILURE);
+		}
+		printf("Scheduler threads: %zu\n", threads);
+	} else if (options.threadpool) {
 		threadpool = pthreadpool_create(options.threads);
 		printf("Threads: %zu\n", pthreadpool_get_threads_count(threadpool));
 	}
 	printf("Iterations: %zu\n", options.iterations);
 
+	if (options.thread_scaling) {
+		/* Speedup relative to one thread shows load imbalance between threads at higher thread counts */
+		const size_t max_threads = pthreadpool_get_threads_count(threadpool);
+		double single_thread_time = 0.0;
+		for (size_t threads = 1;; threads = (threads * 2 < max_threads) ? threads * 2 : max_threads) {
+			pthreadpool_t scaling_threadpool = pthreadpool_create(threads);
+			const struct nnp_profile scaling_profile =
+				benchmark_convolution(
+					options.mode,
+					memory, cache_size,
+					options.algorithm,
+					options.kernel_transform_strategy,
+					batch_size, input_channels, output_channels,
+					input_size, input_padding, kernel_size,
+					input, kernel, bias, output,
+					scaling_threadpool, options.iterations);
+			pthreadpool_destroy(scaling_threadpool);
+
+			if (threads == 1) {
+				single_thread_time = scaling_profile.total;
+			}
+			const double speedup = single_thread_time / scaling_profile.total;
+			printf("Threads: %3zu  Time: %8.3f ms  Speedup: %5.2fx  Efficiency: %5.1f%%\n",
+				threads, scaling_profile.total * 1.0e+3, speedup, speedup / ((double) threads) * 100.0);
+			if (threads == max_threads) {
+				break;
+			}
+		}
+
+		pthreadpool_destroy(threadpool);
+		return EXIT_SUCCESS;
+	}
+
 	const struct nnp_profile convolution_profile =
 		benchmark_convolution(
 			options.mode,
@@ -508,6 +569,10 @@ int main(int argc, char** argv) {
 	if (threadpool) {
 		pthreadpool_destroy(threadpool);
 	}
+	if (scheduler) {
+		nnp_scheduler_end_job(scheduler_job);
+		nnp_scheduler_destroy(scheduler);
+	}
 
 	return EXIT_SUCCESS;
 }
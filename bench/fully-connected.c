@@ -15,7 +15,12 @@ extern void read_memory(const void* memory, size_t length);
 
 enum mode {
 	mode_output,
+	mode_output_prepacked,
+	mode_input_gradient,
+	mode_kernel_gradient,
 	mode_inference,
+	mode_inference_f16,
+	mode_inference_bf16,
 };
 
 struct nnp_profile benchmark_fully_connected_output(
@@ -30,7 +35,7 @@ struct nnp_profile benchmark_fully_connected_output(
 	pthreadpool_t threadpool,
 	size_t max_iterations)
 {
-	if (mode == mode_inference) {
+	if ((mode == mode_inference) || (mode == mode_inference_f16) || (mode == mode_inference_bf16)) {
 		unsigned long long computation_time[max_iterations];
 		size_t computation_samples = 0;
 		for (size_t iteration = 0; iteration < max_iterations; iteration++) {
@@ -40,13 +45,39 @@ struct nnp_profile benchmark_fully_connected_output(
 			if (!read_timer(&start_time))
 				continue;
 
-			nnp_fully_connected_inference(
-				input_channels,
-				output_channels,
-				input,
-				kernel,
-				output,
-				threadpool);
+			switch (mode) {
+				case mode_inference_f16:
+					nnp_fully_connected_inference_f16f32(
+						input_channels,
+						output_channels,
+						input,
+						kernel,
+						NULL,
+						output,
+						nnp_activation_identity, 0.0f,
+						threadpool);
+					break;
+				case mode_inference_bf16:
+					nnp_fully_connected_inference_bf16f32(
+						input_channels,
+						output_channels,
+						input,
+						kernel,
+						NULL,
+						output,
+						nnp_activation_identity, 0.0f,
+						threadpool);
+					break;
+				default:
+					nnp_fully_connected_inference(
+						input_channels,
+						output_channels,
+						input,
+						kernel,
+						output,
+						threadpool);
+					break;
+			}
 
 			if (!read_timer(&end_time))
 				continue;
@@ -58,6 +89,53 @@ struct nnp_profile benchmark_fully_connected_output(
 			.total = median_computation_time * 1.0e-9,
 			.block_multiplication = median_computation_time * 1.0e-9
 		};
+	} else if (mode == mode_input_gradient) {
+		struct nnp_profile computation_profile[max_iterations];
+		for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+			read_memory(memory, cache_size);
+			nnp_fully_connected_input_gradient(
+				batch_size,
+				input_channels,
+				output_channels,
+				output,
+				kernel,
+				(float*) input,
+				threadpool,
+				&computation_profile[iteration]);
+		}
+		return median_profile(computation_profile, max_iterations);
+	} else if (mode == mode_kernel_gradient) {
+		struct nnp_profile computation_profile[max_iterations];
+		for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+			read_memory(memory, cache_size);
+			nnp_fully_connected_kernel_gradient(
+				batch_size,
+				input_channels,
+				output_channels,
+				input,
+				output,
+				(float*) kernel,
+				threadpool,
+				&computation_profile[iteration]);
+		}
+		return median_profile(computation_profile, max_iterations);
+	} else if (mode == mode_output_prepacked) {
+		struct nnp_profile computation_profile[max_iterations];
+		for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+			read_memory(memory, cache_size);
+			nnp_fully_connected_output_prepacked(
+				batch_size,
+				input_channels,
+				output_channels,
+				input,
+				kernel,
+				NULL,
+				output,
+				nnp_activation_identity, 0.0f,
+				threadpool,
+				&computation_profile[iteration]);
+		}
+		return median_profile(computation_profile, max_iterations);
 	} else {
 		struct nnp_profile computation_profile[max_iterations];
 		for (size_t iteration = 0; iteration < max_iterations; iteration++) {
@@ -93,7 +171,7 @@ static void print_options_help(const char* program_name) {
 "  -ic  --input-channels     The number of input channels\n"
 "  -oc  --output-channels    The number of output channels\n"
 "Optional parameters:\n"
-"  -m   --mode               The fully connected layer mode (output, inference)\n"
+"  -m   --mode               The fully connected layer mode (output, output-prepacked, input-gradient, kernel-gradient, inference, inference-f16, inference-bf16)\n"
 "  -b   --batch              The size of a minibatch (default: 1)\n"
 "  -t   --threads            The number of threads (default: all; 0 to disable threadpool)\n"
 "  -i   --iterations         # iterations (default: 3)\n",
@@ -160,8 +238,18 @@ static struct options parse_options(int argc, char** argv) {
 			}
 			if (strcmp(argv[argi + 1], "output") == 0) {
 				options.mode = mode_output;
+			} else if (strcmp(argv[argi + 1], "output-prepacked") == 0) {
+				options.mode = mode_output_prepacked;
+			} else if (strcmp(argv[argi + 1], "input-gradient") == 0) {
+				options.mode = mode_input_gradient;
+			} else if (strcmp(argv[argi + 1], "kernel-gradient") == 0) {
+				options.mode = mode_kernel_gradient;
 			} else if (strcmp(argv[argi + 1], "inference") == 0) {
 				options.mode = mode_inference;
+			} else if (strcmp(argv[argi + 1], "inference-f16") == 0) {
+				options.mode = mode_inference_f16;
+			} else if (strcmp(argv[argi + 1], "inference-bf16") == 0) {
+				options.mode = mode_inference_bf16;
 			} else {
 				fprintf(stderr, "Error: invalid value %s for the mode\n", argv[argi + 1]);
 				exit(EXIT_FAILURE);
@@ -254,6 +342,20 @@ int main(int argc, char** argv) {
 	}
 	printf("Iterations: %zu\n", options.iterations);
 
+	if (options.mode == mode_output_prepacked) {
+		size_t packed_kernel_size = 0;
+		nnp_fully_connected_pack_kernel(input_channels, output_channels, kernel, NULL, &packed_kernel_size, threadpool);
+
+		void* packed_kernel = NULL;
+		if (posix_memalign(&packed_kernel, 64, packed_kernel_size) != 0) {
+			fprintf(stderr, "Error: failed to allocate memory for packed kernel\n");
+			exit(EXIT_FAILURE);
+		}
+		nnp_fully_connected_pack_kernel(input_channels, output_channels, kernel, packed_kernel, &packed_kernel_size, threadpool);
+		free(kernel);
+		kernel = packed_kernel;
+	}
+
 	const struct nnp_profile output_profile =
 		benchmark_fully_connected_output(
 			options.mode,
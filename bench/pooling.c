@@ -54,7 +54,42 @@ unsigned long long benchmark_pooling(
 	return median(computation_time, max_iterations);
 }
 
+struct pooling_layer {
+	const char* name;
+	size_t channels;
+	struct nnp_size input_size;
+	size_t input_padding;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+};
+
+static const struct pooling_layer alexnet_layers[] = {
+	{ "pool1", 64,  { 55, 55 }, 0, { 3, 3 }, { 2, 2 } },
+	{ "pool2", 192, { 27, 27 }, 0, { 3, 3 }, { 2, 2 } },
+	{ "pool5", 256, { 13, 13 }, 0, { 3, 3 }, { 2, 2 } },
+	{ NULL }
+};
+
+static const struct pooling_layer overfeat_fast_layers[] = {
+	{ "pool1", 96,   { 48, 48 }, 0, { 2, 2 }, { 2, 2 } },
+	{ "pool2", 256,  { 24, 24 }, 0, { 2, 2 }, { 2, 2 } },
+	{ "pool3", 1024, { 12, 12 }, 0, { 2, 2 }, { 2, 2 } },
+	{ NULL }
+};
+
+static const struct pooling_layer googlenet_layers[] = {
+	{ "pool1/3x3_s2",            64,  { 112, 112 }, 0, { 3, 3 }, { 2, 2 } },
+	{ "pool2/3x3_s2",            192, { 56, 56 },   0, { 3, 3 }, { 2, 2 } },
+	{ "inception_3a/pool",       192, { 28, 28 },   1, { 3, 3 }, { 1, 1 } },
+	{ "pool3/3x3_s2",            480, { 28, 28 },   0, { 3, 3 }, { 2, 2 } },
+	{ "inception_4a/pool",       480, { 14, 14 },   1, { 3, 3 }, { 1, 1 } },
+	{ "pool4/3x3_s2",            832, { 14, 14 },   0, { 3, 3 }, { 2, 2 } },
+	{ "inception_5a/pool",       832, { 7, 7 },     1, { 3, 3 }, { 1, 1 } },
+	{ NULL }
+};
+
 struct options {
+	const struct pooling_layer* network;
 	size_t batch_size;
 	size_t channels;
 	struct nnp_size input_size;
@@ -69,10 +104,11 @@ struct options {
 static void print_options_help(const char* program_name) {
 	printf(
 "%s parameters...\n"
-"Required parameters:\n"
+"Required parameters (unless network is specified):\n"
 "  -c   --channels           The number of channels\n"
 "  -is  --input-size         Input height and width\n"
 "Optional parameters:\n"
+"  -n   --network            Benchmark all pooling layers of the network (alexnet, overfeat-fast, googlenet)\n"
 "  -b   --batch              The size of a minibatch (default: 1)\n"
 "  -ip  --input-padding      Implicit input padding (default: 0)\n"
 "  -ps  --pooling-size       Vertical and horizontal pooling size (default: 2x2)\n"
@@ -84,6 +120,7 @@ static void print_options_help(const char* program_name) {
 
 static struct options parse_options(int argc, char** argv) {
 	struct options options = {
+		.network = NULL,
 		.batch_size = 1,
 		.channels = 0,
 		.input_size = { 0, 0 },
@@ -95,7 +132,23 @@ static struct options parse_options(int argc, char** argv) {
 		.threadpool = true,
 	};
 	for (int argi = 1; argi < argc; argi += 1) {
-		if ((strcmp(argv[argi], "--batch") == 0) || (strcmp(argv[argi], "-b") == 0)) {
+		if ((strcmp(argv[argi], "--network") == 0) || (strcmp(argv[argi], "-n") == 0)) {
+			if (argi + 1 == argc) {
+				fprintf(stderr, "Error: expected network name\n");
+				exit(EXIT_FAILURE);
+			}
+			if (strcmp(argv[argi + 1], "alexnet") == 0) {
+				options.network = alexnet_layers;
+			} else if (strcmp(argv[argi + 1], "overfeat-fast") == 0) {
+				options.network = overfeat_fast_layers;
+			} else if (strcmp(argv[argi + 1], "googlenet") == 0) {
+				options.network = googlenet_layers;
+			} else {
+				fprintf(stderr, "Error: invalid network name %s\n", argv[argi + 1]);
+				exit(EXIT_FAILURE);
+			}
+			argi += 1;
+		} else if ((strcmp(argv[argi], "--batch") == 0) || (strcmp(argv[argi], "-b") == 0)) {
 			if (argi + 1 == argc) {
 				fprintf(stderr, "Error: expected batch value\n");
 				exit(EXIT_FAILURE);
@@ -239,6 +292,9 @@ static struct options parse_options(int argc, char** argv) {
 			exit(EXIT_FAILURE);
 		}
 	}
+	if (options.network != NULL) {
+		return options;
+	}
 	if (options.channels == 0) {
 		fprintf(stderr, "Error: the number of channels is not specified\n");
 		print_options_help(argv[0]);
@@ -252,39 +308,28 @@ static struct options parse_options(int argc, char** argv) {
 	return options;
 }
 
-int main(int argc, char** argv) {
-	enum nnp_status init_status = nnp_initialize();
-	if (init_status != nnp_status_success) {
-		fprintf(stderr, "NNPACK initialization failed: error code %d\n", init_status);
-		exit(EXIT_FAILURE);
-	}
-
-	const struct options options = parse_options(argc, argv);
-
-	const size_t batch_size = options.batch_size;
-	const size_t channels = options.channels;
-	const struct nnp_size input_size = options.input_size;
-	const struct nnp_padding input_padding = { options.input_padding, options.input_padding, options.input_padding, options.input_padding };
-	const struct nnp_size pooling_size = options.pooling_size;
-	const struct nnp_size pooling_stride = options.pooling_stride;
+static void benchmark_pooling_layer(
+	const void* memory, size_t cache_size,
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	pthreadpool_t threadpool,
+	size_t iterations)
+{
+	const struct nnp_padding input_padding = { padding, padding, padding, padding };
 	const struct nnp_size output_size = {
-		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom, pooling_stride.height),
-		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right, pooling_stride.width),
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
 	};
 
-	printf("Batch size: %zu\n", batch_size);
 	printf("Channels: %zu\n", channels);
-	printf("Input: %zux%zu with implicit padding %zu\n", input_size.height, input_size.width, options.input_padding);
+	printf("Input: %zux%zu with implicit padding %zu\n", input_size.height, input_size.width, padding);
 	printf("Pooling: %zux%zu with %zux%zu stride\n",
 		pooling_size.height, pooling_size.width, pooling_stride.height, pooling_stride.width);
 
-	const size_t cache_size = 128 * 1024 * 1024;
-	void* memory = NULL;
-	if (posix_memalign(&memory, 64, cache_size) != 0) {
-		fprintf(stderr, "Error: failed to allocate memory for cache flushing buffer\n");
-		exit(EXIT_FAILURE);
-	}
-
 	const size_t input_bytes = batch_size * channels * input_size.width * input_size.height * sizeof(float);
 	const size_t output_bytes = batch_size * channels * output_size.width * output_size.height * sizeof(float);
 	void* input = malloc(input_bytes);
@@ -292,24 +337,61 @@ int main(int argc, char** argv) {
 	memset(input, 0, input_bytes);
 	memset(output, 0, output_bytes);
 
-	pthreadpool_t threadpool = NULL;
-	if (options.threadpool) {
-		threadpool = pthreadpool_create(options.threads);
-		printf("Threads: %zu\n", pthreadpool_get_threads_count(threadpool));
-	}
-	printf("Iterations: %zu\n", options.iterations);
-
 	const unsigned long long pooling_output_nanoseconds =
 		benchmark_pooling(
 			memory, cache_size,
 			batch_size, channels,
 			input_size, input_padding, pooling_size, pooling_stride,
 			input, output,
-			threadpool, options.iterations);
+			threadpool, iterations);
 
 	printf("Time: %5.3f ms [%.1f GB/s]\n",
 		((double) pooling_output_nanoseconds) * 1.0e-6,
 		((double) (input_bytes + output_bytes)) / ((double) pooling_output_nanoseconds));
+
+	free(input);
+	free(output);
+}
+
+int main(int argc, char** argv) {
+	enum nnp_status init_status = nnp_initialize();
+	if (init_status != nnp_status_success) {
+		fprintf(stderr, "NNPACK initialization failed: error code %d\n", init_status);
+		exit(EXIT_FAILURE);
+	}
+
+	const struct options options = parse_options(argc, argv);
+
+	pthreadpool_t threadpool = NULL;
+	if (options.threadpool) {
+		threadpool = pthreadpool_create(options.threads);
+		printf("Threads: %zu\n", pthreadpool_get_threads_count(threadpool));
+	}
+	printf("Iterations: %zu\n", options.iterations);
+
+	const size_t cache_size = 128 * 1024 * 1024;
+	void* memory = NULL;
+	if (posix_memalign(&memory, 64, cache_size) != 0) {
+		fprintf(stderr, "Error: failed to allocate memory for cache flushing buffer\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("Batch size: %zu\n", options.batch_size);
+	if (options.network != NULL) {
+		for (const struct pooling_layer* layer = options.network; layer->name != NULL; layer++) {
+			printf("Layer %s\n", layer->name);
+			benchmark_pooling_layer(memory, cache_size,
+				options.batch_size, layer->channels,
+				layer->input_size, layer->input_padding, layer->pooling_size, layer->pooling_stride,
+				threadpool, options.iterations);
+		}
+	} else {
+		benchmark_pooling_layer(memory, cache_size,
+			options.batch_size, options.channels,
+			options.input_size, options.input_padding, options.pooling_size, options.pooling_stride,
+			threadpool, options.iterations);
+	}
+
 	if (threadpool) {
 		pthreadpool_destroy(threadpool);
 	}
@@ -244,6 +244,9 @@ class Configuration:
         }
         if lib_dirs:
             variables["libdirs"] = " ".join(["-L" + l for l in lib_dirs])
+        if self.host == "x86_64-linux-gnu":
+            # shm_open is in librt before glibc 2.34
+            libs = libs + ["rt"]
         if libs:
             variables["libs"] = " ".join(["-l" + l for l in libs])
         if extra_ldflags:
@@ -416,12 +419,28 @@ def main():
         config.cc("convolution-input-gradient.c"),
         config.cc("convolution-kernel.c"),
         config.cc("convolution-inference.c"),
+        config.cc("convolution-inference-u8s8.c"),
         config.cc("fully-connected-output.c"),
         config.cc("fully-connected-inference.c"),
+        config.cc("fully-connected-u8s8.c"),
+        config.cc("fully-connected-sparse.c"),
         config.cc("pooling-output.c"),
         config.cc("softmax-output.c"),
         config.cc("relu-output.c"),
         config.cc("relu-input-gradient.c"),
+        config.cc("activation-output.c"),
+        config.cc("activation-input-gradient.c"),
+        config.cc("batch-norm.c"),
+        config.cc("lrn-output.c"),
+        config.cc("lrn-input-gradient.c"),
+        config.cc("elementwise.c"),
+        config.cc("network.c"),
+        config.cc("model.c"),
+        config.cc("shared-kernel.c"),
+        config.cc("stream.c"),
+        config.cc("scheduler.c"),
+        config.cc("work-stealing.c"),
+        config.cc("numa.c"),
     ]
 
     if config.host.startswith("x86_64-") and not options.use_psimd:
@@ -432,10 +451,19 @@ def main():
             config.peachpy("x86_64-fma/2d-wt-8x8-3x3.py"),
             # Pooling
             config.peachpy("x86_64-fma/max-pooling.py"),
+            config.peachpy("x86_64-fma/average-pooling.py"),
             # ReLU and Softmax
             config.peachpy("x86_64-fma/relu.py"),
             config.peachpy("x86_64-fma/softmax.py"),
             config.cc("x86_64-fma/softmax.c"),
+            # Sigmoid, tanh, ELU, SELU, GELU, and swish
+            config.peachpy("x86_64-fma/activations.py"),
+            # Batch normalization
+            config.peachpy("x86_64-fma/batch-norm.py"),
+            # Local response normalization
+            config.peachpy("x86_64-fma/lrn.py"),
+            # Elementwise arithmetic
+            config.peachpy("x86_64-fma/elementwise.py"),
             # FFT block accumulation
             config.peachpy("x86_64-fma/fft-block-mac.py"),
             # Tuple GEMM
@@ -444,6 +472,11 @@ def main():
             # BLAS microkernels
             config.peachpy("x86_64-fma/sgemm.py"),
             config.peachpy("x86_64-fma/sdotxf.py"),
+            config.peachpy("x86_64-fma/sdotmxf.py"),
+            config.peachpy("x86_64-fma/shdotxf.py"),
+            config.peachpy("x86_64-fma/u8s8dotxf.py"),
+            config.peachpy("x86_64-fma/u8s8gemm.py"),
+            config.peachpy("x86_64-fma/scsrmv.py"),
         ]
     else:
         arch_nnpack_objects = [
@@ -454,6 +487,17 @@ def main():
             # ReLU and Softmax
             config.cc("psimd/relu.c"),
             config.cc("psimd/softmax.c"),
+            # Sigmoid, tanh, ELU, SELU, GELU, and swish
+            config.cc("psimd/activations.c"),
+            # Batch normalization
+            config.cc("psimd/batch-norm.c"),
+            # Local response normalization
+            config.cc("psimd/lrn.c"),
+            # Elementwise arithmetic
+            config.cc("psimd/elementwise.c"),
+            # Max- and average-pooling
+            config.cc("psimd/max-pooling.c"),
+            config.cc("psimd/average-pooling.c"),
             # Tuple GEMM
             config.cc("psimd/blas/s4gemm.c"),
             config.cc("psimd/blas/c4gemm.c"),
@@ -465,17 +509,32 @@ def main():
             # BLAS microkernels
             config.cc("psimd/blas/sgemm.c"),
             config.cc("psimd/blas/sdotxf.c"),
+            config.cc("psimd/blas/sdotmxf.c"),
+            config.cc("psimd/blas/shdotxf.c"),
+            config.cc("psimd/blas/u8s8dotxf.c"),
+            config.cc("psimd/blas/u8s8gemm.c"),
+            config.cc("psimd/blas/scsrmv.c"),
         ]
 
     reference_layer_objects = [
         config.cc("ref/convolution-output.c"),
         config.cc("ref/convolution-input-gradient.c"),
         config.cc("ref/convolution-kernel.c"),
+        config.cc("ref/convolution-output-u8s8.c"),
         config.cc("ref/fully-connected-output.c"),
+        config.cc("ref/fully-connected-input-gradient.c"),
+        config.cc("ref/fully-connected-kernel-gradient.c"),
+        config.cc("ref/fully-connected-output-u8s8.c"),
         config.cc("ref/pooling-output.c"),
         config.cc("ref/softmax-output.c"),
+        config.cc("ref/softmax-input-gradient.c"),
         config.cc("ref/relu-output.c"),
         config.cc("ref/relu-input-gradient.c"),
+        config.cc("ref/activation-output.c"),
+        config.cc("ref/activation-input-gradient.c"),
+        config.cc("ref/batch-norm.c"),
+        config.cc("ref/lrn.c"),
+        config.cc("ref/elementwise.c"),
     ]
 
     reference_fft_objects = [
@@ -656,6 +715,19 @@ def main():
         config.phony("fully-connected-output-test",
             [fully_connected_output_smoke_test, fully_connected_output_alexnet_test, fully_connected_output_vgg_a_test, fully_connected_output_overfeat_fast_test])
 
+        fully_connected_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("fully-connected-input-gradient/smoke.cc")] + gtest_objects,
+                "fully-connected-input-gradient-smoketest")
+        config.phony("fully-connected-input-gradient-test", [fully_connected_input_gradient_smoke_test])
+
+        fully_connected_kernel_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("fully-connected-kernel-gradient/smoke.cc")] + gtest_objects,
+                "fully-connected-kernel-gradient-smoketest")
+        config.phony("fully-connected-kernel-gradient-test", [fully_connected_kernel_gradient_smoke_test])
+
+        fully_connected_inference_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("fully-connected-inference/smoke.cc")] + gtest_objects,
+                "fully-connected-inference-smoketest")
         fully_connected_inference_alexnet_test = \
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("fully-connected-inference/alexnet.cc")] + gtest_objects,
                 "fully-connected-inference-alexnet-test")
@@ -666,11 +738,14 @@ def main():
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("fully-connected-inference/overfeat-fast.cc")] + gtest_objects,
                 "fully-connected-inference-overfeat-fast-test")
         config.phony("fully-connected-inference-test",
-            [fully_connected_inference_alexnet_test, fully_connected_inference_vgg_a_test, fully_connected_inference_overfeat_fast_test])
+            [fully_connected_inference_smoke_test, fully_connected_inference_alexnet_test, fully_connected_inference_vgg_a_test, fully_connected_inference_overfeat_fast_test])
 
         pooling_output_smoke_test = \
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("pooling-output/smoke.cc")] + gtest_objects,
                 "pooling-output-smoketest")
+        pooling_output_alexnet_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("pooling-output/alexnet.cc")] + gtest_objects,
+                "pooling-output-alexnet-test")
         pooling_output_vgg_a_test = \
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("pooling-output/vgg-a.cc")] + gtest_objects,
                 "pooling-output-vgg-a-test")
@@ -678,7 +753,22 @@ def main():
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("pooling-output/overfeat-fast.cc")] + gtest_objects,
                 "pooling-output-overfeat-fast")
         config.phony("pooling-output-test",
-            [pooling_output_smoke_test, pooling_output_vgg_a_test, pooling_output_overfeat_fast_test])
+            [pooling_output_smoke_test, pooling_output_alexnet_test, pooling_output_vgg_a_test, pooling_output_overfeat_fast_test])
+
+        average_pooling_output_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("average-pooling-output/smoke.cc")] + gtest_objects,
+                "average-pooling-output-smoketest")
+        config.phony("average-pooling-output-test", [average_pooling_output_smoke_test])
+
+        max_pooling_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("max-pooling-input-gradient/smoke.cc")] + gtest_objects,
+                "max-pooling-input-gradient-smoketest")
+        config.phony("max-pooling-input-gradient-test", [max_pooling_input_gradient_smoke_test])
+
+        global_average_pooling_output_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("global-average-pooling-output/smoke.cc")] + gtest_objects,
+                "global-average-pooling-output-smoketest")
+        config.phony("global-average-pooling-output-test", [global_average_pooling_output_smoke_test])
 
         relu_output_alexnet_test = \
             config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("relu-output/alexnet.cc")] + gtest_objects,
@@ -713,17 +803,90 @@ def main():
         config.phony("softmax-output-test",
             [softmax_output_smoke_test, softmax_output_imagenet_test])
 
+        softmax_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("softmax-input-gradient/smoke.cc")] + gtest_objects,
+                "softmax-input-gradient-smoketest")
+        config.phony("softmax-input-gradient-test", [softmax_input_gradient_smoke_test])
+
+        activation_output_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("activation-output/smoke.cc")] + gtest_objects,
+                "activation-output-smoketest")
+        config.phony("activation-output-test", [activation_output_smoke_test])
+
+        activation_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("activation-input-gradient/smoke.cc")] + gtest_objects,
+                "activation-input-gradient-smoketest")
+        config.phony("activation-input-gradient-test", [activation_input_gradient_smoke_test])
+
+        batch_norm_output_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("batch-norm-output/smoke.cc")] + gtest_objects,
+                "batch-norm-output-smoketest")
+        config.phony("batch-norm-output-test", [batch_norm_output_smoke_test])
+
+        batch_norm_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("batch-norm-input-gradient/smoke.cc")] + gtest_objects,
+                "batch-norm-input-gradient-smoketest")
+        config.phony("batch-norm-input-gradient-test", [batch_norm_input_gradient_smoke_test])
+
+        lrn_output_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("lrn-output/smoke.cc")] + gtest_objects,
+                "lrn-output-smoketest")
+        lrn_output_alexnet_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("lrn-output/alexnet.cc")] + gtest_objects,
+                "lrn-output-alexnet-test")
+        config.phony("lrn-output-test",
+            [lrn_output_smoke_test, lrn_output_alexnet_test])
+
+        lrn_input_gradient_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("lrn-input-gradient/smoke.cc")] + gtest_objects,
+                "lrn-input-gradient-smoketest")
+        lrn_input_gradient_alexnet_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("lrn-input-gradient/alexnet.cc")] + gtest_objects,
+                "lrn-input-gradient-alexnet-test")
+        config.phony("lrn-input-gradient-test",
+            [lrn_input_gradient_smoke_test, lrn_input_gradient_alexnet_test])
+
+        elementwise_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("elementwise/smoke.cc")] + gtest_objects,
+                "elementwise-smoketest")
+        config.phony("elementwise-test", [elementwise_smoke_test])
+
+        network_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("network/smoke.cc")] + gtest_objects,
+                "network-smoketest")
+        config.phony("network-test", [network_smoke_test])
+
+        model_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("model/smoke.cc")] + gtest_objects,
+                "model-smoketest")
+        config.phony("model-test", [model_smoke_test])
+
+        stream_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("stream/smoke.cc")] + gtest_objects,
+                "stream-smoketest")
+        config.phony("stream-test", [stream_smoke_test])
+
+        scheduler_smoke_test = \
+            config.unittest(nnpack_objects + reference_layer_objects + [config.cxx("scheduler/smoke.cc")] + gtest_objects,
+                "scheduler-smoketest")
+        config.phony("scheduler-test", [scheduler_smoke_test])
+
         config.phony("test", [
             "convolution-output-test", "convolution-input-gradient-test", "convolution-kernel-gradient-test", "convolution-inference-test",
-            "fully-connected-output-test", "fully-connected-inference-test",
-            "pooling-output-test",
-            "relu-output-test", "relu-input-gradient-test",
-            "softmax-output-test"])
+            "fully-connected-output-test", "fully-connected-input-gradient-test", "fully-connected-kernel-gradient-test", "fully-connected-inference-test",
+            "pooling-output-test", "max-pooling-input-gradient-test", "average-pooling-output-test", "global-average-pooling-output-test",
+            "relu-output-test", "relu-input-gradient-test", "activation-output-test", "activation-input-gradient-test",
+            "batch-norm-output-test", "batch-norm-input-gradient-test",
+            "lrn-output-test", "lrn-input-gradient-test", "elementwise-test",
+            "softmax-output-test", "softmax-input-gradient-test", "network-test", "model-test", "stream-test", "scheduler-test"])
         config.phony("smoketest", [
             convolution_output_smoke_test, convolution_input_gradient_smoke_test, convolution_kernel_gradient_smoke_test, convolution_inference_smoke_test,
-            fully_connected_output_smoke_test,
-            pooling_output_smoke_test,
-            softmax_output_smoke_test])
+            fully_connected_output_smoke_test, fully_connected_input_gradient_smoke_test, fully_connected_kernel_gradient_smoke_test, fully_connected_inference_smoke_test,
+            pooling_output_smoke_test, max_pooling_input_gradient_smoke_test, average_pooling_output_smoke_test, global_average_pooling_output_smoke_test,
+            activation_output_smoke_test, activation_input_gradient_smoke_test,
+            batch_norm_output_smoke_test, batch_norm_input_gradient_smoke_test,
+            lrn_output_smoke_test, lrn_input_gradient_smoke_test, elementwise_smoke_test,
+            softmax_output_smoke_test, softmax_input_gradient_smoke_test, network_smoke_test, model_smoke_test, stream_smoke_test, scheduler_smoke_test])
 
     # Build benchmarks
     config.source_dir = os.path.join(root_dir, "bench")
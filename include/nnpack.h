@@ -24,6 +24,14 @@ enum nnp_status {
 	nnp_status_invalid_input_channels = 4,
 	/** NNPACK function was called with output_channels == 0. */
 	nnp_status_invalid_output_channels = 5,
+	/** NNPACK function was called with invalid normalization parameters, e.g. negative or non-finite epsilon */
+	nnp_status_invalid_normalization = 6,
+	/** NNPACK function was called with an unknown layer type, or with layers whose sizes do not chain */
+	nnp_status_invalid_layer = 7,
+	/** NNPACK function was called with a model file which is not in NNPACK model format, or was saved for a different CPU */
+	nnp_status_invalid_model = 8,
+	/** NNPACK function was called with threads_count == 0, or with more minimum threads than the scheduler has */
+	nnp_status_invalid_threads_count = 9,
 	/** NNPACK function was called with input_size.height == 0 or input_size.width == 0 */
 	nnp_status_invalid_input_size = 10,
 	/** NNPACK function was called with input_stride.height == 0 or input_stride.width == 0 */
@@ -44,6 +52,14 @@ enum nnp_status {
 	nnp_status_invalid_pooling_stride = 15,
 	/** NNPACK function was called with convolution algorithm not in nnp_convolution_algorithm enumeration */
 	nnp_status_invalid_algorithm = 15,
+	/** Activation function is invalid */
+	nnp_status_invalid_activation = 16,
+	/** NNPACK function was called with a quantization scale which is not positive and finite */
+	nnp_status_invalid_quantization = 17,
+	/** NNPACK function was called with padding mode not in nnp_pooling_padding_mode enumeration */
+	nnp_status_invalid_pooling_padding_mode = 18,
+	/** NNPACK function was called with a class label outside of [0, channels) range */
+	nnp_status_invalid_label = 19,
 
 	/** NNPACK does not support the particular input size for the function */
 	nnp_status_unsupported_input_size = 20,
@@ -59,13 +75,33 @@ enum nnp_status {
 	nnp_status_unsupported_pooling_stride = 25,
 	/** NNPACK does not support the particular convolution algorithm for the function */
 	nnp_status_unsupported_algorithm = 26,
+	/** NNPACK does not support the particular number of input channels, e.g. 8-bit products could overflow accumulators */
+	nnp_status_unsupported_input_channels = 27,
 
 	/** NNPACK function was called before the library was initialized */
 	nnp_status_uninitialized = 50,
 	/** NNPACK does not implement this function for the host CPU */
 	nnp_status_unsupported_hardware = 51,
 	/** NNPACK failed to allocate memory for temporary buffers */
-	nnp_status_out_of_memory = 52
+	nnp_status_out_of_memory = 52,
+	/** Buffer provided by the caller is too small */
+	nnp_status_insufficient_buffer = 53,
+	/** Buffer provided by the caller is not properly aligned */
+	nnp_status_misaligned_buffer = 54,
+	/** NNPACK failed to read or write a file */
+	nnp_status_io_error = 55,
+	/** NNPACK failed to create a thread or another system object */
+	nnp_status_system_error = 56
+};
+
+/**
+ * @brief Activation function applied to the output of a layer.
+ */
+enum nnp_activation {
+	/** Identity activation f(x) := x, i.e. no transformation */
+	nnp_activation_identity = 0,
+	/** ReLU activation f(x) := (x > 0) ? x : x * negative_slope, with parametrized negative slope */
+	nnp_activation_relu = 1,
 };
 
 /**
@@ -82,7 +118,25 @@ enum nnp_convolution_algorithm {
 	nnp_convolution_algorithm_wt8x8 = 3
 };
 
+/**
+ * @brief Treatment of implicit padding in the divisor of average pooling.
+ */
+enum nnp_pooling_padding_mode {
+	/**
+	 * Padding pixels are counted in the divisor, i.e. pools which are not clipped by the padded image boundary are
+	 * divided by pooling_size.height * pooling_size.width (count_include_pad semantics of Caffe and Inception models).
+	 */
+	nnp_pooling_padding_mode_include = 0,
+	/** Only input pixels are counted in the divisor. Pools which lie entirely in the padding produce zeroes. */
+	nnp_pooling_padding_mode_exclude = 1,
+};
+
 enum nnp_convolution_kernel_transform_strategy {
+	/**
+	 * Only for convolutional layers of nnp_network_create: all images of the batch are computed at once, as in
+	 * nnp_convolution_output. Inference functions reject this value.
+	 */
+	nnp_convolution_kernel_transform_strategy_batch = 0,
 	nnp_convolution_kernel_transform_strategy_recompute = 1,
 	nnp_convolution_kernel_transform_strategy_reuse = 2,
 	nnp_convolution_kernel_transform_strategy_precomputed = 3
@@ -112,6 +166,157 @@ struct nnp_padding {
 	size_t left;
 };
 
+/**
+ * @brief Parameters of 8-bit asymmetric quantization of a tensor.
+ * @details A quantized value q represents the real value scale * (q - zero_point).
+ */
+struct nnp_quantization {
+	/** Real value of a unit step of quantized values. Must be positive and finite. */
+	float scale;
+	/** Quantized value which represents real zero */
+	uint8_t zero_point;
+};
+
+/**
+ * @brief Shape of an operand of an elementwise operation on 4D tensors in NCHW layout.
+ * @details A dimension of size 1 is broadcast along the corresponding dimension of the output.
+ */
+struct nnp_tensor_shape {
+	/** The number of images, or 1 to use the same image for all images of the output. */
+	size_t batch_size;
+	/** The number of channels, or 1 to use the same channel for all channels of the output. */
+	size_t channels;
+	/** Size of images, or 1x1 to use the same value for all pixels of an output channel. */
+	struct nnp_size image_size;
+};
+
+/**
+ * @brief Type of a layer in a network created by nnp_network_create.
+ */
+enum nnp_layer_type {
+	/** 2D convolutional layer, computed as in nnp_convolution_output or nnp_convolution_inference */
+	nnp_layer_type_convolution = 1,
+	/** Fully connected layer, computed as in nnp_fully_connected_output_with_bias or nnp_fully_connected_output_prepacked */
+	nnp_layer_type_fully_connected = 2,
+	/** Max-pooling layer, computed as in nnp_max_pooling_output */
+	nnp_layer_type_max_pooling = 3,
+	/** Rectified linear unit layer, computed as in nnp_relu_output */
+	nnp_layer_type_relu = 4,
+	/** Softmax layer, computed as in nnp_softmax_output */
+	nnp_layer_type_softmax = 5
+};
+
+struct nnp_convolution_layer {
+	enum nnp_convolution_algorithm algorithm;
+	/**
+	 * nnp_convolution_kernel_transform_strategy_batch (zero) to compute all images at once as in
+	 * nnp_convolution_output, or a strategy to compute every image separately as in nnp_convolution_inference.
+	 */
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	/**
+	 * A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width], or a kernel
+	 * transformed by nnp_convolution_inference_transform_kernel with nnp_convolution_kernel_transform_strategy_precomputed.
+	 */
+	const float* kernel;
+	/** A 1D array bias[output_channels]. */
+	const float* bias;
+};
+
+struct nnp_fully_connected_layer {
+	size_t input_channels;
+	size_t output_channels;
+	/** A 2D matrix kernel[output_channels][input_channels], or a kernel packed by nnp_fully_connected_pack_kernel. */
+	const float* kernel;
+	/** A 1D array bias[output_channels], or NULL if the layer has no bias. */
+	const float* bias;
+	/** Whether the kernel is packed by nnp_fully_connected_pack_kernel. */
+	bool prepacked_kernel;
+};
+
+struct nnp_max_pooling_layer {
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+};
+
+struct nnp_relu_layer {
+	/** The number of elements in an input (and output) of the layer for one image. */
+	size_t channels;
+	float negative_slope;
+};
+
+struct nnp_softmax_layer {
+	/** The number of elements in an input (and output) of the layer for one image. */
+	size_t channels;
+};
+
+/**
+ * @brief Description of a layer in a network created by nnp_network_create.
+ * @details The member of the union which corresponds to the type of the layer specifies its parameters.
+ */
+struct nnp_layer {
+	enum nnp_layer_type type;
+	union {
+		struct nnp_convolution_layer convolution;
+		struct nnp_fully_connected_layer fully_connected;
+		struct nnp_max_pooling_layer max_pooling;
+		struct nnp_relu_layer relu;
+		struct nnp_softmax_layer softmax;
+	};
+};
+
+/**
+ * @brief A feed-forward network with a static memory plan, created by nnp_network_create.
+ */
+typedef struct nnp_network* nnp_network_t;
+
+/**
+ * @brief A model file mapped into memory by nnp_model_load.
+ */
+typedef struct nnp_model* nnp_model_t;
+
+/**
+ * @brief A transformed convolution kernel in shared memory, acquired by nnp_convolution_inference_share_kernel.
+ */
+typedef struct nnp_shared_kernel* nnp_shared_kernel_t;
+
+/**
+ * @brief A queue of operations which run in order on a background thread, created by nnp_stream_create.
+ */
+typedef struct nnp_stream* nnp_stream_t;
+
+/**
+ * @brief An operation enqueued by nnp_stream_enqueue.
+ * @param context The context pointer passed to nnp_stream_enqueue.
+ * @param threadpool The thread pool of the stream. The operation should pass it to NNPACK functions it calls.
+ * @return Status of the operation, which is passed to the callback and reported by nnp_stream_synchronize.
+ */
+typedef enum nnp_status (*nnp_stream_function)(void* context, pthreadpool_t threadpool);
+
+/**
+ * @brief A function called on the stream thread after an operation completes.
+ * @param context The callback context pointer passed with the operation.
+ * @param status Status of the operation.
+ */
+typedef void (*nnp_stream_callback)(void* context, enum nnp_status status);
+
+/**
+ * @brief A set of worker threads shared by concurrent jobs, created by nnp_scheduler_create.
+ */
+typedef struct nnp_scheduler* nnp_scheduler_t;
+
+/**
+ * @brief A job which runs parallel loops on the workers of a scheduler, started by nnp_scheduler_begin_job.
+ */
+typedef struct nnp_scheduler_job* nnp_scheduler_job_t;
+
 /**
  * @brief Profiling information about time spent in different phases of a function call.
  */
@@ -294,6 +499,9 @@ enum nnp_status nnp_convolution_kernel_gradient(
  *                                                             and never store it to memory.
  *    - nnp_convolution_kernel_transform_strategy_reuse     -- compute transformation of kernel tensor once, store in
  *                                                             memory, and reuse the coefficients for every input tile.
+ *    - nnp_convolution_kernel_transform_strategy_precomputed -- use transformation of kernel tensor precomputed by
+ *                                                             nnp_convolution_inference_transform_kernel. The
+ *                                                             algorithm must be the same, and can not be auto.
  *
  * @param input_channels The number of channels (AKA features, dimensions) in the input image.
  * @param output_channels The number of channels (AKA features, dimensions) in the output image.
@@ -302,6 +510,8 @@ enum nnp_status nnp_convolution_kernel_gradient(
  * @param kernel_size Kernel size.
  * @param[in]  input  A 3D tensor input[input_channels][input_size.height][input_size.width].
  * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ *                    With nnp_convolution_kernel_transform_strategy_precomputed, a kernel transformed by
+ *                    nnp_convolution_inference_transform_kernel, aligned on 64 bytes.
  * @param[in]  bias   A 1D array bias[output_channels].
  * @param[out] output A 3D tensor output[output_channels][output_size.height][output_size.width] where
  *                        output_size.height = (input_padding.top + input_size.height + input_padding.bottom) -
@@ -328,10 +538,198 @@ enum nnp_status nnp_convolution_inference(
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile);
 
+/**
+ * @brief Transforms the kernel of a convolutional layer into the layout used by nnp_convolution_inference.
+ * @details Transforming kernels ahead of time, e.g. when a model is saved, lets nnp_convolution_inference with
+ *          nnp_convolution_kernel_transform_strategy_precomputed skip the kernel transform entirely.
+ *          The transformed layout is opaque and is valid only for the same algorithm, input_channels, output_channels,
+ *          and kernel_size values, and only on the machine (and NNPACK build) which transformed it.
+ * @param algorithm The type of algorithm to use for convolution: nnp_convolution_algorithm_ft8x8,
+ *                  nnp_convolution_algorithm_ft16x16, or nnp_convolution_algorithm_wt8x8.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input image.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output image.
+ * @param kernel_size Kernel size.
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[out] transformed_kernel A buffer for the transformed kernel, aligned on 64 bytes.
+ *                                If transformed_kernel is NULL, the function only stores the required buffer size in
+ *                                transformed_kernel_size and returns nnp_status_success.
+ * @param[in,out] transformed_kernel_size On input, the size of transformed_kernel buffer, in bytes.
+ *                                        If transformed_kernel is NULL, on output it contains the required buffer size.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_convolution_inference_transform_kernel(
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	const float kernel[],
+	void* transformed_kernel,
+	size_t* transformed_kernel_size,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Provides the kernel of a convolutional layer, transformed as by nnp_convolution_inference_transform_kernel,
+ *        in shared memory which is shared by all processes on the machine.
+ * @details Shared memory objects are identified by a hash of the kernel tensor, algorithm, and the layout parameters
+ *          (tile size and SIMD width). The first process which requests a kernel transforms it into a new shared
+ *          memory object; other processes, including those which request the kernel concurrently, wait for the
+ *          transform and map the same object read-only. If a process dies during the transform, the next request
+ *          redoes it.
+ *          Shared memory objects persist after all processes release them, so that restarted processes skip the
+ *          transform. Use nnp_shared_kernel_remove to delete an object.
+ *          Objects also keep a copy of the original kernel, which is compared with the requested kernel. If a
+ *          different kernel with the same hash already has an object, the function returns nnp_status_io_error.
+ * @param algorithm The type of algorithm to use for convolution: nnp_convolution_algorithm_ft8x8,
+ *                  nnp_convolution_algorithm_ft16x16, or nnp_convolution_algorithm_wt8x8.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input image.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output image.
+ * @param kernel_size Kernel size.
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[out] shared_kernel A pointer to the location where the function stores the shared kernel.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_convolution_inference_share_kernel(
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	const float kernel[],
+	nnp_shared_kernel_t* shared_kernel,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Provides the transformed kernel of a shared kernel.
+ * @param shared_kernel A shared kernel acquired by nnp_convolution_inference_share_kernel.
+ * @param[out] transformed_kernel A pointer to the location where the function stores a pointer to the read-only
+ *                                transformed kernel. The pointer is aligned on 64 bytes, and can be passed to
+ *                                nnp_convolution_inference with nnp_convolution_kernel_transform_strategy_precomputed
+ *                                until the shared kernel is released.
+ */
+enum nnp_status nnp_shared_kernel_get_data(
+	nnp_shared_kernel_t shared_kernel,
+	const void** transformed_kernel);
+
+/**
+ * @brief Deletes the shared memory object of a shared kernel.
+ * @details Mappings of the object in this and other processes remain valid until they are released, but new requests
+ *          for the kernel create a new object.
+ * @param shared_kernel A shared kernel acquired by nnp_convolution_inference_share_kernel.
+ */
+enum nnp_status nnp_shared_kernel_remove(nnp_shared_kernel_t shared_kernel);
+
+/**
+ * @brief Unmaps a shared kernel acquired by nnp_convolution_inference_share_kernel.
+ * @param shared_kernel A shared kernel acquired by nnp_convolution_inference_share_kernel, or NULL.
+ */
+enum nnp_status nnp_shared_kernel_release(nnp_shared_kernel_t shared_kernel);
+
+/**
+ * @brief Computes output of a convolutional layer followed by ReLU and 2x2 stride 2 max-pooling for a single input image.
+ * @details This function targets prediction with convolutional neural networks built of convolution, ReLU, and
+ *          max-pooling blocks (e.g. AlexNet and VGG). ReLU and max-pooling are applied to every output tile right
+ *          after its output transform, and only the pooled tensor is written to memory.
+ *          The result is equivalent to nnp_convolution_inference, followed by nnp_relu_output with zero negative slope,
+ *          followed by nnp_max_pooling_output with 2x2 pooling size, 2x2 stride, and no padding.
+ *          Output tiles are rounded down to even size, so that pools never cross tile boundaries.
+ * @param algorithm The type of algorithm to use for convolution. Possible values are the same as for
+ *                  nnp_convolution_inference. If the algorithm's output tile has less than 2 rows or columns for the
+ *                  kernel size, the function returns nnp_status_unsupported_algorithm.
+ *                  nnp_convolution_algorithm_auto only chooses among algorithms with output tiles of at least 2x2
+ *                  pixels, and compares them by the number of even-sized tiles, so it fails only for kernels with
+ *                  more than 15 rows or columns.
+ * @param kernel_transform_strategy A strategy that guides computation of kernel transforms coefficients.
+ *                                  Possible values are the same as for nnp_convolution_inference.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input image.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output image.
+ * @param input_size Size of input image, excluding implicit zero-padding.
+ * @param input_padding Implicit zero-padding of input image.
+ * @param kernel_size Kernel size.
+ * @param[in]  input  A 3D tensor input[input_channels][input_size.height][input_size.width].
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[in]  bias   A 1D array bias[output_channels].
+ * @param[out] output A 3D tensor output[output_channels][pooled_size.height][pooled_size.width] where
+ *                    pooled_size.height = ceil(output_size.height / 2)
+ *                    pooled_size.width  = ceil(output_size.width / 2)
+ *                    and output_size is the size of convolution output, as in nnp_convolution_inference.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_convolution_inference_relu_max_pooling(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a single convolutional layer for a single 8-bit quantized input image.
+ * @details This function targets prediction with quantized convolutional neural networks. Input and output images
+ *          are unsigned 8-bit with asymmetric quantization, kernel is signed 8-bit with symmetric per-output-channel
+ *          quantization, and products are accumulated in 32-bit integers. Accumulators are requantized to 8 bits,
+ *          together with bias and activation, right after they are computed.
+ *          The implementation lowers convolution to blocked matrix multiplication. Receptive fields of a block of
+ *          output pixels are gathered (im2col) into packed panels right before the block is multiplied by the kernel.
+ *          To keep 32-bit accumulators exact, input_channels * kernel_size.height * kernel_size.width must not
+ *          exceed 65536, otherwise the function returns nnp_status_unsupported_input_channels.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input image.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output image.
+ * @param input_size Size of input image, excluding implicit zero-padding.
+ * @param input_padding Implicit zero-padding of input image. Padding elements are equal to input zero point.
+ * @param kernel_size Kernel size.
+ * @param[in]  input  A 3D tensor input[input_channels][input_size.height][input_size.width].
+ * @param input_quantization Quantization parameters of the input image.
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ *                    Kernel elements represent real values kernel_scales[output_channel] * kernel[...].
+ * @param[in]  kernel_scales A 1D array kernel_scales[output_channels] of positive quantization scales of kernel.
+ * @param[in]  bias   A 1D array bias[output_channels] of real (not quantized) values, or NULL if the layer has no bias.
+ * @param[out] output A 3D tensor output[output_channels][output_size.height][output_size.width] where
+ *                    output_size.height = (input_padding.top + input_size.height + input_padding.bottom) -
+ *                                         (kernel_size.height - 1)
+ *                    output_size.width  = (input_padding.left + input_size.width + input_padding.right) -
+ *                                         (kernel_size.width - 1)
+ * @param output_quantization Quantization parameters of the output image.
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_convolution_inference_u8s8(
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
 /**
  * @brief Computes output of a fully connected layer from input and kernel matrices.
  * @details This function targets training of convolutional neural networks and performs forward propagation.
- *          It is optimized for moderate minibatch sizes (64-128) and can be inefficient on a small minibatch.
+ *          It is optimized for moderate minibatch sizes (64-128). Minibatches of up to 8 vectors are processed with
+ *          fused dot product kernels, which read the kernel matrix from memory only once.
  *          For minibatch size 1, use nnp_fully_connected_inference for optimal performance.
  * @param batch_size The number of vectors on the input and output of the fully connected layer.
  * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
@@ -353,114 +751,1326 @@ enum nnp_status nnp_fully_connected_output(
 	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
- * @details This function targets prediction with convolutional neural networks and performs forward propagation.
- * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
- * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
- * @param[in]  input  A 1D array input[input_channels].
- * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
- * @param[out] output A 1D array output[output_channels].
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a fully connected layer with bias and activation from input and kernel matrices.
+ * @details This function is equivalent to nnp_fully_connected_output followed by addition of bias and activation
+ *          function. Bias and activation are applied to every tile of the output right after it is computed,
+ *          while the tile is in L1 cache, rather than in separate passes over the output in memory.
+ * @param[in]  bias   A 1D array bias[output_channels], or NULL if the layer has no bias.
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ *                       Ignored for other activation functions.
+ * @see nnp_fully_connected_output for the description of other parameters.
  */
-enum nnp_status nnp_fully_connected_inference(
+enum nnp_status nnp_fully_connected_output_with_bias(
+	size_t batch_size,
 	size_t input_channels,
 	size_t output_channels,
 	const float input[],
 	const float kernel[],
+	const float bias[],
 	float output[],
-	pthreadpool_t threadpool);
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a max-pooling layer for an input tensor.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of images on the input and output of the max-pooling layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
- * @param input_size Size of input images, excluding implicit zero-padding.
- * @param input_padding Implicit padding of input images. The padding pixels are ignored by the pooling filter, but
- *                      affect the output size.
- * @param pooling_size   Size of the pooling filter. Only 2x2 filter are currently supported.
- * @param pooling_stride Stride of the pooling filter. Only 2x2 strides are currently supported.
- * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
- * @param[out] output A 4D tensor output[batch_size][channels][output_size.height][output_size.width] where
- *                    output_size.height = ceil(
- *                      (input_padding.top + input_size.height + input_padding.bottom - pooling_size.height) /
- *                        pooling_stride.height)
- *                    output_size.width = ceil(
- *                      (input_padding.left + input_size.width + input_padding.right - pooling_size.width) /
- *                        pooling_stride.width)
+ * @brief Computes gradient of input of a fully connected layer from gradient of output and kernel matrices.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          It is optimized for moderate minibatch sizes (64-128) and can be inefficient on a small minibatch.
+ * @param batch_size The number of vectors (and their gradients) on the input and output of the fully connected layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix (and gradient).
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix (and gradient).
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][output_channels].
+ * @param[in]  kernel      A 2D matrix kernel[output_channels][input_channels].
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][input_channels].
  * @param threadpool A thread pool for parallelization of the computation.
  *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
  */
-enum nnp_status nnp_max_pooling_output(
+enum nnp_status nnp_fully_connected_input_gradient(
 	size_t batch_size,
-	size_t channels,
-	struct nnp_size input_size,
-	struct nnp_padding input_padding,
-	struct nnp_size pooling_size,
-	struct nnp_size pooling_stride,
-	const float input[],
-	float output[],
-	pthreadpool_t threadpool);
+	size_t input_channels,
+	size_t output_channels,
+	const float grad_output[],
+	const float kernel[],
+	float grad_input[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a softmax layer for an input matrix.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the softmax layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
- * @param[out] output A 2D matrix output[batch_size][channels].
+ * @brief Computes gradient of kernel of a fully connected layer from gradient of output and input matrices.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          It is optimized for moderate minibatch sizes (64-128) and can be inefficient on a small minibatch.
+ * @param batch_size The number of vectors on the input and output of the fully connected layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix (and gradient).
+ * @param[in]  input       A 2D matrix input[batch_size][input_channels].
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][output_channels].
+ * @param[out] grad_kernel A 2D matrix grad_kernel[output_channels][input_channels].
  * @param threadpool A thread pool for parallelization of the computation.
  *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
  */
-enum nnp_status nnp_softmax_output(
-    size_t batch_size,
-    size_t channels,
-    const float input[],
-    float output[],
-    pthreadpool_t threadpool);
+enum nnp_status nnp_fully_connected_kernel_gradient(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float grad_output[],
+	float grad_kernel[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a rectified linear unit (ReLU) layer for an input matrix.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the ReLU layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
- * @param[out] output A 2D matrix output[batch_size][channels].
+ * @brief Packs the kernel matrix of a fully connected layer into the layout used by nnp_fully_connected_output.
+ * @details Packing the kernel ahead of time lets nnp_fully_connected_output_prepacked skip the kernel packing step,
+ *          which dominates the run time when the same weights are applied to many small minibatches.
+ *          The packed layout is opaque and is valid only for the same input_channels and output_channels values, and
+ *          only on the machine (and NNPACK build) which packed it.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
+ * @param[out] packed_kernel A buffer for the packed kernel, aligned on 64 bytes.
+ *                           If packed_kernel is NULL, the function only stores the required buffer size in
+ *                           packed_kernel_size and returns nnp_status_success.
+ * @param[in,out] packed_kernel_size On input, the size of packed_kernel buffer, in bytes.
+ *                                   If packed_kernel is NULL, on output it contains the required buffer size.
  * @param threadpool A thread pool for parallelization of the computation.
  *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
  */
-enum nnp_status nnp_relu_output(
-	size_t batch_size,
-	size_t channels,
-	const float input[],
-	float output[],
-	float negative_slope,
+enum nnp_status nnp_fully_connected_pack_kernel(
+	size_t input_channels,
+	size_t output_channels,
+	const float kernel[],
+	void* packed_kernel,
+	size_t* packed_kernel_size,
 	pthreadpool_t threadpool);
 
 /**
- * @brief Computes gradient of input of a rectified linear unit (ReLU) layer from gradient of output and input matrices.
- * @details This function targets training of convolutional neural networks and performs backward propagation.
- *          Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the ReLU layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @brief Computes output of a fully connected layer from input matrix and a kernel packed by nnp_fully_connected_pack_kernel.
+ * @details This function is equivalent to nnp_fully_connected_output_with_bias, but skips packing of the kernel matrix.
+ * @param batch_size The number of vectors on the input and output of the fully connected layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix.
+ * @param[in]  input  A 2D matrix input[batch_size][input_channels].
+ * @param[in]  packed_kernel A kernel packed by nnp_fully_connected_pack_kernel with the same input_channels and
+ *                           output_channels.
+ * @param[in]  bias   A 1D array bias[output_channels], or NULL if the layer has no bias.
+ * @param[out] output A 2D matrix output[batch_size][output_channels].
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ *                       Ignored for other activation functions.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_output_prepacked(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* packed_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  input  A 1D array input[input_channels].
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
+ * @param[out] output A 1D array output[output_channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_inference(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a fully connected layer with bias and activation for a single input vector.
+ * @details This function is equivalent to nnp_fully_connected_inference followed by addition of bias and activation
+ *          function, which are applied to every block of outputs right after it is computed.
+ * @param[in]  bias   A 1D array bias[output_channels], or NULL if the layer has no bias.
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ *                       Ignored for other activation functions.
+ * @see nnp_fully_connected_inference for the description of other parameters.
+ */
+enum nnp_status nnp_fully_connected_inference_with_bias(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix in half precision.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Kernel elements are stored in IEEE half-precision (fp16) format, which halves the memory traffic of the
+ *          bandwidth-bound matrix-vector product. Elements are converted to single precision on load, and all
+ *          accumulation is done in single precision.
+ *          On x86-64 this function requires F16C instruction set extension.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  input  A 1D array input[input_channels] in single precision.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of fp16 elements.
+ *                    Use nnp_convert_fp32_to_fp16 to convert a single-precision kernel.
+ * @param[in]  bias   A 1D array bias[output_channels] in single precision, or NULL if the layer has no bias.
+ * @param[out] output A 1D array output[output_channels] in single precision.
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ *                       Ignored for other activation functions.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_inference_f16f32(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix in bfloat16.
+ * @details This function is similar to nnp_fully_connected_inference_f16f32, but kernel elements are stored in
+ *          bfloat16 (bf16) format: upper 16 bits of single-precision numbers. bf16 trades mantissa precision for
+ *          the full single-precision exponent range.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of bf16 elements.
+ *                    Use nnp_convert_fp32_to_bf16 to convert a single-precision kernel.
+ * @see nnp_fully_connected_inference_f16f32 for the description of other parameters.
+ */
+enum nnp_status nnp_fully_connected_inference_bf16f32(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Converts an array of single-precision numbers to IEEE half-precision (fp16) format.
+ * @details Conversion rounds to nearest, ties to even. Numbers above the fp16 range are converted to infinities.
+ * @param length The number of elements to convert.
+ * @param[in]  input  A 1D array input[length] of single-precision numbers.
+ * @param[out] output A 1D array output[length] of fp16 numbers.
+ */
+void nnp_convert_fp32_to_fp16(size_t length, const float input[], uint16_t output[]);
+
+/**
+ * @brief Converts an array of single-precision numbers to bfloat16 (bf16) format.
+ * @details Conversion rounds to nearest, ties to even.
+ * @param length The number of elements to convert.
+ * @param[in]  input  A 1D array input[length] of single-precision numbers.
+ * @param[out] output A 1D array output[length] of bf16 numbers.
+ */
+void nnp_convert_fp32_to_bf16(size_t length, const float input[], uint16_t output[]);
+
+/**
+ * @brief Converts a kernel matrix of a fully connected layer into compressed sparse row (CSR) format.
+ * @details The sparse kernel is used by nnp_fully_connected_inference_sparse. Only non-zero kernel elements are
+ *          stored, thus sparse format pays off for pruned layers with most of kernel elements equal to zero.
+ *          The function computes the required buffer size if sparse_kernel is NULL.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
+ * @param[out] sparse_kernel A buffer for the sparse kernel, aligned on sizeof(float), or NULL to query its size.
+ * @param[in,out] sparse_kernel_size On input, the size of sparse_kernel buffer, in bytes.
+ *                                   On output, the size of the sparse kernel, in bytes.
+ */
+enum nnp_status nnp_fully_connected_pack_sparse_kernel(
+	size_t input_channels,
+	size_t output_channels,
+	const float kernel[],
+	void* sparse_kernel,
+	size_t* sparse_kernel_size);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a sparse kernel matrix.
+ * @details This function targets prediction with pruned neural networks: its cost is proportional to the number of
+ *          non-zero kernel elements rather than to the size of the kernel.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  input  A 1D array input[input_channels].
+ * @param[in]  sparse_kernel A kernel matrix in sparse format produced by nnp_fully_connected_pack_sparse_kernel.
+ * @param[in]  bias   A 1D array bias[output_channels], or NULL if the layer has no bias.
+ * @param[out] output A 1D array output[output_channels].
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ *                       Ignored for other activation functions.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_inference_sparse(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* sparse_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a fully connected layer from 8-bit quantized input and kernel matrices.
+ * @details This function targets prediction with quantized neural networks. Input and output matrices are unsigned
+ *          8-bit with asymmetric quantization, kernel is signed 8-bit with symmetric per-output-channel
+ *          quantization, and products are accumulated in 32-bit integers. Accumulators are requantized to 8 bits,
+ *          together with bias and activation, right after they are computed.
+ *          The implementation uses blocked matrix multiplication with register tiles of several vectors and
+ *          output channels.
+ *          To keep 32-bit accumulators exact, input_channels must not exceed 65536, otherwise the function returns
+ *          nnp_status_unsupported_input_channels.
+ * @param batch_size The number of vectors on the input and output of the fully connected layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix.
+ * @param[in]  input  A 2D matrix input[batch_size][input_channels].
+ * @param input_quantization Quantization parameters of the input matrix.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
+ *                    Kernel elements represent real values kernel_scales[output_channel] * kernel[...].
+ * @param[in]  kernel_scales A 1D array kernel_scales[output_channels] of positive quantization scales of kernel.
+ * @param[in]  bias   A 1D array bias[output_channels] of real (not quantized) values, or NULL if the layer has no bias.
+ * @param[out] output A 2D matrix output[batch_size][output_channels].
+ * @param output_quantization Quantization parameters of the output matrix.
+ * @param activation Activation function applied to the output after adding bias.
+ * @param negative_slope The slope of ReLU activation for negative inputs (0 for standard ReLU).
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_fully_connected_output_u8s8(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a fully connected layer for a single 8-bit quantized input vector.
+ * @details This function is equivalent to nnp_fully_connected_output_u8s8 with batch_size = 1, but uses
+ *          matrix-vector products, which read every kernel element once.
+ * @see nnp_fully_connected_output_u8s8 for the description of parameters.
+ */
+enum nnp_status nnp_fully_connected_inference_u8s8(
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a max-pooling layer for an input tensor.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of images on the input and output of the max-pooling layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit padding of input images. The padding pixels are ignored by the pooling filter, but
+ *                      affect the output size.
+ * @param pooling_size   Size of the pooling filter. 2x2 filters with 2x2 stride, and 3x3 filters with 2x2 or 1x1 stride
+ *                       use specialized SIMD kernels; other filters use a general implementation.
+ * @param pooling_stride Stride of the pooling filter. Must not exceed the pooling filter size.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][output_size.height][output_size.width] where
+ *                    output_size.height = ceil(
+ *                      (input_padding.top + input_size.height + input_padding.bottom - pooling_size.height) /
+ *                        pooling_stride.height) + 1
+ *                    output_size.width = ceil(
+ *                      (input_padding.left + input_size.width + input_padding.right - pooling_size.width) /
+ *                        pooling_stride.width) + 1
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_max_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a max-pooling layer for an input tensor, and records the position of the maximum in every pool.
+ * @details This function targets training of convolutional neural networks and performs forward propagation.
+ *          The recorded mask lets nnp_max_pooling_input_gradient propagate gradients without re-reading the input.
+ *          Parameters are the same as for nnp_max_pooling_output, except for the mask.
+ * @param pooling_size   Size of the pooling filter. The pooling filter must contain at most 256 elements.
+ * @param[out] mask A 4D tensor mask[batch_size][channels][output_size.height][output_size.width] with the index
+ *                  i * pooling_size.width + j of the first (in row-major order) maximal element of every pool.
+ *                  Pools which lie entirely in the padding record index 0.
+ */
+enum nnp_status nnp_max_pooling_output_with_mask(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	uint8_t mask[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a max-pooling layer from gradient of output and the mask of maximal elements.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          Every output gradient is added to the gradient of the input element recorded in the mask. Elements which
+ *          are not maximal in any pool get zero gradient.
+ * @param batch_size The number of images (and their gradients) on the input and output of the max-pooling layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit padding of input images.
+ * @param pooling_size   Size of the pooling filter. The pooling filter must contain at most 256 elements.
+ * @param pooling_stride Stride of the pooling filter.
+ * @param[in]  grad_output A 4D tensor grad_output[batch_size][channels][output_size.height][output_size.width].
+ * @param[in]  mask A 4D tensor mask[batch_size][channels][output_size.height][output_size.width] computed by
+ *                  nnp_max_pooling_output_with_mask.
+ * @param[out] grad_input A 4D tensor grad_input[batch_size][channels][input_size.height][input_size.width].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_max_pooling_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float grad_output[],
+	const uint8_t mask[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of an average-pooling layer for an input tensor.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of images on the input and output of the average-pooling layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit zero-padding of input images. Padding pixels contribute zeroes to the sum of a pool.
+ * @param pooling_size   Size of the pooling filter. 2x2 filters with 2x2 stride, and 3x3 filters with 2x2 or 1x1 stride
+ *                       use specialized SIMD kernels; other filters use a general implementation.
+ * @param pooling_stride Stride of the pooling filter. Must not exceed the pooling filter size.
+ * @param padding_mode   Specifies if padding pixels are counted in the divisor of the pool average.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][output_size.height][output_size.width] where
+ *                    output_size is computed as in nnp_max_pooling_output.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_average_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	enum nnp_pooling_padding_mode padding_mode,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a global average-pooling layer for an input tensor.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Every channel of every image is reduced to its average value.
+ * @param batch_size The number of images on the input and vectors on the output of the global average-pooling layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input images and output vectors.
+ * @param input_size Size of input images.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_global_average_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a softmax layer for an input matrix.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ *          If the minibatch has fewer vectors than the thread pool has threads, and vectors are much wider than L1
+ *          cache, every vector is split into blocks which are processed in parallel.
+ * @param batch_size The number of vectors on the input and output of the softmax layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_softmax_output(
+    size_t batch_size,
+    size_t channels,
+    const float input[],
+    float output[],
+    pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a softmax layer from gradient of output and output of the softmax layer.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          grad_input[i] = output[i] * (grad_output[i] - dot(grad_output, output)) for every vector in the batch.
+ * @param batch_size The number of vectors on the input and output of the softmax layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels].
+ * @param[in]  output      A 2D matrix output[batch_size][channels] computed by nnp_softmax_output.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels]. Must not overlap grad_output or output.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_softmax_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float output[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a log-softmax layer for an input matrix.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. output[i] = input[i] - max(input) - log(sum(exp(input - max(input)))), which avoids the
+ *          overflow and the loss of precision of log(softmax(input)).
+ * @param batch_size The number of vectors on the input and output of the log-softmax layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels]. Can be the same as input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_log_softmax_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes cross-entropy loss of a softmax layer and its gradient with respect to the input of the softmax layer.
+ * @details This function targets training of convolutional neural networks and fuses the softmax layer with
+ *          cross-entropy loss. For every vector in the batch, it computes
+ *          loss = log(sum(exp(input))) - input[label] and grad_input = softmax(input) - onehot(label)
+ *          in two passes over the input, without storing the probabilities separately from the gradient.
+ *          Loss and gradient are not averaged over the batch.
+ * @param batch_size The number of vectors on the input of the softmax layer.
+ * @param channels   The number of channels (AKA classes) in input vectors.
+ * @param[in]  input  A 2D matrix input[batch_size][channels] of logits.
+ * @param[in]  labels A 1D array labels[batch_size] of target classes in [0, channels) range.
+ * @param[out] loss   A 1D array loss[batch_size] of cross-entropy losses.
+ * @param[out] grad_input A 2D matrix grad_input[batch_size][channels]. Must not overlap input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_softmax_cross_entropy_loss_and_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	const uint32_t labels[],
+	float loss[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a rectified linear unit (ReLU) layer for an input matrix.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of vectors on the input and output of the ReLU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_relu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a rectified linear unit (ReLU) layer from gradient of output and input matrices.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of vectors on the input and output of the ReLU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_relu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a sigmoid layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of f(x) := 1 / (1 + exp(-x)).
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the sigmoid layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_sigmoid_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a sigmoid layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the sigmoid layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_sigmoid_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a hyperbolic tangent layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of f(x) := tanh(x).
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the hyperbolic tangent layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_tanh_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a hyperbolic tangent layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the hyperbolic tangent layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_tanh_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of an exponential linear unit (ELU) layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of f(x) := (x > 0) ? x : alpha * (exp(x) - 1).
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the ELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
  * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param alpha Scale of the negative part of ELU.
  * @param threadpool A thread pool for parallelization of the computation.
  *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
  */
-enum nnp_status nnp_relu_input_gradient(
+enum nnp_status nnp_elu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float alpha,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of an exponential linear unit (ELU) layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the ELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param alpha Scale of the negative part of ELU.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_elu_input_gradient(
 	size_t batch_size,
 	size_t channels,
 	const float grad_output[],
 	const float input[],
 	float grad_input[],
-	float negative_slope,
+	float alpha,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a scaled exponential linear unit (SELU) layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of f(x) := lambda * ((x > 0) ? x : alpha * (exp(x) - 1)), with
+ *          alpha = 1.6732632 and lambda = 1.0507010.
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the SELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_selu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a scaled exponential linear unit (SELU) layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the SELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_selu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a Gaussian error linear unit (GELU) layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of the tanh approximation
+ *          f(x) := 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))).
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the GELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_gelu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a Gaussian error linear unit (GELU) layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the GELU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_gelu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a swish (SiLU) layer for an input matrix.
+ * @details This function targets both prediction and training of neural networks and performs forward propagation
+ *          of f(x) := x / (1 + exp(-x)).
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of vectors on the input and output of the swish layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_swish_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a swish (SiLU) layer from gradient of output and input matrices.
+ * @details This function targets training of neural networks and performs backward propagation.
+ * @param batch_size The number of vectors on the input and output of the swish layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  grad_output A 2D matrix grad_output[batch_size][channels] with gradient of the layer output.
+ * @param[in]  input       A 2D matrix input[batch_size][channels] with input of the layer in forward propagation.
+ * @param[out] grad_input  A 2D matrix grad_input[batch_size][channels] with gradient of the layer input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_swish_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Folds an inference-mode batch normalization layer into the kernel and bias of the preceding convolutional
+ *        or fully connected layer.
+ * @details Batch normalization y := scale * (x - mean) / sqrt(variance + epsilon) + shift of the layer output is
+ *          equivalent to scaling the kernel of every output channel by s := scale / sqrt(variance + epsilon) and
+ *          replacing its bias with (bias - mean) * s + shift. After folding the batch normalization layer costs nothing
+ *          at runtime. Fully connected layers are handled as 1x1 convolutions.
+ *          Kernels with pre-computed transforms must be folded before the transform is computed.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input images.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output images.
+ * @param kernel_size Kernel size. Use 1x1 for fully connected layers.
+ * @param[in,out] kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[in,out] bias   A 1D array bias[output_channels].
+ * @param[in]  mean     A 1D array mean[output_channels] with running mean of the batch normalization layer.
+ * @param[in]  variance A 1D array variance[output_channels] with running variance of the batch normalization layer.
+ * @param[in]  scale    A 1D array scale[output_channels] with learned scale (gamma), or NULL for unit scale.
+ * @param[in]  shift    A 1D array shift[output_channels] with learned shift (beta), or NULL for zero shift.
+ * @param epsilon A non-negative constant added to variance for numerical stability.
+ */
+enum nnp_status nnp_convolution_fold_batch_norm(
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	float kernel[],
+	float bias[],
+	const float mean[],
+	const float variance[],
+	const float scale[],
+	const float shift[],
+	float epsilon);
+
+/**
+ * @brief Computes output of a batch normalization layer in training mode.
+ * @details This function targets training of neural networks and performs forward propagation of
+ *          y := scale * (x - mean) / sqrt(variance + epsilon) + shift, where mean and (biased) variance of every channel
+ *          are computed over the batch and spatial dimensions in a single vectorized pass over the input.
+ *          Input and output may point to the same buffer for in-place computation.
+ * @param batch_size The number of images on the input and output of the batch normalization layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input and output images.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[in]  scale  A 1D array scale[channels] with learned scale (gamma), or NULL for unit scale.
+ * @param[in]  shift  A 1D array shift[channels] with learned shift (beta), or NULL for zero shift.
+ * @param epsilon A non-negative constant added to variance for numerical stability.
+ * @param[out] output   A 4D tensor output[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] mean     A 1D array mean[channels] with mean of every channel in the batch.
+ * @param[out] variance A 1D array variance[channels] with biased variance of every channel in the batch.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_batch_norm_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	const float scale[],
+	const float shift[],
+	float epsilon,
+	float output[],
+	float mean[],
+	float variance[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradients of input, scale, and shift of a batch normalization layer in training mode.
+ * @details This function targets training of neural networks and performs backward propagation.
+ *          Mean and variance must be the batch statistics produced by nnp_batch_norm_output.
+ * @param batch_size The number of images on the input and output of the batch normalization layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input and output images.
+ * @param[in]  grad_output A 4D tensor grad_output[batch_size][channels][input_size.height][input_size.width].
+ * @param[in]  input       A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[in]  scale    A 1D array scale[channels] with learned scale (gamma), or NULL for unit scale.
+ * @param[in]  mean     A 1D array mean[channels] with mean of every channel in the batch.
+ * @param[in]  variance A 1D array variance[channels] with biased variance of every channel in the batch.
+ * @param epsilon A non-negative constant added to variance for numerical stability.
+ * @param[out] grad_input A 4D tensor grad_input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] grad_scale A 1D array grad_scale[channels] with gradient of scale, or NULL if it is not needed.
+ * @param[out] grad_shift A 1D array grad_shift[channels] with gradient of shift, or NULL if it is not needed.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_batch_norm_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float grad_output[],
+	const float input[],
+	const float scale[],
+	const float mean[],
+	const float variance[],
+	float epsilon,
+	float grad_input[],
+	float grad_scale[],
+	float grad_shift[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a cross-channel local response normalization (LRN) layer.
+ * @details Every element is divided by a power of the sum of squares over a window of local_size adjacent channels
+ *          centered on its channel: output = input / (k + alpha / local_size * sum(input^2))^beta,
+ *          where the window is clipped at the first and last channel (the convention of AlexNet and Caffe).
+ * @param batch_size The number of images on the input and output of the LRN layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input and output images.
+ * @param local_size The number of channels in the normalization window. Must be odd.
+ * @param alpha Non-negative scaling parameter.
+ * @param beta  Exponent parameter.
+ * @param k     Positive additive constant.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][input_size.height][input_size.width].
+ *                    Output must not overlap with input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_lrn_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes input gradient of a cross-channel local response normalization (LRN) layer.
+ * @details This function targets training of neural networks and performs backward propagation.
+ *          Parameters must be the same as in the nnp_lrn_output call for the forward pass.
+ * @param batch_size The number of images on the input and output of the LRN layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input and output images.
+ * @param local_size The number of channels in the normalization window. Must be odd.
+ * @param alpha Non-negative scaling parameter.
+ * @param beta  Exponent parameter.
+ * @param k     Positive additive constant.
+ * @param[in]  grad_output A 4D tensor grad_output[batch_size][channels][input_size.height][input_size.width].
+ * @param[in]  input       A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] grad_input  A 4D tensor grad_input[batch_size][channels][input_size.height][input_size.width].
+ *                         Grad_input may alias grad_output, but must not overlap with input.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_lrn_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes elementwise sum of two tensors, broadcasting their dimensions of size 1.
+ * @details Every dimension of an operand must be either 1 or equal to the output dimension,
+ *          and every output dimension other than 1 must be matched by at least one operand.
+ * @param batch_size The number of images in the output.
+ * @param channels   The number of channels (AKA features, dimensions) in the output.
+ * @param image_size Size of output images.
+ * @param a_shape Shape of the first operand.
+ * @param[in]  a A 4D tensor a[a_shape.batch_size][a_shape.channels][a_shape.image_size.height][a_shape.image_size.width].
+ * @param b_shape Shape of the second operand.
+ * @param[in]  b A 4D tensor b[b_shape.batch_size][b_shape.channels][b_shape.image_size.height][b_shape.image_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][image_size.height][image_size.width].
+ *                    Output may coincide with an operand of the same shape (in-place operation).
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_add(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes elementwise product of two tensors, broadcasting their dimensions of size 1.
+ * @details Broadcasting rules are the same as in nnp_add.
+ * @param batch_size The number of images in the output.
+ * @param channels   The number of channels (AKA features, dimensions) in the output.
+ * @param image_size Size of output images.
+ * @param a_shape Shape of the first operand.
+ * @param[in]  a A 4D tensor a[a_shape.batch_size][a_shape.channels][a_shape.image_size.height][a_shape.image_size.width].
+ * @param b_shape Shape of the second operand.
+ * @param[in]  b A 4D tensor b[b_shape.batch_size][b_shape.channels][b_shape.image_size.height][b_shape.image_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][image_size.height][image_size.width].
+ *                    Output may coincide with an operand of the same shape (in-place operation).
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_multiply(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output = a * b + c elementwise, broadcasting dimensions of size 1 in operands.
+ * @details Broadcasting rules are the same as in nnp_add. With a of the output shape, and b and c of shape
+ *          [1][channels][1][1], this function implements a channel-wise scale and bias layer.
+ * @param batch_size The number of images in the output.
+ * @param channels   The number of channels (AKA features, dimensions) in the output.
+ * @param image_size Size of output images.
+ * @param a_shape Shape of the first multiplicand.
+ * @param[in]  a A 4D tensor a[a_shape.batch_size][a_shape.channels][a_shape.image_size.height][a_shape.image_size.width].
+ * @param b_shape Shape of the second multiplicand.
+ * @param[in]  b A 4D tensor b[b_shape.batch_size][b_shape.channels][b_shape.image_size.height][b_shape.image_size.width].
+ * @param c_shape Shape of the addend.
+ * @param[in]  c A 4D tensor c[c_shape.batch_size][c_shape.channels][c_shape.image_size.height][c_shape.image_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][image_size.height][image_size.width].
+ *                    Output may coincide with an operand of the same shape (in-place operation).
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_multiply_add(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	struct nnp_tensor_shape c_shape,
+	const float c[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Creates a feed-forward network from a chain of layers, and plans its memory.
+ * @details Every layer consumes the output of the previous layer. Intermediate activations are placed in a single
+ *          buffer, where tensors which are not alive at the same time share memory, and ReLU and softmax layers
+ *          overwrite their inputs. Temporary buffers of all layers share a single workspace sized for the layer which
+ *          needs the largest one. All memory is allocated in this function, and nnp_network_run does not allocate.
+ * @param batch_size The number of images processed by every call to nnp_network_run.
+ * @param layers_count The number of layers in the network.
+ * @param[in]  layers A 1D array layers[layers_count]. The network copies the descriptions of layers, but not the
+ *                    kernels and biases: they must stay valid until the network is destroyed.
+ *                    If the number of elements in the input of a layer is different from the number of elements in
+ *                    the output of the previous layer, the function returns nnp_status_invalid_layer.
+ * @param[out] network A pointer to the location where the function stores the created network.
+ */
+enum nnp_status nnp_network_create(
+	size_t batch_size,
+	size_t layers_count,
+	const struct nnp_layer layers[],
+	nnp_network_t* network);
+
+/**
+ * @brief Computes output of a network created by nnp_network_create.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Calls to nnp_network_run with the same network must not overlap in time.
+ * @param network A network created by nnp_network_create.
+ * @param[in]  input  A 2D matrix input[batch_size][input_elements], where input_elements is the number of elements
+ *                    in the input of the first layer for one image.
+ * @param[out] output A 2D matrix output[batch_size][output_elements], where output_elements is the number of
+ *                    elements in the output of the last layer for one image.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_network_run(
+	nnp_network_t network,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Reports the memory footprint of a network created by nnp_network_create.
+ * @param network A network created by nnp_network_create.
+ * @param[out] activations_size If not NULL, receives the size, in bytes, of the buffer for intermediate activations.
+ * @param[out] workspace_size   If not NULL, receives the size, in bytes, of the workspace shared by the layers.
+ */
+enum nnp_status nnp_network_get_memory_size(
+	nnp_network_t network,
+	size_t* activations_size,
+	size_t* workspace_size);
+
+/**
+ * @brief Destroys a network created by nnp_network_create, and releases its memory.
+ * @param network A network created by nnp_network_create, or NULL.
+ */
+enum nnp_status nnp_network_destroy(nnp_network_t network);
+
+/**
+ * @brief Saves layers of a network to a model file with kernels in the layouts used by inference functions.
+ * @details Kernels of convolutional layers are transformed by nnp_convolution_inference_transform_kernel, and kernels
+ *          of fully connected layers are packed by nnp_fully_connected_pack_kernel. Every kernel and bias is aligned in
+ *          the file, so that nnp_model_load can use them in place.
+ *          The model file is valid only on the machine (and NNPACK build) which saved it.
+ * @param[in] path Path of the model file. An existing file is overwritten.
+ * @param layers_count The number of layers in the network.
+ * @param[in] layers A 1D array layers[layers_count] with the same layer descriptions as for nnp_network_create.
+ *                   Convolutional layers must specify an algorithm other than nnp_convolution_algorithm_auto, because
+ *                   the layout of the transformed kernel depends on the algorithm. Kernels of convolutional layers must
+ *                   not be transformed, and kernels of fully connected layers must not be prepacked.
+ *                   Convolutional layers without bias (NULL) are saved with zero bias, because inference functions
+ *                   require it.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_model_save(
+	const char* path,
+	size_t layers_count,
+	const struct nnp_layer layers[],
 	pthreadpool_t threadpool);
 
+/**
+ * @brief Maps a model file saved by nnp_model_save into memory.
+ * @details The file is mapped read-only and shared, so processes which load the same model share its pages in the
+ *          page cache, and only pages which are accessed are read from disk.
+ * @param[in]  path  Path of the model file.
+ * @param[out] model A pointer to the location where the function stores the loaded model.
+ */
+enum nnp_status nnp_model_load(
+	const char* path,
+	nnp_model_t* model);
+
+/**
+ * @brief Provides layers of a model loaded by nnp_model_load.
+ * @details Convolutional layers use nnp_convolution_kernel_transform_strategy_precomputed, and fully connected layers
+ *          use prepacked kernels. Kernels and biases point into the mapped file, and the layers can be passed to
+ *          nnp_network_create without copies.
+ * @param model A model loaded by nnp_model_load.
+ * @param[out] layers_count A pointer to the location where the function stores the number of layers.
+ * @param[out] layers A pointer to the location where the function stores a pointer to the array of layers.
+ *                    The array is valid until the model is unloaded.
+ */
+enum nnp_status nnp_model_get_layers(
+	nnp_model_t model,
+	size_t* layers_count,
+	const struct nnp_layer** layers);
+
+/**
+ * @brief Unmaps a model loaded by nnp_model_load.
+ * @details Networks created from layers of the model must be destroyed before the model is unloaded.
+ * @param model A model loaded by nnp_model_load, or NULL.
+ */
+enum nnp_status nnp_model_unload(nnp_model_t model);
+
+/**
+ * @brief Creates a stream: a queue of operations which run in order on a dedicated background thread.
+ * @details Enqueue functions return without waiting for the operation, so the caller can prepare and enqueue the next
+ *          operations while the current ones run. Several streams may share one thread pool: parallel loops of
+ *          operations in different streams take turns on the pool. Streams interleave at the granularity of whole
+ *          parallel loops rather than tiles, so a long loop of one stream delays the loops of other streams until
+ *          it completes. To run operations side by side on disjoint sets of threads, use a scheduler created by
+ *          nnp_scheduler_create instead.
+ * @param threadpool A thread pool for parallelization of the operations in the stream.
+ *                   If threadpool is NULL, the operations would run on the stream thread without parallelization.
+ * @param[out] stream A pointer to the location where the function stores the created stream.
+ * @return nnp_status_system_error if the stream thread or its event descriptor could not be created.
+ */
+enum nnp_status nnp_stream_create(
+	pthreadpool_t threadpool,
+	nnp_stream_t* stream);
+
+/**
+ * @brief Enqueues a function call to a stream.
+ * @param stream A stream created by nnp_stream_create.
+ * @param function The function to call on the stream thread after all previously enqueued operations complete.
+ * @param context A pointer passed to the function. It must stay valid until the operation completes.
+ * @param callback A function called on the stream thread after the operation completes, or NULL. The operation
+ *                 counts as pending until the callback returns, so the callback must not call
+ *                 nnp_stream_synchronize or nnp_stream_destroy on its own stream: both would deadlock.
+ * @param callback_context A pointer passed to the callback.
+ */
+enum nnp_status nnp_stream_enqueue(
+	nnp_stream_t stream,
+	nnp_stream_function function,
+	void* context,
+	nnp_stream_callback callback,
+	void* callback_context);
+
+/**
+ * @brief Enqueues a run of a network to a stream, as in nnp_network_run with the thread pool of the stream.
+ * @details A network must not run concurrently in several streams, because its runs share intermediate buffers.
+ * @param stream A stream created by nnp_stream_create.
+ * @param network A network created by nnp_network_create.
+ * @param[in]  input  Input of the first layer of the network, as in nnp_network_run. It must stay valid and unchanged
+ *                    until the operation completes.
+ * @param[out] output Output of the last layer of the network, as in nnp_network_run.
+ * @param callback A function called on the stream thread after the operation completes, or NULL. The operation
+ *                 counts as pending until the callback returns, so the callback must not call
+ *                 nnp_stream_synchronize or nnp_stream_destroy on its own stream: both would deadlock.
+ * @param callback_context A pointer passed to the callback.
+ */
+enum nnp_status nnp_stream_enqueue_network_run(
+	nnp_stream_t stream,
+	nnp_network_t network,
+	const float input[],
+	float output[],
+	nnp_stream_callback callback,
+	void* callback_context);
+
+/**
+ * @brief Waits until all operations enqueued to a stream complete, including their callbacks.
+ * @param stream A stream created by nnp_stream_create.
+ * @return Status of the first operation which failed since the last call to nnp_stream_synchronize, or
+ *         nnp_status_success if all operations succeeded.
+ */
+enum nnp_status nnp_stream_synchronize(nnp_stream_t stream);
+
+/**
+ * @brief Provides a file descriptor which signals completion of operations in a stream, e.g. for poll or epoll.
+ * @details The descriptor is a non-blocking eventfd, and its counter increments every time an operation completes.
+ *          It is owned by the stream, and is closed by nnp_stream_destroy. This function is supported only on Linux.
+ * @param stream A stream created by nnp_stream_create.
+ * @param[out] event_fd A pointer to the location where the function stores the file descriptor.
+ * @return nnp_status_unsupported_hardware on systems other than Linux, where streams have no event descriptor.
+ */
+enum nnp_status nnp_stream_get_event_fd(
+	nnp_stream_t stream,
+	int* event_fd);
+
+/**
+ * @brief Completes all operations enqueued to a stream, and destroys the stream.
+ * @param stream A stream created by nnp_stream_create, or NULL.
+ */
+enum nnp_status nnp_stream_destroy(nnp_stream_t stream);
+
+/**
+ * @brief Creates a scheduler: a set of worker threads which run parallel loops of several concurrent jobs.
+ * @details Unlike a thread pool, which runs parallel loops of concurrent callers one after another, a scheduler splits
+ *          its workers between the jobs which have parallel loops in progress. Every job gets its minimum number of
+ *          workers, and the rest are split in proportion to job priorities. Workers move between jobs as parallel
+ *          loops start and complete, so the threads stay busy without oversubscription of the cores.
+ *          On NUMA systems, workers are bound to nodes in groups of equal size, and the rows of every parallel loop
+ *          are split between the nodes, so that the workers of a node mostly access the memory they write.
+ * @param threads_count The number of worker threads, usually the number of cores.
+ * @param[out] scheduler A pointer to the location where the function stores the created scheduler.
+ * @return nnp_status_system_error if a worker thread could not be created.
+ */
+enum nnp_status nnp_scheduler_create(
+	size_t threads_count,
+	nnp_scheduler_t* scheduler);
+
+/**
+ * @brief Starts a job on a scheduler, and binds it to the calling thread.
+ * @details Until nnp_scheduler_end_job, NNPACK functions called on this thread run their parallel loops on the
+ *          scheduler workers assigned to the job, rather than on the thread pool passed to them. The calling thread
+ *          waits while the workers run a parallel loop.
+ * @param scheduler A scheduler created by nnp_scheduler_create.
+ * @param priority Relative weight of the job in the split of workers beyond the minimums. Jobs with zero priority
+ *                 get only their minimum number of workers, and workers which other jobs do not use.
+ * @param min_threads The number of workers the job gets whenever it runs a parallel loop, as long as the minimums of
+ *                    concurrent jobs do not exceed the number of workers. Must be between 1 and the number of workers.
+ * @param[out] job A pointer to the location where the function stores the started job.
+ */
+enum nnp_status nnp_scheduler_begin_job(
+	nnp_scheduler_t scheduler,
+	uint32_t priority,
+	size_t min_threads,
+	nnp_scheduler_job_t* job);
+
+/**
+ * @brief Ends a job started by nnp_scheduler_begin_job on the calling thread, and restores the previous binding.
+ * @param job A job started by nnp_scheduler_begin_job on the calling thread.
+ */
+enum nnp_status nnp_scheduler_end_job(nnp_scheduler_job_t job);
+
+/**
+ * @brief Stops worker threads and destroys a scheduler. All jobs on the scheduler must be ended.
+ * @param scheduler A scheduler created by nnp_scheduler_create, or NULL.
+ */
+enum nnp_status nnp_scheduler_destroy(nnp_scheduler_t scheduler);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Element-wise activation kernels. Length is non-zero and a multiple of SIMD width, and output is SIMD-aligned.
+ * Forward kernels may operate in-place. The last argument is alpha parameter of ELU, and is ignored by other kernels.
+ */
+typedef void (*nnp_activation_forward_function)(const float*, float*, size_t, float);
+typedef void (*nnp_activation_backward_function)(const float*, const float*, float*, size_t, float);
+
+void nnp_sigmoid_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_tanh_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_elu_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_selu_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_gelu_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_swish_forward__avx2(const float* input, float* output, size_t length, float alpha);
+void nnp_sigmoid_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_tanh_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_elu_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_selu_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_gelu_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_swish_backward__avx2(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+
+void nnp_sigmoid_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_tanh_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_elu_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_selu_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_gelu_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_swish_forward__psimd(const float* input, float* output, size_t length, float alpha);
+void nnp_sigmoid_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_tanh_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_elu_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_selu_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_gelu_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+void nnp_swish_backward__psimd(const float* grad_output, const float* input, float* grad_input, size_t length, float alpha);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+static inline float relu(float data, float negative_slope) {
+	return data > 0.0f ? data : data * negative_slope;
+}
+
+/*
+ * Adds bias and applies activation function to a block of output elements.
+ * Intended as an epilogue for matrix multiplication micro-kernels: it runs right after a micro-kernel stored the block,
+ * when the block is still in L1 cache, and thus avoids separate passes over the output in memory. It is not fused into
+ * the micro-kernels, which keep accumulators in registers: the block is loaded from L1 and stored again.
+ */
+static inline void apply_bias_activation(
+	float* block, size_t rows, size_t columns, size_t row_stride,
+	const float* bias, enum nnp_activation activation, float negative_slope)
+{
+	if (bias != NULL) {
+		for (size_t row = 0; row < rows; row++) {
+			for (size_t column = 0; column < columns; column++) {
+				block[row * row_stride + column] += bias[column];
+			}
+		}
+	}
+
+	if (activation == nnp_activation_relu) {
+		for (size_t row = 0; row < rows; row++) {
+			for (size_t column = 0; column < columns; column++) {
+				block[row * row_stride + column] = relu(block[row * row_stride + column], negative_slope);
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Batch normalization kernels. Length is non-zero, and pointers need not be SIMD-aligned.
+ *
+ * Moments kernels compute sum(x - shift) and sum((x - shift)^2).
+ * Subtracting a shift close to the mean avoids catastrophic cancellation in the variance.
+ */
+typedef void (*nnp_batch_norm_moments_function)(size_t, const float*, float, float*);
+/*
+ * Affine kernels compute y = (x - mean) * scale + bias, and may operate in-place.
+ * Centering before scaling keeps precision when the mean is large relative to the standard deviation.
+ */
+typedef void (*nnp_batch_norm_affine_function)(size_t, const float*, float*, float, float, float);
+/*
+ * Gradient moments kernels compute sum(grad_output) and sum(grad_output * (x - mean)).
+ */
+typedef void (*nnp_batch_norm_gradient_moments_function)(size_t, const float*, const float*, float, float*);
+/*
+ * Gradient kernels compute grad_input = grad_output * grad_output_scale + (x - mean) * input_scale + bias.
+ */
+typedef void (*nnp_batch_norm_gradient_function)(size_t, const float*, const float*, float*, float, float, float, float);
+
+void nnp_batch_norm_moments__avx2(size_t length, const float* input, float shift, float moments[2]);
+void nnp_batch_norm_affine__avx2(size_t length, const float* input, float* output, float mean, float scale, float bias);
+void nnp_batch_norm_gradient_moments__avx2(size_t length, const float* grad_output, const float* input, float mean, float moments[2]);
+void nnp_batch_norm_gradient__avx2(size_t length, const float* grad_output, const float* input, float* grad_input,
+	float mean, float grad_output_scale, float input_scale, float bias);
+
+void nnp_batch_norm_moments__psimd(size_t length, const float* input, float shift, float moments[2]);
+void nnp_batch_norm_affine__psimd(size_t length, const float* input, float* output, float mean, float scale, float bias);
+void nnp_batch_norm_gradient_moments__psimd(size_t length, const float* grad_output, const float* input, float mean, float moments[2]);
+void nnp_batch_norm_gradient__psimd(size_t length, const float* grad_output, const float* input, float* grad_input,
+	float mean, float grad_output_scale, float input_scale, float bias);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
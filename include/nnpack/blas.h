@@ -125,6 +125,109 @@ void nnp_sdotxf6__psimd(const float* x, const float* y, size_t stride_y, float*
 void nnp_sdotxf7__psimd(const float* x, const float* y, size_t stride_y, float* sum, size_t n);
 void nnp_sdotxf8__psimd(const float* x, const float* y, size_t stride_y, float* sum, size_t n);
 
+
+typedef void (*nnp_sdotmxf_function)(const float*, size_t, const float*, size_t, float*, size_t, size_t);
+void nnp_sdot2xf1__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf2__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf3__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf4__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf5__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf6__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf1__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf2__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf3__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf4__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf1__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf2__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf3__avx2(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+
+void nnp_sdot2xf1__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf2__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf3__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf4__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf5__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot2xf6__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf1__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf2__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf3__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot3xf4__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf1__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf2__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+void nnp_sdot4xf3__psimd(const float* x, size_t stride_x, const float* y, size_t stride_y, float* sum, size_t stride_sum, size_t n);
+
+
+typedef void (*nnp_shdotxf_function)(const float*, const void*, size_t, float*, size_t);
+void nnp_shdotxf1__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf2__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf3__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf4__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf5__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf6__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf7__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf8__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+
+void nnp_shdotxf1__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf2__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf3__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf4__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf5__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf6__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf7__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_shdotxf8__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+
+void nnp_sbdotxf1__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf2__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf3__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf4__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf5__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf6__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf7__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf8__avx2(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+
+void nnp_sbdotxf1__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf2__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf3__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf4__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf5__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf6__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf7__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+void nnp_sbdotxf8__psimd(const float* x, const void* y, size_t stride_y, float* sum, size_t n);
+
+
+typedef void (*nnp_u8s8dotxf_function)(const uint8_t*, const int8_t*, size_t, int32_t*, size_t, uint8_t);
+void nnp_u8s8dotxf1__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf2__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf3__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf4__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf5__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf6__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf7__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf8__avx2(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+
+void nnp_u8s8dotxf1__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf2__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf3__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf4__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf5__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf6__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf7__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+void nnp_u8s8dotxf8__psimd(const uint8_t* x, const int8_t* y, size_t stride_y, int32_t* sum, size_t n, uint8_t x_zero_point);
+
+
+/*
+ * Multiplication of an MR x 2k panel a by a 2k x NR panel b of 16-bit elements into MR x NR 32-bit accumulators c,
+ * stored in row-major order. Panels hold pairs of consecutive elements along the reduction dimension: the pair for
+ * row m and pair index p is at a[(p * MR + m) * 2], and the pair for column n is at b[(p * NR + n) * 2].
+ * k is the number of pairs, and must be non-zero.
+ */
+typedef void (*nnp_u8s8gemm_function)(size_t, const int16_t*, const int16_t*, int32_t*);
+void nnp_u8s8gemm_4x16__avx2(size_t k, const int16_t* a, const int16_t* b, int32_t* c);
+void nnp_u8s8gemm_4x8__psimd(size_t k, const int16_t* a, const int16_t* b, int32_t* c);
+
+typedef void (*nnp_scsrmv_function)(size_t, const uint32_t*, const uint32_t*, const float*, const float*, float*);
+void nnp_scsrmv__avx2(size_t rows, const uint32_t* row_offsets, const uint32_t* column_indices, const float* values, const float* x, float* y);
+void nnp_scsrmv__psimd(size_t rows, const uint32_t* row_offsets, const uint32_t* column_indices, const float* values, const float* x, float* y);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
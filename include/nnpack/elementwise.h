@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Elementwise arithmetic kernels. Length is non-zero, pointers need not be SIMD-aligned,
+ * and output may alias any of the full-length operands.
+ * In *_scalar variants the operand which precedes the "scalar" suffix points to a single value,
+ * which is broadcast to all elements.
+ */
+typedef void (*nnp_binary_elementwise_function)(size_t, const float*, const float*, float*);
+typedef void (*nnp_ternary_elementwise_function)(size_t, const float*, const float*, const float*, float*);
+
+/* output = a + b */
+void nnp_add__avx2(size_t length, const float* a, const float* b, float* output);
+void nnp_add_scalar__avx2(size_t length, const float* a, const float* b, float* output);
+/* output = a * b */
+void nnp_multiply__avx2(size_t length, const float* a, const float* b, float* output);
+void nnp_multiply_scalar__avx2(size_t length, const float* a, const float* b, float* output);
+/* output = a * b + c */
+void nnp_multiply_add__avx2(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_add_scalar__avx2(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_scalar_add__avx2(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_scalar_add_scalar__avx2(size_t length, const float* a, const float* b, const float* c, float* output);
+
+void nnp_add__psimd(size_t length, const float* a, const float* b, float* output);
+void nnp_add_scalar__psimd(size_t length, const float* a, const float* b, float* output);
+void nnp_multiply__psimd(size_t length, const float* a, const float* b, float* output);
+void nnp_multiply_scalar__psimd(size_t length, const float* a, const float* b, float* output);
+void nnp_multiply_add__psimd(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_add_scalar__psimd(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_scalar_add__psimd(size_t length, const float* a, const float* b, const float* c, float* output);
+void nnp_multiply_scalar_add_scalar__psimd(size_t length, const float* a, const float* b, const float* c, float* output);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
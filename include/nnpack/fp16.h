@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Conversions between single precision and 16-bit floating-point formats:
+ * - IEEE half precision (fp16): 1 sign bit, 5 exponent bits, 10 mantissa bits.
+ * - Brain floating-point (bf16): 1 sign bit, 8 exponent bits, 7 mantissa bits, i.e. upper half of fp32.
+ * Conversions to 16-bit formats round to nearest, ties to even, and preserve infinities and NaNs.
+ */
+
+static inline uint32_t fp32_to_bits(float f) {
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+static inline float fp32_from_bits(uint32_t bits) {
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+static inline float fp16_to_fp32(uint16_t h) {
+	const uint32_t sign     = ((uint32_t) (h & 0x8000)) << 16;
+	const uint32_t exponent = (h >> 10) & 0x1F;
+	const uint32_t mantissa = h & 0x3FF;
+	if (exponent == 0x1F) {
+		/* Infinity or NaN */
+		return fp32_from_bits(sign | UINT32_C(0x7F800000) | (mantissa << 13));
+	} else if (exponent != 0) {
+		/* Normalized number: rebias exponent from 15 to 127 */
+		return fp32_from_bits(sign | ((exponent + 112) << 23) | (mantissa << 13));
+	} else {
+		/* Zero or denormalized number: mantissa * 2**(-24), computed exactly */
+		const float magnitude = ((float) mantissa) * 0x1.0p-24f;
+		return fp32_from_bits(sign | fp32_to_bits(magnitude));
+	}
+}
+
+static inline uint16_t fp16_from_fp32(float f) {
+	const uint32_t bits = fp32_to_bits(f);
+	const uint16_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & UINT32_C(0x7FFFFFFF);
+	if (magnitude > UINT32_C(0x7F800000)) {
+		/* NaN: keep it quiet */
+		return sign | 0x7E00;
+	} else if (magnitude >= UINT32_C(0x477FF000)) {
+		/* Infinity, or a number which rounds above the largest fp16 number (65504) */
+		return sign | 0x7C00;
+	} else if (magnitude < UINT32_C(0x38800000)) {
+		/* Result is zero or denormalized: let floating-point addition do the rounding on a denormal-aligned scale */
+		const float denormal_magic = 0.5f;
+		return sign | (uint16_t) (fp32_to_bits(fp32_from_bits(magnitude) + denormal_magic) - fp32_to_bits(denormal_magic));
+	} else {
+		/* Normalized result: round mantissa to nearest even, then rebias exponent from 127 to 15 */
+		magnitude += UINT32_C(0xFFF) + ((magnitude >> 13) & 1);
+		return sign | (uint16_t) ((magnitude - UINT32_C(0x38000000)) >> 13);
+	}
+}
+
+static inline float bf16_to_fp32(uint16_t h) {
+	return fp32_from_bits(((uint32_t) h) << 16);
+}
+
+static inline uint16_t bf16_from_fp32(float f) {
+	const uint32_t bits = fp32_to_bits(f);
+	if ((bits & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+		/* NaN: keep it quiet */
+		return (uint16_t) (bits >> 16) | 0x0040;
+	}
+	return (uint16_t) ((bits + UINT32_C(0x7FFF) + ((bits >> 16) & 1)) >> 16);
+}
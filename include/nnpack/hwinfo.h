@@ -15,6 +15,7 @@ struct isa_info {
 	bool has_avx;
 	bool has_fma3;
 	bool has_avx2;
+	bool has_f16c;
 };
 
 struct cache_info {
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cross-channel local response normalization kernels.
+ * Every call processes one group of 1 <= length <= SIMD width adjacent pixels in all channels: element of channel c
+ * is at offset c * image_size from the group pointer. The sum of squares over the window of 2 * half_window + 1
+ * channels slides across channels in a SIMD register.
+ *
+ * Forward kernels compute output = input * (k + alpha_over_n * sum(input^2))^minus_beta.
+ * Backward kernels use scratch[channels][SIMD width] to keep per-channel terms of the window sum of the gradient.
+ */
+typedef void (*nnp_lrn_forward_function)(const float*, float*,
+	size_t, size_t, size_t, size_t, float, float, float);
+typedef void (*nnp_lrn_backward_function)(const float*, const float*, float*, float*,
+	size_t, size_t, size_t, size_t, float, float, float);
+
+void nnp_lrn_forward__avx2(const float* input, float* output,
+	size_t channels, size_t image_size, size_t length, size_t half_window,
+	float alpha_over_n, float minus_beta, float k);
+void nnp_lrn_backward__avx2(const float* grad_output, const float* input, float* grad_input, float* scratch,
+	size_t channels, size_t image_size, size_t length, size_t half_window,
+	float alpha_over_n, float minus_beta, float k);
+
+void nnp_lrn_forward__psimd(const float* input, float* output,
+	size_t channels, size_t image_size, size_t length, size_t half_window,
+	float alpha_over_n, float minus_beta, float k);
+void nnp_lrn_backward__psimd(const float* grad_output, const float* input, float* grad_input, float* scratch,
+	size_t channels, size_t image_size, size_t length, size_t half_window,
+	float alpha_over_n, float minus_beta, float k);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * NUMA topology of the host. Nodes are numbered from 0 to nnp_numa_nodes_count() - 1 in the order of system node
+ * identifiers, and only nodes with CPUs are counted. On systems without NUMA information there is one node.
+ */
+
+#define NNP_NUMA_MAX_NODES 16
+
+size_t nnp_numa_nodes_count(void);
+
+/* Restricts the calling thread to the CPUs of a node. Returns false if the system does not support it. */
+bool nnp_numa_bind_thread(size_t node);
+
+/*
+ * Allocates memory without populating it, so that every page is placed on a NUMA node when it is first written,
+ * or as set by nnp_numa_place_memory. The memory uses base pages, which nnp_numa_place_memory can place one by one.
+ * The memory must be released with release_memory.
+ */
+void* nnp_numa_allocate_memory(size_t memory_size);
+
+/*
+ * Asks the system to place the pages of memory which were not written yet on a node.
+ * Only the pages which lie entirely within the range are affected. Placement is a hint, and callers may ignore the
+ * result: returns false if the node is out of range or the system rejected the placement, and true otherwise,
+ * including on systems without NUMA information, where there is nothing to place.
+ */
+bool nnp_numa_place_memory(void* memory, size_t memory_size, size_t node);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
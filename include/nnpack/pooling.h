@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <pthreadpool.h>
 
@@ -10,8 +11,64 @@ extern "C" {
 
 typedef void (*nnp_pooling_function)(const float*, float*, size_t, size_t, size_t, size_t, size_t, size_t, uint32_t, uint32_t, uint32_t, uint32_t);
 
+typedef void (*nnp_maxpool_function)(const float*, float*, size_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t);
+
 void nnp_maxpool_2x2_2x2__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
 	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_2x2__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_1x1__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+
+void nnp_maxpool_2x2_2x2__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_2x2__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_1x1__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+
+typedef void (*nnp_maxpool_mask_function)(const float*, float*, uint8_t*, size_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t);
+
+void nnp_maxpool_2x2_2x2_mask__avx2(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_2x2_mask__avx2(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_1x1_mask__avx2(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+
+void nnp_maxpool_2x2_2x2_mask__psimd(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_2x2_mask__psimd(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+void nnp_maxpool_3x3_1x1_mask__psimd(const float* src_pointer, float* dst_pointer, uint8_t* dst_mask_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count);
+
+typedef void (*nnp_avgpool_function)(const float*, float*, size_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, const float*);
+
+void nnp_avgpool_2x2_2x2__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+void nnp_avgpool_3x3_2x2__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+void nnp_avgpool_3x3_1x1__avx2(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+
+void nnp_avgpool_2x2_2x2__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+void nnp_avgpool_3x3_2x2__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+void nnp_avgpool_3x3_1x1__psimd(const float* src_pointer, float* dst_pointer, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count, uint32_t dst_column_count,
+	const float* dst_scale);
+
+typedef float (*nnp_sum_function)(size_t, const float*);
+
+float nnp_ssum__avx2(size_t n, const float* v);
+float nnp_ssum__psimd(size_t n, const float* v);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/activations.h>
+#include <nnpack/blas.h>
+
+/*
+ * The longest reduction of u8 x s8 products: input channels of fully connected layers, or input channels times kernel
+ * elements of convolutional layers. Products of inputs without zero point and kernel elements are at most 255 * 128
+ * in magnitude, and 2**16 of them sum up to less than 2**31, so 32-bit accumulators never overflow.
+ */
+#define NNP_U8S8_MAX_REDUCTION_SIZE 65536
+
+/*
+ * Converts 32-bit accumulators of u8 x s8 dot products into 8-bit quantized outputs.
+ * Accumulator of output channel c represents the real value input_scale * kernel_scales[c] * accumulator.
+ * Bias and activation are applied to the real value before it is quantized with output parameters and clamped into
+ * [0, 255]. Like apply_bias_activation, this is an epilogue: it runs while accumulators are still in L1 cache.
+ */
+static inline void requantize_output(
+	const int32_t* accumulators, size_t channels,
+	uint8_t* output, size_t output_stride,
+	float input_scale, const float* kernel_scales, const float* bias,
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation, float negative_slope)
+{
+	const float output_scale_reciprocal = 1.0f / output_quantization.scale;
+	const float output_min = -((float) output_quantization.zero_point);
+	const float output_max = 255.0f - ((float) output_quantization.zero_point);
+	for (size_t channel = 0; channel < channels; channel++) {
+		float value = ((float) accumulators[channel]) * (input_scale * kernel_scales[channel]);
+		if (bias != NULL) {
+			value += bias[channel];
+		}
+		if (activation == nnp_activation_relu) {
+			value = relu(value, negative_slope);
+		}
+
+		/* Clamp in floating-point domain, so the conversion to integer never overflows */
+		float quantized_value = nearbyintf(value * output_scale_reciprocal);
+		quantized_value = quantized_value < output_min ? output_min : quantized_value;
+		quantized_value = quantized_value > output_max ? output_max : quantized_value;
+		output[channel * output_stride] = (uint8_t) ((int32_t) quantized_value + (int32_t) output_quantization.zero_point);
+	}
+}
+
+/*
+ * Blocked u8 x s8 matrix multiplication of rows (input vectors or receptive fields of output pixels) by a kernel.
+ * Both operands are packed into panels of 16-bit elements for nnp_u8s8gemm_function micro-kernels: input rows without
+ * zero point, and kernel rows (output channels) widened from 8 bits. The reduction dimension is padded to even size,
+ * and partial panels to the full number of rows or output channels, with zeroes.
+ */
+
+/* Largest register tile of u8s8gemm micro-kernels on any architecture */
+#define NNP_U8S8GEMM_MAX_ACCUMULATORS (4 * 16)
+
+struct u8s8_gemm_blocking {
+	size_t rows_subblock_max;
+	size_t rows_block_max;
+	size_t output_channels_subblock_max;
+	size_t output_channels_block_max;
+	nnp_u8s8gemm_function u8s8gemm;
+};
+
+static inline struct u8s8_gemm_blocking get_u8s8_gemm_blocking(size_t reduction_size) {
+#if NNP_ARCH_X86_64
+	const size_t rows_subblock_max = 4;
+	const size_t output_channels_subblock_max = 16;
+	const nnp_u8s8gemm_function u8s8gemm = nnp_u8s8gemm_4x16__avx2;
+#elif NNP_ARCH_PSIMD
+	const size_t rows_subblock_max = 4;
+	const size_t output_channels_subblock_max = 8;
+	const nnp_u8s8gemm_function u8s8gemm = nnp_u8s8gemm_4x8__psimd;
+#endif
+
+	/*
+	 * A panel of rows stays in L1 cache while it is multiplied by kernel panels of a block of output channels.
+	 * The kernel panels stay in L2 cache between panels of rows, and the packed block of rows stays in L3 cache
+	 * between blocks of output channels.
+	 */
+	const size_t packed_row_size = round_up(reduction_size, 2) * sizeof(int16_t);
+	return (struct u8s8_gemm_blocking) {
+		.rows_subblock_max = rows_subblock_max,
+		.rows_block_max = max(round_down(nnp_hwinfo.blocking.l3 / packed_row_size, rows_subblock_max), rows_subblock_max),
+		.output_channels_subblock_max = output_channels_subblock_max,
+		.output_channels_block_max =
+			max(round_down(nnp_hwinfo.blocking.l2 / packed_row_size, output_channels_subblock_max), output_channels_subblock_max),
+		.u8s8gemm = u8s8gemm,
+	};
+}
+
+struct NNP_CACHE_ALIGN u8s8_kernel_packing_context {
+	const int8_t* kernel;
+	int16_t* packed_kernel;
+	size_t reduction_size;
+	size_t output_channels_subblock_max;
+};
+
+static inline void pack_u8s8_kernel(
+	const struct u8s8_kernel_packing_context context[restrict static 1],
+	size_t output_channels_subblock_start, size_t output_channels_subblock_size)
+{
+	const int8_t* kernel                      = context->kernel;
+	const size_t reduction_size               = context->reduction_size;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+
+	const size_t reduction_stride = round_up(reduction_size, 2);
+	int16_t* packed_kernel = context->packed_kernel + output_channels_subblock_start * reduction_stride;
+	for (size_t n = 0; n < output_channels_subblock_max; n++) {
+		const int8_t* kernel_row = kernel + (output_channels_subblock_start + n) * reduction_size;
+		for (size_t k = 0; k < reduction_stride; k++) {
+			int16_t element = 0;
+			if ((n < output_channels_subblock_size) && (k < reduction_size)) {
+				element = (int16_t) kernel_row[k];
+			}
+			packed_kernel[((k / 2) * output_channels_subblock_max + n) * 2 + k % 2] = element;
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN u8s8_matrix_multiplication_context {
+	size_t reduction_size;
+	size_t rows_subblock_max;
+	size_t output_channels_subblock_max;
+	const int16_t* packed_input;
+	const int16_t* packed_kernel;
+	size_t rows_block_start;
+	float input_scale;
+	const float* kernel_scales;
+	const float* bias;
+	uint8_t* output;
+	/* Distances between outputs of consecutive rows, and of consecutive output channels */
+	size_t output_row_stride;
+	size_t output_channel_stride;
+	struct nnp_quantization output_quantization;
+	enum nnp_activation activation;
+	float negative_slope;
+	nnp_u8s8gemm_function u8s8gemm;
+};
+
+static inline void compute_u8s8_matrix_multiplication(
+	const struct u8s8_matrix_multiplication_context context[restrict static 1],
+	size_t output_channels_block_start, size_t rows_subblock_start,
+	size_t output_channels_block_size,  size_t rows_subblock_size)
+{
+	const size_t reduction_size                       = context->reduction_size;
+	const size_t output_channels_subblock_max         = context->output_channels_subblock_max;
+	const size_t rows_block_start                     = context->rows_block_start;
+	const float input_scale                           = context->input_scale;
+	const float* kernel_scales                        = context->kernel_scales;
+	const float* bias                                 = context->bias;
+	uint8_t* output                                   = context->output;
+	const size_t output_row_stride                    = context->output_row_stride;
+	const size_t output_channel_stride                = context->output_channel_stride;
+	const struct nnp_quantization output_quantization = context->output_quantization;
+	const enum nnp_activation activation              = context->activation;
+	const float negative_slope                        = context->negative_slope;
+	const nnp_u8s8gemm_function u8s8gemm              = context->u8s8gemm;
+
+	const size_t reduction_stride = round_up(reduction_size, 2);
+	const int16_t* packed_input = context->packed_input + rows_subblock_start * reduction_stride;
+
+	NNP_ALIGN(64) int32_t accumulators[NNP_U8S8GEMM_MAX_ACCUMULATORS];
+	for (size_t output_channels_subblock_start = 0; output_channels_subblock_start < output_channels_block_size; output_channels_subblock_start += output_channels_subblock_max) {
+		const size_t output_channels_subblock_size = min(output_channels_block_size - output_channels_subblock_start, output_channels_subblock_max);
+		const size_t output_channel = output_channels_block_start + output_channels_subblock_start;
+
+		u8s8gemm(reduction_stride / 2, packed_input, context->packed_kernel + output_channel * reduction_stride, accumulators);
+
+		for (size_t m = 0; m < rows_subblock_size; m++) {
+			const size_t row = rows_block_start + rows_subblock_start + m;
+			requantize_output(
+				&accumulators[m * output_channels_subblock_max], output_channels_subblock_size,
+				&output[row * output_row_stride + output_channel * output_channel_stride], output_channel_stride,
+				input_scale, &kernel_scales[output_channel],
+				bias == NULL ? NULL : &bias[output_channel],
+				output_quantization, activation, negative_slope);
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <pthreadpool.h>
 
@@ -45,15 +46,67 @@ void nnp_convolution_kernel_gradient__reference(
 	float grad_kernel[],
 	pthreadpool_t threadpool);
 
+void nnp_convolution_output_u8s8__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
 void nnp_fully_connected_output__reference(
 	size_t batch_size,
 	size_t input_channels,
 	size_t output_channels,
 	const float input[],
 	const float kernel[],
+	const float bias[],
 	float output[],
 	pthreadpool_t threadpool);
 
+void nnp_fully_connected_input_gradient__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float grad_output[],
+	const float kernel[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_fully_connected_kernel_gradient__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float grad_output[],
+	float grad_kernel[],
+	pthreadpool_t threadpool);
+
+void nnp_fully_connected_output_u8s8__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool);
+
 void nnp_max_pooling_output__reference(
 	size_t batch_size,
 	size_t channels,
@@ -65,6 +118,38 @@ void nnp_max_pooling_output__reference(
 	float* output_pointer,
 	pthreadpool_t threadpool);
 
+void nnp_max_pooling_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float* input_pointer,
+	const float* grad_output_pointer,
+	float* grad_input_pointer,
+	pthreadpool_t threadpool);
+
+void nnp_average_pooling_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	enum nnp_pooling_padding_mode padding_mode,
+	const float* input_pointer,
+	float* output_pointer,
+	pthreadpool_t threadpool);
+
+void nnp_global_average_pooling_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float* input_pointer,
+	float* output_pointer,
+	pthreadpool_t threadpool);
+
 void nnp_relu_output__reference(
 	size_t batch_size,
 	size_t channels,
@@ -82,6 +167,186 @@ void nnp_relu_input_gradient__reference(
 	float negative_slope,
 	pthreadpool_t threadpool);
 
+void nnp_sigmoid_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_sigmoid_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_tanh_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_tanh_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_elu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float alpha,
+	pthreadpool_t threadpool);
+
+void nnp_elu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	float alpha,
+	pthreadpool_t threadpool);
+
+void nnp_selu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_selu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_gelu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_gelu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_swish_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_swish_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_batch_norm_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	const float scale[],
+	const float shift[],
+	float epsilon,
+	float output[],
+	float mean[],
+	float variance[],
+	pthreadpool_t threadpool);
+
+void nnp_batch_norm_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float grad_output[],
+	const float input[],
+	const float scale[],
+	const float mean[],
+	const float variance[],
+	float epsilon,
+	float grad_input[],
+	float grad_scale[],
+	float grad_shift[],
+	pthreadpool_t threadpool);
+
+void nnp_lrn_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_lrn_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool);
+
+void nnp_add__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_multiply__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool);
+
+void nnp_multiply_add__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	struct nnp_tensor_shape c_shape,
+	const float c[],
+	float output[],
+	pthreadpool_t threadpool);
+
 void nnp_softmax_output__reference(
     size_t batch_size,
     size_t channels,
@@ -89,6 +354,30 @@ void nnp_softmax_output__reference(
     float output[],
     pthreadpool_t threadpool);
 
+void nnp_log_softmax_output__reference(
+    size_t batch_size,
+    size_t channels,
+    const float input[],
+    float output[],
+    pthreadpool_t threadpool);
+
+void nnp_softmax_input_gradient__reference(
+    size_t batch_size,
+    size_t channels,
+    const float grad_output[],
+    const float output[],
+    float grad_input[],
+    pthreadpool_t threadpool);
+
+void nnp_softmax_cross_entropy_loss_and_gradient__reference(
+    size_t batch_size,
+    size_t channels,
+    const float input[],
+    const uint32_t labels[],
+    float loss[],
+    float grad_input[],
+    pthreadpool_t threadpool);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
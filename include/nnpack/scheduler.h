@@ -0,0 +1,196 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <pthreadpool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Parallel loops of NNPACK functions. They run on the workers of the scheduler job bound to the calling thread by
+ * nnp_scheduler_begin_job, if any, and on the thread pool otherwise. The arguments are as in pthreadpool_compute_*.
+ */
+
+struct nnp_scheduler_job;
+
+extern __thread struct nnp_scheduler_job* nnp_scheduler_current_job;
+
+/*
+ * The number of partitions of scheduler loops: one per NUMA node of the scheduler workers, or 1 without NUMA.
+ * Partition p holds the rows [p * rows / partitions, (p + 1) * rows / partitions) of the first loop dimension, and
+ * runs on the workers of NUMA node p, as numbered by nnp_numa_nodes_count.
+ */
+size_t nnp_scheduler_partitions_count(const struct nnp_scheduler_job* job);
+
+/*
+ * The number of workers which the job would get if it started a parallel loop now, given the parallel loops of other
+ * jobs in progress. Workers move between jobs as loops start and complete, so this is an estimate for the choice of
+ * parallelization strategy, not a guarantee. Always at least 1.
+ */
+size_t nnp_scheduler_threads_count(const struct nnp_scheduler_job* job);
+
+void nnp_scheduler_compute_1d(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range);
+
+void nnp_scheduler_compute_1d_tiled(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile);
+
+void nnp_scheduler_compute_2d(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j);
+
+void nnp_scheduler_compute_2d_tiled(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j);
+
+/*
+ * The number of threads which run parallel loops of the calling thread: workers of the bound scheduler job, if any,
+ * threads of the thread pool otherwise, and 1 if the thread pool is NULL. Use it, rather than
+ * pthreadpool_get_threads_count, to choose between parallelization strategies.
+ */
+static inline size_t nnp_get_threads_count(pthreadpool_t threadpool) {
+	const struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		return nnp_scheduler_threads_count(job);
+	} else {
+		return (threadpool == NULL) ? 1 : pthreadpool_get_threads_count(threadpool);
+	}
+}
+
+static inline void nnp_compute_1d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_1d(job, function, argument, range);
+	} else {
+		pthreadpool_compute_1d(threadpool, function, argument, range);
+	}
+}
+
+static inline void nnp_compute_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_1d_tiled(job, function, argument, range, tile);
+	} else {
+		pthreadpool_compute_1d_tiled(threadpool, function, argument, range, tile);
+	}
+}
+
+static inline void nnp_compute_2d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_2d(job, function, argument, range_i, range_j);
+	} else {
+		pthreadpool_compute_2d(threadpool, function, argument, range_i, range_j);
+	}
+}
+
+static inline void nnp_compute_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_2d_tiled(job, function, argument, range_i, range_j, tile_i, tile_j);
+	} else {
+		pthreadpool_compute_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j);
+	}
+}
+
+/*
+ * Work-stealing variants of tiled loops, for loops where tiles take different time, e.g. partial tiles at the edges
+ * of an image. On a thread pool, threads start with equal ranges of tiles and steal half of the remaining tiles of
+ * other threads when they run out. The loops do not allocate memory, and thread pools with more than 64 threads use
+ * the static split of pthreadpool. Scheduler workers always take tiles one by one, so scheduler jobs use the same
+ * loops as nnp_compute_*.
+ */
+
+void nnp_work_stealing_compute_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile);
+
+void nnp_work_stealing_compute_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j);
+
+static inline void nnp_compute_1d_tiled_stealing(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_1d_tiled(job, function, argument, range, tile);
+	} else {
+		nnp_work_stealing_compute_1d_tiled(threadpool, function, argument, range, tile);
+	}
+}
+
+static inline void nnp_compute_2d_tiled_stealing(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	struct nnp_scheduler_job* job = nnp_scheduler_current_job;
+	if (job != NULL) {
+		nnp_scheduler_compute_2d_tiled(job, function, argument, range_i, range_j, tile_i, tile_j);
+	} else {
+		nnp_work_stealing_compute_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j);
+	}
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
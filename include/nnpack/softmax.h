@@ -20,6 +20,31 @@ void nnp_outplace_softmax__avx2(size_t n, const float* x, float* y);
 void nnp_inplace_softmax__psimd(size_t n, float* v);
 void nnp_outplace_softmax__psimd(size_t n, const float* x, float* y);
 
+/*
+ * Split-row softmax: partial function computes maximum and sum of exp(x - maximum) of a block of the row,
+ * and scale function computes y := scale * exp(x - c) for a block of the row.
+ */
+typedef void (*nnp_softmax_partial_function)(size_t, const float*, float*, float*);
+typedef void (*nnp_softmax_scale_function)(size_t, const float*, float*, float, float);
+
+void nnp_softmax_partial__avx2(size_t n, const float* x, float* max, float* sum_exp);
+void nnp_softmax_scale__avx2(size_t n, const float* x, float* y, float scale, float c);
+
+void nnp_softmax_partial__psimd(size_t n, const float* x, float* max, float* sum_exp);
+void nnp_softmax_scale__psimd(size_t n, const float* x, float* y, float scale, float c);
+
+typedef void (*nnp_log_softmax_function)(size_t, const float*, float*);
+typedef void (*nnp_softmax_gradient_function)(size_t, const float*, const float*, float*);
+typedef float (*nnp_softmax_cross_entropy_function)(size_t, const float*, uint32_t, float*);
+
+void nnp_log_softmax__avx2(size_t n, const float* x, float* y);
+void nnp_softmax_gradient__avx2(size_t n, const float* y, const float* g, float* dx);
+float nnp_softmax_cross_entropy__avx2(size_t n, const float* x, uint32_t label, float* g);
+
+void nnp_log_softmax__psimd(size_t n, const float* x, float* y);
+void nnp_softmax_gradient__psimd(size_t n, const float* y, const float* g, float* dx);
+float nnp_softmax_cross_entropy__psimd(size_t n, const float* x, uint32_t label, float* g);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
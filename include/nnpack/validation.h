@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <float.h>
+
 #include <nnpack.h>
 #include <nnpack/utils.h>
 #include <nnpack/hwinfo.h>
@@ -49,7 +52,8 @@ static inline enum nnp_status validate_convolution_arguments(
 }
 
 static inline enum nnp_status validate_fully_connected_arguments(
-	size_t batch_size, size_t input_channels, size_t output_channels)
+	size_t batch_size, size_t input_channels, size_t output_channels,
+	enum nnp_activation activation)
 {
 	if (!nnp_hwinfo.initialized) {
 		return nnp_status_uninitialized;
@@ -71,6 +75,14 @@ static inline enum nnp_status validate_fully_connected_arguments(
 		return nnp_status_invalid_output_channels;
 	}
 
+	switch (activation) {
+		case nnp_activation_identity:
+		case nnp_activation_relu:
+			break;
+		default:
+			return nnp_status_invalid_activation;
+	}
+
 	return nnp_status_success;
 }
 
@@ -99,7 +111,7 @@ static inline enum nnp_status validate_pooling_arguments(
 		return nnp_status_invalid_pooling_stride;
 	}
 
-	if ((pooling_size.height < pooling_stride.height) || (pooling_size.width < pooling_size.width)) {
+	if ((pooling_size.height < pooling_stride.height) || (pooling_size.width < pooling_stride.width)) {
 		return nnp_status_invalid_pooling_stride;
 	}
 
@@ -111,6 +123,42 @@ static inline enum nnp_status validate_pooling_arguments(
 		return nnp_status_invalid_input_padding;
 	}
 
+	/* Padded input must fit at least one pool */
+	if (input_padding.top + input_size.height + input_padding.bottom < pooling_size.height) {
+		return nnp_status_invalid_input_size;
+	}
+
+	if (input_padding.left + input_size.width + input_padding.right < pooling_size.width) {
+		return nnp_status_invalid_input_size;
+	}
+
+	return nnp_status_success;
+}
+
+static inline enum nnp_status validate_global_pooling_arguments(
+	size_t batch_size, size_t channels,
+	struct nnp_size input_size)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (min(input_size.height, input_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
 	return nnp_status_success;
 }
 
@@ -157,3 +205,203 @@ static inline enum nnp_status validate_softmax_arguments(
 
 	return nnp_status_success;
 }
+
+static inline bool is_valid_normalization_epsilon(float epsilon) {
+	/* Also rejects NaN */
+	return (epsilon >= 0.0f) && (epsilon <= FLT_MAX);
+}
+
+static inline enum nnp_status validate_batch_norm_arguments(
+	size_t batch_size, size_t channels,
+	struct nnp_size input_size,
+	float epsilon)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (min(input_size.height, input_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
+	if (!is_valid_normalization_epsilon(epsilon)) {
+		return nnp_status_invalid_normalization;
+	}
+
+	return nnp_status_success;
+}
+
+static inline enum nnp_status validate_batch_norm_fold_arguments(
+	size_t input_channels, size_t output_channels,
+	struct nnp_size kernel_size,
+	float epsilon)
+{
+	if (input_channels == 0) {
+		return nnp_status_invalid_input_channels;
+	}
+
+	if (output_channels == 0) {
+		return nnp_status_invalid_output_channels;
+	}
+
+	if (min(kernel_size.height, kernel_size.width) == 0) {
+		return nnp_status_invalid_kernel_size;
+	}
+
+	if (!is_valid_normalization_epsilon(epsilon)) {
+		return nnp_status_invalid_normalization;
+	}
+
+	return nnp_status_success;
+}
+
+static inline enum nnp_status validate_lrn_arguments(
+	size_t batch_size, size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha, float beta, float k)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (min(input_size.height, input_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
+	/* The window must be centered on the channel */
+	if (local_size % 2 == 0) {
+		return nnp_status_invalid_normalization;
+	}
+
+	/* Also rejects NaN */
+	if (!(alpha >= 0.0f && alpha <= FLT_MAX) || !(beta >= -FLT_MAX && beta <= FLT_MAX)) {
+		return nnp_status_invalid_normalization;
+	}
+
+	/* The base of the power must stay positive and normalized: it is raised to -beta through a logarithm */
+	if (!(k >= FLT_MIN && k <= FLT_MAX)) {
+		return nnp_status_invalid_normalization;
+	}
+
+	return nnp_status_success;
+}
+
+/*
+ * Every dimension of an elementwise operand must match the output dimension or be broadcast from 1,
+ * and every output dimension other than 1 must be matched by at least one operand.
+ */
+static inline enum nnp_status validate_elementwise_arguments(
+	size_t batch_size, size_t channels,
+	struct nnp_size image_size,
+	size_t operands_count,
+	const struct nnp_tensor_shape operand_shapes[])
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (min(image_size.height, image_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
+	bool batch_matched = (batch_size == 1), channels_matched = (channels == 1);
+	bool image_matched = (image_size.height == 1) && (image_size.width == 1);
+	for (size_t i = 0; i < operands_count; i++) {
+		const struct nnp_tensor_shape shape = operand_shapes[i];
+		if (shape.batch_size == batch_size) {
+			batch_matched = true;
+		} else if (shape.batch_size != 1) {
+			return nnp_status_invalid_batch_size;
+		}
+
+		if (shape.channels == channels) {
+			channels_matched = true;
+		} else if (shape.channels != 1) {
+			return nnp_status_invalid_channels;
+		}
+
+		if ((shape.image_size.height == image_size.height) && (shape.image_size.width == image_size.width)) {
+			image_matched = true;
+		} else if ((shape.image_size.height != 1) || (shape.image_size.width != 1)) {
+			return nnp_status_invalid_input_size;
+		}
+	}
+
+	if (!batch_matched) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (!channels_matched) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (!image_matched) {
+		return nnp_status_invalid_input_size;
+	}
+
+	return nnp_status_success;
+}
+
+static inline bool is_valid_quantization_scale(float scale) {
+	/* Also rejects NaN */
+	return (scale > 0.0f) && (scale <= FLT_MAX);
+}
+
+static inline enum nnp_status validate_quantization_arguments(
+	struct nnp_quantization input_quantization,
+	size_t output_channels, const float kernel_scales[],
+	struct nnp_quantization output_quantization)
+{
+	if (!is_valid_quantization_scale(input_quantization.scale)) {
+		return nnp_status_invalid_quantization;
+	}
+
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
+		if (!is_valid_quantization_scale(kernel_scales[output_channel])) {
+			return nnp_status_invalid_quantization;
+		}
+	}
+
+	if (!is_valid_quantization_scale(output_quantization.scale)) {
+		return nnp_status_invalid_quantization;
+	}
+
+	return nnp_status_success;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Variants of layer functions which take temporary buffers from the caller instead of allocating them.
+ * - If workspace_buffer is NULL and workspace_size is NULL, the function allocates and releases its temporary buffers,
+ *   like the public function.
+ * - If workspace_buffer is NULL and workspace_size is not NULL, the function validates parameters, stores the size of
+ *   the workspace it needs, in bytes, in *workspace_size, and returns without computations.
+ * - Otherwise, workspace_buffer must be aligned on 64 bytes and hold at least the required *workspace_size bytes.
+ */
+
+enum nnp_status nnp_convolution_output_with_workspace(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+enum nnp_status nnp_convolution_inference_with_workspace(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+enum nnp_status nnp_fully_connected_output_with_workspace(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+enum nnp_status nnp_fully_connected_output_prepacked_with_workspace(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* packed_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+enum nnp_status nnp_softmax_output_with_workspace(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/activations.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+struct NNP_CACHE_ALIGN activation_input_gradient_context {
+	nnp_activation_backward_function backward_function;
+	const float* grad_output;
+	const float* input;
+	float* grad_input;
+	float alpha;
+};
+
+static void compute_activation_input_gradient(
+	const struct activation_input_gradient_context context[restrict static 1],
+	size_t block_start, size_t block_size)
+{
+	nnp_activation_backward_function backward_function = context->backward_function;
+	const float* grad_output                            = context->grad_output;
+	const float* input                                  = context->input;
+	float* grad_input                                   = context->grad_input;
+	float alpha                                         = context->alpha;
+
+	backward_function(grad_output + block_start, input + block_start, grad_input + block_start, block_size, alpha);
+}
+
+/*
+ * Processes less than SIMD width elements through zero-padded SIMD-aligned blocks,
+ * so that prologue and epilogue elements get exactly the same results as the vector kernels produce.
+ */
+static void compute_activation_input_gradient_remainder(
+	nnp_activation_backward_function backward_function,
+	const float* grad_output, const float* input, float* grad_input, size_t elements, float alpha)
+{
+	float NNP_SIMD_ALIGN grad_output_block[8] = { 0.0f };
+	float NNP_SIMD_ALIGN input_block[8] = { 0.0f };
+	float NNP_SIMD_ALIGN grad_input_block[8];
+	memcpy(grad_output_block, grad_output, elements * sizeof(float));
+	memcpy(input_block, input, elements * sizeof(float));
+	backward_function(grad_output_block, input_block, grad_input_block, nnp_hwinfo.simd_width, alpha);
+	memcpy(grad_input, grad_input_block, elements * sizeof(float));
+}
+
+static enum nnp_status activation_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	nnp_activation_backward_function backward_function,
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_relu_arguments(batch_size, channels);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	size_t elements = batch_size * channels;
+	const size_t simd_width = nnp_hwinfo.simd_width;
+
+	assert(((uintptr_t) grad_output) % sizeof(float) == 0);
+	assert(((uintptr_t) input) % sizeof(float) == 0);
+	assert(((uintptr_t) grad_input) % sizeof(float) == 0);
+
+	const size_t prologue_elements = min((size_t) (-(((uintptr_t) grad_input) / sizeof(float)) % simd_width), elements);
+	if (prologue_elements != 0) {
+		compute_activation_input_gradient_remainder(backward_function,
+			grad_output, input, grad_input, prologue_elements, alpha);
+	}
+	elements -= prologue_elements;
+	grad_output += prologue_elements;
+	input += prologue_elements;
+	grad_input += prologue_elements;
+
+	const size_t epilogue_elements = elements % simd_width;
+	if (epilogue_elements != 0) {
+		compute_activation_input_gradient_remainder(backward_function,
+			grad_output + elements - epilogue_elements,
+			input + elements - epilogue_elements,
+			grad_input + elements - epilogue_elements,
+			epilogue_elements, alpha);
+	}
+	elements -= epilogue_elements;
+
+	struct activation_input_gradient_context activation_input_gradient_context = {
+		.backward_function = backward_function,
+		.grad_output = grad_output,
+		.input = input,
+		.grad_input = grad_input,
+		.alpha = alpha,
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_activation_input_gradient,
+		&activation_input_gradient_context,
+		elements, round_down(nnp_hwinfo.blocking.l1 / sizeof(float), simd_width));
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_sigmoid_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_sigmoid_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_sigmoid_backward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_tanh_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_tanh_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_tanh_backward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_elu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_elu_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_elu_backward__psimd,
+	#endif
+		alpha, threadpool);
+}
+
+enum nnp_status nnp_selu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_selu_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_selu_backward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_gelu_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_gelu_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_gelu_backward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_swish_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	return activation_input_gradient(batch_size, channels, grad_output, input, grad_input,
+	#if NNP_ARCH_X86_64
+		nnp_swish_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_swish_backward__psimd,
+	#endif
+		0.0f, threadpool);
+}
@@ -0,0 +1,190 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/activations.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+struct NNP_CACHE_ALIGN activation_output_context {
+	nnp_activation_forward_function forward_function;
+	const float* input;
+	float* output;
+	float alpha;
+};
+
+static void compute_activation_output(
+	const struct activation_output_context context[restrict static 1],
+	size_t block_start, size_t block_size)
+{
+	nnp_activation_forward_function forward_function = context->forward_function;
+	const float* input                               = context->input;
+	float* output                                    = context->output;
+	float alpha                                      = context->alpha;
+
+	forward_function(input + block_start, output + block_start, block_size, alpha);
+}
+
+/*
+ * Processes less than SIMD width elements through a zero-padded SIMD-aligned block,
+ * so that prologue and epilogue elements get exactly the same results as the vector kernels produce.
+ */
+static void compute_activation_output_remainder(
+	nnp_activation_forward_function forward_function,
+	const float* input, float* output, size_t elements, float alpha)
+{
+	float NNP_SIMD_ALIGN block[8] = { 0.0f };
+	memcpy(block, input, elements * sizeof(float));
+	forward_function(block, block, nnp_hwinfo.simd_width, alpha);
+	memcpy(output, block, elements * sizeof(float));
+}
+
+static enum nnp_status activation_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	nnp_activation_forward_function forward_function,
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_relu_arguments(batch_size, channels);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	size_t elements = batch_size * channels;
+	const size_t simd_width = nnp_hwinfo.simd_width;
+
+	assert(((uintptr_t) input) % sizeof(float) == 0);
+	assert(((uintptr_t) output) % sizeof(float) == 0);
+
+	const size_t prologue_elements = min((size_t) (-(((uintptr_t) output) / sizeof(float)) % simd_width), elements);
+	if (prologue_elements != 0) {
+		compute_activation_output_remainder(forward_function, input, output, prologue_elements, alpha);
+	}
+	elements -= prologue_elements;
+	input += prologue_elements;
+	output += prologue_elements;
+
+	const size_t epilogue_elements = elements % simd_width;
+	if (epilogue_elements != 0) {
+		compute_activation_output_remainder(forward_function,
+			input + elements - epilogue_elements, output + elements - epilogue_elements, epilogue_elements, alpha);
+	}
+	elements -= epilogue_elements;
+
+	struct activation_output_context activation_output_context = {
+		.forward_function = forward_function,
+		.input = input,
+		.output = output,
+		.alpha = alpha,
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_activation_output,
+		&activation_output_context,
+		elements, round_down(nnp_hwinfo.blocking.l1 / sizeof(float), simd_width));
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_sigmoid_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_sigmoid_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_sigmoid_forward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_tanh_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_tanh_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_tanh_forward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_elu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_elu_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_elu_forward__psimd,
+	#endif
+		alpha, threadpool);
+}
+
+enum nnp_status nnp_selu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_selu_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_selu_forward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_gelu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_gelu_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_gelu_forward__psimd,
+	#endif
+		0.0f, threadpool);
+}
+
+enum nnp_status nnp_swish_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return activation_output(batch_size, channels, input, output,
+	#if NNP_ARCH_X86_64
+		nnp_swish_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_swish_forward__psimd,
+	#endif
+		0.0f, threadpool);
+}
@@ -0,0 +1,274 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/batch-norm.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+
+enum nnp_status nnp_convolution_fold_batch_norm(
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	float kernel[],
+	float bias[],
+	const float mean[],
+	const float variance[],
+	const float scale[],
+	const float shift[],
+	float epsilon)
+{
+	enum nnp_status status = validate_batch_norm_fold_arguments(input_channels, output_channels, kernel_size, epsilon);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t kernel_elements = input_channels * kernel_size.height * kernel_size.width;
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
+		const float gamma = scale != NULL ? scale[output_channel] : 1.0f;
+		const float beta = shift != NULL ? shift[output_channel] : 0.0f;
+		const float multiplier = gamma / sqrtf(variance[output_channel] + epsilon);
+
+		float* output_channel_kernel = kernel + output_channel * kernel_elements;
+		for (size_t i = 0; i < kernel_elements; i++) {
+			output_channel_kernel[i] *= multiplier;
+		}
+		bias[output_channel] = (bias[output_channel] - mean[output_channel]) * multiplier + beta;
+	}
+
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN batch_norm_output_context {
+	nnp_batch_norm_moments_function moments_function;
+	nnp_batch_norm_affine_function affine_function;
+	size_t batch_size;
+	size_t channels;
+	size_t image_size;
+	const float* input;
+	const float* scale;
+	const float* shift;
+	float epsilon;
+	float* output;
+	float* mean;
+	float* variance;
+};
+
+static void compute_batch_norm_output(
+	const struct batch_norm_output_context context[restrict static 1],
+	size_t channel)
+{
+	nnp_batch_norm_moments_function moments_function = context->moments_function;
+	nnp_batch_norm_affine_function affine_function   = context->affine_function;
+	const size_t batch_size                          = context->batch_size;
+	const size_t channels                            = context->channels;
+	const size_t image_size                          = context->image_size;
+	const float* input                               = context->input;
+	const float* scale                               = context->scale;
+	const float* shift                               = context->shift;
+	const float epsilon                              = context->epsilon;
+	float* output                                    = context->output;
+
+	/*
+	 * Every image row is reduced by a vectorized kernel to sums of deviations from its first element,
+	 * and per-row statistics are merged with the parallel Welford update (Chan et al.),
+	 * so the input is read only once and the variance does not suffer from catastrophic cancellation.
+	 */
+	float channel_mean = 0.0f, channel_m2 = 0.0f;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const float* input_row = input + (sample * channels + channel) * image_size;
+		float moments[2];
+		const float row_shift = input_row[0];
+		moments_function(image_size, input_row, row_shift, moments);
+
+		const float row_mean_offset = moments[0] / (float) image_size;
+		const float row_mean = row_shift + row_mean_offset;
+		const float row_m2 = maxf(moments[1] - moments[0] * row_mean_offset, 0.0f);
+
+		/* Number of elements accumulated before this row is sample * image_size */
+		const float row_weight = 1.0f / (float) (sample + 1);
+		const float delta = row_mean - channel_mean;
+		channel_mean += delta * row_weight;
+		channel_m2 += row_m2 + delta * delta * ((float) image_size * (float) sample * row_weight);
+	}
+	const float channel_variance = channel_m2 / (float) (batch_size * image_size);
+
+	context->mean[channel] = channel_mean;
+	context->variance[channel] = channel_variance;
+
+	const float gamma = scale != NULL ? scale[channel] : 1.0f;
+	const float beta = shift != NULL ? shift[channel] : 0.0f;
+	const float multiplier = gamma / sqrtf(channel_variance + epsilon);
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		affine_function(image_size, input + offset, output + offset, channel_mean, multiplier, beta);
+	}
+}
+
+enum nnp_status nnp_batch_norm_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	const float scale[],
+	const float shift[],
+	float epsilon,
+	float output[],
+	float mean[],
+	float variance[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_batch_norm_arguments(batch_size, channels, input_size, epsilon);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct batch_norm_output_context batch_norm_output_context = {
+	#if NNP_ARCH_X86_64
+		.moments_function = nnp_batch_norm_moments__avx2,
+		.affine_function = nnp_batch_norm_affine__avx2,
+	#elif NNP_ARCH_PSIMD
+		.moments_function = nnp_batch_norm_moments__psimd,
+		.affine_function = nnp_batch_norm_affine__psimd,
+	#endif
+		.batch_size = batch_size,
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.input = input,
+		.scale = scale,
+		.shift = shift,
+		.epsilon = epsilon,
+		.output = output,
+		.mean = mean,
+		.variance = variance,
+	};
+	nnp_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_batch_norm_output,
+		&batch_norm_output_context,
+		channels);
+
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN batch_norm_input_gradient_context {
+	nnp_batch_norm_gradient_moments_function gradient_moments_function;
+	nnp_batch_norm_gradient_function gradient_function;
+	size_t batch_size;
+	size_t channels;
+	size_t image_size;
+	const float* grad_output;
+	const float* input;
+	const float* scale;
+	const float* mean;
+	const float* variance;
+	float epsilon;
+	float* grad_input;
+	float* grad_scale;
+	float* grad_shift;
+};
+
+static void compute_batch_norm_input_gradient(
+	const struct batch_norm_input_gradient_context context[restrict static 1],
+	size_t channel)
+{
+	nnp_batch_norm_gradient_moments_function gradient_moments_function = context->gradient_moments_function;
+	nnp_batch_norm_gradient_function gradient_function                 = context->gradient_function;
+	const size_t batch_size                                            = context->batch_size;
+	const size_t channels                                              = context->channels;
+	const size_t image_size                                            = context->image_size;
+	const float* grad_output                                           = context->grad_output;
+	const float* input                                                 = context->input;
+	const float* scale                                                 = context->scale;
+	const float epsilon                                                = context->epsilon;
+	float* grad_input                                                  = context->grad_input;
+	float* grad_scale                                                  = context->grad_scale;
+	float* grad_shift                                                  = context->grad_shift;
+
+	const float channel_mean = context->mean[channel];
+	const float inv_std = 1.0f / sqrtf(context->variance[channel] + epsilon);
+
+	float sum_grad_output = 0.0f, sum_grad_output_centered_input = 0.0f;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		float moments[2];
+		gradient_moments_function(image_size, grad_output + offset, input + offset, channel_mean, moments);
+		sum_grad_output += moments[0];
+		sum_grad_output_centered_input += moments[1];
+	}
+
+	if (grad_scale != NULL) {
+		grad_scale[channel] = sum_grad_output_centered_input * inv_std;
+	}
+	if (grad_shift != NULL) {
+		grad_shift[channel] = sum_grad_output;
+	}
+
+	/*
+	 * grad_input = gamma * inv_std * (grad_output - mean(grad_output) - (x - mean) * inv_std^2 * mean(grad_output * (x - mean)))
+	 * is evaluated as an affine combination of grad_output and (x - mean).
+	 */
+	const float gamma = scale != NULL ? scale[channel] : 1.0f;
+	const float grad_output_scale = gamma * inv_std;
+	const float rcp_count = 1.0f / (float) (batch_size * image_size);
+	const float input_scale = -grad_output_scale * inv_std * inv_std * sum_grad_output_centered_input * rcp_count;
+	const float bias = -grad_output_scale * sum_grad_output * rcp_count;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		gradient_function(image_size, grad_output + offset, input + offset, grad_input + offset,
+			channel_mean, grad_output_scale, input_scale, bias);
+	}
+}
+
+enum nnp_status nnp_batch_norm_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float grad_output[],
+	const float input[],
+	const float scale[],
+	const float mean[],
+	const float variance[],
+	float epsilon,
+	float grad_input[],
+	float grad_scale[],
+	float grad_shift[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_batch_norm_arguments(batch_size, channels, input_size, epsilon);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct batch_norm_input_gradient_context batch_norm_input_gradient_context = {
+	#if NNP_ARCH_X86_64
+		.gradient_moments_function = nnp_batch_norm_gradient_moments__avx2,
+		.gradient_function = nnp_batch_norm_gradient__avx2,
+	#elif NNP_ARCH_PSIMD
+		.gradient_moments_function = nnp_batch_norm_gradient_moments__psimd,
+		.gradient_function = nnp_batch_norm_gradient__psimd,
+	#endif
+		.batch_size = batch_size,
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.grad_output = grad_output,
+		.input = input,
+		.scale = scale,
+		.mean = mean,
+		.variance = variance,
+		.epsilon = epsilon,
+		.grad_input = grad_input,
+		.grad_scale = grad_scale,
+		.grad_shift = grad_shift,
+	};
+	nnp_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_batch_norm_input_gradient,
+		&batch_norm_input_gradient_context,
+		channels);
+
+	return nnp_status_success;
+}
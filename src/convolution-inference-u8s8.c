@@ -0,0 +1,213 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/quantization.h>
+#include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
+
+struct NNP_CACHE_ALIGN im2col_u8_context {
+	size_t input_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_size;
+	const uint8_t* input;
+	uint8_t input_zero_point;
+	size_t output_pixels_block_start;
+	size_t output_pixels_subblock_max;
+	int16_t* packed_input;
+};
+
+/*
+ * Gathers receptive fields of a panel of output pixels into a panel of rows of the im2col matrix, in the layout of
+ * u8s8gemm micro-kernels. Input zero point is subtracted, and padding elements are zeroes, as are elements of
+ * rows past the last output pixel and past the end of odd-sized rows.
+ */
+static void compute_im2col_u8(
+	const struct im2col_u8_context context[restrict static 1],
+	size_t output_pixels_subblock_start, size_t output_pixels_subblock_size)
+{
+	const size_t input_channels             = context->input_channels;
+	const struct nnp_size input_size        = context->input_size;
+	const struct nnp_padding input_padding  = context->input_padding;
+	const struct nnp_size kernel_size       = context->kernel_size;
+	const struct nnp_size output_size       = context->output_size;
+	const uint8_t* input                    = context->input;
+	const int32_t input_zero_point          = (int32_t) context->input_zero_point;
+	const size_t output_pixels_subblock_max = context->output_pixels_subblock_max;
+
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t im2col_row_size = input_channels * kernel_elements;
+	const size_t im2col_row_stride = round_up(im2col_row_size, 2);
+	int16_t* packed_input = context->packed_input + output_pixels_subblock_start * im2col_row_stride;
+	for (size_t m = 0; m < output_pixels_subblock_max; m++) {
+		const size_t output_pixel = context->output_pixels_block_start + output_pixels_subblock_start + m;
+		const size_t output_y = output_pixel / output_size.width;
+		const size_t output_x = output_pixel % output_size.width;
+		for (size_t k = 0; k < im2col_row_stride; k++) {
+			int16_t element = 0;
+			if ((m < output_pixels_subblock_size) && (k < im2col_row_size)) {
+				const size_t input_channel = k / kernel_elements;
+				const size_t input_y = output_y + (k % kernel_elements) / kernel_size.width - input_padding.top;
+				const size_t input_x = output_x + (k % kernel_elements) % kernel_size.width - input_padding.left;
+				/* Unsigned comparison also rejects negative (wrapped-around) coordinates */
+				if ((input_y < input_size.height) && (input_x < input_size.width)) {
+					const uint8_t input_element =
+						input[(input_channel * input_size.height + input_y) * input_size.width + input_x];
+					element = (int16_t) ((int32_t) input_element - input_zero_point);
+				}
+			}
+			packed_input[((k / 2) * output_pixels_subblock_max + m) * 2 + k % 2] = element;
+		}
+	}
+}
+
+enum nnp_status nnp_convolution_inference_u8s8(
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(
+		1, input_channels, output_channels,
+		input_size, input_padding, kernel_size);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = validate_quantization_arguments(input_quantization, output_channels, kernel_scales, output_quantization);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	switch (activation) {
+		case nnp_activation_identity:
+		case nnp_activation_relu:
+			break;
+		default:
+			status = nnp_status_invalid_activation;
+			goto cleanup;
+	}
+
+	const struct nnp_size output_size = {
+		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
+		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+	};
+	const size_t output_pixels = output_size.height * output_size.width;
+	const size_t im2col_row_size = input_channels * kernel_size.height * kernel_size.width;
+
+	if (im2col_row_size > NNP_U8S8_MAX_REDUCTION_SIZE) {
+		status = nnp_status_unsupported_input_channels;
+		goto cleanup;
+	}
+
+	const struct u8s8_gemm_blocking blocking = get_u8s8_gemm_blocking(im2col_row_size);
+	const size_t output_pixels_block_max =
+		min(blocking.rows_block_max, round_up(output_pixels, blocking.rows_subblock_max));
+
+	/* Calculate memory footprint and allocate memory */
+	const size_t im2col_row_stride = round_up(im2col_row_size, 2);
+	const size_t packed_kernel_size =
+		round_up(output_channels, blocking.output_channels_subblock_max) * im2col_row_stride * sizeof(int16_t);
+	const size_t packed_input_offset = round_up(packed_kernel_size, 64);
+	memory_size = packed_input_offset + output_pixels_block_max * im2col_row_stride * sizeof(int16_t);
+	memory_block = allocate_memory(memory_size);
+	if (memory_block == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	int16_t* packed_kernel = memory_block;
+	int16_t* packed_input = memory_block + packed_input_offset;
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct u8s8_kernel_packing_context kernel_packing_context = {
+		.kernel = kernel,
+		.packed_kernel = packed_kernel,
+		.reduction_size = im2col_row_size,
+		.output_channels_subblock_max = blocking.output_channels_subblock_max,
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) pack_u8s8_kernel,
+		&kernel_packing_context,
+		output_channels, blocking.output_channels_subblock_max);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	struct im2col_u8_context im2col_context = {
+		.input_channels = input_channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_size = output_size,
+		.input = input,
+		.input_zero_point = input_quantization.zero_point,
+		.output_pixels_subblock_max = blocking.rows_subblock_max,
+		.packed_input = packed_input,
+	};
+	/* Output is in CHW layout: consecutive output channels of the same pixel are output_pixels elements apart */
+	struct u8s8_matrix_multiplication_context matrix_multiplication_context = {
+		.reduction_size = im2col_row_size,
+		.rows_subblock_max = blocking.rows_subblock_max,
+		.output_channels_subblock_max = blocking.output_channels_subblock_max,
+		.packed_input = packed_input,
+		.packed_kernel = packed_kernel,
+		.input_scale = input_quantization.scale,
+		.kernel_scales = kernel_scales,
+		.bias = bias,
+		.output = output,
+		.output_row_stride = 1,
+		.output_channel_stride = output_pixels,
+		.output_quantization = output_quantization,
+		.activation = activation,
+		.negative_slope = negative_slope,
+		.u8s8gemm = blocking.u8s8gemm,
+	};
+	for (size_t output_pixels_block_start = 0; output_pixels_block_start < output_pixels; output_pixels_block_start += output_pixels_block_max) {
+		const size_t output_pixels_block_size = min(output_pixels - output_pixels_block_start, output_pixels_block_max);
+
+		NNP_INPUT_TRANSFORM_START(profile)
+		im2col_context.output_pixels_block_start = output_pixels_block_start;
+		nnp_compute_1d_tiled(threadpool,
+			(pthreadpool_function_1d_tiled_t) compute_im2col_u8,
+			&im2col_context,
+			output_pixels_block_size, blocking.rows_subblock_max);
+		NNP_INPUT_TRANSFORM_END(profile)
+
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		matrix_multiplication_context.rows_block_start = output_pixels_block_start;
+		nnp_compute_2d_tiled(threadpool,
+			(pthreadpool_function_2d_tiled_t) compute_u8s8_matrix_multiplication,
+			&matrix_multiplication_context,
+			output_channels, output_pixels_block_size,
+			blocking.output_channels_block_max, blocking.rows_subblock_max);
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+	}
+
+cleanup:
+	release_memory(memory_block, memory_size);
+	NNP_TOTAL_END(profile)
+	return status;
+}
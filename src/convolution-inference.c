@@ -13,9 +13,100 @@
 #include <nnpack/simd.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/workspace.h>
 #include <nnpack/transform.h>
 
-enum nnp_status nnp_convolution_inference(
+/* Maximum width of output tile among all convolution algorithms (16x16 Fourier transform with 1x1 kernel) */
+#define OUTPUT_TILE_MAX 16
+
+/*
+ * Transforms the output tile into a stack buffer, and stores ReLU and 2x2 stride 2 max-pooling of it to the output.
+ * The output tile must start at even coordinates of the output image. max(0, max(x)) = max(relu(x)), so ReLU is
+ * applied by starting the maximum at zero. Only the pooled outputs are written to memory.
+ */
+static void output_transform_relu_max_pooling(
+	nnp_transform_2d_with_bias output_transform_function,
+	const float transform[],
+	float pooled_output[],
+	const float bias[],
+	size_t transform_stride,
+	size_t pooled_output_stride,
+	uint32_t row_count,
+	uint32_t column_count)
+{
+	float output_tile[OUTPUT_TILE_MAX * OUTPUT_TILE_MAX];
+	output_transform_function(transform, output_tile, bias, transform_stride, OUTPUT_TILE_MAX, row_count, column_count);
+
+	for (uint32_t y = 0; y < row_count; y += 2) {
+		const uint32_t pool_height = min(row_count - y, 2);
+		for (uint32_t x = 0; x < column_count; x += 2) {
+			const uint32_t pool_width = min(column_count - x, 2);
+			float max = 0.0f;
+			for (uint32_t i = 0; i < pool_height; i++) {
+				for (uint32_t j = 0; j < pool_width; j++) {
+					max = maxf(max, output_tile[(y + i) * OUTPUT_TILE_MAX + (x + j)]);
+				}
+			}
+			pooled_output[(y / 2) * pooled_output_stride + (x / 2)] = max;
+		}
+	}
+}
+
+/*
+ * Transforms all kernels into the blocked layout used by the reuse and precomputed kernel transform strategies:
+ * for every block of input channels, transforms of all output channels, each for the input channels of the block.
+ */
+static void transform_kernel(
+	nnp_transform_2d kernel_transform_function,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	size_t tile_elements,
+	size_t tuple_size,
+	const float kernel_pointer[],
+	float kernel_transform[])
+{
+	const float (*kernel)[input_channels][kernel_size.width * kernel_size.height] =
+		(const float(*)[input_channels][kernel_size.width * kernel_size.height]) kernel_pointer;
+	const size_t input_channels_block_max = 16 / (tile_elements / 64);
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
+		for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
+			const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+			for (size_t input_channels_block_offset = 0; input_channels_block_offset < input_channels_block_size; input_channels_block_offset++) {
+				const size_t input_channel = input_channels_block_start + input_channels_block_offset;
+				kernel_transform_function(
+					kernel[output_channel][input_channel],
+					kernel_transform + (input_channels_block_start * output_channels + output_channel * input_channels_block_size + input_channels_block_offset) * tile_elements,
+					kernel_size.width,
+					tuple_size,
+					kernel_size.height, kernel_size.width, 0, 0);
+			}
+		}
+	}
+}
+
+/*
+ * Size of output tiles which an input tile of tile_size produces. With fused max-pooling, pools must not cross
+ * output tiles, so output tiles are rounded down to even size, and tiles overlap in the input. Zero size means that
+ * the kernel leaves no (whole pools of) outputs in the tile.
+ */
+static struct nnp_size get_output_tile_size(
+	struct nnp_size tile_size,
+	struct nnp_size kernel_size,
+	bool relu_max_pooling)
+{
+	struct nnp_size output_tile = {
+		.width = kernel_size.width <= tile_size.width ? tile_size.width - kernel_size.width + 1 : 0,
+		.height = kernel_size.height <= tile_size.height ? tile_size.height - kernel_size.height + 1 : 0
+	};
+	if (relu_max_pooling) {
+		output_tile.width &= -2;
+		output_tile.height &= -2;
+	}
+	return output_tile;
+}
+
+static enum nnp_status convolution_inference(
 	enum nnp_convolution_algorithm algorithm,
 	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
 	size_t input_channels,
@@ -27,6 +118,9 @@ enum nnp_status nnp_convolution_inference(
 	const float kernel_pointer[],
 	const float bias[],
 	float output_pointer[],
+	bool relu_max_pooling,
+	void* workspace_buffer,
+	size_t* workspace_size,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
@@ -46,16 +140,46 @@ enum nnp_status nnp_convolution_inference(
 		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
 	};
 
+	switch (kernel_transform_strategy) {
+		case nnp_convolution_kernel_transform_strategy_recompute:
+		case nnp_convolution_kernel_transform_strategy_reuse:
+		case nnp_convolution_kernel_transform_strategy_precomputed:
+			break;
+		case nnp_convolution_kernel_transform_strategy_batch:
+			/* Batch strategy is only for layers of nnp_network_create: inference computes one image at a time */
+		default:
+			status = nnp_status_invalid_algorithm;
+			goto cleanup;
+	}
+
+	if (kernel_transform_strategy == nnp_convolution_kernel_transform_strategy_precomputed) {
+		/* Layout of the precomputed kernel transform depends on the algorithm, so it can not be chosen here */
+		if (algorithm == nnp_convolution_algorithm_auto) {
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+
+		if (((uintptr_t) kernel_pointer) % 64 != 0) {
+			status = nnp_status_misaligned_buffer;
+			goto cleanup;
+		}
+	}
+
 	if (algorithm == nnp_convolution_algorithm_auto) {
-		if (max(kernel_size.width, kernel_size.height) > 8) {
+		/* Fused max-pooling needs output tiles of at least 2x2 pixels, which are rounded down to even size */
+		const struct nnp_size output_tile_8x8 =
+			get_output_tile_size((struct nnp_size) { .height = 8, .width = 8 }, kernel_size, relu_max_pooling);
+		const struct nnp_size output_tile_16x16 =
+			get_output_tile_size((struct nnp_size) { .height = 16, .width = 16 }, kernel_size, relu_max_pooling);
+		if ((output_tile_8x8.height == 0) || (output_tile_8x8.width == 0)) {
 			algorithm = nnp_convolution_algorithm_ft16x16;
 		} else {
 			const size_t tile_count_8x8 =
-				divide_round_up(output_size.height, 8 - kernel_size.height + 1) *
-				divide_round_up(output_size.width, 8 - kernel_size.width + 1);
+				divide_round_up(output_size.height, output_tile_8x8.height) *
+				divide_round_up(output_size.width, output_tile_8x8.width);
 			const size_t tile_count_16x16 =
-				divide_round_up(output_size.height, 16 - kernel_size.height + 1) *
-				divide_round_up(output_size.width, 16 - kernel_size.width + 1);
+				divide_round_up(output_size.height, output_tile_16x16.height) *
+				divide_round_up(output_size.width, output_tile_16x16.width);
 			if (tile_count_8x8 <= 4 * tile_count_16x16) {
 				/* 8x8 tiles are more efficient */
 				if ((kernel_size.height == 3) && (kernel_size.width == 3)) {
@@ -77,7 +201,7 @@ enum nnp_status nnp_convolution_inference(
 	void (*kernel_fourier_transform_and_macc_function)(const float[], float[], const float[], size_t, uint32_t, uint32_t, uint32_t, uint32_t) = NULL;
 	void (*kernel_winograd_transform_and_mac_function)(const float[], float[], const float[], size_t) = NULL;
 	void (*macc_function)(float[], const float[], const float[]) = NULL;
-	void (*output_transform_function)(const float[], float[], const float[], size_t, size_t, uint32_t, uint32_t) = NULL;
+	nnp_transform_2d_with_bias output_transform_function = NULL;
 	switch (algorithm) {
 		case nnp_convolution_algorithm_wt8x8:
 			if ((kernel_size.height != 3) || (kernel_size.width != 3)) {
@@ -138,9 +262,16 @@ enum nnp_status nnp_convolution_inference(
 		.height = tile_size.height
 	};
 
-	const struct nnp_size output_tile = {
-		.width = input_tile.width - kernel_size.width + 1,
-		.height = input_tile.height - kernel_size.height + 1
+	const struct nnp_size output_tile = get_output_tile_size(tile_size, kernel_size, relu_max_pooling);
+	if ((output_tile.width == 0) || (output_tile.height == 0)) {
+		status = nnp_status_unsupported_algorithm;
+		goto cleanup;
+	}
+
+	/* With fused max-pooling, output tensor has 2x2 stride 2 pooled size of the convolution output */
+	const struct nnp_size pooled_output_size = {
+		.width = divide_round_up(output_size.width, 2),
+		.height = divide_round_up(output_size.height, 2)
 	};
 
 	const size_t transform_tile_size = tile_elements * sizeof(float);
@@ -152,17 +283,55 @@ enum nnp_status nnp_convolution_inference(
 		memory_size += kernel_transform_size;
 	}
 
-	memory_block = allocate_memory(memory_size);
-	if (memory_block == NULL) {
-		status = nnp_status_out_of_memory;
-		goto cleanup;
+	if (workspace_buffer == NULL) {
+		if (workspace_size != NULL) {
+			/* Query of the workspace size */
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+
+		memory_block = allocate_memory(memory_size);
+		if (memory_block == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+
+		if (((uintptr_t) workspace_buffer) % 64 != 0) {
+			status = nnp_status_misaligned_buffer;
+			goto cleanup;
+		}
+
+		memory_block = workspace_buffer;
 	}
 
 	float* input_transform = memory_block;
 	float* output_transform = memory_block + input_transform_size;
-	float* kernel_transform = NULL;
-	if (kernel_transform_strategy == nnp_convolution_kernel_transform_strategy_reuse) {
-		kernel_transform = memory_block + input_transform_size + output_transform_size;
+	const float* kernel_transform = NULL;
+	switch (kernel_transform_strategy) {
+		case nnp_convolution_kernel_transform_strategy_reuse:
+		{
+			float* kernel_transform_buffer = memory_block + input_transform_size + output_transform_size;
+			NNP_KERNEL_TRANSFORM_START(profile)
+			transform_kernel(kernel_transform_function,
+				input_channels, output_channels, kernel_size,
+				tile_elements, tuple_size,
+				kernel_pointer, kernel_transform_buffer);
+			NNP_KERNEL_TRANSFORM_END(profile)
+			kernel_transform = kernel_transform_buffer;
+			break;
+		}
+		case nnp_convolution_kernel_transform_strategy_precomputed:
+			kernel_transform = kernel_pointer;
+			break;
+		case nnp_convolution_kernel_transform_strategy_recompute:
+			break;
+		case nnp_convolution_kernel_transform_strategy_batch:
+			NNP_UNREACHABLE;
 	}
 
 	const size_t input_channels_block_max = 16 / (tile_elements / 64);
@@ -175,6 +344,8 @@ enum nnp_status nnp_convolution_inference(
 			(const float(*)[input_channels][kernel_size.width * kernel_size.height]) kernel_pointer;
 		float (*output)[output_size.width * output_size.height] =
 			(float(*)[output_size.width * output_size.height]) output_pointer;
+		float (*pooled_output)[pooled_output_size.width * pooled_output_size.height] =
+			(float(*)[pooled_output_size.width * pooled_output_size.height]) output_pointer;
 
 		switch (kernel_transform_strategy) {
 			case nnp_convolution_kernel_transform_strategy_recompute:
@@ -191,8 +362,8 @@ enum nnp_status nnp_convolution_inference(
 									input_transform + input_channel * tile_elements,
 									input_size.width,
 									tuple_size,
-									min(input_tile.height, doz(input_size.height, input_y)),
-									min(input_tile.width, doz(input_size.width, input_x)),
+									min(input_tile.height - doz(input_padding.top, y), doz(input_size.height, input_y)),
+									min(input_tile.width - doz(input_padding.left, x), doz(input_size.width, input_x)),
 									doz(input_padding.top, y),
 									doz(input_padding.left, x));
 							}
@@ -222,36 +393,33 @@ enum nnp_status nnp_convolution_inference(
 							NNP_KERNEL_TRANSFORM_END(profile)
 
 							NNP_OUTPUT_TRANSFORM_START(profile)
-							output_transform_function(
-								output_transform + output_channel * tile_elements,
-								&output[output_channel][y * output_size.width + x],
-								&bias[output_channel],
-								tuple_size,
-								output_size.width,
-								min(output_tile.height, output_size.height - y),
-								min(output_tile.width, output_size.width - x));
+							if (relu_max_pooling) {
+								output_transform_relu_max_pooling(
+									output_transform_function,
+									output_transform + output_channel * tile_elements,
+									&pooled_output[output_channel][(y / 2) * pooled_output_size.width + (x / 2)],
+									&bias[output_channel],
+									tuple_size,
+									pooled_output_size.width,
+									min(output_tile.height, output_size.height - y),
+									min(output_tile.width, output_size.width - x));
+							} else {
+								output_transform_function(
+									output_transform + output_channel * tile_elements,
+									&output[output_channel][y * output_size.width + x],
+									&bias[output_channel],
+									tuple_size,
+									output_size.width,
+									min(output_tile.height, output_size.height - y),
+									min(output_tile.width, output_size.width - x));
+							}
 							NNP_OUTPUT_TRANSFORM_END(profile)
 						}
 					}
 				}
 				break;
 			case nnp_convolution_kernel_transform_strategy_reuse:
-				{
-					for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
-						for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
-							const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
-							for (size_t input_channels_block_offset = 0; input_channels_block_offset < input_channels_block_size; input_channels_block_offset++) {
-								const size_t input_channel = input_channels_block_start + input_channels_block_offset;
-								kernel_transform_function(
-									kernel[output_channel][input_channel],
-									kernel_transform + (input_channels_block_start * output_channels + output_channel * input_channels_block_size + input_channels_block_offset) * tile_elements,
-									kernel_size.width,
-									tuple_size,
-									kernel_size.height, kernel_size.width, 0, 0);
-							}
-						}
-					}
-				}
+			case nnp_convolution_kernel_transform_strategy_precomputed:
 				for (size_t y = 0; y < output_size.height; y += output_tile.height) {
 					const size_t input_y = min(doz(y, input_padding.top), input_size.height);
 					for (size_t x = 0; x < output_size.width; x += output_tile.width) {
@@ -265,8 +433,8 @@ enum nnp_status nnp_convolution_inference(
 									input_transform + input_channel * tile_elements,
 									input_size.width,
 									tuple_size,
-									min(input_tile.height, doz(input_size.height, input_y)),
-									min(input_tile.width, doz(input_size.width, input_x)),
+									min(input_tile.height - doz(input_padding.top, y), doz(input_size.height, input_y)),
+									min(input_tile.width - doz(input_padding.left, x), doz(input_size.width, input_x)),
 									doz(input_padding.top, y),
 									doz(input_padding.left, x));
 							}
@@ -289,14 +457,26 @@ enum nnp_status nnp_convolution_inference(
 									}
 
 									if (input_channels_block_start + input_channels_block_size == input_channels) {
-										output_transform_function(
-											output_transform + output_channel * tile_elements,
-											&output[output_channel][y * output_size.width + x],
-											&bias[output_channel],
-											tuple_size,
-											output_size.width,
-											min(output_tile.height, output_size.height - y),
-											min(output_tile.width, output_size.width - x));
+										if (relu_max_pooling) {
+											output_transform_relu_max_pooling(
+												output_transform_function,
+												output_transform + output_channel * tile_elements,
+												&pooled_output[output_channel][(y / 2) * pooled_output_size.width + (x / 2)],
+												&bias[output_channel],
+												tuple_size,
+												pooled_output_size.width,
+												min(output_tile.height, output_size.height - y),
+												min(output_tile.width, output_size.width - x));
+										} else {
+											output_transform_function(
+												output_transform + output_channel * tile_elements,
+												&output[output_channel][y * output_size.width + x],
+												&bias[output_channel],
+												tuple_size,
+												output_size.width,
+												min(output_tile.height, output_size.height - y),
+												min(output_tile.width, output_size.width - x));
+										}
 									}
 								}
 							}
@@ -304,14 +484,181 @@ enum nnp_status nnp_convolution_inference(
 					}
 				}
 				break;
-			case nnp_convolution_kernel_transform_strategy_precomputed:
+			case nnp_convolution_kernel_transform_strategy_batch:
 				NNP_UNREACHABLE;
-				break;
 		}
 	}
 
 cleanup:
-	release_memory(memory_block, memory_size);
+	if (workspace_buffer == NULL) {
+		release_memory(memory_block, memory_size);
+	}
 	NNP_TOTAL_END(profile)
 	return status;
 }
+
+enum nnp_status nnp_convolution_inference(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return convolution_inference(
+		algorithm, kernel_transform_strategy,
+		input_channels, output_channels,
+		input_size, input_padding, kernel_size,
+		input, kernel, bias, output,
+		false,
+		NULL, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_with_workspace(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return convolution_inference(
+		algorithm, kernel_transform_strategy,
+		input_channels, output_channels,
+		input_size, input_padding, kernel_size,
+		input, kernel, bias, output,
+		false,
+		workspace_buffer, workspace_size,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_relu_max_pooling(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return convolution_inference(
+		algorithm, kernel_transform_strategy,
+		input_channels, output_channels,
+		input_size, input_padding, kernel_size,
+		input, kernel, bias, output,
+		true,
+		NULL, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_transform_kernel(
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	const float kernel[],
+	void* transformed_kernel,
+	size_t* transformed_kernel_size,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. The input size does not matter for the kernel transform. */
+	enum nnp_status status = validate_convolution_arguments(
+		1, input_channels, output_channels,
+		kernel_size, (struct nnp_padding) { 0 }, kernel_size);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct nnp_size tile_size;
+	bool fourier_transform;
+	nnp_transform_2d kernel_transform_function = NULL;
+	switch (algorithm) {
+		case nnp_convolution_algorithm_wt8x8:
+			if ((kernel_size.height != 3) || (kernel_size.width != 3)) {
+				return nnp_status_unsupported_algorithm;
+			}
+			tile_size = (struct nnp_size) { .height = 8, .width = 8 };
+		#if NNP_ARCH_X86_64
+			kernel_transform_function = nnp_kwt8x8_3x3_and_stream__avx2;
+		#elif NNP_ARCH_PSIMD
+			kernel_transform_function = nnp_kwt8x8_3x3__psimd;
+		#endif
+			fourier_transform = false;
+			break;
+		case nnp_convolution_algorithm_ft8x8:
+			tile_size = (struct nnp_size) { .height = 8, .width = 8 };
+		#if NNP_ARCH_X86_64
+			kernel_transform_function = nnp_fft8x8_and_stream__avx2;
+		#endif
+			fourier_transform = true;
+			break;
+		case nnp_convolution_algorithm_ft16x16:
+			tile_size = (struct nnp_size) { .height = 16, .width = 16 };
+		#if NNP_ARCH_X86_64
+			kernel_transform_function = nnp_fft16x16_and_stream__avx2;
+		#endif
+			fourier_transform = true;
+			break;
+		case nnp_convolution_algorithm_auto:
+			/* Layout of the kernel transform depends on the algorithm */
+			return nnp_status_unsupported_algorithm;
+		default:
+			return nnp_status_invalid_algorithm;
+	}
+
+	if (kernel_transform_function == NULL) {
+		/* Inference with this algorithm is not implemented for the host CPU */
+		return nnp_status_unsupported_algorithm;
+	}
+
+	if ((kernel_size.height > tile_size.height) || (kernel_size.width > tile_size.width)) {
+		return nnp_status_unsupported_kernel_size;
+	}
+
+	const size_t tuple_elements = (fourier_transform ? nnp_hwinfo.simd_width * 2 : nnp_hwinfo.simd_width);
+	const size_t tile_elements = tile_size.height * tile_size.width;
+	const size_t required_size = output_channels * input_channels * tile_elements * sizeof(float);
+
+	if (transformed_kernel == NULL) {
+		/* Query of the buffer size */
+		*transformed_kernel_size = required_size;
+		return nnp_status_success;
+	}
+
+	if (*transformed_kernel_size < required_size) {
+		return nnp_status_insufficient_buffer;
+	}
+
+	if (((uintptr_t) transformed_kernel) % 64 != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	transform_kernel(kernel_transform_function,
+		input_channels, output_channels, kernel_size,
+		tile_elements, tuple_elements * sizeof(float),
+		kernel, transformed_kernel);
+	return nnp_status_success;
+}
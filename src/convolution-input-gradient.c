@@ -14,6 +14,7 @@
 #include <nnpack/validation.h>
 #include <nnpack/transform.h>
 #include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
 
 
 struct NNP_CACHE_ALIGN kernel_transform_context {
@@ -298,7 +299,7 @@ static void compute_convolution_input_gradient(
 		.output_channels_block_max = output_channels_block_max,
 		.kernel_size = kernel_size,
 	};
-	pthreadpool_compute_2d_tiled(threadpool,
+	nnp_compute_2d_tiled_stealing(threadpool,
 		(pthreadpool_function_2d_tiled_t) compute_kernel_transform,
 		&kernel_transform_context,
 		output_channels, input_channels,
@@ -327,7 +328,7 @@ static void compute_convolution_input_gradient(
 				.column_count = min(output_size.width - grad_output_x,
 					transform_tile.width - grad_output_transform_context.column_offset),
 			};
-			pthreadpool_compute_2d_tiled(threadpool,
+			nnp_compute_2d_tiled_stealing(threadpool,
 				(pthreadpool_function_2d_tiled_t) compute_grad_output_transform,
 				&grad_output_transform_context,
 				output_channels, batch_size,
@@ -408,7 +409,7 @@ static void compute_convolution_input_gradient(
 								matrix_multiplication_context.sgemm[2][3] = nnp_s4gemm3x4__psimd;
 							#endif
 						}
-						pthreadpool_compute_2d_tiled(threadpool,
+						nnp_compute_2d_tiled_stealing(threadpool,
 							(pthreadpool_function_2d_tiled_t) (fourier_transform ?
 								compute_complex_matrix_multiplication :
 								compute_real_matrix_multiplication),
@@ -435,7 +436,7 @@ static void compute_convolution_input_gradient(
 				.column_offset = fourier_transform ? kernel_size.width - 1 : 0,
 				.column_count = min(input_size.width - x, grad_input_tile.width),
 			};
-			pthreadpool_compute_2d_tiled(threadpool,
+			nnp_compute_2d_tiled_stealing(threadpool,
 				(pthreadpool_function_2d_tiled_t) compute_grad_input_transform,
 				&grad_input_transform_context,
 				batch_size, input_channels,
@@ -14,6 +14,7 @@
 #include <nnpack/validation.h>
 #include <nnpack/transform.h>
 #include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
 
 
 struct NNP_CACHE_ALIGN input_transform_context {
@@ -217,13 +218,11 @@ static void compute_convolution_kernel_gradient(
 	struct nnp_size output_tile,
 	const float* input_pointer,
 	const float* grad_output_pointer,
-	float* grad_kernel,
 	float* input_transform,
 	float* grad_output_transform,
 	float* grad_kernel_transform,
 	nnp_transform_2d input_transform_function,
 	nnp_transform_2d grad_output_transform_function,
-	nnp_transform_2d grad_kernel_transform_function,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
@@ -259,7 +258,7 @@ static void compute_convolution_kernel_gradient(
 					.input_transform = input_transform,
 					.transform_function = input_transform_function,
 				};
-				pthreadpool_compute_2d_tiled(threadpool,
+				nnp_compute_2d_tiled_stealing(threadpool,
 					(pthreadpool_function_2d_tiled_t) compute_input_transform,
 					&input_transform_context,
 					batch_block_size, input_channels,
@@ -280,7 +279,7 @@ static void compute_convolution_kernel_gradient(
 					.grad_output_transform = grad_output_transform,
 					.transform_function = grad_output_transform_function,
 				};
-				pthreadpool_compute_2d_tiled(threadpool,
+				nnp_compute_2d_tiled_stealing(threadpool,
 					(pthreadpool_function_2d_tiled_t) compute_grad_output_transform,
 					&grad_output_transform_context,
 					batch_block_size, output_channels,
@@ -334,7 +333,7 @@ static void compute_convolution_kernel_gradient(
 								matrix_multiplication_context.cgemm[1][1] = nnp_c4gemmca2x2__psimd;
 							#endif
 						}
-						pthreadpool_compute_2d_tiled(threadpool,
+						nnp_compute_2d_tiled_stealing(threadpool,
 							(pthreadpool_function_2d_tiled_t) compute_complex_matrix_multiplication,
 							&matrix_multiplication_context,
 							output_channels,          input_channels_block_size,
@@ -342,29 +341,103 @@ static void compute_convolution_kernel_gradient(
 					}
 				}
 				NNP_BLOCK_MULTIPLICATION_END(profile)
+			}
+		}
+	}
+}
 
+struct NNP_CACHE_ALIGN kernel_gradient_shard_context {
+	size_t tuple_elements;
+	size_t batch_size;
+	size_t batch_shard_max;
+	size_t batch_block_max;
+	size_t input_channels;
+	size_t input_channels_block_max;
+	size_t input_channels_subblock_max;
+	size_t output_channels;
+	size_t output_channels_block_max;
+	size_t output_channels_subblock_max;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_size;
+	struct nnp_size transform_tile;
+	struct nnp_size output_tile;
+	const float* input;
+	const float* grad_output;
+	void* memory_block;
+	size_t shard_memory_size;
+	size_t grad_kernel_transform_size;
+	size_t input_transform_size;
+	nnp_transform_2d input_transform_function;
+	nnp_transform_2d grad_output_transform_function;
+};
 
+/*
+ * Accumulates partial kernel gradient (in transform domain) for a contiguous shard of the batch.
+ * Each shard owns a private copy of all transform buffers, and runs its loops on the calling thread.
+ */
+static void compute_kernel_gradient_shard(
+	const struct kernel_gradient_shard_context context[restrict static 1],
+	size_t shard)
+{
+	const size_t batch_size        = context->batch_size;
+	const size_t batch_shard_max   = context->batch_shard_max;
+	const size_t input_channels    = context->input_channels;
+	const size_t output_channels   = context->output_channels;
+	const struct nnp_size input_size  = context->input_size;
+	const struct nnp_size output_size = context->output_size;
+
+	const size_t batch_shard_start = shard * batch_shard_max;
+	const size_t batch_shard_size  = min(batch_size - batch_shard_start, batch_shard_max);
+
+	void* shard_memory = context->memory_block + shard * context->shard_memory_size;
+	float* grad_kernel_transform = shard_memory;
+	float* input_transform       = shard_memory + context->grad_kernel_transform_size;
+	float* grad_output_transform = shard_memory + context->grad_kernel_transform_size + context->input_transform_size;
+
+	compute_convolution_kernel_gradient(
+		context->tuple_elements,
+		batch_shard_size, context->batch_block_max,
+		input_channels, context->input_channels_block_max, context->input_channels_subblock_max,
+		output_channels, context->output_channels_block_max, context->output_channels_subblock_max,
+		input_size, context->input_padding, context->kernel_size, output_size,
+		context->transform_tile, context->output_tile,
+		context->input + batch_shard_start * input_channels * input_size.height * input_size.width,
+		context->grad_output + batch_shard_start * output_channels * output_size.height * output_size.width,
+		input_transform, grad_output_transform, grad_kernel_transform,
+		context->input_transform_function, context->grad_output_transform_function,
+		NULL,
+		NULL);
+}
+
+struct NNP_CACHE_ALIGN grad_kernel_reduction_context {
+	float* grad_kernel_transform;
+	size_t partial_stride;
+	size_t partial_count;
+};
+
+/*
+ * Pairwise (tree) reduction of per-shard kernel gradient partials into the first partial.
+ * The reduction is parallelized over blocks of transform-domain coefficients.
+ */
+static void compute_grad_kernel_reduction(
+	const struct grad_kernel_reduction_context context[restrict static 1],
+	size_t block_start, size_t block_size)
+{
+	float* grad_kernel_transform = context->grad_kernel_transform + block_start;
+	const size_t partial_stride  = context->partial_stride;
+	const size_t partial_count   = context->partial_count;
+
+	for (size_t step = 1; step < partial_count; step *= 2) {
+		for (size_t partial = 0; partial + step < partial_count; partial += 2 * step) {
+			float *restrict accumulator = grad_kernel_transform + partial * partial_stride;
+			const float *restrict addend = grad_kernel_transform + (partial + step) * partial_stride;
+			for (size_t i = 0; i < block_size; i++) {
+				accumulator[i] += addend[i];
 			}
 		}
 	}
-	/* Grad kernel transform */
-	NNP_KERNEL_TRANSFORM_START(profile)
-	struct grad_kernel_transform_context grad_kernel_transform_context = {
-		.tuple_elements = tuple_elements,
-		.input_channels = input_channels,
-		.output_channels = output_channels,
-		.output_channels_block_max = output_channels_block_max,
-		.kernel_size = kernel_size,
-		.grad_kernel = grad_kernel,
-		.grad_kernel_transform = grad_kernel_transform,
-		.transform_function = grad_kernel_transform_function,
-	};
-	pthreadpool_compute_2d_tiled(threadpool,
-		(pthreadpool_function_2d_tiled_t) compute_grad_kernel_transform,
-		&grad_kernel_transform_context,
-		output_channels, input_channels,
-		1,               input_channels_subblock_max);
-	NNP_KERNEL_TRANSFORM_END(profile)
 }
 
 
@@ -486,11 +559,28 @@ enum nnp_status nnp_convolution_kernel_gradient(
 	const size_t output_channels_block_max =
 		round_down(cache_elements_l2 / batch_block_max, output_channels_subblock_max);
 
+	/*
+	 * Choose between channel-parallel and batch-parallel modes.
+	 * With few channels (e.g. the first layer of a network) the matrix multiplication has fewer tiles than there are
+	 * threads. In this case we split the batch into shards, let every thread accumulate kernel gradient for its shard
+	 * in a private transform-domain buffer, and reduce the partial results before the inverse transform.
+	 */
+	const size_t threads_count = nnp_get_threads_count(threadpool);
+	const size_t matrix_multiplication_tiles =
+		divide_round_up(output_channels, output_channels_block_max) *
+		divide_round_up(min(input_channels, input_channels_block_max), input_channels_subblock_max);
+	size_t batch_shard_max = batch_size;
+	if (matrix_multiplication_tiles < threads_count) {
+		batch_shard_max = divide_round_up(batch_size, min(batch_size, threads_count));
+	}
+	const size_t batch_shards = divide_round_up(batch_size, batch_shard_max);
+
 	/* Calculate memory footprint and allocate memory */
-	const size_t input_transform_size = min(batch_size, batch_block_max) * input_channels * transform_tile_elements * sizeof(float);
-	const size_t grad_output_transform_size = min(batch_size, batch_block_max) * output_channels * transform_tile_elements * sizeof(float);
+	const size_t input_transform_size = min(batch_shard_max, batch_block_max) * input_channels * transform_tile_elements * sizeof(float);
+	const size_t grad_output_transform_size = min(batch_shard_max, batch_block_max) * output_channels * transform_tile_elements * sizeof(float);
 	const size_t grad_kernel_transform_size = output_channels * input_channels * transform_tile_elements * sizeof(float);
-	const size_t memory_size = input_transform_size + grad_output_transform_size + grad_kernel_transform_size;
+	const size_t shard_memory_size = grad_kernel_transform_size + input_transform_size + grad_output_transform_size;
+	const size_t memory_size = batch_shards * shard_memory_size;
 
 	memory_block = allocate_memory(memory_size);
 	if (memory_block == NULL) {
@@ -498,9 +588,9 @@ enum nnp_status nnp_convolution_kernel_gradient(
 		goto cleanup;
 	}
 
-	float* input_transform = memory_block;
-	float* grad_output_transform = memory_block + input_transform_size;
-	float* grad_kernel_transform = memory_block + input_transform_size + grad_output_transform_size;
+	float* grad_kernel_transform = memory_block;
+	float* input_transform = memory_block + grad_kernel_transform_size;
+	float* grad_output_transform = memory_block + grad_kernel_transform_size + input_transform_size;
 
 	/* Calculate remaining parameters and do the computation */
 	const struct nnp_size output_tile = {
@@ -508,18 +598,83 @@ enum nnp_status nnp_convolution_kernel_gradient(
 		.width = transform_tile.width - kernel_size.width + 1
 	};
 
-	compute_convolution_kernel_gradient(
-		tuple_elements,
-		batch_size, batch_block_max,
-		input_channels, input_channels_block_max, input_channels_subblock_max,
-		output_channels, output_channels_block_max, output_channels_subblock_max,
-		input_size, input_padding, kernel_size, output_size,
-		transform_tile, output_tile,
-		input, grad_output, grad_kernel,
-		input_transform, grad_output_transform, grad_kernel_transform,
-		input_transform_function, grad_output_transform_function, grad_kernel_transform_function,
-		threadpool,
-		profile);
+	if (batch_shards == 1) {
+		compute_convolution_kernel_gradient(
+			tuple_elements,
+			batch_size, batch_block_max,
+			input_channels, input_channels_block_max, input_channels_subblock_max,
+			output_channels, output_channels_block_max, output_channels_subblock_max,
+			input_size, input_padding, kernel_size, output_size,
+			transform_tile, output_tile,
+			input, grad_output,
+			input_transform, grad_output_transform, grad_kernel_transform,
+			input_transform_function, grad_output_transform_function,
+			threadpool,
+			profile);
+	} else {
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		struct kernel_gradient_shard_context kernel_gradient_shard_context = {
+			.tuple_elements = tuple_elements,
+			.batch_size = batch_size,
+			.batch_shard_max = batch_shard_max,
+			.batch_block_max = batch_block_max,
+			.input_channels = input_channels,
+			.input_channels_block_max = input_channels_block_max,
+			.input_channels_subblock_max = input_channels_subblock_max,
+			.output_channels = output_channels,
+			.output_channels_block_max = output_channels_block_max,
+			.output_channels_subblock_max = output_channels_subblock_max,
+			.input_size = input_size,
+			.input_padding = input_padding,
+			.kernel_size = kernel_size,
+			.output_size = output_size,
+			.transform_tile = transform_tile,
+			.output_tile = output_tile,
+			.input = input,
+			.grad_output = grad_output,
+			.memory_block = memory_block,
+			.shard_memory_size = shard_memory_size,
+			.grad_kernel_transform_size = grad_kernel_transform_size,
+			.input_transform_size = input_transform_size,
+			.input_transform_function = input_transform_function,
+			.grad_output_transform_function = grad_output_transform_function,
+		};
+		nnp_compute_1d(threadpool,
+			(pthreadpool_function_1d_t) compute_kernel_gradient_shard,
+			&kernel_gradient_shard_context,
+			batch_shards);
+
+		struct grad_kernel_reduction_context grad_kernel_reduction_context = {
+			.grad_kernel_transform = grad_kernel_transform,
+			.partial_stride = shard_memory_size / sizeof(float),
+			.partial_count = batch_shards,
+		};
+		nnp_compute_1d_tiled(threadpool,
+			(pthreadpool_function_1d_tiled_t) compute_grad_kernel_reduction,
+			&grad_kernel_reduction_context,
+			grad_kernel_transform_size / sizeof(float),
+			max(round_down(nnp_hwinfo.blocking.l1 / (batch_shards * sizeof(float)), tuple_elements), tuple_elements));
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+	}
+
+	/* Grad kernel transform */
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct grad_kernel_transform_context grad_kernel_transform_context = {
+		.tuple_elements = tuple_elements,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.output_channels_block_max = output_channels_block_max,
+		.kernel_size = kernel_size,
+		.grad_kernel = grad_kernel,
+		.grad_kernel_transform = grad_kernel_transform,
+		.transform_function = grad_kernel_transform_function,
+	};
+	nnp_compute_2d_tiled_stealing(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_grad_kernel_transform,
+		&grad_kernel_transform_context,
+		output_channels, input_channels,
+		1,               input_channels_subblock_max);
+	NNP_KERNEL_TRANSFORM_END(profile)
 
 cleanup:
 	release_memory(memory_block, memory_size);
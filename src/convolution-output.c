@@ -12,8 +12,11 @@
 #include <nnpack/hwinfo.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/workspace.h>
 #include <nnpack/transform.h>
 #include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
+#include <nnpack/numa.h>
 
 
 struct NNP_CACHE_ALIGN kernel_transform_context {
@@ -300,7 +303,7 @@ static void compute_convolution_output(
 		.input_channels_block_max = input_channels_block_max,
 		.kernel_size = kernel_size,
 	};
-	pthreadpool_compute_2d_tiled(threadpool,
+	nnp_compute_2d_tiled_stealing(threadpool,
 		(pthreadpool_function_2d_tiled_t) compute_kernel_transform,
 		&kernel_transform_context,
 		input_channels, output_channels,
@@ -329,7 +332,7 @@ static void compute_convolution_output(
 				.column_count = min(input_size.width - input_x,
 					transform_tile.width - input_transform_context.column_offset),
 			};
-			pthreadpool_compute_2d_tiled(threadpool,
+			nnp_compute_2d_tiled_stealing(threadpool,
 				(pthreadpool_function_2d_tiled_t) compute_input_transform,
 				&input_transform_context,
 				input_channels, batch_size,
@@ -413,7 +416,7 @@ static void compute_convolution_output(
 								matrix_multiplication_context.sgemm[2][3] = nnp_s4gemm3x4__psimd;
 							#endif
 						}
-						pthreadpool_compute_2d_tiled(threadpool,
+						nnp_compute_2d_tiled_stealing(threadpool,
 							(pthreadpool_function_2d_tiled_t) (fourier_transform ?
 								compute_complex_matrix_multiplication :
 								compute_real_matrix_multiplication),
@@ -439,7 +442,7 @@ static void compute_convolution_output(
 				.row_count = min(output_tile.height, output_size.height - y),
 				.column_count = min(output_tile.width, output_size.width - x),
 			};
-			pthreadpool_compute_2d_tiled(threadpool,
+			nnp_compute_2d_tiled_stealing(threadpool,
 				(pthreadpool_function_2d_tiled_t) compute_output_transform,
 				&output_transform_context,
 				batch_size, output_channels,
@@ -449,7 +452,62 @@ static void compute_convolution_output(
 	}
 }
 
-enum nnp_status nnp_convolution_output(
+/*
+ * Places slices of kernel and output transforms on NUMA nodes. Block multiplication runs output channel blocks of
+ * scheduler partition p on the workers of node p, and puts the slices of the transforms for these output channels
+ * on the same node. Pages are placed before they are written, so the transforms write remote memory once, and the
+ * block multiplication, which reads and accumulates them many times, works on local memory.
+ */
+static void place_transforms(
+	size_t partitions_count,
+	size_t tuple_count,
+	size_t tuple_elements,
+	size_t batch_size,
+	size_t batch_block_max,
+	size_t input_channels,
+	size_t input_channels_block_max,
+	size_t output_channels,
+	size_t output_channels_block_max,
+	float* kernel_transform,
+	float* output_transform)
+{
+	const size_t output_channels_blocks = divide_round_up(output_channels, output_channels_block_max);
+	for (size_t partition = 0; partition < partitions_count; partition++) {
+		const size_t output_channels_start =
+			min(partition * output_channels_blocks / partitions_count * output_channels_block_max, output_channels);
+		const size_t output_channels_end =
+			min((partition + 1) * output_channels_blocks / partitions_count * output_channels_block_max, output_channels);
+		const size_t output_channels_count = output_channels_end - output_channels_start;
+		if (output_channels_count == 0) {
+			continue;
+		}
+
+		for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index += 1) {
+			for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
+				const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+				nnp_numa_place_memory(
+					kernel_transform +
+						tuple_index * tuple_elements * output_channels * input_channels +
+						input_channels_block_start * output_channels * tuple_elements +
+						output_channels_start * input_channels_block_size * tuple_elements,
+					output_channels_count * input_channels_block_size * tuple_elements * sizeof(float),
+					partition);
+			}
+			for (size_t batch_block_start = 0; batch_block_start < batch_size; batch_block_start += batch_block_max) {
+				const size_t batch_block_size = min(batch_size - batch_block_start, batch_block_max);
+				nnp_numa_place_memory(
+					output_transform +
+						tuple_index * tuple_elements * batch_size * output_channels +
+						batch_block_start * output_channels * tuple_elements +
+						output_channels_start * batch_block_size * tuple_elements,
+					output_channels_count * batch_block_size * tuple_elements * sizeof(float),
+					partition);
+			}
+		}
+	}
+}
+
+enum nnp_status nnp_convolution_output_with_workspace(
 	enum nnp_convolution_algorithm algorithm,
 	size_t batch_size,
 	size_t input_channels,
@@ -461,6 +519,8 @@ enum nnp_status nnp_convolution_output(
 	const float kernel[],
 	const float bias[],
 	float output[],
+	void* workspace_buffer,
+	size_t* workspace_size,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
@@ -577,10 +637,38 @@ enum nnp_status nnp_convolution_output(
 	const size_t output_transform_size = batch_size * output_channels * transform_tile_elements * sizeof(float);
 	const size_t memory_size = kernel_transform_size + input_transform_size + output_transform_size;
 
-	memory_block = allocate_memory(memory_size);
-	if (memory_block == NULL) {
-		status = nnp_status_out_of_memory;
-		goto cleanup;
+	/* Transforms are placed on NUMA nodes only when they are allocated here, and loops run on a NUMA-aware scheduler */
+	const size_t numa_partitions_count = (nnp_scheduler_current_job != NULL ?
+		nnp_scheduler_partitions_count(nnp_scheduler_current_job) : 1);
+
+	if (workspace_buffer == NULL) {
+		if (workspace_size != NULL) {
+			/* Query of the workspace size */
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+
+		if (numa_partitions_count > 1) {
+			memory_block = nnp_numa_allocate_memory(memory_size);
+		} else {
+			memory_block = allocate_memory(memory_size);
+		}
+		if (memory_block == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+
+		if (((uintptr_t) workspace_buffer) % 64 != 0) {
+			status = nnp_status_misaligned_buffer;
+			goto cleanup;
+		}
+
+		memory_block = workspace_buffer;
 	}
 
 	float* input_transform = memory_block;
@@ -602,6 +690,15 @@ enum nnp_status nnp_convolution_output(
 	const size_t output_channels_block_max =
 		round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max);
 
+	if (workspace_buffer == NULL && numa_partitions_count > 1) {
+		place_transforms(numa_partitions_count,
+			transform_tile_elements / tuple_elements, tuple_elements,
+			batch_size, batch_block_max,
+			input_channels, input_channels_block_max,
+			output_channels, output_channels_block_max,
+			kernel_transform, output_transform);
+	}
+
 	/* Calculate remaining parameters and do the computation */
 	const struct nnp_size output_tile = {
 		.height = transform_tile.height - kernel_size.height + 1,
@@ -622,7 +719,32 @@ enum nnp_status nnp_convolution_output(
 		profile);
 
 cleanup:
-	release_memory(memory_block, memory_size);
+	if (workspace_buffer == NULL) {
+		release_memory(memory_block, memory_size);
+	}
 	NNP_TOTAL_END(profile)
 	return status;
 }
+
+enum nnp_status nnp_convolution_output(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return nnp_convolution_output_with_workspace(algorithm,
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size,
+		input, kernel, bias, output,
+		NULL, NULL,
+		threadpool, profile);
+}
@@ -0,0 +1,324 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/elementwise.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+
+#define MAX_OPERANDS 3
+
+/*
+ * Iteration space of an elementwise operation: output rows of inner_size contiguous elements, indexed by two outer
+ * dimensions. Operand strides are in elements, and zero along broadcast dimensions.
+ */
+struct elementwise_layout {
+	size_t inner_size;
+	size_t outer_size[2];
+	size_t inner_stride[MAX_OPERANDS];
+	size_t outer_stride[2][MAX_OPERANDS];
+};
+
+/*
+ * Collapses batch, channel, and pixel dimensions into as few dimensions as possible.
+ * Adjacent dimensions are merged when every operand is either contiguous or broadcast across both of them,
+ * so that e.g. addition of same-shape tensors becomes a single stream, and a per-channel bias becomes one row per
+ * image channel. Output dimensions of size 1 are dropped.
+ */
+static struct elementwise_layout collapse_dimensions(
+	size_t batch_size, size_t channels, struct nnp_size image_size,
+	size_t operands_count, const struct nnp_tensor_shape operand_shapes[])
+{
+	const size_t output_dimensions[3] = { batch_size, channels, image_size.height * image_size.width };
+	size_t operand_strides[3][MAX_OPERANDS];
+	for (size_t operand = 0; operand < operands_count; operand++) {
+		const struct nnp_tensor_shape shape = operand_shapes[operand];
+		const size_t operand_dimensions[3] = { shape.batch_size, shape.channels, shape.image_size.height * shape.image_size.width };
+		size_t stride = 1;
+		for (size_t dimension = 3; dimension-- != 0; ) {
+			operand_strides[dimension][operand] = (operand_dimensions[dimension] == 1) ? 0 : stride;
+			stride *= operand_dimensions[dimension];
+		}
+	}
+
+	/* Collapsed dimensions, from inner to outer */
+	size_t collapsed_count = 0;
+	size_t collapsed_size[3];
+	size_t collapsed_stride[3][MAX_OPERANDS];
+	for (size_t dimension = 3; dimension-- != 0; ) {
+		if (output_dimensions[dimension] == 1) {
+			continue;
+		}
+
+		bool mergeable = collapsed_count != 0;
+		for (size_t operand = 0; mergeable && operand < operands_count; operand++) {
+			const size_t previous = collapsed_count - 1;
+			mergeable = operand_strides[dimension][operand] ==
+				collapsed_stride[previous][operand] * collapsed_size[previous];
+		}
+
+		if (mergeable) {
+			collapsed_size[collapsed_count - 1] *= output_dimensions[dimension];
+		} else {
+			collapsed_size[collapsed_count] = output_dimensions[dimension];
+			for (size_t operand = 0; operand < operands_count; operand++) {
+				collapsed_stride[collapsed_count][operand] = operand_strides[dimension][operand];
+			}
+			collapsed_count += 1;
+		}
+	}
+
+	/* A single-element output: all operands are read as contiguous rows of one element */
+	if (collapsed_count == 0) {
+		collapsed_size[0] = 1;
+		for (size_t operand = 0; operand < operands_count; operand++) {
+			collapsed_stride[0][operand] = 1;
+		}
+		collapsed_count = 1;
+	}
+
+	struct elementwise_layout layout = {
+		.inner_size = collapsed_size[0],
+		.outer_size = { 1, 1 },
+	};
+	for (size_t operand = 0; operand < operands_count; operand++) {
+		layout.inner_stride[operand] = collapsed_stride[0][operand];
+	}
+	for (size_t outer = 0; outer + 1 < collapsed_count; outer++) {
+		layout.outer_size[outer] = collapsed_size[outer + 1];
+		for (size_t operand = 0; operand < operands_count; operand++) {
+			layout.outer_stride[outer][operand] = collapsed_stride[outer + 1][operand];
+		}
+	}
+	return layout;
+}
+
+struct NNP_CACHE_ALIGN elementwise_context {
+	nnp_binary_elementwise_function binary_function;
+	nnp_ternary_elementwise_function ternary_function;
+	/*
+	 * If true, operands 1 and 2 are broadcast multiplicands, and binary_function adds their product to operand 0.
+	 */
+	bool premultiply;
+	size_t operands_count;
+	const float* operands[MAX_OPERANDS];
+	struct elementwise_layout layout;
+	float* output;
+};
+
+static void compute_elementwise(
+	const struct elementwise_context context[restrict static 1],
+	size_t row_start, size_t column_start,
+	size_t row_range, size_t column_range)
+{
+	nnp_binary_elementwise_function binary_function   = context->binary_function;
+	nnp_ternary_elementwise_function ternary_function = context->ternary_function;
+	const bool premultiply                            = context->premultiply;
+	const size_t operands_count                       = context->operands_count;
+	const struct elementwise_layout* layout           = &context->layout;
+	float* output                                     = context->output;
+
+	for (size_t row = row_start; row < row_start + row_range; row++) {
+		const size_t outer0 = row % layout->outer_size[0];
+		const size_t outer1 = row / layout->outer_size[0];
+
+		const float* operands[MAX_OPERANDS];
+		for (size_t operand = 0; operand < operands_count; operand++) {
+			operands[operand] = context->operands[operand] +
+				outer0 * layout->outer_stride[0][operand] +
+				outer1 * layout->outer_stride[1][operand] +
+				column_start * layout->inner_stride[operand];
+		}
+
+		float* output_row = output + row * layout->inner_size + column_start;
+		if (premultiply) {
+			const float product = (*operands[1]) * (*operands[2]);
+			binary_function(column_range, operands[0], &product, output_row);
+		} else if (ternary_function != NULL) {
+			ternary_function(column_range, operands[0], operands[1], operands[2], output_row);
+		} else {
+			binary_function(column_range, operands[0], operands[1], output_row);
+		}
+	}
+}
+
+static void swap_operands(struct elementwise_context context[restrict static 1], size_t i, size_t j) {
+	const float* operand = context->operands[i];
+	context->operands[i] = context->operands[j];
+	context->operands[j] = operand;
+
+	struct elementwise_layout* layout = &context->layout;
+	size_t stride = layout->inner_stride[i];
+	layout->inner_stride[i] = layout->inner_stride[j];
+	layout->inner_stride[j] = stride;
+	for (size_t outer = 0; outer < 2; outer++) {
+		stride = layout->outer_stride[outer][i];
+		layout->outer_stride[outer][i] = layout->outer_stride[outer][j];
+		layout->outer_stride[outer][j] = stride;
+	}
+}
+
+static void compute_elementwise_rows(
+	struct elementwise_context context[restrict static 1],
+	pthreadpool_t threadpool)
+{
+	/* Tiles of about L1 cache size: several short rows, or part of a long row */
+	const struct elementwise_layout* layout = &context->layout;
+	const size_t tile_elements = round_down(nnp_hwinfo.blocking.l1 / sizeof(float), nnp_hwinfo.simd_width);
+	const size_t column_tile = min(layout->inner_size, tile_elements);
+	const size_t row_tile = max(tile_elements / layout->inner_size, 1);
+
+	nnp_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_elementwise,
+		context,
+		layout->outer_size[0] * layout->outer_size[1], layout->inner_size,
+		row_tile, column_tile);
+}
+
+static enum nnp_status compute_binary_elementwise(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	nnp_binary_elementwise_function function,
+	nnp_binary_elementwise_function scalar_function,
+	pthreadpool_t threadpool)
+{
+	const struct nnp_tensor_shape operand_shapes[2] = { a_shape, b_shape };
+	enum nnp_status status = validate_elementwise_arguments(batch_size, channels, image_size, 2, operand_shapes);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct elementwise_context elementwise_context = {
+		.operands_count = 2,
+		.operands = { a, b },
+		.layout = collapse_dimensions(batch_size, channels, image_size, 2, operand_shapes),
+		.output = output,
+	};
+
+	/* Both operations are commutative: keep the broadcast operand, if any, second */
+	if (elementwise_context.layout.inner_stride[0] == 0) {
+		swap_operands(&elementwise_context, 0, 1);
+	}
+	elementwise_context.binary_function =
+		(elementwise_context.layout.inner_stride[1] == 0) ? scalar_function : function;
+
+	compute_elementwise_rows(&elementwise_context, threadpool);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_add(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return compute_binary_elementwise(batch_size, channels, image_size,
+		a_shape, a, b_shape, b, output,
+	#if NNP_ARCH_X86_64
+		nnp_add__avx2, nnp_add_scalar__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_add__psimd, nnp_add_scalar__psimd,
+	#endif
+		threadpool);
+}
+
+enum nnp_status nnp_multiply(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	return compute_binary_elementwise(batch_size, channels, image_size,
+		a_shape, a, b_shape, b, output,
+	#if NNP_ARCH_X86_64
+		nnp_multiply__avx2, nnp_multiply_scalar__avx2,
+	#elif NNP_ARCH_PSIMD
+		nnp_multiply__psimd, nnp_multiply_scalar__psimd,
+	#endif
+		threadpool);
+}
+
+enum nnp_status nnp_multiply_add(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	struct nnp_tensor_shape c_shape,
+	const float c[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	const struct nnp_tensor_shape operand_shapes[3] = { a_shape, b_shape, c_shape };
+	enum nnp_status status = validate_elementwise_arguments(batch_size, channels, image_size, 3, operand_shapes);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct elementwise_context elementwise_context = {
+		.operands_count = 3,
+		.operands = { a, b, c },
+		.layout = collapse_dimensions(batch_size, channels, image_size, 3, operand_shapes),
+		.output = output,
+	};
+
+	/* Multiplication is commutative: keep the broadcast multiplicand, if any, second */
+	if (elementwise_context.layout.inner_stride[0] == 0) {
+		swap_operands(&elementwise_context, 0, 1);
+	}
+	const bool broadcast_a = elementwise_context.layout.inner_stride[0] == 0;
+	const bool broadcast_b = elementwise_context.layout.inner_stride[1] == 0;
+	const bool broadcast_c = elementwise_context.layout.inner_stride[2] == 0;
+	if (broadcast_a) {
+		/* Both multiplicands are broadcast, and the addend is not: add their product to the addend */
+		swap_operands(&elementwise_context, 0, 2);
+		elementwise_context.premultiply = true;
+	#if NNP_ARCH_X86_64
+		elementwise_context.binary_function = nnp_add_scalar__avx2;
+	#elif NNP_ARCH_PSIMD
+		elementwise_context.binary_function = nnp_add_scalar__psimd;
+	#endif
+	} else if (broadcast_b) {
+	#if NNP_ARCH_X86_64
+		elementwise_context.ternary_function = broadcast_c ?
+			nnp_multiply_scalar_add_scalar__avx2 : nnp_multiply_scalar_add__avx2;
+	#elif NNP_ARCH_PSIMD
+		elementwise_context.ternary_function = broadcast_c ?
+			nnp_multiply_scalar_add_scalar__psimd : nnp_multiply_scalar_add__psimd;
+	#endif
+	} else {
+	#if NNP_ARCH_X86_64
+		elementwise_context.ternary_function = broadcast_c ?
+			nnp_multiply_add_scalar__avx2 : nnp_multiply_add__avx2;
+	#elif NNP_ARCH_PSIMD
+		elementwise_context.ternary_function = broadcast_c ?
+			nnp_multiply_add_scalar__psimd : nnp_multiply_add__psimd;
+	#endif
+	}
+
+	compute_elementwise_rows(&elementwise_context, threadpool);
+	return nnp_status_success;
+}
@@ -9,15 +9,22 @@
 #include <nnpack/system.h>
 #include <nnpack/utils.h>
 #include <nnpack/simd.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/fp16.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/activations.h>
 #include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
 
 struct NNP_CACHE_ALIGN fully_connected_inference_context {
 	size_t input_channels;
 	const float* input;
 	const float* kernel;
+	const float* bias;
 	float* output;
+	enum nnp_activation activation;
+	float negative_slope;
 	nnp_sdotxf_function sdotxf[8];
 };
 
@@ -25,13 +32,20 @@ static void compute_fully_connected_inference(
 	const struct fully_connected_inference_context context[restrict static 1],
 	size_t output_channels_subblock_start, size_t output_channels_subblock_size)
 {
-	const size_t input_channels      = context->input_channels;
-	const float* input               = context->input;
-	const float* kernel              = context->kernel;
-	float* output                    = context->output;
-	const nnp_sdotxf_function sdotxf = context->sdotxf[output_channels_subblock_size - 1];
+	const size_t input_channels          = context->input_channels;
+	const float* input                   = context->input;
+	const float* kernel                  = context->kernel;
+	const float* bias                    = context->bias;
+	float* output                        = context->output;
+	const enum nnp_activation activation = context->activation;
+	const float negative_slope           = context->negative_slope;
+	const nnp_sdotxf_function sdotxf     = context->sdotxf[output_channels_subblock_size - 1];
 
 	sdotxf(input, &kernel[output_channels_subblock_start * input_channels], input_channels, &output[output_channels_subblock_start], input_channels);
+	apply_bias_activation(
+		&output[output_channels_subblock_start], 1, output_channels_subblock_size, output_channels_subblock_size,
+		bias == NULL ? NULL : &bias[output_channels_subblock_start],
+		activation, negative_slope);
 }
 
 enum nnp_status nnp_fully_connected_inference(
@@ -41,9 +55,27 @@ enum nnp_status nnp_fully_connected_inference(
 	const float kernel[],
 	float output[],
 	pthreadpool_t threadpool)
+{
+	return nnp_fully_connected_inference_with_bias(
+		input_channels, output_channels,
+		input, kernel, NULL, output,
+		nnp_activation_identity, 0.0f,
+		threadpool);
+}
+
+enum nnp_status nnp_fully_connected_inference_with_bias(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
 {
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels);
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation);
 	if (status != nnp_status_success) {
 		return status;
 	}
@@ -54,7 +86,10 @@ enum nnp_status nnp_fully_connected_inference(
 		.input_channels = input_channels,
 		.input = input,
 		.kernel = kernel,
+		.bias = bias,
 		.output = output,
+		.activation = activation,
+		.negative_slope = negative_slope,
 		.sdotxf = {
 #if NNP_ARCH_X86_64
 			[0] = nnp_sdotxf1__avx2,
@@ -77,10 +112,184 @@ enum nnp_status nnp_fully_connected_inference(
 #endif
 		},
 	};
-	pthreadpool_compute_1d_tiled(threadpool,
+	nnp_compute_1d_tiled(threadpool,
 		(pthreadpool_function_1d_tiled_t) compute_fully_connected_inference,
 		&fully_connected_inference_context,
 		output_channels, output_channels_subblock_max);
 
 	return nnp_status_success;
 }
+
+
+struct NNP_CACHE_ALIGN fully_connected_inference_f16_context {
+	size_t input_channels;
+	const float* input;
+	const uint16_t* kernel;
+	const float* bias;
+	float* output;
+	enum nnp_activation activation;
+	float negative_slope;
+	const nnp_shdotxf_function* shdotxf;
+};
+
+static void compute_fully_connected_inference_f16(
+	const struct fully_connected_inference_f16_context context[restrict static 1],
+	size_t output_channels_subblock_start, size_t output_channels_subblock_size)
+{
+	const size_t input_channels          = context->input_channels;
+	const float* input                   = context->input;
+	const uint16_t* kernel               = context->kernel;
+	const float* bias                    = context->bias;
+	float* output                        = context->output;
+	const enum nnp_activation activation = context->activation;
+	const float negative_slope           = context->negative_slope;
+	const nnp_shdotxf_function shdotxf   = context->shdotxf[output_channels_subblock_size - 1];
+
+	shdotxf(input, &kernel[output_channels_subblock_start * input_channels], input_channels, &output[output_channels_subblock_start], input_channels);
+	apply_bias_activation(
+		&output[output_channels_subblock_start], 1, output_channels_subblock_size, output_channels_subblock_size,
+		bias == NULL ? NULL : &bias[output_channels_subblock_start],
+		activation, negative_slope);
+}
+
+static const nnp_shdotxf_function shdotxf_functions[8] = {
+#if NNP_ARCH_X86_64
+	[0] = nnp_shdotxf1__avx2,
+	[1] = nnp_shdotxf2__avx2,
+	[2] = nnp_shdotxf3__avx2,
+	[3] = nnp_shdotxf4__avx2,
+	[4] = nnp_shdotxf5__avx2,
+	[5] = nnp_shdotxf6__avx2,
+	[6] = nnp_shdotxf7__avx2,
+	[7] = nnp_shdotxf8__avx2,
+#elif NNP_ARCH_PSIMD
+	[0] = nnp_shdotxf1__psimd,
+	[1] = nnp_shdotxf2__psimd,
+	[2] = nnp_shdotxf3__psimd,
+	[3] = nnp_shdotxf4__psimd,
+	[4] = nnp_shdotxf5__psimd,
+	[5] = nnp_shdotxf6__psimd,
+	[6] = nnp_shdotxf7__psimd,
+	[7] = nnp_shdotxf8__psimd,
+#endif
+};
+
+static const nnp_shdotxf_function sbdotxf_functions[8] = {
+#if NNP_ARCH_X86_64
+	[0] = nnp_sbdotxf1__avx2,
+	[1] = nnp_sbdotxf2__avx2,
+	[2] = nnp_sbdotxf3__avx2,
+	[3] = nnp_sbdotxf4__avx2,
+	[4] = nnp_sbdotxf5__avx2,
+	[5] = nnp_sbdotxf6__avx2,
+	[6] = nnp_sbdotxf7__avx2,
+	[7] = nnp_sbdotxf8__avx2,
+#elif NNP_ARCH_PSIMD
+	[0] = nnp_sbdotxf1__psimd,
+	[1] = nnp_sbdotxf2__psimd,
+	[2] = nnp_sbdotxf3__psimd,
+	[3] = nnp_sbdotxf4__psimd,
+	[4] = nnp_sbdotxf5__psimd,
+	[5] = nnp_sbdotxf6__psimd,
+	[6] = nnp_sbdotxf7__psimd,
+	[7] = nnp_sbdotxf8__psimd,
+#endif
+};
+
+static void fully_connected_inference_f16(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const uint16_t kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	const nnp_shdotxf_function shdotxf[],
+	pthreadpool_t threadpool)
+{
+	const size_t output_channels_subblock_max = 8;
+	struct fully_connected_inference_f16_context fully_connected_inference_context = {
+		.input_channels = input_channels,
+		.input = input,
+		.kernel = kernel,
+		.bias = bias,
+		.output = output,
+		.activation = activation,
+		.negative_slope = negative_slope,
+		.shdotxf = shdotxf,
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_fully_connected_inference_f16,
+		&fully_connected_inference_context,
+		output_channels, output_channels_subblock_max);
+}
+
+enum nnp_status nnp_fully_connected_inference_f16f32(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+#if NNP_ARCH_X86_64
+	/* Kernels convert fp16 elements with VCVTPH2PS instruction */
+	if (!nnp_hwinfo.isa.has_f16c) {
+		return nnp_status_unsupported_hardware;
+	}
+#endif
+
+	/* Do the computation */
+	fully_connected_inference_f16(input_channels, output_channels,
+		input, kernel, bias, output, activation, negative_slope,
+		shdotxf_functions, threadpool);
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_fully_connected_inference_bf16f32(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* Do the computation */
+	fully_connected_inference_f16(input_channels, output_channels,
+		input, kernel, bias, output, activation, negative_slope,
+		sbdotxf_functions, threadpool);
+
+	return nnp_status_success;
+}
+
+void nnp_convert_fp32_to_fp16(size_t length, const float input[], uint16_t output[]) {
+	for (size_t i = 0; i < length; i++) {
+		output[i] = fp16_from_fp32(input[i]);
+	}
+}
+
+void nnp_convert_fp32_to_bf16(size_t length, const float input[], uint16_t output[]) {
+	for (size_t i = 0; i < length; i++) {
+		output[i] = bf16_from_fp32(input[i]);
+	}
+}
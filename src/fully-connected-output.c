@@ -11,13 +11,18 @@
 #include <nnpack/simd.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/workspace.h>
+#include <nnpack/activations.h>
 #include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
 
 struct NNP_CACHE_ALIGN input_packing_context {
 	const float* matrix;
 	float* packed_matrix;
 
 	size_t input_channels;
+	size_t outer_stride;
+	size_t input_channels_stride;
 	size_t outer_subblock_max;
 };
 
@@ -26,19 +31,23 @@ static void pack_input_matrix(
 	size_t outer_block_start, size_t input_channels_block_start,
 	size_t outer_block_size, size_t input_channels_block_size)
 {
-	const float* matrix             = context->matrix;
-	float* packed_matrix            = context->packed_matrix;
-	const size_t input_channels     = context->input_channels;
-	const size_t outer_subblock_max = context->outer_subblock_max;
+	const float* matrix                = context->matrix;
+	float* packed_matrix               = context->packed_matrix;
+	const size_t input_channels        = context->input_channels;
+	const size_t outer_stride          = context->outer_stride;
+	const size_t input_channels_stride = context->input_channels_stride;
+	const size_t outer_subblock_max    = context->outer_subblock_max;
 
+	/* Partial subblocks are packed densely: sgemm micro-kernels advance by the actual number of rows */
+	const size_t outer_block_stride = round_up(outer_block_size, outer_subblock_max);
 	for (size_t outer_subblock_start = 0; outer_subblock_start < outer_block_size; outer_subblock_start += outer_subblock_max) {
 		const size_t outer_subblock_size = min(outer_block_size - outer_subblock_start, outer_subblock_max);
 		for (size_t input_channels_block_offset = 0; input_channels_block_offset < input_channels_block_size; input_channels_block_offset += 1) {
 			const size_t input_channel = input_channels_block_start + input_channels_block_offset;
 			for (size_t outer_subblock_offset = 0; outer_subblock_offset < outer_subblock_size; outer_subblock_offset += 1) {
-				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * input_channels + input_channel;
-				const size_t packed_index = outer_block_start * input_channels + input_channels_block_start * outer_block_size +
-					outer_subblock_start * input_channels_block_size + input_channels_block_offset * outer_subblock_max + outer_subblock_offset;
+				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * outer_stride + input_channel * input_channels_stride;
+				const size_t packed_index = outer_block_start * input_channels + input_channels_block_start * outer_block_stride +
+					outer_subblock_start * input_channels_block_size + input_channels_block_offset * outer_subblock_size + outer_subblock_offset;
 				packed_matrix[packed_index] = matrix[index];
 			}
 		}
@@ -50,7 +59,8 @@ struct NNP_CACHE_ALIGN kernel_packing_context {
 	float* packed_matrix;
 
 	size_t simd_width;
-	size_t input_channels;
+	size_t outer_stride;
+	size_t input_channels_stride;
 	size_t outer_subblock_max;
 	size_t input_channels_block_start;
 	size_t input_channels_block_size;
@@ -62,7 +72,8 @@ static void pack_kernel_matrix(
 {
 	const float* matrix                     = context->matrix;
 	float* packed_matrix                    = context->packed_matrix;
-	const size_t input_channels             = context->input_channels;
+	const size_t outer_stride               = context->outer_stride;
+	const size_t input_channels_stride      = context->input_channels_stride;
 	const size_t outer_subblock_max         = context->outer_subblock_max;
 	const size_t input_channels_block_start = context->input_channels_block_start;
 	const size_t input_channels_block_size  = context->input_channels_block_size;
@@ -74,7 +85,7 @@ static void pack_kernel_matrix(
 		for (size_t input_channels_block_offset = 0; input_channels_block_offset < input_channels_block_size; input_channels_block_offset += 1) {
 			const size_t input_channel = input_channels_block_start + input_channels_block_offset;
 			for (size_t outer_subblock_offset = 0; outer_subblock_offset < outer_subblock_size; outer_subblock_offset += 1) {
-				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * input_channels + input_channel;
+				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * outer_stride + input_channel * input_channels_stride;
 				const size_t packed_index = (outer_block_start + outer_subblock_start) * input_channels_block_size +
 					input_channels_block_offset * outer_subblock_stride + outer_subblock_offset;
 				packed_matrix[packed_index] = matrix[index];
@@ -86,7 +97,10 @@ static void pack_kernel_matrix(
 struct NNP_CACHE_ALIGN matrix_multiplication_context {
 	const float* input;
 	const float* kernel;
+	const float* bias;
 	float* output;
+	enum nnp_activation activation;
+	float negative_slope;
 	size_t input_channels;
 	size_t output_channels;
 	size_t batch_block_start;
@@ -107,7 +121,10 @@ static void compute_matrix_multiplication(
 {
 	const float* input                       = context->input;
 	const float* kernel                      = context->kernel;
+	const float* bias                        = context->bias;
 	float* output                            = context->output;
+	const enum nnp_activation activation     = context->activation;
+	const float negative_slope               = context->negative_slope;
 	const size_t input_channels              = context->input_channels;
 	const size_t output_channels             = context->output_channels;
 	const size_t input_channels_block_start   = context->input_channels_block_start;
@@ -122,6 +139,8 @@ static void compute_matrix_multiplication(
 
 	const size_t batch_block_stride          = round_up(batch_block_size, batch_subblock_max);
 	const size_t output_channels_block_stride = round_up(output_channels_block_size, output_channels_subblock_max);
+	/* Bias and activation are applied after the last block of input channels is accumulated */
+	const bool last_input_channels_block = input_channels_block_start + input_channels_block_size == input_channels;
 
 	for (size_t output_channels_subblock_start = 0; output_channels_subblock_start < output_channels_block_size; output_channels_subblock_start += output_channels_subblock_max) {
 		const size_t output_channels_subblock_size = min(output_channels_block_size - output_channels_subblock_start, output_channels_subblock_max);
@@ -141,10 +160,18 @@ static void compute_matrix_multiplication(
 				&output[(batch_block_start + batch_subblock_start) * output_channels + (output_channels_block_start + output_channels_subblock_start)],
 				output_channels);
 		}
+		if (last_input_channels_block) {
+			apply_bias_activation(
+				&output[(batch_block_start + batch_subblock_start) * output_channels + (output_channels_block_start + output_channels_subblock_start)],
+				batch_subblock_size, output_channels_subblock_size, output_channels,
+				bias == NULL ? NULL : &bias[output_channels_block_start + output_channels_subblock_start],
+				activation, negative_slope);
+		}
 	}
 }
 
 static void compute_fully_connected_output(
+	bool prepacked_kernel,
 	size_t simd_width,
 	size_t batch_size,
 	size_t batch_block_max,
@@ -154,7 +181,10 @@ static void compute_fully_connected_output(
 	size_t output_channels,
 	size_t output_channels_block_max,
 	size_t output_channels_subblock_max,
-	const float* input,	const float* kernel, float* output,
+	const float* input, size_t input_row_stride, size_t input_column_stride,
+	const float* kernel, size_t kernel_row_stride, size_t kernel_column_stride,
+	const float* bias, float* output,
+	enum nnp_activation activation, float negative_slope,
 	float* packed_input, float* packed_kernel,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
@@ -164,9 +194,11 @@ static void compute_fully_connected_output(
 		.matrix = input,
 		.packed_matrix = packed_input,
 		.input_channels = input_channels,
+		.outer_stride = input_row_stride,
+		.input_channels_stride = input_column_stride,
 		.outer_subblock_max = batch_subblock_max,
 	};
-	pthreadpool_compute_2d_tiled(threadpool,
+	nnp_compute_2d_tiled(threadpool,
 		(pthreadpool_function_2d_tiled_t) pack_input_matrix,
 		&input_packing_context,
 		batch_size, input_channels,
@@ -176,7 +208,10 @@ static void compute_fully_connected_output(
 	struct matrix_multiplication_context matrix_multiplication_context = {
 		.input = packed_input,
 		.kernel = packed_kernel,
+		.bias = bias,
 		.output = output,
+		.activation = activation,
+		.negative_slope = negative_slope,
 		.input_channels = input_channels,
 		.output_channels = output_channels,
 		.output_channels_subblock_max = output_channels_subblock_max,
@@ -193,21 +228,28 @@ static void compute_fully_connected_output(
 	for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
 		const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
 
-		NNP_KERNEL_TRANSFORM_START(profile)
-		struct kernel_packing_context kernel_packing_context = {
-			.matrix = kernel,
-			.packed_matrix = packed_kernel,
-			.simd_width = simd_width,
-			.input_channels = input_channels,
-			.outer_subblock_max = output_channels_subblock_max,
-			.input_channels_block_start = input_channels_block_start,
-			.input_channels_block_size = input_channels_block_size,
-		};
-		pthreadpool_compute_1d_tiled(threadpool,
-			(pthreadpool_function_1d_tiled_t) pack_kernel_matrix,
-			&kernel_packing_context,
-			output_channels, output_channels_block_max);
-		NNP_KERNEL_TRANSFORM_END(profile)
+		if (prepacked_kernel) {
+			/* Kernel blocks are stored one after another, each block is packed for the whole range of output channels */
+			matrix_multiplication_context.kernel =
+				kernel + round_up(output_channels, output_channels_subblock_max) * input_channels_block_start;
+		} else {
+			NNP_KERNEL_TRANSFORM_START(profile)
+			struct kernel_packing_context kernel_packing_context = {
+				.matrix = kernel,
+				.packed_matrix = packed_kernel,
+				.simd_width = simd_width,
+				.outer_stride = kernel_row_stride,
+				.input_channels_stride = kernel_column_stride,
+				.outer_subblock_max = output_channels_subblock_max,
+				.input_channels_block_start = input_channels_block_start,
+				.input_channels_block_size = input_channels_block_size,
+			};
+			nnp_compute_1d_tiled(threadpool,
+				(pthreadpool_function_1d_tiled_t) pack_kernel_matrix,
+				&kernel_packing_context,
+				output_channels, output_channels_block_max);
+			NNP_KERNEL_TRANSFORM_END(profile)
+		}
 
 		NNP_BLOCK_MULTIPLICATION_START(profile)
 		matrix_multiplication_context.input_channels_block_start = input_channels_block_start;
@@ -217,7 +259,7 @@ static void compute_fully_connected_output(
 
 			matrix_multiplication_context.batch_block_start = batch_block_start;
 			matrix_multiplication_context.batch_block_size = batch_block_size;
-			pthreadpool_compute_2d_tiled(threadpool,
+			nnp_compute_2d_tiled_stealing(threadpool,
 				(pthreadpool_function_2d_tiled_t) compute_matrix_multiplication,
 				&matrix_multiplication_context,
 				output_channels,          batch_block_size,
@@ -227,30 +269,172 @@ static void compute_fully_connected_output(
 	}
 }
 
-enum nnp_status nnp_fully_connected_output(
+struct NNP_CACHE_ALIGN small_batch_context {
+	size_t batch_size;
+	size_t batch_subblock_max;
+	size_t input_channels;
+	size_t output_channels;
+	const float* input;
+	const float* kernel;
+	const float* bias;
+	float* output;
+	enum nnp_activation activation;
+	float negative_slope;
+	nnp_sdotxf_function sdotxf[8];
+	nnp_sdotmxf_function sdotmxf[3][6];
+};
+
+static void compute_small_batch_output(
+	const struct small_batch_context context[restrict static 1],
+	size_t output_channels_subblock_start, size_t output_channels_subblock_size)
+{
+	const size_t batch_size              = context->batch_size;
+	const size_t batch_subblock_max      = context->batch_subblock_max;
+	const size_t input_channels          = context->input_channels;
+	const size_t output_channels         = context->output_channels;
+	const float* input                   = context->input;
+	const float* kernel                  = context->kernel;
+	const float* bias                    = context->bias;
+	float* output                        = context->output;
+	const enum nnp_activation activation = context->activation;
+	const float negative_slope           = context->negative_slope;
+
+	/* The kernel rows stay in cache between batch subblocks, so they are streamed from memory only once */
+	const float* kernel_subblock = kernel + output_channels_subblock_start * input_channels;
+	for (size_t batch_subblock_start = 0; batch_subblock_start < batch_size; batch_subblock_start += batch_subblock_max) {
+		const size_t batch_subblock_size = min(batch_size - batch_subblock_start, batch_subblock_max);
+		const float* input_subblock = input + batch_subblock_start * input_channels;
+		float* output_subblock = output + batch_subblock_start * output_channels + output_channels_subblock_start;
+		if (batch_subblock_size == 1) {
+			context->sdotxf[output_channels_subblock_size - 1](
+				input_subblock,
+				kernel_subblock, input_channels,
+				output_subblock,
+				input_channels);
+		} else {
+			context->sdotmxf[batch_subblock_size - 2][output_channels_subblock_size - 1](
+				input_subblock, input_channels,
+				kernel_subblock, input_channels,
+				output_subblock, output_channels,
+				input_channels);
+		}
+		apply_bias_activation(
+			output_subblock, batch_subblock_size, output_channels_subblock_size, output_channels,
+			bias == NULL ? NULL : &bias[output_channels_subblock_start],
+			activation, negative_slope);
+	}
+}
+
+static void compute_small_batch_fully_connected_output(
 	size_t batch_size,
 	size_t input_channels,
 	size_t output_channels,
-	const float input[],
-	const float kernel[],
-	float output[],
-	pthreadpool_t threadpool,
-	struct nnp_profile* profile)
+	const float* input, const float* kernel, const float* bias, float* output,
+	enum nnp_activation activation, float negative_slope,
+	pthreadpool_t threadpool)
 {
-	void* memory_block = NULL;
-	NNP_TOTAL_START(profile)
+	/* Split the minibatch into subblocks of nearly equal size, at most 4 vectors each */
+	const size_t batch_subblock_max = divide_round_up(batch_size, divide_round_up(batch_size, 4));
+	/* Maximum number of fused dot products per input vector for 1, 2, 3, and 4 input vectors */
+	static const size_t fusion_factor_max[4] = { 8, 6, 4, 3 };
+	const size_t output_channels_subblock_max = fusion_factor_max[batch_subblock_max - 1];
 
-	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels);
-	if (status != nnp_status_success) {
-		goto cleanup;
-	}
+	struct small_batch_context small_batch_context = {
+		.batch_size = batch_size,
+		.batch_subblock_max = batch_subblock_max,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input = input,
+		.kernel = kernel,
+		.bias = bias,
+		.output = output,
+		.activation = activation,
+		.negative_slope = negative_slope,
+#if NNP_ARCH_X86_64
+		.sdotxf = {
+			[0] = nnp_sdotxf1__avx2,
+			[1] = nnp_sdotxf2__avx2,
+			[2] = nnp_sdotxf3__avx2,
+			[3] = nnp_sdotxf4__avx2,
+			[4] = nnp_sdotxf5__avx2,
+			[5] = nnp_sdotxf6__avx2,
+			[6] = nnp_sdotxf7__avx2,
+			[7] = nnp_sdotxf8__avx2,
+		},
+		.sdotmxf = {
+			[0] = {
+				[0] = nnp_sdot2xf1__avx2,
+				[1] = nnp_sdot2xf2__avx2,
+				[2] = nnp_sdot2xf3__avx2,
+				[3] = nnp_sdot2xf4__avx2,
+				[4] = nnp_sdot2xf5__avx2,
+				[5] = nnp_sdot2xf6__avx2,
+			},
+			[1] = {
+				[0] = nnp_sdot3xf1__avx2,
+				[1] = nnp_sdot3xf2__avx2,
+				[2] = nnp_sdot3xf3__avx2,
+				[3] = nnp_sdot3xf4__avx2,
+			},
+			[2] = {
+				[0] = nnp_sdot4xf1__avx2,
+				[1] = nnp_sdot4xf2__avx2,
+				[2] = nnp_sdot4xf3__avx2,
+			},
+		},
+#elif NNP_ARCH_PSIMD
+		.sdotxf = {
+			[0] = nnp_sdotxf1__psimd,
+			[1] = nnp_sdotxf2__psimd,
+			[2] = nnp_sdotxf3__psimd,
+			[3] = nnp_sdotxf4__psimd,
+			[4] = nnp_sdotxf5__psimd,
+			[5] = nnp_sdotxf6__psimd,
+			[6] = nnp_sdotxf7__psimd,
+			[7] = nnp_sdotxf8__psimd,
+		},
+		.sdotmxf = {
+			[0] = {
+				[0] = nnp_sdot2xf1__psimd,
+				[1] = nnp_sdot2xf2__psimd,
+				[2] = nnp_sdot2xf3__psimd,
+				[3] = nnp_sdot2xf4__psimd,
+				[4] = nnp_sdot2xf5__psimd,
+				[5] = nnp_sdot2xf6__psimd,
+			},
+			[1] = {
+				[0] = nnp_sdot3xf1__psimd,
+				[1] = nnp_sdot3xf2__psimd,
+				[2] = nnp_sdot3xf3__psimd,
+				[3] = nnp_sdot3xf4__psimd,
+			},
+			[2] = {
+				[0] = nnp_sdot4xf1__psimd,
+				[1] = nnp_sdot4xf2__psimd,
+				[2] = nnp_sdot4xf3__psimd,
+			},
+		},
+#endif
+	};
+	nnp_compute_1d_tiled_stealing(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_small_batch_output,
+		&small_batch_context,
+		output_channels, output_channels_subblock_max);
+}
+
+struct fully_connected_output_blocking {
+	size_t batch_subblock_max;
+	size_t batch_block_max;
+	size_t input_channels_block_max;
+	size_t output_channels_subblock_max;
+	size_t output_channels_block_max;
+};
 
+static struct fully_connected_output_blocking get_fully_connected_output_blocking(void) {
 	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
 	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
 	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / sizeof(float);
 
-	const size_t simd_width = nnp_hwinfo.simd_width;
 	const size_t batch_subblock_max = 4;
 #if NNP_ARCH_X86_64
 	const size_t output_channels_subblock_max = 24;
@@ -259,38 +443,384 @@ enum nnp_status nnp_fully_connected_output(
 #endif
 
 	const size_t input_channels_block_max = cache_elements_l1 / (batch_subblock_max + output_channels_subblock_max);
-	const size_t batch_block_max = round_down(cache_elements_l3 / input_channels_block_max, batch_subblock_max);
-	const size_t output_channels_block_max = round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max);
+	return (struct fully_connected_output_blocking) {
+		.batch_subblock_max = batch_subblock_max,
+		.batch_block_max = round_down(cache_elements_l3 / input_channels_block_max, batch_subblock_max),
+		.input_channels_block_max = input_channels_block_max,
+		.output_channels_subblock_max = output_channels_subblock_max,
+		.output_channels_block_max = round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max),
+	};
+}
+
+/* Largest minibatch processed with fused dot product kernels rather than matrix-matrix multiplication */
+static const size_t small_batch_max = 8;
+
+/*
+ * Computes output[batch_size][output_channels] = input x transpose(kernel), where
+ * input(i, j) = input[i * input_row_stride + j * input_column_stride] is a batch_size x input_channels matrix, and
+ * kernel(i, j) = kernel[i * kernel_row_stride + j * kernel_column_stride] is an output_channels x input_channels matrix.
+ * Strides let backward propagation reuse the same blocking and micro-kernels with transposed operands.
+ */
+static enum nnp_status fully_connected_matrix_multiplication(
+	bool prepacked_kernel,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[], size_t input_row_stride, size_t input_column_stride,
+	const float kernel[], size_t kernel_row_stride, size_t kernel_column_stride,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	const struct fully_connected_output_blocking blocking = get_fully_connected_output_blocking();
 
 	/* Calculate memory footprint and allocate memory */
-	const size_t packed_input_size = round_up(batch_size, batch_subblock_max) * input_channels * sizeof(float);
+	const size_t packed_input_size = round_up(batch_size, blocking.batch_subblock_max) * input_channels * sizeof(float);
 	/* Extra alignment on 64 is needed to ensure that packed_kernel is always SIMD-aligned */
 	const size_t packed_kernel_offset = round_up(packed_input_size, 64);
-	const size_t packed_kernel_size = round_up(output_channels, output_channels_subblock_max) * input_channels_block_max * sizeof(float);
+	const size_t packed_kernel_size = prepacked_kernel ? 0 :
+		round_up(output_channels, blocking.output_channels_subblock_max) * blocking.input_channels_block_max * sizeof(float);
 	const size_t memory_size = packed_kernel_offset + packed_kernel_size;
 
-	memory_block = allocate_memory(memory_size);
-	if (memory_block == NULL) {
-		status = nnp_status_out_of_memory;
-		goto cleanup;
+	void* memory_block = workspace_buffer;
+	if (workspace_buffer == NULL) {
+		if (workspace_size != NULL) {
+			/* Query of the workspace size */
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+
+		memory_block = allocate_memory(memory_size);
+		if (memory_block == NULL) {
+			return nnp_status_out_of_memory;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			return nnp_status_insufficient_buffer;
+		}
+
+		if (((uintptr_t) workspace_buffer) % 64 != 0) {
+			return nnp_status_misaligned_buffer;
+		}
 	}
 
 	float* packed_input = memory_block;
-	float* packed_kernel = memory_block + packed_kernel_offset;
+	float* packed_kernel = prepacked_kernel ? NULL : memory_block + packed_kernel_offset;
 
 	/* Do the computation */
 	compute_fully_connected_output(
+		prepacked_kernel,
 		simd_width,
-		batch_size, batch_block_max, batch_subblock_max,
-		input_channels, input_channels_block_max,
-		output_channels, output_channels_block_max, output_channels_subblock_max,
-		input, kernel, output,
+		batch_size, blocking.batch_block_max, blocking.batch_subblock_max,
+		input_channels, blocking.input_channels_block_max,
+		output_channels, blocking.output_channels_block_max, blocking.output_channels_subblock_max,
+		input, input_row_stride, input_column_stride,
+		kernel, kernel_row_stride, kernel_column_stride,
+		bias, output,
+		activation, negative_slope,
 		packed_input, packed_kernel,
 		threadpool,
 		profile);
 
+	if (workspace_buffer == NULL) {
+		release_memory(memory_block, memory_size);
+	}
+	return nnp_status_success;
+}
+
+static enum nnp_status fully_connected_output(
+	bool prepacked_kernel,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	if (!prepacked_kernel && batch_size <= small_batch_max) {
+		if (workspace_buffer == NULL && workspace_size != NULL) {
+			/* Query of the workspace size: dot product kernels do not need temporary buffers */
+			*workspace_size = 0;
+			goto cleanup;
+		}
+
+		/* Small minibatch is bound by memory bandwidth: compute dot products directly, without packing */
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		compute_small_batch_fully_connected_output(
+			batch_size, input_channels, output_channels,
+			input, kernel, bias, output,
+			activation, negative_slope,
+			threadpool);
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+	} else {
+		status = fully_connected_matrix_multiplication(prepacked_kernel,
+			batch_size, input_channels, output_channels,
+			input, input_channels, 1,
+			kernel, input_channels, 1,
+			bias, output,
+			activation, negative_slope,
+			workspace_buffer, workspace_size,
+			threadpool, profile);
+	}
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_output(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return fully_connected_output(false,
+		batch_size, input_channels, output_channels,
+		input, kernel, NULL, output,
+		nnp_activation_identity, 0.0f,
+		NULL, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_fully_connected_output_with_bias(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return fully_connected_output(false,
+		batch_size, input_channels, output_channels,
+		input, kernel, bias, output,
+		activation, negative_slope,
+		NULL, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_fully_connected_output_with_workspace(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return fully_connected_output(false,
+		batch_size, input_channels, output_channels,
+		input, kernel, bias, output,
+		activation, negative_slope,
+		workspace_buffer, workspace_size,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_fully_connected_output_prepacked(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* packed_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return nnp_fully_connected_output_prepacked_with_workspace(
+		batch_size, input_channels, output_channels,
+		input, packed_kernel, bias, output,
+		activation, negative_slope,
+		NULL, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_fully_connected_output_prepacked_with_workspace(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* packed_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	if (((uintptr_t) packed_kernel) % 64 != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	return fully_connected_output(true,
+		batch_size, input_channels, output_channels,
+		input, packed_kernel, bias, output,
+		activation, negative_slope,
+		workspace_buffer, workspace_size,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_fully_connected_pack_kernel(
+	size_t input_channels,
+	size_t output_channels,
+	const float kernel[],
+	void* packed_kernel,
+	size_t* packed_kernel_size,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, nnp_activation_identity);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const struct fully_connected_output_blocking blocking = get_fully_connected_output_blocking();
+	const size_t output_channels_stride = round_up(output_channels, blocking.output_channels_subblock_max);
+	const size_t required_size = output_channels_stride * input_channels * sizeof(float);
+
+	if (packed_kernel == NULL) {
+		/* Query of the buffer size */
+		*packed_kernel_size = required_size;
+		return nnp_status_success;
+	}
+
+	if (*packed_kernel_size < required_size) {
+		return nnp_status_insufficient_buffer;
+	}
+
+	if (((uintptr_t) packed_kernel) % 64 != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += blocking.input_channels_block_max) {
+		const size_t input_channels_block_size = min(input_channels - input_channels_block_start, blocking.input_channels_block_max);
+
+		struct kernel_packing_context kernel_packing_context = {
+			.matrix = kernel,
+			.packed_matrix = (float*) packed_kernel + output_channels_stride * input_channels_block_start,
+			.simd_width = nnp_hwinfo.simd_width,
+			.outer_stride = input_channels,
+			.input_channels_stride = 1,
+			.outer_subblock_max = blocking.output_channels_subblock_max,
+			.input_channels_block_start = input_channels_block_start,
+			.input_channels_block_size = input_channels_block_size,
+		};
+		nnp_compute_1d_tiled(threadpool,
+			(pthreadpool_function_1d_tiled_t) pack_kernel_matrix,
+			&kernel_packing_context,
+			output_channels, blocking.output_channels_block_max);
+	}
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_fully_connected_input_gradient(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float grad_output[],
+	const float kernel[],
+	float grad_input[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, nnp_activation_identity);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/*
+	 * grad_input[batch_size][input_channels] = grad_output[batch_size][output_channels] x kernel[output_channels][input_channels]:
+	 * the reduction is over output channels, and the kernel matrix is packed transposed.
+	 */
+	status = fully_connected_matrix_multiplication(false,
+		batch_size, output_channels, input_channels,
+		grad_output, output_channels, 1,
+		kernel, 1, input_channels,
+		NULL, grad_input,
+		nnp_activation_identity, 0.0f,
+		NULL, NULL,
+		threadpool, profile);
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_kernel_gradient(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float grad_output[],
+	float grad_kernel[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, nnp_activation_identity);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/*
+	 * grad_kernel[output_channels][input_channels] = transpose(grad_output[batch_size][output_channels]) x input[batch_size][input_channels]:
+	 * the reduction is over the minibatch, and both matrices are packed transposed.
+	 */
+	status = fully_connected_matrix_multiplication(false,
+		output_channels, batch_size, input_channels,
+		grad_output, 1, output_channels,
+		input, 1, input_channels,
+		NULL, grad_kernel,
+		nnp_activation_identity, 0.0f,
+		NULL, NULL,
+		threadpool, profile);
+
 cleanup:
-	release_memory(memory_block, memory_size);
 	NNP_TOTAL_END(profile)
 	return status;
 }
@@ -0,0 +1,165 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/activations.h>
+#include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
+
+/*
+ * Sparse kernel is stored in compressed sparse row (CSR) format, as three consecutive arrays:
+ * - uint32_t row_offsets[output_channels + 1]: offsets of the first non-zero element in each row, and total count of
+ *   non-zero elements in the last element.
+ * - uint32_t column_indices[non_zeroes]: input channels of non-zero elements.
+ * - float values[non_zeroes]: values of non-zero elements.
+ */
+
+static inline size_t get_sparse_kernel_size(size_t output_channels, size_t non_zeroes) {
+	return (output_channels + 1) * sizeof(uint32_t) + non_zeroes * (sizeof(uint32_t) + sizeof(float));
+}
+
+enum nnp_status nnp_fully_connected_pack_sparse_kernel(
+	size_t input_channels,
+	size_t output_channels,
+	const float kernel[],
+	void* sparse_kernel,
+	size_t* sparse_kernel_size)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, nnp_activation_identity);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	size_t non_zeroes = 0;
+	for (size_t index = 0; index < output_channels * input_channels; index++) {
+		non_zeroes += (size_t) (kernel[index] != 0.0f);
+	}
+
+	/* Offsets are 32-bit, and column indices are signed 32-bit for VGATHERDPS */
+	if ((input_channels > INT32_MAX) || (non_zeroes > UINT32_MAX)) {
+		return nnp_status_unsupported_input_size;
+	}
+
+	const size_t required_size = get_sparse_kernel_size(output_channels, non_zeroes);
+	if (sparse_kernel == NULL) {
+		/* Query of the buffer size */
+		*sparse_kernel_size = required_size;
+		return nnp_status_success;
+	}
+
+	if (*sparse_kernel_size < required_size) {
+		return nnp_status_insufficient_buffer;
+	}
+
+	if (((uintptr_t) sparse_kernel) % sizeof(float) != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	uint32_t* row_offsets = sparse_kernel;
+	uint32_t* column_indices = row_offsets + output_channels + 1;
+	float* values = (float*) (column_indices + non_zeroes);
+
+	uint32_t offset = 0;
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
+		row_offsets[output_channel] = offset;
+		for (size_t input_channel = 0; input_channel < input_channels; input_channel++) {
+			const float value = kernel[output_channel * input_channels + input_channel];
+			if (value != 0.0f) {
+				column_indices[offset] = (uint32_t) input_channel;
+				values[offset] = value;
+				offset++;
+			}
+		}
+	}
+	row_offsets[output_channels] = offset;
+
+	*sparse_kernel_size = required_size;
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN fully_connected_inference_sparse_context {
+	const float* input;
+	const uint32_t* row_offsets;
+	const uint32_t* column_indices;
+	const float* values;
+	const float* bias;
+	float* output;
+	enum nnp_activation activation;
+	float negative_slope;
+	nnp_scsrmv_function scsrmv;
+};
+
+static void compute_fully_connected_inference_sparse(
+	const struct fully_connected_inference_sparse_context context[restrict static 1],
+	size_t output_channels_tile_start, size_t output_channels_tile_size)
+{
+	const float* input                   = context->input;
+	const uint32_t* row_offsets          = context->row_offsets;
+	const uint32_t* column_indices       = context->column_indices;
+	const float* values                  = context->values;
+	const float* bias                    = context->bias;
+	float* output                        = context->output;
+	const enum nnp_activation activation = context->activation;
+	const float negative_slope           = context->negative_slope;
+	const nnp_scsrmv_function scsrmv     = context->scsrmv;
+
+	scsrmv(output_channels_tile_size,
+		&row_offsets[output_channels_tile_start], column_indices, values,
+		input, &output[output_channels_tile_start]);
+	apply_bias_activation(
+		&output[output_channels_tile_start], 1, output_channels_tile_size, output_channels_tile_size,
+		bias == NULL ? NULL : &bias[output_channels_tile_start],
+		activation, negative_slope);
+}
+
+enum nnp_status nnp_fully_connected_inference_sparse(
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const void* sparse_kernel,
+	const float bias[],
+	float output[],
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const uint32_t* row_offsets = sparse_kernel;
+	const uint32_t* column_indices = row_offsets + output_channels + 1;
+	const float* values = (const float*) (column_indices + row_offsets[output_channels]);
+
+	/* Do the computation */
+	/* Rows differ in the number of non-zeroes, so tiles are small enough to balance the load between threads */
+	const size_t output_channels_tile_max = 16;
+	struct fully_connected_inference_sparse_context fully_connected_inference_context = {
+		.input = input,
+		.row_offsets = row_offsets,
+		.column_indices = column_indices,
+		.values = values,
+		.bias = bias,
+		.output = output,
+		.activation = activation,
+		.negative_slope = negative_slope,
+#if NNP_ARCH_X86_64
+		.scsrmv = nnp_scsrmv__avx2,
+#elif NNP_ARCH_PSIMD
+		.scsrmv = nnp_scsrmv__psimd,
+#endif
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_fully_connected_inference_sparse,
+		&fully_connected_inference_context,
+		output_channels, output_channels_tile_max);
+
+	return nnp_status_success;
+}
@@ -0,0 +1,302 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/quantization.h>
+#include <nnpack/blas.h>
+#include <nnpack/scheduler.h>
+
+struct NNP_CACHE_ALIGN u8s8_input_packing_context {
+	const uint8_t* input;
+	int16_t* packed_input;
+	size_t input_channels;
+	size_t batch_block_start;
+	size_t batch_subblock_max;
+	uint8_t input_zero_point;
+};
+
+/* Packs a panel of input vectors, with input zero point subtracted, for u8s8gemm micro-kernels */
+static void pack_u8s8_input(
+	const struct u8s8_input_packing_context context[restrict static 1],
+	size_t batch_subblock_start, size_t batch_subblock_size)
+{
+	const size_t input_channels     = context->input_channels;
+	const size_t batch_subblock_max = context->batch_subblock_max;
+	const int32_t input_zero_point  = (int32_t) context->input_zero_point;
+
+	const size_t input_channels_stride = round_up(input_channels, 2);
+	const uint8_t* input = context->input + (context->batch_block_start + batch_subblock_start) * input_channels;
+	int16_t* packed_input = context->packed_input + batch_subblock_start * input_channels_stride;
+	for (size_t m = 0; m < batch_subblock_max; m++) {
+		for (size_t k = 0; k < input_channels_stride; k++) {
+			int16_t element = 0;
+			if ((m < batch_subblock_size) && (k < input_channels)) {
+				element = (int16_t) ((int32_t) input[m * input_channels + k] - input_zero_point);
+			}
+			packed_input[((k / 2) * batch_subblock_max + m) * 2 + k % 2] = element;
+		}
+	}
+}
+
+static enum nnp_status fully_connected_output_u8s8(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct u8s8_gemm_blocking blocking = get_u8s8_gemm_blocking(input_channels);
+	const size_t batch_block_max = min(blocking.rows_block_max, round_up(batch_size, blocking.rows_subblock_max));
+
+	/* Calculate memory footprint and allocate memory */
+	const size_t input_channels_stride = round_up(input_channels, 2);
+	const size_t packed_kernel_size =
+		round_up(output_channels, blocking.output_channels_subblock_max) * input_channels_stride * sizeof(int16_t);
+	const size_t packed_input_offset = round_up(packed_kernel_size, 64);
+	const size_t memory_size = packed_input_offset + batch_block_max * input_channels_stride * sizeof(int16_t);
+	void* memory_block = allocate_memory(memory_size);
+	if (memory_block == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	int16_t* packed_kernel = memory_block;
+	int16_t* packed_input = memory_block + packed_input_offset;
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct u8s8_kernel_packing_context kernel_packing_context = {
+		.kernel = kernel,
+		.packed_kernel = packed_kernel,
+		.reduction_size = input_channels,
+		.output_channels_subblock_max = blocking.output_channels_subblock_max,
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) pack_u8s8_kernel,
+		&kernel_packing_context,
+		output_channels, blocking.output_channels_subblock_max);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	struct u8s8_input_packing_context input_packing_context = {
+		.input = input,
+		.packed_input = packed_input,
+		.input_channels = input_channels,
+		.batch_subblock_max = blocking.rows_subblock_max,
+		.input_zero_point = input_quantization.zero_point,
+	};
+	struct u8s8_matrix_multiplication_context matrix_multiplication_context = {
+		.reduction_size = input_channels,
+		.rows_subblock_max = blocking.rows_subblock_max,
+		.output_channels_subblock_max = blocking.output_channels_subblock_max,
+		.packed_input = packed_input,
+		.packed_kernel = packed_kernel,
+		.input_scale = input_quantization.scale,
+		.kernel_scales = kernel_scales,
+		.bias = bias,
+		.output = output,
+		.output_row_stride = output_channels,
+		.output_channel_stride = 1,
+		.output_quantization = output_quantization,
+		.activation = activation,
+		.negative_slope = negative_slope,
+		.u8s8gemm = blocking.u8s8gemm,
+	};
+	for (size_t batch_block_start = 0; batch_block_start < batch_size; batch_block_start += batch_block_max) {
+		const size_t batch_block_size = min(batch_size - batch_block_start, batch_block_max);
+
+		NNP_INPUT_TRANSFORM_START(profile)
+		input_packing_context.batch_block_start = batch_block_start;
+		nnp_compute_1d_tiled(threadpool,
+			(pthreadpool_function_1d_tiled_t) pack_u8s8_input,
+			&input_packing_context,
+			batch_block_size, blocking.rows_subblock_max);
+		NNP_INPUT_TRANSFORM_END(profile)
+
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		matrix_multiplication_context.rows_block_start = batch_block_start;
+		nnp_compute_2d_tiled(threadpool,
+			(pthreadpool_function_2d_tiled_t) compute_u8s8_matrix_multiplication,
+			&matrix_multiplication_context,
+			output_channels, batch_block_size,
+			blocking.output_channels_block_max, blocking.rows_subblock_max);
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+	}
+
+	release_memory(memory_block, memory_size);
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN fully_connected_inference_u8s8_context {
+	size_t input_channels;
+	const uint8_t* input;
+	struct nnp_quantization input_quantization;
+	const int8_t* kernel;
+	const float* kernel_scales;
+	const float* bias;
+	uint8_t* output;
+	struct nnp_quantization output_quantization;
+	enum nnp_activation activation;
+	float negative_slope;
+	nnp_u8s8dotxf_function u8s8dotxf[8];
+};
+
+static void compute_fully_connected_inference_u8s8(
+	const struct fully_connected_inference_u8s8_context context[restrict static 1],
+	size_t output_channels_subblock_start, size_t output_channels_subblock_size)
+{
+	const size_t input_channels                       = context->input_channels;
+	const uint8_t* input                              = context->input;
+	const struct nnp_quantization input_quantization  = context->input_quantization;
+	const int8_t* kernel                              = context->kernel;
+	const float* kernel_scales                        = context->kernel_scales;
+	const float* bias                                 = context->bias;
+	uint8_t* output                                   = context->output;
+	const struct nnp_quantization output_quantization = context->output_quantization;
+	const enum nnp_activation activation              = context->activation;
+	const float negative_slope                        = context->negative_slope;
+	const nnp_u8s8dotxf_function u8s8dotxf            = context->u8s8dotxf[output_channels_subblock_size - 1];
+
+	int32_t accumulators[8];
+	u8s8dotxf(
+		input,
+		&kernel[output_channels_subblock_start * input_channels], input_channels,
+		accumulators, input_channels,
+		input_quantization.zero_point);
+	requantize_output(
+		accumulators, output_channels_subblock_size,
+		&output[output_channels_subblock_start], 1,
+		input_quantization.scale, &kernel_scales[output_channels_subblock_start],
+		bias == NULL ? NULL : &bias[output_channels_subblock_start],
+		output_quantization, activation, negative_slope);
+}
+
+enum nnp_status nnp_fully_connected_output_u8s8(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = validate_quantization_arguments(input_quantization, output_channels, kernel_scales, output_quantization);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	if (input_channels > NNP_U8S8_MAX_REDUCTION_SIZE) {
+		status = nnp_status_unsupported_input_channels;
+		goto cleanup;
+	}
+
+	/* Do the computation */
+	status = fully_connected_output_u8s8(
+		batch_size, input_channels, output_channels,
+		input, input_quantization,
+		kernel, kernel_scales, bias,
+		output, output_quantization,
+		activation, negative_slope,
+		threadpool, profile);
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_inference_u8s8(
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	status = validate_quantization_arguments(input_quantization, output_channels, kernel_scales, output_quantization);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	if (input_channels > NNP_U8S8_MAX_REDUCTION_SIZE) {
+		return nnp_status_unsupported_input_channels;
+	}
+
+	/* Do the computation */
+	const size_t output_channels_subblock_max = 8;
+	struct fully_connected_inference_u8s8_context fully_connected_inference_context = {
+		.input_channels = input_channels,
+		.input = input,
+		.input_quantization = input_quantization,
+		.kernel = kernel,
+		.kernel_scales = kernel_scales,
+		.bias = bias,
+		.output = output,
+		.output_quantization = output_quantization,
+		.activation = activation,
+		.negative_slope = negative_slope,
+		.u8s8dotxf = {
+#if NNP_ARCH_X86_64
+			[0] = nnp_u8s8dotxf1__avx2,
+			[1] = nnp_u8s8dotxf2__avx2,
+			[2] = nnp_u8s8dotxf3__avx2,
+			[3] = nnp_u8s8dotxf4__avx2,
+			[4] = nnp_u8s8dotxf5__avx2,
+			[5] = nnp_u8s8dotxf6__avx2,
+			[6] = nnp_u8s8dotxf7__avx2,
+			[7] = nnp_u8s8dotxf8__avx2,
+#elif NNP_ARCH_PSIMD
+			[0] = nnp_u8s8dotxf1__psimd,
+			[1] = nnp_u8s8dotxf2__psimd,
+			[2] = nnp_u8s8dotxf3__psimd,
+			[3] = nnp_u8s8dotxf4__psimd,
+			[4] = nnp_u8s8dotxf5__psimd,
+			[5] = nnp_u8s8dotxf6__psimd,
+			[6] = nnp_u8s8dotxf7__psimd,
+			[7] = nnp_u8s8dotxf8__psimd,
+#endif
+		},
+	};
+	nnp_compute_1d_tiled(threadpool,
+		(pthreadpool_function_1d_tiled_t) compute_fully_connected_inference_u8s8,
+		&fully_connected_inference_context,
+		output_channels, output_channels_subblock_max);
+
+	return nnp_status_success;
+}
@@ -9,6 +9,9 @@
 	#ifndef bit_AVX2
 		#define bit_AVX2 0x00000020
 	#endif
+	#ifndef bit_F16C
+		#define bit_F16C 0x20000000
+	#endif
 
 	#if __native_client__
 		#define NNP_NACL_CODE_BUNDLE_SIZE 32
@@ -80,6 +83,13 @@ static pthread_once_t hwinfo_init_control = PTHREAD_ONCE_INIT;
 				0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4,
 				0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4,
 			};
+			static const uint8_t f16c_bundle[NNP_NACL_CODE_BUNDLE_SIZE] = {
+				/* VCVTPH2PS ymm0, xmm1 */
+				0xC4, 0xE2, 0x7D, 0x13, 0xC1,
+				/* Fill remainder with HLTs */
+				0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4,
+				0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4,
+			};
 
 			struct nacl_irt_code_data_alloc nacl_irt_code_data_alloc = { 0 };
 			if (nacl_interface_query(NACL_IRT_CODE_DATA_ALLOC_v0_1, &nacl_irt_code_data_alloc,
@@ -102,6 +112,10 @@ static pthread_once_t hwinfo_init_control = PTHREAD_ONCE_INIT;
 
 						nnp_hwinfo.isa.has_avx2 =
 							!nacl_irt_dyncode.dyncode_create((void*) code_segment, avx2_bundle, NNP_NACL_CODE_BUNDLE_SIZE);
+						code_segment += NNP_NACL_CODE_BUNDLE_SIZE;
+
+						nnp_hwinfo.isa.has_f16c =
+							!nacl_irt_dyncode.dyncode_create((void*) code_segment, f16c_bundle, NNP_NACL_CODE_BUNDLE_SIZE);
 					}
 				}
 			}
@@ -131,6 +145,8 @@ static pthread_once_t hwinfo_init_control = PTHREAD_ONCE_INIT;
 					nnp_hwinfo.isa.has_fma3 = !!(basic_info.ecx & bit_FMA);
 					/* AVX2: ebx[bit 5] in structured feature info */
 					nnp_hwinfo.isa.has_avx2 = !!(structured_info.ebx & bit_AVX2);
+					/* F16C: ecx[bit 29] in basic info */
+					nnp_hwinfo.isa.has_f16c = !!(basic_info.ecx & bit_F16C);
 				}
 			}
 		#endif
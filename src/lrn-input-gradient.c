@@ -0,0 +1,135 @@
+#include <stddef.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/lrn.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+
+struct NNP_CACHE_ALIGN lrn_input_gradient_context {
+	nnp_lrn_backward_function backward_function;
+	size_t channels;
+	size_t image_size;
+	size_t groups_per_sample;
+	size_t groups_count;
+	size_t shard_groups_max;
+	size_t half_window;
+	float alpha_over_n;
+	float minus_beta;
+	float k;
+	const float* grad_output;
+	const float* input;
+	float* grad_input;
+	float* scratch;
+};
+
+/*
+ * Processes a contiguous range of (sample, pixel group) pairs.
+ * Every shard owns a private scratch buffer of channels * SIMD width elements, so a thread reuses one buffer,
+ * which stays in L1 cache, for all pixel groups it processes.
+ */
+static void compute_lrn_input_gradient(
+	const struct lrn_input_gradient_context context[restrict static 1],
+	size_t shard)
+{
+	nnp_lrn_backward_function backward_function = context->backward_function;
+	const size_t channels                       = context->channels;
+	const size_t image_size                     = context->image_size;
+	const size_t groups_per_sample              = context->groups_per_sample;
+	const size_t groups_count                   = context->groups_count;
+	const size_t shard_groups_max               = context->shard_groups_max;
+	const size_t half_window                    = context->half_window;
+	const float alpha_over_n                    = context->alpha_over_n;
+	const float minus_beta                      = context->minus_beta;
+	const float k                               = context->k;
+	const float* grad_output                    = context->grad_output;
+	const float* input                          = context->input;
+	float* grad_input                           = context->grad_input;
+
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	float* scratch = context->scratch + shard * channels * simd_width;
+
+	const size_t groups_start = shard * shard_groups_max;
+	const size_t groups_end = min(groups_start + shard_groups_max, groups_count);
+	for (size_t group = groups_start; group < groups_end; group++) {
+		const size_t sample = group / groups_per_sample;
+		const size_t pixel = (group % groups_per_sample) * simd_width;
+		const size_t offset = sample * channels * image_size + pixel;
+		backward_function(grad_output + offset, input + offset, grad_input + offset, scratch,
+			channels, image_size, min(simd_width, image_size - pixel), half_window,
+			alpha_over_n, minus_beta, k);
+	}
+}
+
+enum nnp_status nnp_lrn_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+
+	enum nnp_status status = validate_lrn_arguments(batch_size, channels, input_size, local_size, alpha, beta, k);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	const size_t image_size = input_size.height * input_size.width;
+	const size_t groups_per_sample = divide_round_up(image_size, simd_width);
+	const size_t groups_count = batch_size * groups_per_sample;
+
+	/* Split pixel groups into one shard per thread */
+	const size_t threads_count = nnp_get_threads_count(threadpool);
+	const size_t shard_groups_max = divide_round_up(groups_count, min(groups_count, threads_count));
+	const size_t shards = divide_round_up(groups_count, shard_groups_max);
+
+	memory_size = shards * channels * simd_width * sizeof(float);
+	memory_block = allocate_memory(memory_size);
+	if (memory_block == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	struct lrn_input_gradient_context lrn_input_gradient_context = {
+	#if NNP_ARCH_X86_64
+		.backward_function = nnp_lrn_backward__avx2,
+	#elif NNP_ARCH_PSIMD
+		.backward_function = nnp_lrn_backward__psimd,
+	#endif
+		.channels = channels,
+		.image_size = image_size,
+		.groups_per_sample = groups_per_sample,
+		.groups_count = groups_count,
+		.shard_groups_max = shard_groups_max,
+		.half_window = local_size / 2,
+		.alpha_over_n = alpha / (float) local_size,
+		.minus_beta = -beta,
+		.k = k,
+		.grad_output = grad_output,
+		.input = input,
+		.grad_input = grad_input,
+		.scratch = memory_block,
+	};
+	nnp_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_lrn_input_gradient,
+		&lrn_input_gradient_context,
+		shards);
+
+cleanup:
+	release_memory(memory_block, memory_size);
+	return status;
+}
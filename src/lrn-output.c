@@ -0,0 +1,97 @@
+#include <stddef.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/lrn.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
+
+
+struct NNP_CACHE_ALIGN lrn_output_context {
+	nnp_lrn_forward_function forward_function;
+	size_t channels;
+	size_t image_size;
+	size_t half_window;
+	float alpha_over_n;
+	float minus_beta;
+	float k;
+	const float* input;
+	float* output;
+};
+
+static void compute_lrn_output(
+	const struct lrn_output_context context[restrict static 1],
+	size_t sample, size_t pixels_start,
+	size_t sample_range, size_t pixels_range)
+{
+	nnp_lrn_forward_function forward_function = context->forward_function;
+	const size_t channels                     = context->channels;
+	const size_t image_size                   = context->image_size;
+	const size_t half_window                  = context->half_window;
+	const float alpha_over_n                  = context->alpha_over_n;
+	const float minus_beta                    = context->minus_beta;
+	const float k                             = context->k;
+	const float* input                        = context->input;
+	float* output                             = context->output;
+
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	const size_t sample_offset = sample * channels * image_size;
+	for (size_t pixel = pixels_start; pixel < pixels_start + pixels_range; pixel += simd_width) {
+		const size_t offset = sample_offset + pixel;
+		forward_function(input + offset, output + offset,
+			channels, image_size, min(simd_width, pixels_start + pixels_range - pixel), half_window,
+			alpha_over_n, minus_beta, k);
+	}
+}
+
+enum nnp_status nnp_lrn_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_lrn_arguments(batch_size, channels, input_size, local_size, alpha, beta, k);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t image_size = input_size.height * input_size.width;
+
+	/*
+	 * Every kernel call walks all channels of one group of SIMD-width pixels.
+	 * A tile spans several groups, so that a thread streams through adjacent cache lines of every channel.
+	 */
+	const size_t pixels_tile = 16 * nnp_hwinfo.simd_width;
+
+	struct lrn_output_context lrn_output_context = {
+	#if NNP_ARCH_X86_64
+		.forward_function = nnp_lrn_forward__avx2,
+	#elif NNP_ARCH_PSIMD
+		.forward_function = nnp_lrn_forward__psimd,
+	#endif
+		.channels = channels,
+		.image_size = image_size,
+		.half_window = local_size / 2,
+		.alpha_over_n = alpha / (float) local_size,
+		.minus_beta = -beta,
+		.k = k,
+		.input = input,
+		.output = output,
+	};
+	nnp_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_lrn_output,
+		&lrn_output_context,
+		batch_size, image_size,
+		1, pixels_tile);
+
+	return nnp_status_success;
+}
@@ -0,0 +1,538 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <nnpack.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/hwinfo.h>
+
+
+/*
+ * Layout of a model file:
+ * - struct model_header
+ * - struct model_layer[layers_count]
+ * - kernels and biases of the layers, every one aligned on 64 bytes from the start of the file.
+ * Kernels are stored in the layouts of the inference functions, and these layouts depend on the architecture, SIMD
+ * width, and L1 cache blocking. These parameters are recorded in the header, and files saved with different parameters
+ * are rejected by the loader.
+ */
+
+#define MODEL_MAGIC "NNPMODEL"
+#define MODEL_VERSION 1
+#define MODEL_ALIGNMENT 64
+
+#if NNP_ARCH_X86_64
+	#define MODEL_ARCHITECTURE 1
+#elif NNP_ARCH_PSIMD
+	#define MODEL_ARCHITECTURE 2
+#endif
+
+struct model_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t architecture;
+	uint32_t simd_width;
+	uint32_t reserved;
+	uint64_t l1_cache_blocking;
+	uint64_t layers_count;
+	uint64_t file_size;
+};
+
+/* Location of an array in the model file. Arrays of zero size are absent. */
+struct model_blob {
+	uint64_t offset;
+	uint64_t size;
+};
+
+/* Channels of max-pooling, ReLU, and softmax layers are stored in input_channels */
+struct model_layer {
+	uint32_t type;
+	uint32_t algorithm;
+	uint64_t input_channels;
+	uint64_t output_channels;
+	uint64_t input_height;
+	uint64_t input_width;
+	uint64_t padding_top;
+	uint64_t padding_right;
+	uint64_t padding_bottom;
+	uint64_t padding_left;
+	/* Kernel size of convolutional layers, or pooling size of max-pooling layers */
+	uint64_t kernel_height;
+	uint64_t kernel_width;
+	uint64_t stride_height;
+	uint64_t stride_width;
+	float negative_slope;
+	uint32_t reserved;
+	struct model_blob kernel;
+	struct model_blob bias;
+};
+
+struct nnp_model {
+	void* mapping;
+	size_t mapping_size;
+	size_t layers_count;
+	struct nnp_layer* layers;
+};
+
+static void init_model_header(struct model_header header[restrict static 1], size_t layers_count, size_t file_size) {
+	memset(header, 0, sizeof(struct model_header));
+	memcpy(header->magic, MODEL_MAGIC, sizeof(header->magic));
+	header->version = MODEL_VERSION;
+	header->architecture = MODEL_ARCHITECTURE;
+	header->simd_width = nnp_hwinfo.simd_width;
+	header->l1_cache_blocking = nnp_hwinfo.blocking.l1;
+	header->layers_count = layers_count;
+	header->file_size = file_size;
+}
+
+/* Size of the kernel of a layer in the model file, or 0 if the layer has no kernel */
+static enum nnp_status get_kernel_blob_size(const struct nnp_layer layer[restrict static 1], size_t kernel_size[restrict static 1]) {
+	*kernel_size = 0;
+	switch (layer->type) {
+		case nnp_layer_type_convolution:
+			return nnp_convolution_inference_transform_kernel(layer->convolution.algorithm,
+				layer->convolution.input_channels, layer->convolution.output_channels, layer->convolution.kernel_size,
+				NULL, NULL, kernel_size, NULL);
+		case nnp_layer_type_fully_connected:
+			return nnp_fully_connected_pack_kernel(
+				layer->fully_connected.input_channels, layer->fully_connected.output_channels,
+				NULL, NULL, kernel_size, NULL);
+		case nnp_layer_type_max_pooling:
+		case nnp_layer_type_relu:
+		case nnp_layer_type_softmax:
+			return nnp_status_success;
+		default:
+			return nnp_status_invalid_layer;
+	}
+}
+
+static size_t get_bias_blob_size(const struct nnp_layer layer[restrict static 1]) {
+	switch (layer->type) {
+		case nnp_layer_type_convolution:
+			/* Inference functions require a bias, so layers without one are saved with zero bias */
+			return layer->convolution.output_channels * sizeof(float);
+		case nnp_layer_type_fully_connected:
+			return layer->fully_connected.bias == NULL ? 0 : layer->fully_connected.output_channels * sizeof(float);
+		default:
+			return 0;
+	}
+}
+
+static void encode_layer(
+	const struct nnp_layer layer[restrict static 1],
+	struct model_blob kernel,
+	struct model_blob bias,
+	struct model_layer record[restrict static 1])
+{
+	memset(record, 0, sizeof(struct model_layer));
+	record->type = layer->type;
+	record->kernel = kernel;
+	record->bias = bias;
+	switch (layer->type) {
+		case nnp_layer_type_convolution:
+			record->algorithm = layer->convolution.algorithm;
+			record->input_channels = layer->convolution.input_channels;
+			record->output_channels = layer->convolution.output_channels;
+			record->input_height = layer->convolution.input_size.height;
+			record->input_width = layer->convolution.input_size.width;
+			record->padding_top = layer->convolution.input_padding.top;
+			record->padding_right = layer->convolution.input_padding.right;
+			record->padding_bottom = layer->convolution.input_padding.bottom;
+			record->padding_left = layer->convolution.input_padding.left;
+			record->kernel_height = layer->convolution.kernel_size.height;
+			record->kernel_width = layer->convolution.kernel_size.width;
+			break;
+		case nnp_layer_type_fully_connected:
+			record->input_channels = layer->fully_connected.input_channels;
+			record->output_channels = layer->fully_connected.output_channels;
+			break;
+		case nnp_layer_type_max_pooling:
+			record->input_channels = layer->max_pooling.channels;
+			record->input_height = layer->max_pooling.input_size.height;
+			record->input_width = layer->max_pooling.input_size.width;
+			record->padding_top = layer->max_pooling.input_padding.top;
+			record->padding_right = layer->max_pooling.input_padding.right;
+			record->padding_bottom = layer->max_pooling.input_padding.bottom;
+			record->padding_left = layer->max_pooling.input_padding.left;
+			record->kernel_height = layer->max_pooling.pooling_size.height;
+			record->kernel_width = layer->max_pooling.pooling_size.width;
+			record->stride_height = layer->max_pooling.pooling_stride.height;
+			record->stride_width = layer->max_pooling.pooling_stride.width;
+			break;
+		case nnp_layer_type_relu:
+			record->input_channels = layer->relu.channels;
+			record->negative_slope = layer->relu.negative_slope;
+			break;
+		case nnp_layer_type_softmax:
+			record->input_channels = layer->softmax.channels;
+			break;
+	}
+}
+
+/* Decodes a layer record. Kernel and bias of the layer point into the mapped file. */
+static void decode_layer(
+	const struct model_layer record[restrict static 1],
+	const void* mapping,
+	struct nnp_layer layer[restrict static 1])
+{
+	memset(layer, 0, sizeof(struct nnp_layer));
+	layer->type = (enum nnp_layer_type) record->type;
+	const float* kernel = record->kernel.size == 0 ? NULL : (const float*) ((const char*) mapping + record->kernel.offset);
+	const float* bias = record->bias.size == 0 ? NULL : (const float*) ((const char*) mapping + record->bias.offset);
+	switch (layer->type) {
+		case nnp_layer_type_convolution:
+			layer->convolution = (struct nnp_convolution_layer) {
+				.algorithm = (enum nnp_convolution_algorithm) record->algorithm,
+				.kernel_transform_strategy = nnp_convolution_kernel_transform_strategy_precomputed,
+				.input_channels = record->input_channels,
+				.output_channels = record->output_channels,
+				.input_size = { .width = record->input_width, .height = record->input_height },
+				.input_padding = {
+					.top = record->padding_top,
+					.right = record->padding_right,
+					.bottom = record->padding_bottom,
+					.left = record->padding_left,
+				},
+				.kernel_size = { .width = record->kernel_width, .height = record->kernel_height },
+				.kernel = kernel,
+				.bias = bias,
+			};
+			break;
+		case nnp_layer_type_fully_connected:
+			layer->fully_connected = (struct nnp_fully_connected_layer) {
+				.input_channels = record->input_channels,
+				.output_channels = record->output_channels,
+				.kernel = kernel,
+				.bias = bias,
+				.prepacked_kernel = true,
+			};
+			break;
+		case nnp_layer_type_max_pooling:
+			layer->max_pooling = (struct nnp_max_pooling_layer) {
+				.channels = record->input_channels,
+				.input_size = { .width = record->input_width, .height = record->input_height },
+				.input_padding = {
+					.top = record->padding_top,
+					.right = record->padding_right,
+					.bottom = record->padding_bottom,
+					.left = record->padding_left,
+				},
+				.pooling_size = { .width = record->kernel_width, .height = record->kernel_height },
+				.pooling_stride = { .width = record->stride_width, .height = record->stride_height },
+			};
+			break;
+		case nnp_layer_type_relu:
+			layer->relu = (struct nnp_relu_layer) {
+				.channels = record->input_channels,
+				.negative_slope = record->negative_slope,
+			};
+			break;
+		case nnp_layer_type_softmax:
+			layer->softmax = (struct nnp_softmax_layer) {
+				.channels = record->input_channels,
+			};
+			break;
+	}
+}
+
+/* Writes zeros to the file up to the next multiple of MODEL_ALIGNMENT */
+static bool write_padding(FILE* file, size_t size) {
+	static const char zeros[MODEL_ALIGNMENT];
+	const size_t padding_size = round_up(size, MODEL_ALIGNMENT) - size;
+	return fwrite(zeros, 1, padding_size, file) == padding_size;
+}
+
+enum nnp_status nnp_model_save(
+	const char* path,
+	size_t layers_count,
+	const struct nnp_layer layers[],
+	pthreadpool_t threadpool)
+{
+	struct model_layer* records = NULL;
+	void* staging_buffer = NULL;
+	size_t staging_buffer_size = 0;
+	FILE* file = NULL;
+	enum nnp_status status = nnp_status_success;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (layers_count == 0) {
+		return nnp_status_invalid_layer;
+	}
+
+	records = calloc(layers_count, sizeof(struct model_layer));
+	if (records == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	/* Assign locations in the file to kernels and biases, and find the size of the largest transformed kernel */
+	size_t file_size = round_up(sizeof(struct model_header) + layers_count * sizeof(struct model_layer), MODEL_ALIGNMENT);
+	for (size_t i = 0; i < layers_count; i++) {
+		const struct nnp_layer* layer = &layers[i];
+		if ((layer->type == nnp_layer_type_convolution && layer->convolution.kernel_transform_strategy != nnp_convolution_kernel_transform_strategy_batch) ||
+			(layer->type == nnp_layer_type_fully_connected && layer->fully_connected.prepacked_kernel))
+		{
+			status = nnp_status_invalid_layer;
+			goto cleanup;
+		}
+
+		size_t kernel_size;
+		status = get_kernel_blob_size(layer, &kernel_size);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+		staging_buffer_size = max(staging_buffer_size, kernel_size);
+
+		const struct model_blob kernel = { .offset = kernel_size == 0 ? 0 : file_size, .size = kernel_size };
+		file_size += round_up(kernel_size, MODEL_ALIGNMENT);
+
+		const size_t bias_size = get_bias_blob_size(layer);
+		const struct model_blob bias = { .offset = bias_size == 0 ? 0 : file_size, .size = bias_size };
+		file_size += round_up(bias_size, MODEL_ALIGNMENT);
+
+		encode_layer(layer, kernel, bias, &records[i]);
+	}
+
+	if (staging_buffer_size != 0) {
+		staging_buffer = allocate_memory(staging_buffer_size);
+		if (staging_buffer == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	}
+
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	struct model_header header;
+	init_model_header(&header, layers_count, file_size);
+	if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+		fwrite(records, sizeof(struct model_layer), layers_count, file) != layers_count ||
+		!write_padding(file, sizeof(struct model_header) + layers_count * sizeof(struct model_layer)))
+	{
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	for (size_t i = 0; i < layers_count; i++) {
+		const struct nnp_layer* layer = &layers[i];
+		size_t kernel_size = records[i].kernel.size;
+		const float* bias = NULL;
+		switch (layer->type) {
+			case nnp_layer_type_convolution:
+				status = nnp_convolution_inference_transform_kernel(layer->convolution.algorithm,
+					layer->convolution.input_channels, layer->convolution.output_channels, layer->convolution.kernel_size,
+					layer->convolution.kernel, staging_buffer, &kernel_size, threadpool);
+				bias = layer->convolution.bias;
+				break;
+			case nnp_layer_type_fully_connected:
+				status = nnp_fully_connected_pack_kernel(
+					layer->fully_connected.input_channels, layer->fully_connected.output_channels,
+					layer->fully_connected.kernel, staging_buffer, &kernel_size, threadpool);
+				bias = layer->fully_connected.bias;
+				break;
+			default:
+				break;
+		}
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		if (fwrite(staging_buffer, 1, records[i].kernel.size, file) != records[i].kernel.size ||
+			!write_padding(file, records[i].kernel.size))
+		{
+			status = nnp_status_io_error;
+			goto cleanup;
+		}
+
+		const size_t bias_size = records[i].bias.size;
+		if (bias == NULL && bias_size != 0) {
+			/* Zero bias of a convolutional layer, which is smaller than its transformed kernel */
+			memset(staging_buffer, 0, bias_size);
+			bias = staging_buffer;
+		}
+		if (fwrite(bias, 1, bias_size, file) != bias_size || !write_padding(file, bias_size)) {
+			status = nnp_status_io_error;
+			goto cleanup;
+		}
+	}
+
+	if (fclose(file) != 0) {
+		status = nnp_status_io_error;
+	}
+	file = NULL;
+
+cleanup:
+	if (file != NULL) {
+		fclose(file);
+	}
+	release_memory(staging_buffer, staging_buffer_size);
+	free(records);
+	return status;
+}
+
+/* Checks that a blob lies within the file and is aligned */
+static inline bool is_valid_blob(struct model_blob blob, size_t expected_size, size_t file_size) {
+	if (blob.size != expected_size) {
+		return false;
+	}
+	if (blob.size == 0) {
+		return true;
+	}
+	return (blob.offset % MODEL_ALIGNMENT == 0) && (blob.offset <= file_size) && (blob.size <= file_size - blob.offset);
+}
+
+static enum nnp_status validate_model(const void* mapping, size_t file_size) {
+	if (file_size < sizeof(struct model_header)) {
+		return nnp_status_invalid_model;
+	}
+
+	const struct model_header* header = mapping;
+	struct model_header expected_header;
+	init_model_header(&expected_header, header->layers_count, file_size);
+	if (memcmp(header, &expected_header, sizeof(struct model_header)) != 0) {
+		/* Not a model file, truncated file, or a model for a different CPU */
+		return nnp_status_invalid_model;
+	}
+
+	const size_t layers_count = header->layers_count;
+	if (layers_count == 0 || layers_count > (file_size - sizeof(struct model_header)) / sizeof(struct model_layer)) {
+		return nnp_status_invalid_model;
+	}
+
+	const struct model_layer* records = (const struct model_layer*) (header + 1);
+	for (size_t i = 0; i < layers_count; i++) {
+		struct nnp_layer layer;
+		decode_layer(&records[i], mapping, &layer);
+
+		size_t kernel_size;
+		if (get_kernel_blob_size(&layer, &kernel_size) != nnp_status_success) {
+			return nnp_status_invalid_model;
+		}
+		if (!is_valid_blob(records[i].kernel, kernel_size, file_size)) {
+			return nnp_status_invalid_model;
+		}
+		/* Convolutional layers always have a bias, and fully connected layers may have none */
+		const size_t bias_size = (records[i].type == nnp_layer_type_convolution || records[i].bias.size != 0) ?
+			records[i].output_channels * sizeof(float) : 0;
+		if (!is_valid_blob(records[i].bias, bias_size, file_size)) {
+			return nnp_status_invalid_model;
+		}
+	}
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_model_load(
+	const char* path,
+	nnp_model_t* model_out)
+{
+	struct nnp_model* model = NULL;
+	int fd = -1;
+	enum nnp_status status = nnp_status_success;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	model = calloc(1, sizeof(struct nnp_model));
+	if (model == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+	if (file_stat.st_size < (off_t) sizeof(struct model_header)) {
+		status = nnp_status_invalid_model;
+		goto cleanup;
+	}
+
+	/* Shared read-only mapping: pages of the file are shared with the page cache and other processes */
+	void* mapping = mmap(NULL, (size_t) file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+	model->mapping = mapping;
+	model->mapping_size = (size_t) file_stat.st_size;
+
+	status = validate_model(model->mapping, model->mapping_size);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const struct model_header* header = model->mapping;
+	const struct model_layer* records = (const struct model_layer*) (header + 1);
+	model->layers_count = header->layers_count;
+	model->layers = calloc(model->layers_count, sizeof(struct nnp_layer));
+	if (model->layers == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	for (size_t i = 0; i < model->layers_count; i++) {
+		decode_layer(&records[i], model->mapping, &model->layers[i]);
+	}
+
+	*model_out = model;
+	model = NULL;
+
+cleanup:
+	if (fd != -1) {
+		close(fd);
+	}
+	nnp_model_unload(model);
+	return status;
+}
+
+enum nnp_status nnp_model_get_layers(
+	nnp_model_t model,
+	size_t* layers_count,
+	const struct nnp_layer** layers)
+{
+	*layers_count = model->layers_count;
+	*layers = model->layers;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_model_unload(nnp_model_t model) {
+	if (model != NULL) {
+		if (model->mapping != NULL) {
+			munmap(model->mapping, model->mapping_size);
+		}
+		free(model->layers);
+		free(model);
+	}
+	return nnp_status_success;
+}
@@ -0,0 +1,434 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nnpack.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/hwinfo.h>
+
+#include <nnpack/validation.h>
+#include <nnpack/workspace.h>
+
+
+struct network_layer {
+	struct nnp_layer layer;
+	/* Input and output of the layer in the activations buffer. Ignored for input of the first layer and output of the last layer. */
+	const float* input;
+	float* output;
+	/* Size of the workspace the layer needs, in bytes */
+	size_t workspace_size;
+};
+
+struct nnp_network {
+	size_t batch_size;
+	size_t layers_count;
+	struct network_layer* layers;
+	/* Activations buffer followed by the workspace */
+	void* memory_block;
+	size_t memory_size;
+	size_t activations_size;
+	void* workspace;
+	size_t workspace_size;
+};
+
+/* Buffer for activations between layers. It is alive from the layer which writes it to the last layer which reads it. */
+struct activation_buffer {
+	size_t size;
+	size_t first_layer;
+	size_t last_layer;
+	size_t offset;
+	bool placed;
+};
+
+static inline bool is_alive_together(const struct activation_buffer* a, const struct activation_buffer* b) {
+	return (a->first_layer <= b->last_layer) && (b->first_layer <= a->last_layer);
+}
+
+static inline bool is_overlapping(const struct activation_buffer* a, size_t offset, size_t size) {
+	return (a->offset < offset + size) && (offset < a->offset + a->size);
+}
+
+/*
+ * Places activation buffers in a single memory block, so that buffers which are alive at the same time do not overlap.
+ * Larger buffers are placed first, every buffer at the lowest offset free during all of its lifetime.
+ * Returns the size of the memory block.
+ */
+static size_t plan_activation_buffers(size_t buffers_count, struct activation_buffer buffers[]) {
+	size_t memory_size = 0;
+	for (size_t placed_count = 0; placed_count < buffers_count; placed_count++) {
+		struct activation_buffer* buffer = NULL;
+		for (size_t i = 0; i < buffers_count; i++) {
+			if (!buffers[i].placed && (buffer == NULL || buffers[i].size > buffer->size)) {
+				buffer = &buffers[i];
+			}
+		}
+
+		size_t offset = 0;
+		bool moved;
+		do {
+			moved = false;
+			for (size_t i = 0; i < buffers_count; i++) {
+				const struct activation_buffer* other = &buffers[i];
+				if (other->placed && is_alive_together(buffer, other) && is_overlapping(other, offset, buffer->size)) {
+					offset = other->offset + other->size;
+					moved = true;
+				}
+			}
+		} while (moved);
+
+		buffer->offset = offset;
+		buffer->placed = true;
+		memory_size = max(memory_size, offset + buffer->size);
+	}
+	return memory_size;
+}
+
+/*
+ * Validates a layer, and computes the number of elements in its input and output for one image,
+ * and the size of its workspace for batch_size images.
+ */
+static enum nnp_status analyze_layer(
+	size_t batch_size,
+	const struct nnp_layer layer[restrict static 1],
+	size_t input_elements[restrict static 1],
+	size_t output_elements[restrict static 1],
+	size_t workspace_size[restrict static 1])
+{
+	enum nnp_status status;
+	*workspace_size = 0;
+	switch (layer->type) {
+		case nnp_layer_type_convolution:
+		{
+			const struct nnp_convolution_layer convolution = layer->convolution;
+			if (convolution.kernel_transform_strategy == nnp_convolution_kernel_transform_strategy_batch) {
+				status = nnp_convolution_output_with_workspace(convolution.algorithm,
+					batch_size, convolution.input_channels, convolution.output_channels,
+					convolution.input_size, convolution.input_padding, convolution.kernel_size,
+					NULL, NULL, NULL, NULL,
+					NULL, workspace_size,
+					NULL, NULL);
+			} else {
+				/* Images are computed one by one, and reuse the same workspace */
+				status = nnp_convolution_inference_with_workspace(
+					convolution.algorithm, convolution.kernel_transform_strategy,
+					convolution.input_channels, convolution.output_channels,
+					convolution.input_size, convolution.input_padding, convolution.kernel_size,
+					NULL, NULL, NULL, NULL,
+					NULL, workspace_size,
+					NULL, NULL);
+			}
+			const size_t output_height = convolution.input_padding.top + convolution.input_size.height +
+				convolution.input_padding.bottom - convolution.kernel_size.height + 1;
+			const size_t output_width = convolution.input_padding.left + convolution.input_size.width +
+				convolution.input_padding.right - convolution.kernel_size.width + 1;
+			*input_elements = convolution.input_channels * convolution.input_size.height * convolution.input_size.width;
+			*output_elements = convolution.output_channels * output_height * output_width;
+			return status;
+		}
+		case nnp_layer_type_fully_connected:
+		{
+			const struct nnp_fully_connected_layer fully_connected = layer->fully_connected;
+			if (fully_connected.prepacked_kernel) {
+				status = nnp_fully_connected_output_prepacked_with_workspace(
+					batch_size, fully_connected.input_channels, fully_connected.output_channels,
+					NULL, fully_connected.kernel, NULL, NULL,
+					nnp_activation_identity, 0.0f,
+					NULL, workspace_size,
+					NULL, NULL);
+			} else {
+				status = nnp_fully_connected_output_with_workspace(
+					batch_size, fully_connected.input_channels, fully_connected.output_channels,
+					NULL, NULL, NULL, NULL,
+					nnp_activation_identity, 0.0f,
+					NULL, workspace_size,
+					NULL, NULL);
+			}
+			*input_elements = fully_connected.input_channels;
+			*output_elements = fully_connected.output_channels;
+			return status;
+		}
+		case nnp_layer_type_max_pooling:
+		{
+			const struct nnp_max_pooling_layer max_pooling = layer->max_pooling;
+			status = validate_pooling_arguments(batch_size, max_pooling.channels,
+				max_pooling.input_size, max_pooling.input_padding,
+				max_pooling.pooling_size, max_pooling.pooling_stride);
+			if (max_pooling.channels == 0) {
+				status = nnp_status_invalid_channels;
+			}
+			const size_t output_height = divide_round_up(max_pooling.input_padding.top + max_pooling.input_size.height +
+				max_pooling.input_padding.bottom - max_pooling.pooling_size.height, max_pooling.pooling_stride.height) + 1;
+			const size_t output_width = divide_round_up(max_pooling.input_padding.left + max_pooling.input_size.width +
+				max_pooling.input_padding.right - max_pooling.pooling_size.width, max_pooling.pooling_stride.width) + 1;
+			*input_elements = max_pooling.channels * max_pooling.input_size.height * max_pooling.input_size.width;
+			*output_elements = max_pooling.channels * output_height * output_width;
+			return status;
+		}
+		case nnp_layer_type_relu:
+			*input_elements = *output_elements = layer->relu.channels;
+			return validate_relu_arguments(batch_size, layer->relu.channels);
+		case nnp_layer_type_softmax:
+			*input_elements = *output_elements = layer->softmax.channels;
+			return nnp_softmax_output_with_workspace(batch_size, layer->softmax.channels,
+				NULL, NULL,
+				NULL, workspace_size,
+				NULL);
+		default:
+			return nnp_status_invalid_layer;
+	}
+}
+
+/* ReLU and softmax layers can overwrite their input */
+static inline bool is_inplace_layer(enum nnp_layer_type type) {
+	return (type == nnp_layer_type_relu) || (type == nnp_layer_type_softmax);
+}
+
+enum nnp_status nnp_network_create(
+	size_t batch_size,
+	size_t layers_count,
+	const struct nnp_layer layers[],
+	nnp_network_t* network_out)
+{
+	struct nnp_network* network = NULL;
+	struct activation_buffer* buffers = NULL;
+	size_t* output_buffers = NULL;
+	enum nnp_status status = nnp_status_success;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (layers_count == 0) {
+		return nnp_status_invalid_layer;
+	}
+
+	network = calloc(1, sizeof(struct nnp_network));
+	if (network == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	network->batch_size = batch_size;
+	network->layers_count = layers_count;
+
+	network->layers = calloc(layers_count, sizeof(struct network_layer));
+	buffers = calloc(layers_count, sizeof(struct activation_buffer));
+	output_buffers = calloc(layers_count, sizeof(size_t));
+	if (network->layers == NULL || buffers == NULL || output_buffers == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	/* Validate layers, and assign an activation buffer to the output of every layer but the last */
+	size_t buffers_count = 0;
+	size_t previous_output_elements = 0;
+	for (size_t i = 0; i < layers_count; i++) {
+		size_t input_elements, output_elements;
+		status = analyze_layer(batch_size, &layers[i], &input_elements, &output_elements,
+			&network->layers[i].workspace_size);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		if (i != 0 && input_elements != previous_output_elements) {
+			status = nnp_status_invalid_layer;
+			goto cleanup;
+		}
+		previous_output_elements = output_elements;
+
+		network->layers[i].layer = layers[i];
+		network->workspace_size = max(network->workspace_size, network->layers[i].workspace_size);
+
+		if (i + 1 == layers_count) {
+			/* The last layer writes to the output of the network */
+			break;
+		}
+
+		if (i != 0 && is_inplace_layer(layers[i].type)) {
+			/* Keep the input buffer alive until the next layer reads the output from it */
+			output_buffers[i] = output_buffers[i - 1];
+			buffers[output_buffers[i]].last_layer = i + 1;
+		} else {
+			output_buffers[i] = buffers_count;
+			buffers[buffers_count++] = (struct activation_buffer) {
+				.size = round_up(batch_size * output_elements * sizeof(float), 64),
+				.first_layer = i,
+				.last_layer = i + 1,
+			};
+		}
+	}
+
+	network->activations_size = plan_activation_buffers(buffers_count, buffers);
+	network->memory_size = network->activations_size + network->workspace_size;
+	if (network->memory_size != 0) {
+		network->memory_block = allocate_memory(network->memory_size);
+		if (network->memory_block == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	}
+	network->workspace = network->memory_block + network->activations_size;
+
+	for (size_t i = 0; i + 1 < layers_count; i++) {
+		float* output = network->memory_block + buffers[output_buffers[i]].offset;
+		network->layers[i].output = output;
+		network->layers[i + 1].input = output;
+	}
+
+	*network_out = network;
+	network = NULL;
+
+cleanup:
+	nnp_network_destroy(network);
+	free(buffers);
+	free(output_buffers);
+	return status;
+}
+
+static enum nnp_status run_convolution_layer(
+	size_t batch_size,
+	const struct nnp_convolution_layer layer[restrict static 1],
+	const float* input,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool)
+{
+	if (layer->kernel_transform_strategy == nnp_convolution_kernel_transform_strategy_batch) {
+		return nnp_convolution_output_with_workspace(layer->algorithm,
+			batch_size, layer->input_channels, layer->output_channels,
+			layer->input_size, layer->input_padding, layer->kernel_size,
+			input, layer->kernel, layer->bias, output,
+			workspace_buffer, workspace_size,
+			threadpool, NULL);
+	}
+
+	const size_t input_elements = layer->input_channels * layer->input_size.height * layer->input_size.width;
+	const size_t output_elements = layer->output_channels *
+		(layer->input_padding.top + layer->input_size.height + layer->input_padding.bottom - layer->kernel_size.height + 1) *
+		(layer->input_padding.left + layer->input_size.width + layer->input_padding.right - layer->kernel_size.width + 1);
+	for (size_t image = 0; image < batch_size; image++) {
+		const enum nnp_status status = nnp_convolution_inference_with_workspace(
+			layer->algorithm, layer->kernel_transform_strategy,
+			layer->input_channels, layer->output_channels,
+			layer->input_size, layer->input_padding, layer->kernel_size,
+			input + image * input_elements, layer->kernel, layer->bias, output + image * output_elements,
+			workspace_buffer, workspace_size,
+			threadpool, NULL);
+		if (status != nnp_status_success) {
+			return status;
+		}
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_run(
+	nnp_network_t network,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	const size_t batch_size = network->batch_size;
+	const size_t layers_count = network->layers_count;
+	for (size_t i = 0; i < layers_count; i++) {
+		const struct network_layer* network_layer = &network->layers[i];
+		const float* layer_input = (i == 0) ? input : network_layer->input;
+		float* layer_output = (i + 1 == layers_count) ? output : network_layer->output;
+
+		/* Layers which do not need a workspace get none, so that they neither query nor allocate it */
+		void* workspace_buffer = NULL;
+		size_t workspace_size = network->workspace_size;
+		size_t* workspace_size_pointer = NULL;
+		if (network_layer->workspace_size != 0) {
+			workspace_buffer = network->workspace;
+			workspace_size_pointer = &workspace_size;
+		}
+
+		const struct nnp_layer* layer = &network_layer->layer;
+		enum nnp_status status;
+		switch (layer->type) {
+			case nnp_layer_type_convolution:
+				status = run_convolution_layer(batch_size, &layer->convolution,
+					layer_input, layer_output,
+					workspace_buffer, workspace_size_pointer,
+					threadpool);
+				break;
+			case nnp_layer_type_fully_connected:
+				if (layer->fully_connected.prepacked_kernel) {
+					status = nnp_fully_connected_output_prepacked_with_workspace(
+						batch_size, layer->fully_connected.input_channels, layer->fully_connected.output_channels,
+						layer_input, layer->fully_connected.kernel, layer->fully_connected.bias, layer_output,
+						nnp_activation_identity, 0.0f,
+						workspace_buffer, workspace_size_pointer,
+						threadpool, NULL);
+				} else {
+					status = nnp_fully_connected_output_with_workspace(
+						batch_size, layer->fully_connected.input_channels, layer->fully_connected.output_channels,
+						layer_input, layer->fully_connected.kernel, layer->fully_connected.bias, layer_output,
+						nnp_activation_identity, 0.0f,
+						workspace_buffer, workspace_size_pointer,
+						threadpool, NULL);
+				}
+				break;
+			case nnp_layer_type_max_pooling:
+				status = nnp_max_pooling_output(
+					batch_size, layer->max_pooling.channels,
+					layer->max_pooling.input_size, layer->max_pooling.input_padding,
+					layer->max_pooling.pooling_size, layer->max_pooling.pooling_stride,
+					layer_input, layer_output,
+					threadpool);
+				break;
+			case nnp_layer_type_relu:
+				status = nnp_relu_output(
+					batch_size, layer->relu.channels,
+					layer_input, layer_output,
+					layer->relu.negative_slope,
+					threadpool);
+				break;
+			case nnp_layer_type_softmax:
+				status = nnp_softmax_output_with_workspace(
+					batch_size, layer->softmax.channels,
+					layer_input, layer_output,
+					workspace_buffer, workspace_size_pointer,
+					threadpool);
+				break;
+			default:
+				NNP_UNREACHABLE;
+		}
+		if (status != nnp_status_success) {
+			return status;
+		}
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_get_memory_size(
+	nnp_network_t network,
+	size_t* activations_size,
+	size_t* workspace_size)
+{
+	if (activations_size != NULL) {
+		*activations_size = network->activations_size;
+	}
+	if (workspace_size != NULL) {
+		*workspace_size = network->workspace_size;
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_destroy(nnp_network_t network) {
+	if (network != NULL) {
+		release_memory(network->memory_block, network->memory_size);
+		free(network->layers);
+		free(network);
+	}
+	return nnp_status_success;
+}
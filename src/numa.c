@@ -0,0 +1,147 @@
+#if defined(__linux__)
+	#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+#if defined(__linux__)
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+#endif
+
+#include <nnpack/numa.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+
+#if defined(__linux__)
+	/* Preferred node policy of mbind: pages go to the node if it has free memory, and elsewhere otherwise */
+	#define NNP_MPOL_PREFERRED 1
+
+	struct numa_node {
+		/* System identifier of the node */
+		unsigned int id;
+		cpu_set_t cpus;
+	};
+
+	static struct numa_node numa_nodes[NNP_NUMA_MAX_NODES];
+	/* Whether numa_nodes were read from sysfs, rather than defaulted to a single node */
+	static bool numa_nodes_detected = false;
+#endif
+
+static size_t numa_nodes_count = 1;
+static pthread_once_t numa_init_control = PTHREAD_ONCE_INIT;
+
+#if defined(__linux__)
+/* Parses a list of CPU ranges in sysfs format, e.g. "0-7,16-23" */
+static bool parse_cpu_list(FILE* file, cpu_set_t cpus[restrict static 1]) {
+	CPU_ZERO(cpus);
+	bool empty = true;
+	unsigned int first, last;
+	while (fscanf(file, "%u", &first) == 1) {
+		last = first;
+		int separator = fgetc(file);
+		if (separator == '-') {
+			if (fscanf(file, "%u", &last) != 1) {
+				break;
+			}
+			separator = fgetc(file);
+		}
+		for (unsigned int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+			CPU_SET(cpu, cpus);
+			empty = false;
+		}
+		if (separator != ',') {
+			break;
+		}
+	}
+	return !empty;
+}
+
+static void init_numa(void) {
+	/* Node identifiers may have gaps, e.g. when nodes are offline */
+	size_t nodes_count = 0;
+	for (unsigned int id = 0; id < 64 && nodes_count < NNP_NUMA_MAX_NODES; id++) {
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", id);
+		FILE* file = fopen(path, "r");
+		if (file == NULL) {
+			continue;
+		}
+		numa_nodes[nodes_count].id = id;
+		if (parse_cpu_list(file, &numa_nodes[nodes_count].cpus)) {
+			nodes_count += 1;
+		}
+		fclose(file);
+	}
+	numa_nodes_detected = nodes_count != 0;
+	numa_nodes_count = max(nodes_count, 1);
+}
+#else
+static void init_numa(void) {
+}
+#endif
+
+size_t nnp_numa_nodes_count(void) {
+	pthread_once(&numa_init_control, init_numa);
+	return numa_nodes_count;
+}
+
+bool nnp_numa_bind_thread(size_t node) {
+#if defined(__linux__)
+	if (node >= nnp_numa_nodes_count() || numa_nodes_count == 1) {
+		return false;
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &numa_nodes[node].cpus) == 0;
+#else
+	return false;
+#endif
+}
+
+void* nnp_numa_allocate_memory(size_t memory_size) {
+#if defined(__linux__)
+	/*
+	 * Base pages only: nnp_numa_place_memory aligns ranges to the base page size, and mbind rejects ranges which are
+	 * not aligned to the pages of a MAP_HUGETLB mapping.
+	 */
+	void* memory_block = mmap(NULL, memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory_block == MAP_FAILED) {
+		return NULL;
+	}
+	return memory_block;
+#else
+	return allocate_memory(memory_size);
+#endif
+}
+
+bool nnp_numa_place_memory(void* memory, size_t memory_size, size_t node) {
+	if (node >= nnp_numa_nodes_count()) {
+		return false;
+	}
+
+#if defined(__linux__) && defined(SYS_mbind)
+	if (!numa_nodes_detected) {
+		return true;
+	}
+
+	const uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE);
+	const uintptr_t start = ((uintptr_t) memory + page_size - 1) & -page_size;
+	const uintptr_t end = ((uintptr_t) memory + memory_size) & -page_size;
+	if (start >= end) {
+		return true;
+	}
+
+	/* The kernel reads maxnode - 1 bits of the mask */
+	unsigned long node_mask = 1ul << numa_nodes[node].id;
+	return syscall(SYS_mbind, (void*) start, (unsigned long) (end - start), NNP_MPOL_PREFERRED,
+		&node_mask, (unsigned long) (sizeof(node_mask) * 8 + 1), 0u) == 0;
+#else
+	return true;
+#endif
+}
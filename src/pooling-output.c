@@ -10,6 +10,7 @@
 #include <nnpack/utils.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
 
 struct NNP_CACHE_ALIGN pooling_context {
 	nnp_pooling_function pooling_function;
@@ -24,6 +25,12 @@ struct NNP_CACHE_ALIGN pooling_context {
 	struct nnp_size pooling_stride;
 };
 
+/*
+ * General k x k stride N max pooling.
+ * Output rows are processed in tiles of 8 pixels, and the running maximum of every pool in the tile is kept in
+ * registers while the rows of the input tile are scanned. Tiles which do not touch the image boundary take a path
+ * without any bounds checks.
+ */
 static void compute_max_pooling_forward__generic(
 	const float *restrict input_pointer,
 	float *restrict output_pointer,
@@ -38,30 +45,61 @@ static void compute_max_pooling_forward__generic(
 	uint32_t pooling_height,
 	uint32_t pooling_width)
 {
+	const size_t output_tile_width = 8;
+
 	const float (*input)[input_width] = (const float(*)[input_width]) input_pointer;
 	float (*output)[output_width] = (float(*)[output_width]) output_pointer;
 
 	for (size_t y = 0; y < output_height; y++) {
-		for (size_t x = 0; x < output_width; x++) {
-			float v = -__builtin_inff();
-			for (size_t i = 0; i < pooling_height; i++) {
-				const size_t s = y * stride_height + i - padding_top;
-				if (s < input_height) {
+		const size_t input_row_start = min(doz(y * stride_height, padding_top), input_height);
+		const size_t input_row_end = min(doz(y * stride_height + pooling_height, padding_top), input_height);
+		for (size_t x = 0; x < output_width; x += output_tile_width) {
+			const size_t output_tile_columns = min(output_tile_width, output_width - x);
+			float max[output_tile_width];
+			for (size_t k = 0; k < output_tile_width; k++) {
+				max[k] = -__builtin_inff();
+			}
+
+			const bool interior_tile = (output_tile_columns == output_tile_width) &&
+				(x * stride_width >= padding_left) &&
+				((x + output_tile_width - 1) * stride_width + pooling_width <= padding_left + input_width);
+			if (interior_tile) {
+				for (size_t s = input_row_start; s < input_row_end; s++) {
+					const float* input_row = &input[s][x * stride_width - padding_left];
 					for (size_t j = 0; j < pooling_width; j++) {
-						const size_t t = x * pooling_width + j - padding_left;
-						if (t < input_width) {
-							v = maxf(input[s][t], v);
+						for (size_t k = 0; k < output_tile_width; k++) {
+							max[k] = maxf(input_row[k * stride_width + j], max[k]);
+						}
+					}
+				}
+			} else {
+				for (size_t k = 0; k < output_tile_columns; k++) {
+					const size_t input_column_start = min(doz((x + k) * stride_width, padding_left), input_width);
+					const size_t input_column_end = min(doz((x + k) * stride_width + pooling_width, padding_left), input_width);
+					for (size_t s = input_row_start; s < input_row_end; s++) {
+						for (size_t t = input_column_start; t < input_column_end; t++) {
+							max[k] = maxf(input[s][t], max[k]);
 						}
 					}
 				}
 			}
-			output[y][x] = v;
+
+			for (size_t k = 0; k < output_tile_columns; k++) {
+				output[y][x + k] = max[k];
+			}
 		}
 	}
 }
 
-#if NNP_ARCH_X86_64
-static void compute_max_pooling_forward_2x2_2x2__avx2(
+/*
+ * Max pooling with a SIMD micro-kernel, which computes one row of up to output_tile_width pooled pixels.
+ * Micro-kernel gets a pointer to the first non-padding element of the input tile, and the number of padding rows and
+ * columns which precede it in the tile.
+ */
+static inline void compute_max_pooling_forward_tiled(
+	nnp_maxpool_function maxpool,
+	struct nnp_size input_tile,
+	size_t output_tile_width,
 	const float *restrict input_pointer,
 	float *restrict output_pointer,
 	size_t input_height,
@@ -71,33 +109,21 @@ static void compute_max_pooling_forward_2x2_2x2__avx2(
 	size_t output_height,
 	size_t output_width,
 	uint32_t stride_height,
-	uint32_t stride_width,
-	uint32_t pooling_height,
-	uint32_t pooling_width)
+	uint32_t stride_width)
 {
-	const struct nnp_size output_tile = {
-		.height = 1,
-		.width  = 8
-	};
-	const struct nnp_size input_tile = {
-		.height =  2,
-		.width  = 16,
-	};
-
 	const float (*input)[input_width] = (const float(*)[input_width]) input_pointer;
 	float (*output)[output_width] = (float(*)[output_width]) output_pointer;
 
-	for (size_t y = 0; y < output_height; y += output_tile.height) {
+	for (size_t y = 0; y < output_height; y++) {
 		const size_t input_y = min(doz(y * stride_height, padding_top), input_height);
-		const size_t input_row_offset = doz(padding_top, y);
+		const size_t input_row_offset = doz(padding_top, y * stride_height);
 		const size_t input_row_count = min(input_tile.height, doz(input_height, input_y));
-		const size_t output_row_count = min(output_tile.height, output_height - y);
-		for (size_t x = 0; x < output_width; x += output_tile.width) {
+		for (size_t x = 0; x < output_width; x += output_tile_width) {
 			const size_t input_x = min(doz(x * stride_width, padding_left), input_width);
-			const size_t input_column_offset = doz(padding_left, x);
+			const size_t input_column_offset = doz(padding_left, x * stride_width);
 			const size_t input_column_count = min(input_tile.width, doz(input_width, input_x));
-			const size_t output_column_count = min(output_tile.width, output_width - x);
-			nnp_maxpool_2x2_2x2__avx2(
+			const size_t output_column_count = min(output_tile_width, output_width - x);
+			maxpool(
 				&input[input_y][input_x],
 				&output[y][x],
 				input_width,
@@ -109,6 +135,151 @@ static void compute_max_pooling_forward_2x2_2x2__avx2(
 		}
 	}
 }
+
+#if NNP_ARCH_X86_64
+static void compute_max_pooling_forward_2x2_2x2__avx2(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height =  2,
+		.width  = 16,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_2x2_2x2__avx2, input_tile, 8,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
+
+static void compute_max_pooling_forward_3x3_2x2__avx2(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height =  3,
+		.width  = 17,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_3x3_2x2__avx2, input_tile, 8,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
+
+static void compute_max_pooling_forward_3x3_1x1__avx2(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height =  3,
+		.width  = 10,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_3x3_1x1__avx2, input_tile, 8,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
+#elif NNP_ARCH_PSIMD
+static void compute_max_pooling_forward_2x2_2x2__psimd(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height = 2,
+		.width  = 8,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_2x2_2x2__psimd, input_tile, 4,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
+
+static void compute_max_pooling_forward_3x3_2x2__psimd(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height = 3,
+		.width  = 9,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_3x3_2x2__psimd, input_tile, 4,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
+
+static void compute_max_pooling_forward_3x3_1x1__psimd(
+	const float *restrict input_pointer,
+	float *restrict output_pointer,
+	size_t input_height,
+	size_t input_width,
+	size_t padding_top,
+	size_t padding_left,
+	size_t output_height,
+	size_t output_width,
+	uint32_t stride_height,
+	uint32_t stride_width,
+	uint32_t pooling_height,
+	uint32_t pooling_width)
+{
+	const struct nnp_size input_tile = {
+		.height = 3,
+		.width  = 6,
+	};
+	compute_max_pooling_forward_tiled(nnp_maxpool_3x3_1x1__psimd, input_tile, 4,
+		input_pointer, output_pointer,
+		input_height, input_width, padding_top, padding_left,
+		output_height, output_width, stride_height, stride_width);
+}
 #endif
 
 static void compute_pooling_output(
@@ -167,22 +338,555 @@ enum nnp_status nnp_max_pooling_output(
 		.input_pointer = input,
 		.output_pointer = output,
 		.input_size = input_size,
+		.input_padding = input_padding,
 		.output_size = output_size,
 		.pooling_size = pooling_size,
 		.pooling_stride = pooling_stride,
 		.pooling_function = compute_max_pooling_forward__generic,
 	};
 
-	#if NNP_ARCH_X86_64
-	if ((pooling_stride.height == 2) && (pooling_stride.width == 2) && (pooling_size.height == 2) && (pooling_size.width == 2)) {
+	if ((pooling_size.height == 2) && (pooling_size.width == 2) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
 		pooling_context.pooling_function = compute_max_pooling_forward_2x2_2x2__avx2;
+#elif NNP_ARCH_PSIMD
+		pooling_context.pooling_function = compute_max_pooling_forward_2x2_2x2__psimd;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
+		pooling_context.pooling_function = compute_max_pooling_forward_3x3_2x2__avx2;
+#elif NNP_ARCH_PSIMD
+		pooling_context.pooling_function = compute_max_pooling_forward_3x3_2x2__psimd;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 1) && (pooling_stride.width == 1)) {
+#if NNP_ARCH_X86_64
+		pooling_context.pooling_function = compute_max_pooling_forward_3x3_1x1__avx2;
+#elif NNP_ARCH_PSIMD
+		pooling_context.pooling_function = compute_max_pooling_forward_3x3_1x1__psimd;
+#endif
 	}
-	#endif
 
-	pthreadpool_compute_2d(threadpool,
+	nnp_compute_2d(threadpool,
 		(pthreadpool_function_2d_t) compute_pooling_output,
 		&pooling_context,
 		batch_size, channels);
 
 	return nnp_status_success;
 }
+
+struct NNP_CACHE_ALIGN max_pooling_mask_context {
+	nnp_maxpool_mask_function maxpool_mask;
+	struct nnp_size input_tile;
+	size_t output_tile_width;
+	const float* input_pointer;
+	float* output_pointer;
+	uint8_t* mask_pointer;
+
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size output_size;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+};
+
+static void compute_max_pooling_output_with_mask(
+	const struct max_pooling_mask_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const nnp_maxpool_mask_function maxpool_mask = context->maxpool_mask;
+	const struct nnp_size input_tile             = context->input_tile;
+	const size_t output_tile_width               = context->output_tile_width;
+	const size_t channels                        = context->channels;
+	const struct nnp_size input_size             = context->input_size;
+	const struct nnp_padding input_padding       = context->input_padding;
+	const struct nnp_size output_size            = context->output_size;
+	const struct nnp_size pooling_size           = context->pooling_size;
+	const struct nnp_size pooling_stride         = context->pooling_stride;
+
+	const float (*input)[channels][input_size.height][input_size.width] =
+		(const float(*)[channels][input_size.height][input_size.width]) context->input_pointer;
+	float (*output)[channels][output_size.height][output_size.width] =
+		(float(*)[channels][output_size.height][output_size.width]) context->output_pointer;
+	uint8_t (*mask)[channels][output_size.height][output_size.width] =
+		(uint8_t(*)[channels][output_size.height][output_size.width]) context->mask_pointer;
+
+	for (size_t y = 0; y < output_size.height; y++) {
+		const size_t input_y = min(doz(y * pooling_stride.height, input_padding.top), input_size.height);
+		const size_t input_row_offset = doz(input_padding.top, y * pooling_stride.height);
+		const size_t input_row_end = min(doz(y * pooling_stride.height + pooling_size.height, input_padding.top), input_size.height);
+		for (size_t x = 0; x < output_size.width; x += output_tile_width) {
+			const size_t output_column_count = min(output_tile_width, output_size.width - x);
+			const size_t input_x = min(doz(x * pooling_stride.width, input_padding.left), input_size.width);
+			if (maxpool_mask != NULL) {
+				const size_t input_column_offset = doz(input_padding.left, x * pooling_stride.width);
+				const size_t input_row_count = min(input_tile.height, input_size.height - input_y);
+				const size_t input_column_count = min(input_tile.width, input_size.width - input_x);
+				maxpool_mask(
+					&input[sample][channel][input_y][input_x],
+					&output[sample][channel][y][x],
+					&mask[sample][channel][y][x],
+					input_size.width,
+					input_row_offset,
+					input_row_count,
+					input_column_offset,
+					input_column_count,
+					output_column_count);
+			} else {
+				for (size_t k = 0; k < output_column_count; k++) {
+					/* Coordinates of the top-left corner of the pool in the padded image */
+					const size_t pool_y = y * pooling_stride.height;
+					const size_t pool_x = (x + k) * pooling_stride.width;
+					const size_t input_column_start = min(doz(pool_x, input_padding.left), input_size.width);
+					const size_t input_column_end = min(doz(pool_x + pooling_size.width, input_padding.left), input_size.width);
+					float max = -__builtin_inff();
+					size_t index = 0;
+					for (size_t s = input_y; s < input_row_end; s++) {
+						for (size_t t = input_column_start; t < input_column_end; t++) {
+							if (input[sample][channel][s][t] > max) {
+								max = input[sample][channel][s][t];
+								index = (s + input_padding.top - pool_y) * pooling_size.width + (t + input_padding.left - pool_x);
+							}
+						}
+					}
+					output[sample][channel][y][x + k] = max;
+					mask[sample][channel][y][x + k] = (uint8_t) index;
+				}
+			}
+		}
+	}
+}
+
+enum nnp_status nnp_max_pooling_output_with_mask(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	uint8_t mask[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_pooling_arguments(
+		batch_size, channels,
+		input_size, input_padding,
+		pooling_size, pooling_stride);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* Index within the pool must fit into uint8_t */
+	if (pooling_size.height * pooling_size.width > 256) {
+		return nnp_status_unsupported_pooling_size;
+	}
+
+	const struct nnp_size output_size = {
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
+	};
+
+	struct max_pooling_mask_context max_pooling_mask_context = {
+		.maxpool_mask = NULL,
+		.output_tile_width = 8,
+		.input_pointer = input,
+		.output_pointer = output,
+		.mask_pointer = mask,
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.output_size = output_size,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+	};
+
+	if ((pooling_size.height == 2) && (pooling_size.width == 2) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_2x2_2x2_mask__avx2;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 2, .width = 16 };
+		max_pooling_mask_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_2x2_2x2_mask__psimd;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 2, .width = 8 };
+		max_pooling_mask_context.output_tile_width = 4;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_3x3_2x2_mask__avx2;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 3, .width = 17 };
+		max_pooling_mask_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_3x3_2x2_mask__psimd;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 3, .width = 9 };
+		max_pooling_mask_context.output_tile_width = 4;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 1) && (pooling_stride.width == 1)) {
+#if NNP_ARCH_X86_64
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_3x3_1x1_mask__avx2;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 3, .width = 10 };
+		max_pooling_mask_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		max_pooling_mask_context.maxpool_mask = nnp_maxpool_3x3_1x1_mask__psimd;
+		max_pooling_mask_context.input_tile = (struct nnp_size) { .height = 3, .width = 6 };
+		max_pooling_mask_context.output_tile_width = 4;
+#endif
+	}
+
+	nnp_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_max_pooling_output_with_mask,
+		&max_pooling_mask_context,
+		batch_size, channels);
+
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN max_pooling_input_gradient_context {
+	const float* grad_output_pointer;
+	const uint8_t* mask_pointer;
+	float* grad_input_pointer;
+
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size output_size;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+};
+
+static void compute_max_pooling_input_gradient(
+	const struct max_pooling_input_gradient_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels                  = context->channels;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size output_size      = context->output_size;
+	const struct nnp_size pooling_size     = context->pooling_size;
+	const struct nnp_size pooling_stride   = context->pooling_stride;
+
+	const float (*grad_output)[channels][output_size.height][output_size.width] =
+		(const float(*)[channels][output_size.height][output_size.width]) context->grad_output_pointer;
+	const uint8_t (*mask)[channels][output_size.height][output_size.width] =
+		(const uint8_t(*)[channels][output_size.height][output_size.width]) context->mask_pointer;
+	float (*grad_input)[channels][input_size.height][input_size.width] =
+		(float(*)[channels][input_size.height][input_size.width]) context->grad_input_pointer;
+
+	/* Each task owns one channel of one image, so overlapping pools can accumulate without synchronization */
+	memset(grad_input[sample][channel], 0, input_size.height * input_size.width * sizeof(float));
+	for (size_t y = 0; y < output_size.height; y++) {
+		for (size_t x = 0; x < output_size.width; x++) {
+			const size_t index = mask[sample][channel][y][x];
+			const size_t i = index / pooling_size.width;
+			const size_t j = index % pooling_size.width;
+			/* Unsigned comparison also rejects pools which lie in the top or left padding */
+			const size_t s = y * pooling_stride.height + i - input_padding.top;
+			const size_t t = x * pooling_stride.width + j - input_padding.left;
+			if ((s < input_size.height) && (t < input_size.width)) {
+				grad_input[sample][channel][s][t] += grad_output[sample][channel][y][x];
+			}
+		}
+	}
+}
+
+enum nnp_status nnp_max_pooling_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float grad_output[],
+	const uint8_t mask[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_pooling_arguments(
+		batch_size, channels,
+		input_size, input_padding,
+		pooling_size, pooling_stride);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	if (pooling_size.height * pooling_size.width > 256) {
+		return nnp_status_unsupported_pooling_size;
+	}
+
+	const struct nnp_size output_size = {
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
+	};
+
+	struct max_pooling_input_gradient_context max_pooling_input_gradient_context = {
+		.grad_output_pointer = grad_output,
+		.mask_pointer = mask,
+		.grad_input_pointer = grad_input,
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.output_size = output_size,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+	};
+	nnp_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_max_pooling_input_gradient,
+		&max_pooling_input_gradient_context,
+		batch_size, channels);
+
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN average_pooling_context {
+	nnp_avgpool_function avgpool;
+	struct nnp_size input_tile;
+	size_t output_tile_width;
+	const float* input_pointer;
+	float* output_pointer;
+
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size output_size;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+	enum nnp_pooling_padding_mode padding_mode;
+};
+
+/*
+ * Returns the number of pixels along one dimension which are counted in the divisor of a pool.
+ * The pool starts at pool_start in the coordinates of the padded image.
+ */
+static inline size_t get_average_pooling_extent(
+	size_t pool_start, size_t pool_size,
+	size_t padding_before, size_t input_size, size_t padding_after,
+	enum nnp_pooling_padding_mode padding_mode)
+{
+	switch (padding_mode) {
+		case nnp_pooling_padding_mode_include:
+			return doz(min(pool_start + pool_size, padding_before + input_size + padding_after), pool_start);
+		case nnp_pooling_padding_mode_exclude:
+			return doz(min(pool_start + pool_size, padding_before + input_size), max(pool_start, padding_before));
+	}
+	return 0;
+}
+
+static void compute_average_pooling_output(
+	const struct average_pooling_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const nnp_avgpool_function avgpool               = context->avgpool;
+	const struct nnp_size input_tile                 = context->input_tile;
+	const size_t output_tile_width                   = context->output_tile_width;
+	const size_t channels                            = context->channels;
+	const struct nnp_size input_size                 = context->input_size;
+	const struct nnp_padding input_padding           = context->input_padding;
+	const struct nnp_size output_size                = context->output_size;
+	const struct nnp_size pooling_size               = context->pooling_size;
+	const struct nnp_size pooling_stride             = context->pooling_stride;
+	const enum nnp_pooling_padding_mode padding_mode = context->padding_mode;
+
+	const float (*input)[channels][input_size.height][input_size.width] =
+		(const float(*)[channels][input_size.height][input_size.width]) context->input_pointer;
+	float (*output)[channels][output_size.height][output_size.width] =
+		(float(*)[channels][output_size.height][output_size.width]) context->output_pointer;
+
+	for (size_t y = 0; y < output_size.height; y++) {
+		const size_t row_extent = get_average_pooling_extent(
+			y * pooling_stride.height, pooling_size.height,
+			input_padding.top, input_size.height, input_padding.bottom,
+			padding_mode);
+		const size_t input_y = min(doz(y * pooling_stride.height, input_padding.top), input_size.height);
+		const size_t input_row_offset = doz(input_padding.top, y * pooling_stride.height);
+		const size_t input_row_end = min(doz(y * pooling_stride.height + pooling_size.height, input_padding.top), input_size.height);
+		for (size_t x = 0; x < output_size.width; x += output_tile_width) {
+			const size_t output_column_count = min(output_tile_width, output_size.width - x);
+
+			/* Reciprocals of pool divisors. Pools without any counted pixels produce zeroes. */
+			float scale[8] = { 0.0f };
+			for (size_t k = 0; k < output_column_count; k++) {
+				const size_t column_extent = get_average_pooling_extent(
+					(x + k) * pooling_stride.width, pooling_size.width,
+					input_padding.left, input_size.width, input_padding.right,
+					padding_mode);
+				const size_t divisor = row_extent * column_extent;
+				if (divisor != 0) {
+					scale[k] = 1.0f / (float) divisor;
+				}
+			}
+
+			const size_t input_x = min(doz(x * pooling_stride.width, input_padding.left), input_size.width);
+			if (avgpool != NULL) {
+				const size_t input_column_offset = doz(input_padding.left, x * pooling_stride.width);
+				const size_t input_row_count = min(input_tile.height, input_size.height - input_y);
+				const size_t input_column_count = min(input_tile.width, input_size.width - input_x);
+				avgpool(
+					&input[sample][channel][input_y][input_x],
+					&output[sample][channel][y][x],
+					input_size.width,
+					input_row_offset,
+					input_row_count,
+					input_column_offset,
+					input_column_count,
+					output_column_count,
+					scale);
+			} else {
+				for (size_t k = 0; k < output_column_count; k++) {
+					const size_t input_column_start = min(doz((x + k) * pooling_stride.width, input_padding.left), input_size.width);
+					const size_t input_column_end = min(doz((x + k) * pooling_stride.width + pooling_size.width, input_padding.left), input_size.width);
+					float sum = 0.0f;
+					for (size_t s = input_y; s < input_row_end; s++) {
+						for (size_t t = input_column_start; t < input_column_end; t++) {
+							sum += input[sample][channel][s][t];
+						}
+					}
+					output[sample][channel][y][x + k] = sum * scale[k];
+				}
+			}
+		}
+	}
+}
+
+enum nnp_status nnp_average_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	enum nnp_pooling_padding_mode padding_mode,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_pooling_arguments(
+		batch_size, channels,
+		input_size, input_padding,
+		pooling_size, pooling_stride);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	switch (padding_mode) {
+		case nnp_pooling_padding_mode_include:
+		case nnp_pooling_padding_mode_exclude:
+			break;
+		default:
+			return nnp_status_invalid_pooling_padding_mode;
+	}
+
+	const struct nnp_size output_size = {
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
+	};
+
+	struct average_pooling_context average_pooling_context = {
+		.avgpool = NULL,
+		.output_tile_width = 8,
+		.input_pointer = input,
+		.output_pointer = output,
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.output_size = output_size,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+		.padding_mode = padding_mode,
+	};
+
+	if ((pooling_size.height == 2) && (pooling_size.width == 2) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
+		average_pooling_context.avgpool = nnp_avgpool_2x2_2x2__avx2;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 2, .width = 16 };
+		average_pooling_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		average_pooling_context.avgpool = nnp_avgpool_2x2_2x2__psimd;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 2, .width = 8 };
+		average_pooling_context.output_tile_width = 4;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 2) && (pooling_stride.width == 2)) {
+#if NNP_ARCH_X86_64
+		average_pooling_context.avgpool = nnp_avgpool_3x3_2x2__avx2;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 3, .width = 17 };
+		average_pooling_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		average_pooling_context.avgpool = nnp_avgpool_3x3_2x2__psimd;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 3, .width = 9 };
+		average_pooling_context.output_tile_width = 4;
+#endif
+	} else if ((pooling_size.height == 3) && (pooling_size.width == 3) && (pooling_stride.height == 1) && (pooling_stride.width == 1)) {
+#if NNP_ARCH_X86_64
+		average_pooling_context.avgpool = nnp_avgpool_3x3_1x1__avx2;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 3, .width = 10 };
+		average_pooling_context.output_tile_width = 8;
+#elif NNP_ARCH_PSIMD
+		average_pooling_context.avgpool = nnp_avgpool_3x3_1x1__psimd;
+		average_pooling_context.input_tile = (struct nnp_size) { .height = 3, .width = 6 };
+		average_pooling_context.output_tile_width = 4;
+#endif
+	}
+
+	nnp_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_average_pooling_output,
+		&average_pooling_context,
+		batch_size, channels);
+
+	return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN global_average_pooling_context {
+	nnp_sum_function sum;
+	size_t channels;
+	size_t image_size;
+	float scale;
+	const float* input_pointer;
+	float* output_pointer;
+};
+
+static void compute_global_average_pooling_output(
+	const struct global_average_pooling_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const nnp_sum_function sum = context->sum;
+	const size_t channels      = context->channels;
+	const size_t image_size    = context->image_size;
+	const float scale          = context->scale;
+
+	const float (*input)[channels][image_size] = (const float(*)[channels][image_size]) context->input_pointer;
+	float (*output)[channels] = (float(*)[channels]) context->output_pointer;
+
+	output[sample][channel] = sum(image_size, input[sample][channel]) * scale;
+}
+
+enum nnp_status nnp_global_average_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_global_pooling_arguments(batch_size, channels, input_size);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t image_size = input_size.height * input_size.width;
+	struct global_average_pooling_context global_average_pooling_context = {
+#if NNP_ARCH_X86_64
+		.sum = nnp_ssum__avx2,
+#elif NNP_ARCH_PSIMD
+		.sum = nnp_ssum__psimd,
+#endif
+		.channels = channels,
+		.image_size = image_size,
+		.scale = 1.0f / (float) image_size,
+		.input_pointer = input,
+		.output_pointer = output,
+	};
+	nnp_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_global_average_pooling_output,
+		&global_average_pooling_context,
+		batch_size, channels);
+
+	return nnp_status_success;
+}
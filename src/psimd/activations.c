@@ -0,0 +1,314 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack/simd.h>
+#include <psimd/exp.h>
+
+
+#define SELU_ALPHA 0x1.AC5AFAp+0f
+#define SELU_LAMBDA 0x1.0CFABEp+0f
+#define GELU_SQRT_2_OVER_PI 0x1.988454p-1f
+#define GELU_CUBIC_COEFFICIENT 0x1.6E4E26p-5f
+
+static inline v4f v4f_abs(v4f x) {
+	return v4f_andi(x, v4i_splat(0x7FFFFFFF));
+}
+
+/*
+ * Computes exp(x) - 1 for non-positive x.
+ * Near zero exp(x) - 1 loses precision to cancellation, and a Taylor polynomial of degree 8 is used instead.
+ */
+static inline v4f v4f_expm1_nonpositive(v4f x) {
+	const v4f c2 = v4f_splat(0x1.000000p-1f);
+	const v4f c3 = v4f_splat(0x1.555556p-3f);
+	const v4f c4 = v4f_splat(0x1.555556p-5f);
+	const v4f c5 = v4f_splat(0x1.111112p-7f);
+	const v4f c6 = v4f_splat(0x1.6C16C2p-10f);
+	const v4f c7 = v4f_splat(0x1.A01A02p-13f);
+	const v4f c8 = v4f_splat(0x1.A01A02p-16f);
+
+	const v4f p = x + x * x * (c2 + x * (c3 + x * (c4 + x * (c5 + x * (c6 + x * (c7 + x * c8))))));
+	const v4f e = v4f_exp(x) - v4f_splat(1.0f);
+	return v4f_blend(x < v4f_splat(-0.5f), e, p);
+}
+
+/*
+ * Computes sigmoid(x) and sigmoid'(x) = sigmoid(x) * sigmoid(-x) without overflow in the exponent:
+ * with e = exp(-|x|) and r = 1 / (1 + e), sigmoid(|x|) = r, sigmoid(-|x|) = e * r.
+ */
+static inline v4f v4f_sigmoid(v4f x, v4f derivative[restrict static 1]) {
+	const v4f e = v4f_exp(-v4f_abs(x));
+	const v4f r = v4f_splat(1.0f) / (v4f_splat(1.0f) + e);
+	const v4f er = e * r;
+	*derivative = er * r;
+	return v4f_signblend(x, er, r);
+}
+
+/*
+ * Computes tanh(x) and tanh'(x) = 1 - tanh(x)^2 via m = expm1(-2|x|):
+ * tanh(|x|) = -m / (2 + m) and tanh'(x) = 4 (1 + m) / (2 + m)^2.
+ */
+static inline v4f v4f_tanh(v4f x, v4f derivative[restrict static 1]) {
+	const v4f m = v4f_expm1_nonpositive(v4f_splat(-2.0f) * v4f_abs(x));
+	const v4f r = v4f_splat(1.0f) / (v4f_splat(2.0f) + m);
+	const v4f t = -m * r;
+	*derivative = v4f_splat(4.0f) * (v4f_splat(1.0f) + m) * r * r;
+	return v4f_signblend(x, -t, t);
+}
+
+static inline v4f v4f_elu(v4f x, v4f alpha) {
+	return v4f_blend(x > v4f_zero(), x, alpha * v4f_expm1_nonpositive(v4f_min(x, v4f_zero())));
+}
+
+static inline v4f v4f_grad_elu(v4f grad_output, v4f x, v4f alpha) {
+	return v4f_blend(x > v4f_zero(), grad_output, grad_output * alpha * v4f_exp(v4f_min(x, v4f_zero())));
+}
+
+/*
+ * GELU (tanh approximation): 0.5 x (1 + tanh(u)) = x sigmoid(2u), where u = sqrt(2/pi) (x + 0.044715 x^3).
+ */
+static inline v4f v4f_gelu(v4f x, v4f derivative[restrict static 1]) {
+	const v4f x2 = x * x;
+	const v4f two_u = v4f_splat(2.0f * GELU_SQRT_2_OVER_PI) * x * (v4f_splat(1.0f) + v4f_splat(GELU_CUBIC_COEFFICIENT) * x2);
+	const v4f two_du = v4f_splat(2.0f * GELU_SQRT_2_OVER_PI) * (v4f_splat(1.0f) + v4f_splat(3.0f * GELU_CUBIC_COEFFICIENT) * x2);
+	v4f sigmoid_derivative;
+	const v4f s = v4f_sigmoid(two_u, &sigmoid_derivative);
+	*derivative = s + x * sigmoid_derivative * two_du;
+	return x * s;
+}
+
+/*
+ * Swish: x sigmoid(x), with derivative sigmoid(x) + x sigmoid'(x).
+ */
+static inline v4f v4f_swish(v4f x, v4f derivative[restrict static 1]) {
+	v4f sigmoid_derivative;
+	const v4f s = v4f_sigmoid(x, &sigmoid_derivative);
+	*derivative = s + x * sigmoid_derivative;
+	return x * s;
+}
+
+void nnp_sigmoid_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_st(output, v4f_sigmoid(v4f_ld(input), &derivative));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_sigmoid_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_sigmoid(v4f_ld(input), &derivative);
+		v4f_st(grad_input, v4f_ld(grad_output) * derivative);
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
+
+void nnp_tanh_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_st(output, v4f_tanh(v4f_ld(input), &derivative));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_tanh_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_tanh(v4f_ld(input), &derivative);
+		v4f_st(grad_input, v4f_ld(grad_output) * derivative);
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
+
+void nnp_elu_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	const v4f vec_alpha = v4f_splat(alpha);
+
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f_st(output, v4f_elu(v4f_ld(input), vec_alpha));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_elu_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	const v4f vec_alpha = v4f_splat(alpha);
+
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f_st(grad_input, v4f_grad_elu(v4f_ld(grad_output), v4f_ld(input), vec_alpha));
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
+
+void nnp_selu_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	const v4f vec_alpha = v4f_splat(SELU_ALPHA);
+	const v4f vec_lambda = v4f_splat(SELU_LAMBDA);
+
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f_st(output, vec_lambda * v4f_elu(v4f_ld(input), vec_alpha));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_selu_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	const v4f vec_alpha = v4f_splat(SELU_ALPHA);
+	const v4f vec_lambda = v4f_splat(SELU_LAMBDA);
+
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f_st(grad_input, v4f_grad_elu(vec_lambda * v4f_ld(grad_output), v4f_ld(input), vec_alpha));
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
+
+void nnp_gelu_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_st(output, v4f_gelu(v4f_ld(input), &derivative));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_gelu_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_gelu(v4f_ld(input), &derivative);
+		v4f_st(grad_input, v4f_ld(grad_output) * derivative);
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
+
+void nnp_swish_forward__psimd(
+	const float input[static 4],
+	float output[static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_st(output, v4f_swish(v4f_ld(input), &derivative));
+
+		input  += 4;
+		output += 4;
+		length -= 4;
+	} while (length != 0);
+}
+
+void nnp_swish_backward__psimd(
+	const float grad_output[restrict static 4],
+	const float input[restrict static 4],
+	float grad_input[restrict static 4],
+	size_t length,
+	float alpha)
+{
+	/* Length is always non-zero and proportional to SIMD width */
+	do {
+		v4f derivative;
+		v4f_swish(v4f_ld(input), &derivative);
+		v4f_st(grad_input, v4f_ld(grad_output) * derivative);
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+		length      -= 4;
+	} while (length != 0);
+}
@@ -0,0 +1,150 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/simd.h>
+
+
+/*
+ * Loads 4 elements of the input tile row, starting at the specified column of the tile.
+ * Elements in columns outside of [column_start, column_end) are set to zero.
+ * Element in column_start of the tile is stored at row[0].
+ */
+static inline v4f v4f_ld_avgpool(const float row[restrict static 1], uint32_t column_start, uint32_t column_end, uint32_t column) {
+	if ((column >= column_start) && (column + 4 <= column_end)) {
+		return v4f_ld(row + (column - column_start));
+	} else {
+		v4f result = v4f_zero();
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			if ((column + lane >= column_start) && (column + lane < column_end)) {
+				result[lane] = row[column + lane - column_start];
+			}
+		}
+		return result;
+	}
+}
+
+static inline void v4f_st_avgpool(float dst[restrict static 1], v4f value, uint32_t dst_column_count) {
+	if (dst_column_count >= 4) {
+		v4f_st(dst, value);
+	} else {
+		for (uint32_t lane = 0; lane < dst_column_count; lane++) {
+			dst[lane] = value[lane];
+		}
+	}
+}
+
+/*
+ * Computes element-wise sum of the input tile rows.
+ * Rows outside of [src_row_offset, src_row_offset + src_row_count) contribute zeroes.
+ */
+static inline void avgpool_rows(
+	const float* src, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count,
+	uint32_t pool_height, size_t vectors, const uint32_t column_offsets[restrict static 1], v4f sum[restrict static 1])
+{
+	const uint32_t src_column_end = src_column_offset + src_column_count;
+	for (size_t vector = 0; vector < vectors; vector++) {
+		sum[vector] = v4f_zero();
+	}
+	for (uint32_t row = 0; row < pool_height; row++) {
+		/* Unsigned comparison also rejects rows above the first loaded row */
+		const uint32_t src_row = row - src_row_offset;
+		if (src_row < src_row_count) {
+			const float* src_row_pointer = src + src_row * src_stride;
+			for (size_t vector = 0; vector < vectors; vector++) {
+				sum[vector] += v4f_ld_avgpool(src_row_pointer, src_column_offset, src_column_end, column_offsets[vector]);
+			}
+		}
+	}
+}
+
+void nnp_avgpool_2x2_2x2__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count,
+	const float dst_scale[restrict static 4])
+{
+	static const uint32_t column_offsets[2] = { 0, 4 };
+	v4f sum[2];
+	avgpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		2, 2, column_offsets, sum);
+
+	/* De-interleave the first and the second element of every pool */
+	const v4f even = __builtin_shufflevector(sum[0], sum[1], 0, 2, 4, 6);
+	const v4f odd  = __builtin_shufflevector(sum[0], sum[1], 1, 3, 5, 7);
+	v4f_st_avgpool(dst_pointer, (even + odd) * v4f_ld(dst_scale), dst_column_count);
+}
+
+void nnp_avgpool_3x3_2x2__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count,
+	const float dst_scale[restrict static 4])
+{
+	static const uint32_t column_offsets[4] = { 0, 4, 2, 6 };
+	v4f sum[4];
+	avgpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		3, 4, column_offsets, sum);
+
+	/* De-interleave the first, the second, and the third element of every pool */
+	const v4f even = __builtin_shufflevector(sum[0], sum[1], 0, 2, 4, 6);
+	const v4f odd  = __builtin_shufflevector(sum[0], sum[1], 1, 3, 5, 7);
+	const v4f next = __builtin_shufflevector(sum[2], sum[3], 0, 2, 4, 6);
+	v4f_st_avgpool(dst_pointer, (even + odd + next) * v4f_ld(dst_scale), dst_column_count);
+}
+
+void nnp_avgpool_3x3_1x1__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count,
+	const float dst_scale[restrict static 4])
+{
+	static const uint32_t column_offsets[3] = { 0, 1, 2 };
+	v4f sum[3];
+	avgpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		3, 3, column_offsets, sum);
+
+	v4f_st_avgpool(dst_pointer, (sum[0] + sum[1] + sum[2]) * v4f_ld(dst_scale), dst_column_count);
+}
+
+float nnp_ssum__psimd(
+	size_t n,
+	const float v[restrict static 1])
+{
+	v4f vsum0 = v4f_zero(), vsum1 = v4f_zero(), vsum2 = v4f_zero(), vsum3 = v4f_zero();
+	for (; n >= 16; n -= 16) {
+		vsum0 += v4f_ld(v +  0);
+		vsum1 += v4f_ld(v +  4);
+		vsum2 += v4f_ld(v +  8);
+		vsum3 += v4f_ld(v + 12);
+		v += 16;
+	}
+	vsum0 = (vsum0 + vsum1) + (vsum2 + vsum3);
+	for (; n >= 4; n -= 4) {
+		vsum0 += v4f_ld(v);
+		v += 4;
+	}
+	float sum = v4f_reduce_sum(vsum0);
+	while (n--) {
+		sum += *v++;
+	}
+	return sum;
+}
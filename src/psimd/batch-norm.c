@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack/simd.h>
+#include <nnpack/batch-norm.h>
+
+
+void nnp_batch_norm_moments__psimd(
+	size_t length,
+	const float input[restrict static 1],
+	float shift,
+	float moments[restrict static 2])
+{
+	const v4f vec_shift = v4f_splat(shift);
+	v4f vec_sum = v4f_zero(), vec_sum_squares = v4f_zero();
+	for (; length >= 4; length -= 4) {
+		const v4f x = v4f_ld(input) - vec_shift;
+		vec_sum += x;
+		vec_sum_squares += x * x;
+
+		input += 4;
+	}
+	float sum = v4f_reduce_sum(vec_sum), sum_squares = v4f_reduce_sum(vec_sum_squares);
+	for (; length != 0; length -= 1) {
+		const float x = *input++ - shift;
+		sum += x;
+		sum_squares += x * x;
+	}
+	moments[0] = sum;
+	moments[1] = sum_squares;
+}
+
+void nnp_batch_norm_affine__psimd(
+	size_t length,
+	const float input[static 1],
+	float output[static 1],
+	float mean,
+	float scale,
+	float bias)
+{
+	const v4f vec_mean = v4f_splat(mean);
+	const v4f vec_scale = v4f_splat(scale);
+	const v4f vec_bias = v4f_splat(bias);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, (v4f_ld(input) - vec_mean) * vec_scale + vec_bias);
+
+		input  += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = (*input++ - mean) * scale + bias;
+	}
+}
+
+void nnp_batch_norm_gradient_moments__psimd(
+	size_t length,
+	const float grad_output[restrict static 1],
+	const float input[restrict static 1],
+	float mean,
+	float moments[restrict static 2])
+{
+	const v4f vec_mean = v4f_splat(mean);
+	v4f vec_sum = v4f_zero(), vec_sum_products = v4f_zero();
+	for (; length >= 4; length -= 4) {
+		const v4f dy = v4f_ld(grad_output);
+		vec_sum += dy;
+		vec_sum_products += dy * (v4f_ld(input) - vec_mean);
+
+		grad_output += 4;
+		input       += 4;
+	}
+	float sum = v4f_reduce_sum(vec_sum), sum_products = v4f_reduce_sum(vec_sum_products);
+	for (; length != 0; length -= 1) {
+		const float dy = *grad_output++;
+		sum += dy;
+		sum_products += dy * (*input++ - mean);
+	}
+	moments[0] = sum;
+	moments[1] = sum_products;
+}
+
+void nnp_batch_norm_gradient__psimd(
+	size_t length,
+	const float grad_output[restrict static 1],
+	const float input[restrict static 1],
+	float grad_input[restrict static 1],
+	float mean,
+	float grad_output_scale,
+	float input_scale,
+	float bias)
+{
+	const v4f vec_mean = v4f_splat(mean);
+	const v4f vec_grad_output_scale = v4f_splat(grad_output_scale);
+	const v4f vec_input_scale = v4f_splat(input_scale);
+	const v4f vec_bias = v4f_splat(bias);
+	for (; length >= 4; length -= 4) {
+		v4f_st(grad_input, v4f_ld(grad_output) * vec_grad_output_scale + (v4f_ld(input) - vec_mean) * vec_input_scale + vec_bias);
+
+		grad_output += 4;
+		input       += 4;
+		grad_input  += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*grad_input++ = *grad_output++ * grad_output_scale + (*input++ - mean) * input_scale + bias;
+	}
+}
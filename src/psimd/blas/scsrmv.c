@@ -0,0 +1,20 @@
+#include <stddef.h>
+#include <stdint.h>
+
+
+void nnp_scsrmv__psimd(
+	size_t rows,
+	const uint32_t row_offsets[restrict static 1],
+	const uint32_t column_indices[restrict static 1],
+	const float values[restrict static 1],
+	const float x[restrict static 1],
+	float y[restrict static 1])
+{
+	for (size_t row = 0; row < rows; row++) {
+		float acc = 0.0f;
+		for (uint32_t offset = row_offsets[row]; offset < row_offsets[row + 1]; offset++) {
+			acc += values[offset] * x[column_indices[offset]];
+		}
+		y[row] = acc;
+	}
+}
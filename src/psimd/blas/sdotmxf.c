@@ -0,0 +1,204 @@
+#include <stddef.h>
+
+#include <nnpack/simd.h>
+
+
+static inline void sdotmxf__psimd(
+	const size_t batch_size,
+	const size_t fusion_factor,
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	v4f vacc[4][6];
+	for (size_t m = 0; m < batch_size; m++) {
+		for (size_t f = 0; f < fusion_factor; f++) {
+			vacc[m][f] = v4f_zero();
+		}
+	}
+
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4) {
+		v4f vx[4];
+		for (size_t m = 0; m < batch_size; m++) {
+			vx[m] = v4f_ld(x + m * stride_x + k);
+		}
+		/* Each row of y is loaded once and multiplied by all input vectors */
+		for (size_t f = 0; f < fusion_factor; f++) {
+			const v4f vy = v4f_ld(y + f * stride_y + k);
+			for (size_t m = 0; m < batch_size; m++) {
+				vacc[m][f] += vx[m] * vy;
+			}
+		}
+	}
+
+	for (size_t m = 0; m < batch_size; m++) {
+		for (size_t f = 0; f < fusion_factor; f++) {
+			float acc = v4f_reduce_sum(vacc[m][f]);
+			for (size_t i = k; i < n; i++) {
+				acc += x[m * stride_x + i] * y[f * stride_y + i];
+			}
+			sum[m * stride_sum + f] = acc;
+		}
+	}
+}
+
+void nnp_sdot2xf1__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 1, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot2xf2__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 2, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot2xf3__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 3, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot2xf4__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 4, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot2xf5__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 5, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot2xf6__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(2, 6, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot3xf1__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(3, 1, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot3xf2__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(3, 2, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot3xf3__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(3, 3, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot3xf4__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(3, 4, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot4xf1__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(4, 1, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot4xf2__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(4, 2, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
+
+void nnp_sdot4xf3__psimd(
+	const float x[restrict static 1],
+	size_t stride_x,
+	const float y[restrict static 1],
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t stride_sum,
+	size_t n)
+{
+	sdotmxf__psimd(4, 3, x, stride_x, y, stride_y, sum, stride_sum, n);
+}
@@ -0,0 +1,211 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nnpack/simd.h>
+#include <nnpack/fp16.h>
+
+
+static inline v4f v4f_ld_fp16(const uint16_t y[restrict static 4]) {
+	const float f[4] = { fp16_to_fp32(y[0]), fp16_to_fp32(y[1]), fp16_to_fp32(y[2]), fp16_to_fp32(y[3]) };
+	return v4f_ld(f);
+}
+
+static inline v4f v4f_ld_bf16(const uint16_t y[restrict static 4]) {
+	const float f[4] = { bf16_to_fp32(y[0]), bf16_to_fp32(y[1]), bf16_to_fp32(y[2]), bf16_to_fp32(y[3]) };
+	return v4f_ld(f);
+}
+
+static inline void shdotxf__psimd(
+	const size_t fusion_factor,
+	const bool bf16,
+	const float x[restrict static 1],
+	const uint16_t* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	v4f vacc[8];
+	for (size_t f = 0; f < fusion_factor; f++) {
+		vacc[f] = v4f_zero();
+	}
+
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4) {
+		const v4f vx = v4f_ld(x + k);
+		for (size_t f = 0; f < fusion_factor; f++) {
+			const uint16_t* y_row = y + f * stride_y + k;
+			const v4f vy = bf16 ? v4f_ld_bf16(y_row) : v4f_ld_fp16(y_row);
+			vacc[f] += vx * vy;
+		}
+	}
+
+	for (size_t f = 0; f < fusion_factor; f++) {
+		float acc = v4f_reduce_sum(vacc[f]);
+		for (size_t i = k; i < n; i++) {
+			const uint16_t y_element = y[f * stride_y + i];
+			acc += x[i] * (bf16 ? bf16_to_fp32(y_element) : fp16_to_fp32(y_element));
+		}
+		sum[f] = acc;
+	}
+}
+
+void nnp_shdotxf1__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(1, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf2__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(2, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf3__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(3, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf4__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(4, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf5__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(5, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf6__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(6, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf7__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(7, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_shdotxf8__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(8, false, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf1__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(1, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf2__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(2, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf3__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(3, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf4__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(4, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf5__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(5, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf6__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(6, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf7__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(7, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
+
+void nnp_sbdotxf8__psimd(
+	const float x[restrict static 1],
+	const void* y,
+	size_t stride_y,
+	float sum[restrict static 1],
+	size_t n)
+{
+	shdotxf__psimd(8, true, x, (const uint16_t*) y, stride_y, sum, n);
+}
@@ -0,0 +1,118 @@
+#include <stddef.h>
+#include <stdint.h>
+
+
+static inline void u8s8dotxf__psimd(
+	const size_t fusion_factor,
+	const uint8_t x[restrict static 1],
+	const int8_t* y,
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	int32_t acc[8];
+	for (size_t f = 0; f < fusion_factor; f++) {
+		acc[f] = 0;
+	}
+
+	/* Accumulation is exact: 32-bit accumulators do not overflow for n up to NNP_U8S8_MAX_REDUCTION_SIZE, which callers check */
+	for (size_t k = 0; k < n; k++) {
+		const int32_t vx = (int32_t) x[k] - (int32_t) x_zero_point;
+		for (size_t f = 0; f < fusion_factor; f++) {
+			acc[f] += vx * (int32_t) y[f * stride_y + k];
+		}
+	}
+
+	for (size_t f = 0; f < fusion_factor; f++) {
+		sum[f] = acc[f];
+	}
+}
+
+void nnp_u8s8dotxf1__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(1, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf2__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(2, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf3__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(3, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf4__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(4, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf5__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(5, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf6__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(6, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf7__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(7, x, y, stride_y, sum, n, x_zero_point);
+}
+
+void nnp_u8s8dotxf8__psimd(
+	const uint8_t x[restrict static 1],
+	const int8_t y[restrict static 1],
+	size_t stride_y,
+	int32_t sum[restrict static 1],
+	size_t n,
+	uint8_t x_zero_point)
+{
+	u8s8dotxf__psimd(8, x, y, stride_y, sum, n, x_zero_point);
+}
@@ -0,0 +1,29 @@
+#include <stddef.h>
+#include <stdint.h>
+
+
+void nnp_u8s8gemm_4x8__psimd(
+	size_t k,
+	const int16_t a[restrict static 8],
+	const int16_t b[restrict static 16],
+	int32_t c[restrict static 32])
+{
+	int32_t acc[4][8] = { { 0 } };
+	do {
+		for (size_t m = 0; m < 4; m++) {
+			const int32_t a0 = (int32_t) a[m * 2 + 0];
+			const int32_t a1 = (int32_t) a[m * 2 + 1];
+			for (size_t n = 0; n < 8; n++) {
+				acc[m][n] += a0 * (int32_t) b[n * 2 + 0] + a1 * (int32_t) b[n * 2 + 1];
+			}
+		}
+		a += 4 * 2;
+		b += 8 * 2;
+	} while (--k);
+
+	for (size_t m = 0; m < 4; m++) {
+		for (size_t n = 0; n < 8; n++) {
+			c[m * 8 + n] = acc[m][n];
+		}
+	}
+}
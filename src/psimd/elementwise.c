@@ -0,0 +1,163 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack/simd.h>
+#include <nnpack/elementwise.h>
+
+
+void nnp_add__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	float output[static 1])
+{
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) + v4f_ld(b));
+
+		a      += 4;
+		b      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ + *b++;
+	}
+}
+
+void nnp_add_scalar__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	float output[static 1])
+{
+	const float scalar_b = *b;
+	const v4f vec_b = v4f_splat(scalar_b);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) + vec_b);
+
+		a      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ + scalar_b;
+	}
+}
+
+void nnp_multiply__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	float output[static 1])
+{
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * v4f_ld(b));
+
+		a      += 4;
+		b      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * *b++;
+	}
+}
+
+void nnp_multiply_scalar__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	float output[static 1])
+{
+	const float scalar_b = *b;
+	const v4f vec_b = v4f_splat(scalar_b);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * vec_b);
+
+		a      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * scalar_b;
+	}
+}
+
+void nnp_multiply_add__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	const float c[static 1],
+	float output[static 1])
+{
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * v4f_ld(b) + v4f_ld(c));
+
+		a      += 4;
+		b      += 4;
+		c      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * *b++ + *c++;
+	}
+}
+
+void nnp_multiply_add_scalar__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	const float c[static 1],
+	float output[static 1])
+{
+	const float scalar_c = *c;
+	const v4f vec_c = v4f_splat(scalar_c);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * v4f_ld(b) + vec_c);
+
+		a      += 4;
+		b      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * *b++ + scalar_c;
+	}
+}
+
+void nnp_multiply_scalar_add__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	const float c[static 1],
+	float output[static 1])
+{
+	const float scalar_b = *b;
+	const v4f vec_b = v4f_splat(scalar_b);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * vec_b + v4f_ld(c));
+
+		a      += 4;
+		c      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * scalar_b + *c++;
+	}
+}
+
+void nnp_multiply_scalar_add_scalar__psimd(
+	size_t length,
+	const float a[static 1],
+	const float b[static 1],
+	const float c[static 1],
+	float output[static 1])
+{
+	const float scalar_b = *b, scalar_c = *c;
+	const v4f vec_b = v4f_splat(scalar_b);
+	const v4f vec_c = v4f_splat(scalar_c);
+	for (; length >= 4; length -= 4) {
+		v4f_st(output, v4f_ld(a) * vec_b + vec_c);
+
+		a      += 4;
+		output += 4;
+	}
+	for (; length != 0; length -= 1) {
+		*output++ = *a++ * scalar_b + scalar_c;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <nnpack/simd.h>
+
+
+/*
+ * Natural logarithm of positive normalized x.
+ * x is decomposed as 2^e * m with m in [sqrt(1/2), sqrt(2)), and log(m) = log(1 + f) is approximated with the
+ * Cephes logf polynomial in f. Zero, negative, denormal, and non-finite inputs produce unspecified results.
+ */
+static inline v4f v4f_log(v4f x) {
+	const v4i mantissa_mask = v4i_splat(0x007FFFFF);
+	const v4i one_bits = v4i_splat(0x3F800000);
+	const v4i magic_bits = v4i_splat(0x4B000000); /* 0x1.0p+23f: low mantissa bits hold an integer */
+	const v4f magic_bias = v4f_splat(0x1.0000FEp+23f); /* 0x1.0p+23f + 127 */
+	const v4f sqrt2 = v4f_splat(0x1.6A09E6p+0f);
+	const v4f ln2_hi = v4f_splat(0x1.630000p-1f); /* 0.693359375, exact in 8 bits */
+	const v4f ln2_lo = v4f_splat(-0x1.BD0106p-13f);
+
+	const v4f c0 = v4f_splat( 0x1.204376p-4f);
+	const v4f c1 = v4f_splat(-0x1.D7A370p-4f);
+	const v4f c2 = v4f_splat( 0x1.DE4A34p-4f);
+	const v4f c3 = v4f_splat(-0x1.FCBA9Ep-4f);
+	const v4f c4 = v4f_splat( 0x1.23D37Ep-3f);
+	const v4f c5 = v4f_splat(-0x1.555CA0p-3f);
+	const v4f c6 = v4f_splat( 0x1.999D58p-3f);
+	const v4f c7 = v4f_splat(-0x1.FFFFF8p-3f);
+	const v4f c8 = v4f_splat( 0x1.555554p-2f);
+
+	const v4i bits = (v4i) x;
+	v4f e = ((v4f) ((bits >> v4i_splat(23)) | magic_bits)) - magic_bias;
+	v4f m = (v4f) ((bits & mantissa_mask) | one_bits);
+
+	/* Move m from [1, 2) to [sqrt(1/2), sqrt(2)) */
+	const v4i m_gt_sqrt2 = m > sqrt2;
+	e = e + v4f_andi(v4f_splat(1.0f), m_gt_sqrt2);
+	m = v4f_blend(m_gt_sqrt2, m * v4f_splat(0.5f), m);
+
+	const v4f f = m - v4f_splat(1.0f);
+	const v4f z = f * f;
+	const v4f p = c0 * f + c1;
+	const v4f q = (((((((p * f + c2) * f + c3) * f + c4) * f + c5) * f + c6) * f + c7) * f + c8) * f * z;
+	return (f + (q + e * ln2_lo - v4f_splat(0.5f) * z)) + e * ln2_hi;
+}
@@ -0,0 +1,143 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack/simd.h>
+#include <nnpack/utils.h>
+#include <nnpack/lrn.h>
+
+#include <psimd/exp.h>
+#include <psimd/log.h>
+
+
+/* Loads the first length elements of the group, and sets the other lanes to zero */
+static inline v4f v4f_ld_lrn(const float* address, size_t length) {
+	if (length >= 4) {
+		return v4f_ld(address);
+	} else {
+		v4f result = v4f_zero();
+		for (size_t lane = 0; lane < length; lane++) {
+			result[lane] = address[lane];
+		}
+		return result;
+	}
+}
+
+static inline void v4f_st_lrn(float* address, v4f value, size_t length) {
+	if (length >= 4) {
+		v4f_st(address, value);
+	} else {
+		for (size_t lane = 0; lane < length; lane++) {
+			address[lane] = value[lane];
+		}
+	}
+}
+
+/* Computes (k + alpha_over_n * sum)^minus_beta as exp(minus_beta * log(scale)) */
+static inline v4f v4f_lrn_power(v4f scale, v4f minus_beta) {
+	return v4f_exp(minus_beta * v4f_log(scale));
+}
+
+/* Sum of squares of channels [0, min(half_window, channels - 1)]: the window of channel 0 */
+static inline v4f v4f_lrn_initial_sum(const float* input, size_t channels, size_t image_size, size_t length, size_t half_window) {
+	v4f sum = v4f_zero();
+	for (size_t channel = 0; channel < min(half_window + 1, channels); channel++) {
+		const v4f x = v4f_ld_lrn(input + channel * image_size, length);
+		sum += x * x;
+	}
+	return sum;
+}
+
+void nnp_lrn_forward__psimd(
+	const float input[restrict static 1],
+	float output[restrict static 1],
+	size_t channels,
+	size_t image_size,
+	size_t length,
+	size_t half_window,
+	float alpha_over_n,
+	float minus_beta,
+	float k)
+{
+	const v4f vec_alpha_over_n = v4f_splat(alpha_over_n);
+	const v4f vec_minus_beta = v4f_splat(minus_beta);
+	const v4f vec_k = v4f_splat(k);
+
+	v4f sum = v4f_lrn_initial_sum(input, channels, image_size, length, half_window);
+	for (size_t channel = 0; channel < channels; channel++) {
+		const v4f x = v4f_ld_lrn(input + channel * image_size, length);
+		const v4f power = v4f_lrn_power(vec_k + vec_alpha_over_n * sum, vec_minus_beta);
+		v4f_st_lrn(output + channel * image_size, x * power, length);
+
+		/* Slide the window: add the channel entering it, and remove the channel leaving it */
+		if (channel + half_window + 1 < channels) {
+			const v4f x_lead = v4f_ld_lrn(input + (channel + half_window + 1) * image_size, length);
+			sum += x_lead * x_lead;
+		}
+		if (channel >= half_window) {
+			const v4f x_trail = v4f_ld_lrn(input + (channel - half_window) * image_size, length);
+			sum -= x_trail * x_trail;
+		}
+	}
+}
+
+void nnp_lrn_backward__psimd(
+	const float grad_output[static 1],
+	const float input[restrict static 1],
+	float grad_input[static 1],
+	float scratch[restrict static 4],
+	size_t channels,
+	size_t image_size,
+	size_t length,
+	size_t half_window,
+	float alpha_over_n,
+	float minus_beta,
+	float k)
+{
+	const v4f vec_alpha_over_n = v4f_splat(alpha_over_n);
+	const v4f vec_minus_beta = v4f_splat(minus_beta);
+	const v4f vec_k = v4f_splat(k);
+
+	/*
+	 * First pass: grad_input := grad_output * scale^(-beta),
+	 *             scratch    := grad_output * input * scale^(-beta - 1)
+	 */
+	v4f sum = v4f_lrn_initial_sum(input, channels, image_size, length, half_window);
+	for (size_t channel = 0; channel < channels; channel++) {
+		const v4f x = v4f_ld_lrn(input + channel * image_size, length);
+		const v4f dy = v4f_ld_lrn(grad_output + channel * image_size, length);
+		const v4f scale = vec_k + vec_alpha_over_n * sum;
+		const v4f power = v4f_lrn_power(scale, vec_minus_beta);
+		v4f_st_lrn(grad_input + channel * image_size, dy * power, length);
+		v4f_st(scratch + channel * 4, dy * x * power / scale);
+
+		if (channel + half_window + 1 < channels) {
+			const v4f x_lead = v4f_ld_lrn(input + (channel + half_window + 1) * image_size, length);
+			sum += x_lead * x_lead;
+		}
+		if (channel >= half_window) {
+			const v4f x_trail = v4f_ld_lrn(input + (channel - half_window) * image_size, length);
+			sum -= x_trail * x_trail;
+		}
+	}
+
+	/*
+	 * Second pass: grad_input += -2 * alpha_over_n * beta * input * (window sum of scratch)
+	 */
+	const v4f coefficient = v4f_splat(2.0f * alpha_over_n * minus_beta);
+	v4f scratch_sum = v4f_zero();
+	for (size_t channel = 0; channel < min(half_window + 1, channels); channel++) {
+		scratch_sum += v4f_ld(scratch + channel * 4);
+	}
+	for (size_t channel = 0; channel < channels; channel++) {
+		const v4f x = v4f_ld_lrn(input + channel * image_size, length);
+		const v4f dx = v4f_ld_lrn(grad_input + channel * image_size, length);
+		v4f_st_lrn(grad_input + channel * image_size, dx + coefficient * x * scratch_sum, length);
+
+		if (channel + half_window + 1 < channels) {
+			scratch_sum += v4f_ld(scratch + (channel + half_window + 1) * 4);
+		}
+		if (channel >= half_window) {
+			scratch_sum -= v4f_ld(scratch + (channel - half_window) * 4);
+		}
+	}
+}
@@ -0,0 +1,210 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/simd.h>
+
+
+/*
+ * Loads 4 elements of the input tile row, starting at the specified column of the tile.
+ * Elements in columns outside of [column_start, column_end) are set to -inf.
+ * Element in column_start of the tile is stored at row[0].
+ */
+static inline v4f v4f_ld_maxpool(const float row[restrict static 1], uint32_t column_start, uint32_t column_end, uint32_t column) {
+	if ((column >= column_start) && (column + 4 <= column_end)) {
+		return v4f_ld(row + (column - column_start));
+	} else {
+		v4f result = v4f_splat(-__builtin_inff());
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			if ((column + lane >= column_start) && (column + lane < column_end)) {
+				result[lane] = row[column + lane - column_start];
+			}
+		}
+		return result;
+	}
+}
+
+static inline void v4f_st_maxpool(float dst[restrict static 1], v4f value, uint32_t dst_column_count) {
+	if (dst_column_count >= 4) {
+		v4f_st(dst, value);
+	} else {
+		for (uint32_t lane = 0; lane < dst_column_count; lane++) {
+			dst[lane] = value[lane];
+		}
+	}
+}
+
+/*
+ * Computes element-wise maximum of the input tile rows.
+ * Rows outside of [src_row_offset, src_row_offset + src_row_count) contribute -inf.
+ */
+static inline void maxpool_rows(
+	const float* src, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count,
+	uint32_t pool_height, size_t vectors, const uint32_t column_offsets[restrict static 1], v4f max[restrict static 1])
+{
+	const uint32_t src_column_end = src_column_offset + src_column_count;
+	for (size_t vector = 0; vector < vectors; vector++) {
+		max[vector] = v4f_splat(-__builtin_inff());
+	}
+	for (uint32_t row = 0; row < pool_height; row++) {
+		/* Unsigned comparison also rejects rows above the first loaded row */
+		const uint32_t src_row = row - src_row_offset;
+		if (src_row < src_row_count) {
+			const float* src_row_pointer = src + src_row * src_stride;
+			for (size_t vector = 0; vector < vectors; vector++) {
+				max[vector] = v4f_max(max[vector],
+					v4f_ld_maxpool(src_row_pointer, src_column_offset, src_column_end, column_offsets[vector]));
+			}
+		}
+	}
+}
+
+void nnp_maxpool_2x2_2x2__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	static const uint32_t column_offsets[2] = { 0, 4 };
+	v4f max[2];
+	maxpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		2, 2, column_offsets, max);
+
+	/* De-interleave the first and the second element of every pool */
+	const v4f even = __builtin_shufflevector(max[0], max[1], 0, 2, 4, 6);
+	const v4f odd  = __builtin_shufflevector(max[0], max[1], 1, 3, 5, 7);
+	v4f_st_maxpool(dst_pointer, v4f_max(even, odd), dst_column_count);
+}
+
+void nnp_maxpool_3x3_2x2__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	static const uint32_t column_offsets[4] = { 0, 4, 2, 6 };
+	v4f max[4];
+	maxpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		3, 4, column_offsets, max);
+
+	/* De-interleave the first, the second, and the third element of every pool */
+	const v4f even = __builtin_shufflevector(max[0], max[1], 0, 2, 4, 6);
+	const v4f odd  = __builtin_shufflevector(max[0], max[1], 1, 3, 5, 7);
+	const v4f next = __builtin_shufflevector(max[2], max[3], 0, 2, 4, 6);
+	v4f_st_maxpool(dst_pointer, v4f_max(v4f_max(even, odd), next), dst_column_count);
+}
+
+void nnp_maxpool_3x3_1x1__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	static const uint32_t column_offsets[3] = { 0, 1, 2 };
+	v4f max[3];
+	maxpool_rows(src_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		3, 3, column_offsets, max);
+
+	v4f_st_maxpool(dst_pointer, v4f_max(v4f_max(max[0], max[1]), max[2]), dst_column_count);
+}
+
+/*
+ * Computes the maximum of every pool and the index (i * pool_width + j) of its first maximal element in row-major order.
+ * Rows outside of [src_row_offset, src_row_offset + src_row_count) are skipped.
+ */
+static inline void maxpool_with_mask(
+	const float* src, float* dst, uint8_t* dst_mask, size_t src_stride,
+	uint32_t src_row_offset, uint32_t src_row_count, uint32_t src_column_offset, uint32_t src_column_count,
+	uint32_t dst_column_count, uint32_t pool, uint32_t stride)
+{
+	const uint32_t src_column_end = src_column_offset + src_column_count;
+	v4f max = v4f_splat(-__builtin_inff());
+	v4i index = v4i_splat(0);
+	for (uint32_t row = 0; row < pool; row++) {
+		/* Unsigned comparison also rejects rows above the first loaded row */
+		const uint32_t src_row = row - src_row_offset;
+		if (src_row < src_row_count) {
+			const float* src_row_pointer = src + src_row * src_stride;
+			for (uint32_t column = 0; column < pool; column++) {
+				v4f value;
+				if (stride == 2) {
+					const v4f lo = v4f_ld_maxpool(src_row_pointer, src_column_offset, src_column_end, column);
+					const v4f hi = v4f_ld_maxpool(src_row_pointer, src_column_offset, src_column_end, column + 4);
+					value = __builtin_shufflevector(lo, hi, 0, 2, 4, 6);
+				} else {
+					value = v4f_ld_maxpool(src_row_pointer, src_column_offset, src_column_end, column);
+				}
+				const v4i greater = value > max;
+				max = v4f_blend(greater, value, max);
+				index = v4i_blend(greater, v4i_splat(row * pool + column), index);
+			}
+		}
+	}
+	v4f_st_maxpool(dst, max, dst_column_count);
+	for (uint32_t lane = 0; lane < dst_column_count; lane++) {
+		dst_mask[lane] = (uint8_t) index[lane];
+	}
+}
+
+void nnp_maxpool_2x2_2x2_mask__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	uint8_t dst_mask_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	maxpool_with_mask(src_pointer, dst_pointer, dst_mask_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		dst_column_count, 2, 2);
+}
+
+void nnp_maxpool_3x3_2x2_mask__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	uint8_t dst_mask_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	maxpool_with_mask(src_pointer, dst_pointer, dst_mask_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		dst_column_count, 3, 2);
+}
+
+void nnp_maxpool_3x3_1x1_mask__psimd(
+	const float src_pointer[restrict static 1],
+	float dst_pointer[restrict static 1],
+	uint8_t dst_mask_pointer[restrict static 1],
+	size_t src_stride,
+	uint32_t src_row_offset,
+	uint32_t src_row_count,
+	uint32_t src_column_offset,
+	uint32_t src_column_count,
+	uint32_t dst_column_count)
+{
+	maxpool_with_mask(src_pointer, dst_pointer, dst_mask_pointer, src_stride,
+		src_row_offset, src_row_count, src_column_offset, src_column_count,
+		dst_column_count, 3, 1);
+}
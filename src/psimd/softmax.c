@@ -5,6 +5,7 @@
 #include <nnpack/simd.h>
 #include <nnpack/utils.h>
 #include <nnpack/softmax.h>
+#include <nnpack/blas.h>
 
 #include <psimd/exp.h>
 
@@ -85,7 +86,7 @@ static float sum_exp_minus_c__psimd(size_t n, const float v[restrict static n],
 		n -= 4;
 	}
 	if (n != 0) {
-		sum0 += v4f_exp(v4f_andi(v4f_ld(v + n - 4), mask[n - 1]) - c);
+		sum0 += v4f_andi(v4f_exp(v4f_ld(v + n - 4) - c), mask[n - 1]);
 	}
 	return v4f_reduce_sum(sum0);
 }
@@ -152,6 +153,73 @@ static void outplace_scaled_exp_minus_c__psimd(size_t n, const float x[restrict
 	}
 }
 
+static void scaled_minus_c__scalar(size_t n, const float x[static n], const float* s, float y[static n], float c) {
+	do {
+		const float scale = (s == NULL) ? 1.0f : *s++;
+		*y++ = (*x++ - c) * scale;
+	} while (--n);
+}
+
+static void outplace_minus_c__psimd(size_t n, const float x[static n], float y[static n], v4f c) {
+	const v4f ylast = v4f_ld(x + n - 4) - c;
+	while (n >= 16) {
+		const v4f y0 = v4f_ld(x +  0) - c;
+		const v4f y1 = v4f_ld(x +  4) - c;
+		const v4f y2 = v4f_ld(x +  8) - c;
+		const v4f y3 = v4f_ld(x + 12) - c;
+
+		v4f_st(y +  0, y0);
+		v4f_st(y +  4, y1);
+		v4f_st(y +  8, y2);
+		v4f_st(y + 12, y3);
+
+		x += 16;
+		y += 16;
+		n -= 16;
+	}
+	while (n >= 4) {
+		v4f_st(y, v4f_ld(x) - c);
+
+		x += 4;
+		y += 4;
+		n -= 4;
+	}
+	if (n != 0) {
+		v4f_st(y + n - 4, ylast);
+	}
+}
+
+static void outplace_scaled_minus_c__psimd(size_t n, const float x[restrict static n], const float s[restrict static n], float y[restrict static n], v4f c) {
+	const v4f ylast = (v4f_ld(x + n - 4) - c) * v4f_ld(s + n - 4);
+	while (n >= 16) {
+		const v4f y0 = (v4f_ld(x +  0) - c) * v4f_ld(s +  0);
+		const v4f y1 = (v4f_ld(x +  4) - c) * v4f_ld(s +  4);
+		const v4f y2 = (v4f_ld(x +  8) - c) * v4f_ld(s +  8);
+		const v4f y3 = (v4f_ld(x + 12) - c) * v4f_ld(s + 12);
+
+		v4f_st(y +  0, y0);
+		v4f_st(y +  4, y1);
+		v4f_st(y +  8, y2);
+		v4f_st(y + 12, y3);
+
+		x += 16;
+		s += 16;
+		y += 16;
+		n -= 16;
+	}
+	while (n >= 4) {
+		v4f_st(y, (v4f_ld(x) - c) * v4f_ld(s));
+
+		x += 4;
+		s += 4;
+		y += 4;
+		n -= 4;
+	}
+	if (n != 0) {
+		v4f_st(y + n - 4, ylast);
+	}
+}
+
 void nnp_inplace_softmax__psimd(
 	size_t n,
 	float v[restrict static n])
@@ -186,3 +254,91 @@ void nnp_outplace_softmax__psimd(
 		scaled_exp_minus_c__scalar(n, x, y, scale, c);
 	}
 }
+
+void nnp_softmax_partial__psimd(
+	size_t n,
+	const float x[restrict static n],
+	float max[restrict static 1],
+	float sum_exp[restrict static 1])
+{
+	if (n >= 4) {
+		const v4f c = max__psimd(n, x);
+		*max = c[0];
+		*sum_exp = sum_exp_minus_c__psimd(n, x, c);
+	} else {
+		const float c = max__scalar(n, x);
+		*max = c;
+		*sum_exp = sum_exp_minus_c__scalar(n, x, c);
+	}
+}
+
+void nnp_softmax_scale__psimd(
+	size_t n,
+	const float x[static n],
+	float y[static n],
+	float scale,
+	float c)
+{
+	if (n >= 4) {
+		if (x == y) {
+			inplace_scaled_exp_minus_c__psimd(n, y, v4f_splat(scale), v4f_splat(c));
+		} else {
+			outplace_scaled_exp_minus_c__psimd(n, x, y, v4f_splat(scale), v4f_splat(c));
+		}
+	} else {
+		scaled_exp_minus_c__scalar(n, x, y, scale, c);
+	}
+}
+
+void nnp_log_softmax__psimd(
+	size_t n,
+	const float x[static n],
+	float y[static n])
+{
+	if (n >= 4) {
+		const v4f c = max__psimd(n, x);
+		const float sum = sum_exp_minus_c__psimd(n, x, c);
+		outplace_minus_c__psimd(n, x, y, c + v4f_splat(logf(sum)));
+	} else {
+		const float c = max__scalar(n, x);
+		const float sum = sum_exp_minus_c__scalar(n, x, c);
+		scaled_minus_c__scalar(n, x, NULL, y, c + logf(sum));
+	}
+}
+
+void nnp_softmax_gradient__psimd(
+	size_t n,
+	const float y[restrict static n],
+	const float g[restrict static n],
+	float dx[restrict static n])
+{
+	float dot;
+	nnp_sdotxf1__psimd(g, y, 0, &dot, n);
+	if (n >= 4) {
+		outplace_scaled_minus_c__psimd(n, g, y, dx, v4f_splat(dot));
+	} else {
+		scaled_minus_c__scalar(n, g, y, dx, dot);
+	}
+}
+
+float nnp_softmax_cross_entropy__psimd(
+	size_t n,
+	const float x[restrict static n],
+	uint32_t label,
+	float g[restrict static n])
+{
+	float loss;
+	if (n >= 4) {
+		const v4f c = max__psimd(n, x);
+		const float sum = sum_exp_minus_c__psimd(n, x, c);
+		loss = c[0] + logf(sum) - x[label];
+		outplace_scaled_exp_minus_c__psimd(n, x, g, v4f_splat(1.0f / sum), c);
+	} else {
+		const float c = max__scalar(n, x);
+		const float sum = sum_exp_minus_c__scalar(n, x, c);
+		loss = c + logf(sum) - x[label];
+		scaled_exp_minus_c__scalar(n, x, g, 1.0f / sum, c);
+	}
+	g[label] -= 1.0f;
+	return loss;
+}
@@ -0,0 +1,157 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+#define SELU_ALPHA 1.6732632423543772848
+#define SELU_LAMBDA 1.0507009873554804934
+#define GELU_SQRT_2_OVER_PI 0.79788456080286535588
+#define GELU_CUBIC_COEFFICIENT 0.044715
+
+struct activation_input_gradient_context {
+	size_t channels;
+	const float* grad_output;
+	const float* input;
+	float* grad_input;
+	double (*derivative)(double, double);
+	double alpha;
+};
+
+static double sigmoid(double x) {
+	return 1.0 / (1.0 + exp(-x));
+}
+
+static double grad_sigmoid(double x, double alpha) {
+	return sigmoid(x) * sigmoid(-x);
+}
+
+static double grad_tanh(double x, double alpha) {
+	const double t = tanh(x);
+	return (1.0 - t) * (1.0 + t);
+}
+
+static double grad_elu(double x, double alpha) {
+	return x > 0.0 ? 1.0 : alpha * exp(x);
+}
+
+static double grad_selu(double x, double alpha) {
+	return SELU_LAMBDA * grad_elu(x, SELU_ALPHA);
+}
+
+static double grad_gelu(double x, double alpha) {
+	const double u = GELU_SQRT_2_OVER_PI * (x + GELU_CUBIC_COEFFICIENT * x * x * x);
+	const double du = GELU_SQRT_2_OVER_PI * (1.0 + 3.0 * GELU_CUBIC_COEFFICIENT * x * x);
+	return sigmoid(2.0 * u) + 2.0 * x * du * sigmoid(2.0 * u) * sigmoid(-2.0 * u);
+}
+
+static double grad_swish(double x, double alpha) {
+	return sigmoid(x) + x * sigmoid(x) * sigmoid(-x);
+}
+
+static void compute_activation_input_gradient(
+	const struct activation_input_gradient_context context[restrict static 1],
+	size_t sample)
+{
+	const size_t channels                = context->channels;
+	const float* grad_output             = context->grad_output + sample * channels;
+	const float* input                   = context->input       + sample * channels;
+	float* grad_input                    = context->grad_input  + sample * channels;
+	double (*derivative)(double, double) = context->derivative;
+	const double alpha                   = context->alpha;
+
+	for (size_t channel = 0; channel < channels; channel++) {
+		grad_input[channel] = (float) ((double) grad_output[channel] * derivative((double) input[channel], alpha));
+	}
+}
+
+static void activation_input_gradient(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	double (*derivative)(double, double),
+	double alpha,
+	pthreadpool_t threadpool)
+{
+	struct activation_input_gradient_context activation_input_gradient_context = {
+		.channels = channels,
+		.grad_output = grad_output,
+		.input = input,
+		.grad_input = grad_input,
+		.derivative = derivative,
+		.alpha = alpha,
+	};
+
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_activation_input_gradient,
+		&activation_input_gradient_context,
+		batch_size);
+}
+
+void nnp_sigmoid_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_sigmoid, 0.0, threadpool);
+}
+
+void nnp_tanh_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_tanh, 0.0, threadpool);
+}
+
+void nnp_elu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_elu, alpha, threadpool);
+}
+
+void nnp_selu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_selu, 0.0, threadpool);
+}
+
+void nnp_gelu_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_gelu, 0.0, threadpool);
+}
+
+void nnp_swish_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	activation_input_gradient(batch_size, channels, grad_output, input, grad_input, grad_swish, 0.0, threadpool);
+}
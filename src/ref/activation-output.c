@@ -0,0 +1,142 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+#define SELU_ALPHA 1.6732632423543772848
+#define SELU_LAMBDA 1.0507009873554804934
+#define GELU_SQRT_2_OVER_PI 0.79788456080286535588
+#define GELU_CUBIC_COEFFICIENT 0.044715
+
+struct activation_output_context {
+	size_t channels;
+	const float* input;
+	float* output;
+	double (*function)(double, double);
+	double alpha;
+};
+
+static double sigmoid(double x, double alpha) {
+	return 1.0 / (1.0 + exp(-x));
+}
+
+static double hyperbolic_tangent(double x, double alpha) {
+	return tanh(x);
+}
+
+static double elu(double x, double alpha) {
+	return x > 0.0 ? x : alpha * expm1(x);
+}
+
+static double selu(double x, double alpha) {
+	return SELU_LAMBDA * elu(x, SELU_ALPHA);
+}
+
+/* 0.5 x (1 + tanh(u)) is evaluated as x sigmoid(2u) to avoid cancellation for negative u */
+static double gelu(double x, double alpha) {
+	const double u = GELU_SQRT_2_OVER_PI * (x + GELU_CUBIC_COEFFICIENT * x * x * x);
+	return x * sigmoid(2.0 * u, 0.0);
+}
+
+static double swish(double x, double alpha) {
+	return x * sigmoid(x, 0.0);
+}
+
+static void compute_activation_output(
+	const struct activation_output_context context[restrict static 1],
+	size_t sample)
+{
+	const size_t channels              = context->channels;
+	const float* input                 = context->input + sample * channels;
+	float* output                      = context->output + sample * channels;
+	double (*function)(double, double) = context->function;
+	const double alpha                 = context->alpha;
+
+	for (size_t channel = 0; channel < channels; channel++) {
+		output[channel] = (float) function((double) input[channel], alpha);
+	}
+}
+
+static void activation_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	double (*function)(double, double),
+	double alpha,
+	pthreadpool_t threadpool)
+{
+	struct activation_output_context activation_output_context = {
+		.channels = channels,
+		.input = input,
+		.output = output,
+		.function = function,
+		.alpha = alpha,
+	};
+
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_activation_output,
+		&activation_output_context,
+		batch_size);
+}
+
+void nnp_sigmoid_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, sigmoid, 0.0, threadpool);
+}
+
+void nnp_tanh_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, hyperbolic_tangent, 0.0, threadpool);
+}
+
+void nnp_elu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float alpha,
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, elu, alpha, threadpool);
+}
+
+void nnp_selu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, selu, 0.0, threadpool);
+}
+
+void nnp_gelu_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, gelu, 0.0, threadpool);
+}
+
+void nnp_swish_output__reference(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	activation_output(batch_size, channels, input, output, swish, 0.0, threadpool);
+}
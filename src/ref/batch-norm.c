@@ -0,0 +1,186 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+struct batch_norm_output_context {
+	size_t batch_size;
+	size_t channels;
+	size_t image_size;
+	const float* input;
+	const float* scale;
+	const float* shift;
+	float epsilon;
+	float* output;
+	float* mean;
+	float* variance;
+};
+
+static void compute_batch_norm_output(
+	const struct batch_norm_output_context context[restrict static 1],
+	size_t channel)
+{
+	const size_t batch_size = context->batch_size;
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+	const float* input      = context->input;
+	float* output           = context->output;
+
+	double sum = 0.0;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const float* input_row = input + (sample * channels + channel) * image_size;
+		for (size_t i = 0; i < image_size; i++) {
+			sum += (double) input_row[i];
+		}
+	}
+	const double mean = sum / (double) (batch_size * image_size);
+
+	double sum_squares = 0.0;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const float* input_row = input + (sample * channels + channel) * image_size;
+		for (size_t i = 0; i < image_size; i++) {
+			const double deviation = (double) input_row[i] - mean;
+			sum_squares += deviation * deviation;
+		}
+	}
+	const double variance = sum_squares / (double) (batch_size * image_size);
+
+	context->mean[channel] = (float) mean;
+	context->variance[channel] = (float) variance;
+
+	const double gamma = context->scale != NULL ? (double) context->scale[channel] : 1.0;
+	const double beta = context->shift != NULL ? (double) context->shift[channel] : 0.0;
+	const double inv_std = 1.0 / sqrt(variance + (double) context->epsilon);
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		for (size_t i = 0; i < image_size; i++) {
+			output[offset + i] = (float) (gamma * ((double) input[offset + i] - mean) * inv_std + beta);
+		}
+	}
+}
+
+void nnp_batch_norm_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float input[],
+	const float scale[],
+	const float shift[],
+	float epsilon,
+	float output[],
+	float mean[],
+	float variance[],
+	pthreadpool_t threadpool)
+{
+	struct batch_norm_output_context batch_norm_output_context = {
+		.batch_size = batch_size,
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.input = input,
+		.scale = scale,
+		.shift = shift,
+		.epsilon = epsilon,
+		.output = output,
+		.mean = mean,
+		.variance = variance,
+	};
+
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_batch_norm_output,
+		&batch_norm_output_context,
+		channels);
+}
+
+struct batch_norm_input_gradient_context {
+	size_t batch_size;
+	size_t channels;
+	size_t image_size;
+	const float* grad_output;
+	const float* input;
+	const float* scale;
+	const float* mean;
+	const float* variance;
+	float epsilon;
+	float* grad_input;
+	float* grad_scale;
+	float* grad_shift;
+};
+
+static void compute_batch_norm_input_gradient(
+	const struct batch_norm_input_gradient_context context[restrict static 1],
+	size_t channel)
+{
+	const size_t batch_size  = context->batch_size;
+	const size_t channels    = context->channels;
+	const size_t image_size  = context->image_size;
+	const float* grad_output = context->grad_output;
+	const float* input       = context->input;
+	float* grad_input        = context->grad_input;
+
+	const double mean = (double) context->mean[channel];
+	const double inv_std = 1.0 / sqrt((double) context->variance[channel] + (double) context->epsilon);
+	const double gamma = context->scale != NULL ? (double) context->scale[channel] : 1.0;
+	const double count = (double) (batch_size * image_size);
+
+	double sum_grad_output = 0.0, sum_grad_output_normalized_input = 0.0;
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		for (size_t i = 0; i < image_size; i++) {
+			const double normalized_input = ((double) input[offset + i] - mean) * inv_std;
+			sum_grad_output += (double) grad_output[offset + i];
+			sum_grad_output_normalized_input += (double) grad_output[offset + i] * normalized_input;
+		}
+	}
+
+	if (context->grad_scale != NULL) {
+		context->grad_scale[channel] = (float) sum_grad_output_normalized_input;
+	}
+	if (context->grad_shift != NULL) {
+		context->grad_shift[channel] = (float) sum_grad_output;
+	}
+
+	for (size_t sample = 0; sample < batch_size; sample++) {
+		const size_t offset = (sample * channels + channel) * image_size;
+		for (size_t i = 0; i < image_size; i++) {
+			const double normalized_input = ((double) input[offset + i] - mean) * inv_std;
+			grad_input[offset + i] = (float) (gamma * inv_std * ((double) grad_output[offset + i] -
+				(sum_grad_output + normalized_input * sum_grad_output_normalized_input) / count));
+		}
+	}
+}
+
+void nnp_batch_norm_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float grad_output[],
+	const float input[],
+	const float scale[],
+	const float mean[],
+	const float variance[],
+	float epsilon,
+	float grad_input[],
+	float grad_scale[],
+	float grad_shift[],
+	pthreadpool_t threadpool)
+{
+	struct batch_norm_input_gradient_context batch_norm_input_gradient_context = {
+		.batch_size = batch_size,
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.grad_output = grad_output,
+		.input = input,
+		.scale = scale,
+		.mean = mean,
+		.variance = variance,
+		.epsilon = epsilon,
+		.grad_input = grad_input,
+		.grad_scale = grad_scale,
+		.grad_shift = grad_shift,
+	};
+
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_batch_norm_input_gradient,
+		&batch_norm_input_gradient_context,
+		channels);
+}
@@ -0,0 +1,119 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+struct convolution_output_u8s8_context {
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_size kernel_size;
+	struct nnp_size output_size;
+	struct nnp_padding input_padding;
+	const uint8_t* input_pointer;
+	struct nnp_quantization input_quantization;
+	const int8_t* kernel_pointer;
+	const float* kernel_scales;
+	const float* bias;
+	uint8_t* output_pointer;
+	struct nnp_quantization output_quantization;
+	enum nnp_activation activation;
+	float negative_slope;
+};
+
+static void compute_convolution_output_u8s8(
+	const struct convolution_output_u8s8_context context[restrict static 1],
+	size_t sample, size_t output_channel)
+{
+	const size_t input_channels            = context->input_channels;
+	const size_t output_channels           = context->output_channels;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size kernel_size      = context->kernel_size;
+	const struct nnp_size output_size      = context->output_size;
+
+	const uint8_t (*input)[input_channels][input_size.height][input_size.width] =
+		(const uint8_t(*)[input_channels][input_size.height][input_size.width]) context->input_pointer;
+	const int8_t (*kernel)[input_channels][kernel_size.height][kernel_size.width] =
+		(const int8_t(*)[input_channels][kernel_size.height][kernel_size.width]) context->kernel_pointer;
+	uint8_t (*output)[output_channels][output_size.height][output_size.width] =
+		(uint8_t(*)[output_channels][output_size.height][output_size.width]) context->output_pointer;
+
+	const int32_t input_zero_point = context->input_quantization.zero_point;
+	for (size_t y = 0; y < output_size.height; y++) {
+		for (size_t x = 0; x < output_size.width; x++) {
+			/* Padding elements are equal to input zero point, and contribute nothing to the accumulator */
+			int64_t accumulator = 0;
+			for (size_t input_channel = 0; input_channel < input_channels; input_channel++) {
+				for (size_t i = 0; i < kernel_size.height; i++) {
+					const size_t s = y + i - input_padding.top;
+					if (s < input_size.height) {
+						for (size_t j = 0; j < kernel_size.width; j++) {
+							const size_t t = x + j - input_padding.left;
+							if (t < input_size.width) {
+								accumulator += ((int32_t) input[sample][input_channel][s][t] - input_zero_point) *
+									(int32_t) kernel[output_channel][input_channel][i][j];
+							}
+						}
+					}
+				}
+			}
+
+			double v = accumulator * ((double) context->input_quantization.scale * (double) context->kernel_scales[output_channel]);
+			if (context->bias != NULL) {
+				v += context->bias[output_channel];
+			}
+			if (context->activation == nnp_activation_relu && v < 0.0) {
+				v *= context->negative_slope;
+			}
+			v = nearbyint(v / context->output_quantization.scale) + context->output_quantization.zero_point;
+			output[sample][output_channel][y][x] = v < 0.0 ? 0 : v > 255.0 ? 255 : (uint8_t) v;
+		}
+	}
+}
+
+void nnp_convolution_output_u8s8__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	const uint8_t input_pointer[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel_pointer[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output_pointer[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	const struct nnp_size output_size = {
+		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
+		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+	};
+	struct convolution_output_u8s8_context convolution_output_context = {
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_size = output_size,
+		.input_pointer = input_pointer,
+		.input_quantization = input_quantization,
+		.kernel_pointer = kernel_pointer,
+		.kernel_scales = kernel_scales,
+		.bias = bias,
+		.output_pointer = output_pointer,
+		.output_quantization = output_quantization,
+		.activation = activation,
+		.negative_slope = negative_slope
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_convolution_output_u8s8,
+		&convolution_output_context,
+		batch_size, output_channels);
+}
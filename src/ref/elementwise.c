@@ -0,0 +1,151 @@
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+struct elementwise_context {
+	size_t channels;
+	size_t image_size;
+	struct nnp_tensor_shape shapes[3];
+	const float* operands[3];
+	float* output;
+};
+
+/* Reads the operand element which is broadcast to output element (sample, channel, pixel) */
+static inline double load_operand(const struct elementwise_context context[restrict static 1],
+	size_t operand, size_t sample, size_t channel, size_t pixel)
+{
+	const struct nnp_tensor_shape shape = context->shapes[operand];
+	const size_t image_size = shape.image_size.height * shape.image_size.width;
+	if (shape.batch_size == 1) {
+		sample = 0;
+	}
+	if (shape.channels == 1) {
+		channel = 0;
+	}
+	if (image_size == 1) {
+		pixel = 0;
+	}
+	return (double) context->operands[operand][(sample * shape.channels + channel) * image_size + pixel];
+}
+
+static void compute_add(
+	const struct elementwise_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+	float* output           = context->output + (sample * channels + channel) * image_size;
+
+	for (size_t pixel = 0; pixel < image_size; pixel++) {
+		output[pixel] = (float) (
+			load_operand(context, 0, sample, channel, pixel) +
+			load_operand(context, 1, sample, channel, pixel));
+	}
+}
+
+static void compute_multiply(
+	const struct elementwise_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+	float* output           = context->output + (sample * channels + channel) * image_size;
+
+	for (size_t pixel = 0; pixel < image_size; pixel++) {
+		output[pixel] = (float) (
+			load_operand(context, 0, sample, channel, pixel) *
+			load_operand(context, 1, sample, channel, pixel));
+	}
+}
+
+static void compute_multiply_add(
+	const struct elementwise_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+	float* output           = context->output + (sample * channels + channel) * image_size;
+
+	for (size_t pixel = 0; pixel < image_size; pixel++) {
+		output[pixel] = (float) (
+			load_operand(context, 0, sample, channel, pixel) *
+			load_operand(context, 1, sample, channel, pixel) +
+			load_operand(context, 2, sample, channel, pixel));
+	}
+}
+
+void nnp_add__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	struct elementwise_context elementwise_context = {
+		.channels = channels,
+		.image_size = image_size.height * image_size.width,
+		.shapes = { a_shape, b_shape },
+		.operands = { a, b },
+		.output = output,
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_add,
+		&elementwise_context,
+		batch_size, channels);
+}
+
+void nnp_multiply__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	struct elementwise_context elementwise_context = {
+		.channels = channels,
+		.image_size = image_size.height * image_size.width,
+		.shapes = { a_shape, b_shape },
+		.operands = { a, b },
+		.output = output,
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_multiply,
+		&elementwise_context,
+		batch_size, channels);
+}
+
+void nnp_multiply_add__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	struct nnp_tensor_shape a_shape,
+	const float a[],
+	struct nnp_tensor_shape b_shape,
+	const float b[],
+	struct nnp_tensor_shape c_shape,
+	const float c[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	struct elementwise_context elementwise_context = {
+		.channels = channels,
+		.image_size = image_size.height * image_size.width,
+		.shapes = { a_shape, b_shape, c_shape },
+		.operands = { a, b, c },
+		.output = output,
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_multiply_add,
+		&elementwise_context,
+		batch_size, channels);
+}
@@ -0,0 +1,81 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+
+struct fully_connected_output_u8s8_context {
+	size_t input_channels;
+	size_t output_channels;
+	const uint8_t* input_pointer;
+	struct nnp_quantization input_quantization;
+	const int8_t* kernel_pointer;
+	const float* kernel_scales;
+	const float* bias;
+	uint8_t* output_pointer;
+	struct nnp_quantization output_quantization;
+	enum nnp_activation activation;
+	float negative_slope;
+};
+
+static void compute_fully_connected_output_u8s8(
+	const struct fully_connected_output_u8s8_context* context,
+	size_t sample, size_t output_channel)
+{
+	const size_t input_channels = context->input_channels;
+	const size_t output_channels = context->output_channels;
+
+	const uint8_t (*input)[input_channels] = (const uint8_t(*)[input_channels]) context->input_pointer;
+	const int8_t (*kernel)[input_channels] = (const int8_t(*)[input_channels]) context->kernel_pointer;
+	uint8_t (*output)[output_channels] = (uint8_t(*)[output_channels]) context->output_pointer;
+
+	int64_t accumulator = 0;
+	for (size_t input_channel = 0; input_channel < input_channels; input_channel++) {
+		accumulator += ((int32_t) input[sample][input_channel] - (int32_t) context->input_quantization.zero_point) *
+			(int32_t) kernel[output_channel][input_channel];
+	}
+
+	double v = accumulator * ((double) context->input_quantization.scale * (double) context->kernel_scales[output_channel]);
+	if (context->bias != NULL) {
+		v += context->bias[output_channel];
+	}
+	if (context->activation == nnp_activation_relu && v < 0.0) {
+		v *= context->negative_slope;
+	}
+	v = nearbyint(v / context->output_quantization.scale) + context->output_quantization.zero_point;
+	output[sample][output_channel] = v < 0.0 ? 0 : v > 255.0 ? 255 : (uint8_t) v;
+}
+
+void nnp_fully_connected_output_u8s8__reference(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const uint8_t input_pointer[],
+	struct nnp_quantization input_quantization,
+	const int8_t kernel_pointer[],
+	const float kernel_scales[],
+	const float bias[],
+	uint8_t output_pointer[],
+	struct nnp_quantization output_quantization,
+	enum nnp_activation activation,
+	float negative_slope,
+	pthreadpool_t threadpool)
+{
+	struct fully_connected_output_u8s8_context fully_connected_output_context = {
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_pointer = input_pointer,
+		.input_quantization = input_quantization,
+		.kernel_pointer = kernel_pointer,
+		.kernel_scales = kernel_scales,
+		.bias = bias,
+		.output_pointer = output_pointer,
+		.output_quantization = output_quantization,
+		.activation = activation,
+		.negative_slope = negative_slope
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_fully_connected_output_u8s8,
+		&fully_connected_output_context,
+		batch_size, output_channels);
+}
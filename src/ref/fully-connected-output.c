@@ -6,6 +6,7 @@ struct fully_connected_output_context {
 	size_t output_channels;
 	const float* input_pointer;
 	const float* kernel_pointer;
+	const float* bias;
 	float* output_pointer;
 };
 
@@ -20,7 +21,7 @@ static void compute_fully_connected_output(
 	const float (*kernel)[input_channels] = (const float(*)[input_channels]) context->kernel_pointer;
 	float (*output)[output_channels] = (float(*)[output_channels]) context->output_pointer;
 
-	double v = 0.0;
+	double v = context->bias == NULL ? 0.0 : context->bias[output_channel];
 	for (size_t input_channel = 0; input_channel < input_channels; input_channel++) {
 		v += input[sample][input_channel] * kernel[output_channel][input_channel];
 	}
@@ -33,6 +34,7 @@ void nnp_fully_connected_output__reference(
 	size_t output_channels,
 	const float input_pointer[],
 	const float kernel_pointer[],
+	const float bias[],
 	float output_pointer[],
 	pthreadpool_t threadpool)
 {
@@ -41,6 +43,7 @@ void nnp_fully_connected_output__reference(
 		.output_channels = output_channels,
 		.input_pointer = input_pointer,
 		.kernel_pointer = kernel_pointer,
+		.bias = bias,
 		.output_pointer = output_pointer
 	};
 
@@ -0,0 +1,147 @@
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/utils.h>
+#include <nnpack/reference.h>
+
+struct lrn_context {
+	size_t channels;
+	size_t image_size;
+	size_t local_size;
+	double alpha;
+	double beta;
+	double k;
+	const float* grad_output;
+	const float* input;
+	float* output;
+};
+
+/* Channel range [first, last) of the window centered on the channel */
+static inline size_t window_first(size_t channel, size_t half_window) {
+	return channel > half_window ? channel - half_window : 0;
+}
+
+static inline size_t window_last(size_t channel, size_t half_window, size_t channels) {
+	return min(channel + half_window + 1, channels);
+}
+
+static double compute_scale(const struct lrn_context context[restrict static 1],
+	const float* input, size_t channel)
+{
+	const size_t channels    = context->channels;
+	const size_t image_size  = context->image_size;
+	const size_t half_window = context->local_size / 2;
+
+	double sum_squares = 0.0;
+	for (size_t c = window_first(channel, half_window); c < window_last(channel, half_window, channels); c++) {
+		const double x = (double) input[c * image_size];
+		sum_squares += x * x;
+	}
+	return context->k + context->alpha / (double) context->local_size * sum_squares;
+}
+
+static void compute_lrn_output(
+	const struct lrn_context context[restrict static 1],
+	size_t sample, size_t pixel)
+{
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+	const size_t offset     = sample * channels * image_size + pixel;
+	const float* input      = context->input + offset;
+	float* output           = context->output + offset;
+
+	for (size_t channel = 0; channel < channels; channel++) {
+		const double scale = compute_scale(context, input, channel);
+		output[channel * image_size] = (float) ((double) input[channel * image_size] * pow(scale, -context->beta));
+	}
+}
+
+void nnp_lrn_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	struct lrn_context lrn_context = {
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.local_size = local_size,
+		.alpha = (double) alpha,
+		.beta = (double) beta,
+		.k = (double) k,
+		.input = input,
+		.output = output,
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_lrn_output,
+		&lrn_context,
+		batch_size, input_size.height * input_size.width);
+}
+
+static void compute_lrn_input_gradient(
+	const struct lrn_context context[restrict static 1],
+	size_t sample, size_t pixel)
+{
+	const size_t channels    = context->channels;
+	const size_t image_size  = context->image_size;
+	const size_t half_window = context->local_size / 2;
+	const double beta        = context->beta;
+	const size_t offset      = sample * channels * image_size + pixel;
+	const float* grad_output = context->grad_output + offset;
+	const float* input       = context->input + offset;
+	float* grad_input        = context->output + offset;
+
+	/*
+	 * grad_input[c] = grad_output[c] * scale[c]^(-beta) -
+	 *     2 * alpha / local_size * beta * input[c] * sum(grad_output[j] * input[j] * scale[j]^(-beta - 1))
+	 * where j spans the channels whose window contains c.
+	 */
+	for (size_t channel = 0; channel < channels; channel++) {
+		double sum = 0.0;
+		for (size_t j = window_first(channel, half_window); j < window_last(channel, half_window, channels); j++) {
+			const double scale = compute_scale(context, input, j);
+			sum += (double) grad_output[j * image_size] * (double) input[j * image_size] * pow(scale, -beta - 1.0);
+		}
+		const double scale = compute_scale(context, input, channel);
+		grad_input[channel * image_size] = (float) ((double) grad_output[channel * image_size] * pow(scale, -beta) -
+			2.0 * context->alpha / (double) context->local_size * beta * (double) input[channel * image_size] * sum);
+	}
+}
+
+void nnp_lrn_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	size_t local_size,
+	float alpha,
+	float beta,
+	float k,
+	const float grad_output[],
+	const float input[],
+	float grad_input[],
+	pthreadpool_t threadpool)
+{
+	struct lrn_context lrn_context = {
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.local_size = local_size,
+		.alpha = (double) alpha,
+		.beta = (double) beta,
+		.k = (double) k,
+		.grad_output = grad_output,
+		.input = input,
+		.output = grad_input,
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_lrn_input_gradient,
+		&lrn_context,
+		batch_size, input_size.height * input_size.width);
+}
@@ -1,3 +1,5 @@
+#include <stdint.h>
+
 #include <nnpack.h>
 #include <nnpack/reference.h>
 #include <nnpack/utils.h>
@@ -80,3 +82,236 @@ void nnp_max_pooling_output__reference(
 		&max_pooling_output_context,
 		batch_size, channels);
 }
+
+struct max_pooling_input_gradient_context {
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+	struct nnp_size output_size;
+	const float* input_pointer;
+	const float* grad_output_pointer;
+	float* grad_input_pointer;
+};
+
+static void compute_max_pooling_input_gradient(
+	const struct max_pooling_input_gradient_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels                  = context->channels;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size pooling_size     = context->pooling_size;
+	const struct nnp_size pooling_stride   = context->pooling_stride;
+	const struct nnp_size output_size      = context->output_size;
+
+	const float (*input)[channels][input_size.height][input_size.width] =
+		(const float(*)[channels][input_size.height][input_size.width]) context->input_pointer;
+	const float (*grad_output)[channels][output_size.height][output_size.width] =
+		(const float(*)[channels][output_size.height][output_size.width]) context->grad_output_pointer;
+	float (*grad_input)[channels][input_size.height][input_size.width] =
+		(float(*)[channels][input_size.height][input_size.width]) context->grad_input_pointer;
+
+	for (size_t s = 0; s < input_size.height; s++) {
+		for (size_t t = 0; t < input_size.width; t++) {
+			grad_input[sample][channel][s][t] = 0.0f;
+		}
+	}
+
+	for (size_t y = 0; y < output_size.height; y++) {
+		for (size_t x = 0; x < output_size.width; x++) {
+			/* Gradient goes to the first maximal element of the pool in row-major order */
+			float v = -__builtin_inff();
+			size_t max_s = SIZE_MAX, max_t = SIZE_MAX;
+			for (size_t i = 0; i < pooling_size.height; i++) {
+				const size_t s = y * pooling_stride.height + i - input_padding.top;
+				if (s < input_size.height) {
+					for (size_t j = 0; j < pooling_size.width; j++) {
+						const size_t t = x * pooling_stride.width + j - input_padding.left;
+						if ((t < input_size.width) && (input[sample][channel][s][t] > v)) {
+							v = input[sample][channel][s][t];
+							max_s = s;
+							max_t = t;
+						}
+					}
+				}
+			}
+			if (max_s != SIZE_MAX) {
+				grad_input[sample][channel][max_s][max_t] += grad_output[sample][channel][y][x];
+			}
+		}
+	}
+}
+
+void nnp_max_pooling_input_gradient__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float* input_pointer,
+	const float* grad_output_pointer,
+	float* grad_input_pointer,
+	pthreadpool_t threadpool)
+{
+	const struct nnp_size output_size = {
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
+	};
+
+	struct max_pooling_input_gradient_context max_pooling_input_gradient_context = {
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+		.output_size = output_size,
+		.input_pointer = input_pointer,
+		.grad_output_pointer = grad_output_pointer,
+		.grad_input_pointer = grad_input_pointer
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_max_pooling_input_gradient,
+		&max_pooling_input_gradient_context,
+		batch_size, channels);
+}
+
+struct average_pooling_output_context {
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+	enum nnp_pooling_padding_mode padding_mode;
+	struct nnp_size output_size;
+	const float* input_pointer;
+	float* output_pointer;
+};
+
+static void compute_average_pooling_output(
+	const struct average_pooling_output_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels                            = context->channels;
+	const struct nnp_size input_size                 = context->input_size;
+	const struct nnp_padding input_padding           = context->input_padding;
+	const struct nnp_size pooling_size               = context->pooling_size;
+	const struct nnp_size pooling_stride             = context->pooling_stride;
+	const enum nnp_pooling_padding_mode padding_mode = context->padding_mode;
+	const struct nnp_size output_size                = context->output_size;
+
+	const float (*input)[channels][input_size.height][input_size.width] =
+		(const float(*)[channels][input_size.height][input_size.width]) context->input_pointer;
+	float (*output)[channels][output_size.height][output_size.width] =
+		(float(*)[channels][output_size.height][output_size.width]) context->output_pointer;
+
+	const size_t padded_height = input_padding.top + input_size.height + input_padding.bottom;
+	const size_t padded_width = input_padding.left + input_size.width + input_padding.right;
+	for (size_t y = 0; y < output_size.height; y++) {
+		for (size_t x = 0; x < output_size.width; x++) {
+			double sum = 0.0;
+			size_t input_count = 0, padded_count = 0;
+			for (size_t i = 0; i < pooling_size.height; i++) {
+				for (size_t j = 0; j < pooling_size.width; j++) {
+					/* Coordinates in the padded image */
+					const size_t padded_y = y * pooling_stride.height + i;
+					const size_t padded_x = x * pooling_stride.width + j;
+					if ((padded_y < padded_height) && (padded_x < padded_width)) {
+						padded_count += 1;
+					}
+					const size_t s = padded_y - input_padding.top;
+					const size_t t = padded_x - input_padding.left;
+					if ((s < input_size.height) && (t < input_size.width)) {
+						sum += (double) input[sample][channel][s][t];
+						input_count += 1;
+					}
+				}
+			}
+			const size_t count = (padding_mode == nnp_pooling_padding_mode_include) ? padded_count : input_count;
+			output[sample][channel][y][x] = count == 0 ? 0.0f : (float) (sum / (double) count);
+		}
+	}
+}
+
+void nnp_average_pooling_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	enum nnp_pooling_padding_mode padding_mode,
+	const float* input_pointer,
+	float* output_pointer,
+	pthreadpool_t threadpool)
+{
+	const struct nnp_size output_size = {
+		.height = divide_round_up(input_padding.top + input_size.height + input_padding.bottom - pooling_size.height, pooling_stride.height) + 1,
+		.width = divide_round_up(input_padding.left + input_size.width + input_padding.right - pooling_size.width, pooling_stride.width) + 1,
+	};
+
+	struct average_pooling_output_context average_pooling_output_context = {
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+		.padding_mode = padding_mode,
+		.output_size = output_size,
+		.input_pointer = input_pointer,
+		.output_pointer = output_pointer
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_average_pooling_output,
+		&average_pooling_output_context,
+		batch_size, channels);
+}
+
+struct global_average_pooling_output_context {
+	size_t channels;
+	size_t image_size;
+	const float* input_pointer;
+	float* output_pointer;
+};
+
+static void compute_global_average_pooling_output(
+	const struct global_average_pooling_output_context context[restrict static 1],
+	size_t sample, size_t channel)
+{
+	const size_t channels   = context->channels;
+	const size_t image_size = context->image_size;
+
+	const float (*input)[channels][image_size] = (const float(*)[channels][image_size]) context->input_pointer;
+	float (*output)[channels] = (float(*)[channels]) context->output_pointer;
+
+	double sum = 0.0;
+	for (size_t index = 0; index < image_size; index++) {
+		sum += (double) input[sample][channel][index];
+	}
+	output[sample][channel] = (float) (sum / (double) image_size);
+}
+
+void nnp_global_average_pooling_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	const float* input_pointer,
+	float* output_pointer,
+	pthreadpool_t threadpool)
+{
+	struct global_average_pooling_output_context global_average_pooling_output_context = {
+		.channels = channels,
+		.image_size = input_size.height * input_size.width,
+		.input_pointer = input_pointer,
+		.output_pointer = output_pointer
+	};
+
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_global_average_pooling_output,
+		&global_average_pooling_output_context,
+		batch_size, channels);
+}
@@ -0,0 +1,116 @@
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+struct softmax_input_gradient_context {
+    size_t channels;
+    const float* grad_output;
+    const float* output;
+    float* grad_input;
+};
+
+static void compute_softmax_input_gradient(
+    const struct softmax_input_gradient_context context[restrict static 1],
+    size_t sample)
+{
+    const size_t channels = context->channels;
+
+    const float (*grad_output)[channels] =
+        (const float(*)[channels]) context->grad_output;
+    const float (*output)[channels] =
+        (const float(*)[channels]) context->output;
+    float (*grad_input)[channels] =
+        (float(*)[channels]) context->grad_input;
+
+    double dot = 0.0;
+    for (size_t channel = 0; channel < channels; channel++) {
+        dot += (double) grad_output[sample][channel] * (double) output[sample][channel];
+    }
+    for (size_t channel = 0; channel < channels; channel++) {
+        grad_input[sample][channel] = (float) ((double) output[sample][channel] * ((double) grad_output[sample][channel] - dot));
+    }
+}
+
+void nnp_softmax_input_gradient__reference(
+    size_t batch_size,
+    size_t channels,
+    const float* grad_output,
+    const float* output,
+    float* grad_input,
+    pthreadpool_t threadpool)
+{
+    struct softmax_input_gradient_context softmax_input_gradient_context = {
+        .channels = channels,
+        .grad_output = grad_output,
+        .output = output,
+        .grad_input = grad_input,
+    };
+    pthreadpool_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_softmax_input_gradient,
+        &softmax_input_gradient_context,
+        batch_size);
+}
+
+struct softmax_cross_entropy_context {
+    size_t channels;
+    const float* input;
+    const uint32_t* labels;
+    float* loss;
+    float* grad_input;
+};
+
+static void compute_softmax_cross_entropy(
+    const struct softmax_cross_entropy_context context[restrict static 1],
+    size_t sample)
+{
+    const size_t channels  = context->channels;
+    const uint32_t* labels = context->labels;
+    float* loss            = context->loss;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*grad_input)[channels] =
+        (float(*)[channels]) context->grad_input;
+
+    float max_element = -FLT_MAX;
+    for (size_t channel = 0; channel < channels; channel++) {
+        max_element = maxf(max_element, input[sample][channel]);
+    }
+    double sum_exp = 0.0;
+    for (size_t channel = 0; channel < channels; channel++) {
+        sum_exp += exp((double) input[sample][channel] - (double) max_element);
+    }
+
+    const uint32_t label = labels[sample];
+    loss[sample] = (float) ((double) max_element + log(sum_exp) - (double) input[sample][label]);
+    for (size_t channel = 0; channel < channels; channel++) {
+        const double probability = exp((double) input[sample][channel] - (double) max_element) / sum_exp;
+        grad_input[sample][channel] = (float) (probability - (double) (channel == label));
+    }
+}
+
+void nnp_softmax_cross_entropy_loss_and_gradient__reference(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    const uint32_t* labels,
+    float* loss,
+    float* grad_input,
+    pthreadpool_t threadpool)
+{
+    struct softmax_cross_entropy_context softmax_cross_entropy_context = {
+        .channels = channels,
+        .input = input,
+        .labels = labels,
+        .loss = loss,
+        .grad_input = grad_input,
+    };
+    pthreadpool_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_softmax_cross_entropy,
+        &softmax_cross_entropy_context,
+        batch_size);
+}
@@ -63,3 +63,49 @@ void nnp_softmax_output__reference(
         &softmax_output_context,
         batch_size);
 }
+
+struct log_softmax_output_context {
+    size_t channels;
+    const float* input;
+    float* output;
+};
+
+static void compute_log_softmax_output(
+    const struct log_softmax_output_context context[restrict static 1],
+    size_t sample)
+{
+    const size_t channels = context->channels;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*output)[channels] =
+        (float(*)[channels]) context->output;
+
+    const float max_element = vector_maxf(channels, input[sample]);
+    double sum_exp = 0.0;
+    for (size_t channel = 0; channel < channels; channel++) {
+        sum_exp += exp((double) input[sample][channel] - (double) max_element);
+    }
+    const double log_sum_exp = (double) max_element + log(sum_exp);
+    for (size_t channel = 0; channel < channels; channel++) {
+        output[sample][channel] = (float) ((double) input[sample][channel] - log_sum_exp);
+    }
+}
+
+void nnp_log_softmax_output__reference(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    float* output,
+    pthreadpool_t threadpool)
+{
+    struct log_softmax_output_context log_softmax_output_context = {
+        .channels = channels,
+        .input = input,
+        .output = output,
+    };
+    pthreadpool_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_log_softmax_output,
+        &log_softmax_output_context,
+        batch_size);
+}
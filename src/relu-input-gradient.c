@@ -10,6 +10,7 @@
 #include <nnpack/utils.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
 
 struct NNP_CACHE_ALIGN relu_context {
 	nnp_gradient_relu_function relu_function;
@@ -87,7 +88,7 @@ enum nnp_status nnp_relu_input_gradient(
 		.negative_slope = negative_slope,
 	};
 
-	pthreadpool_compute_1d_tiled(threadpool,
+	nnp_compute_1d_tiled(threadpool,
 		(pthreadpool_function_1d_tiled_t) compute_relu_input_gradient,
 		&relu_context,
 		elements, round_down(nnp_hwinfo.blocking.l1 / sizeof(float), simd_width));
@@ -9,6 +9,7 @@
 #include <nnpack/utils.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/scheduler.h>
 
 struct NNP_CACHE_ALIGN inplace_relu_context {
 	nnp_inplace_relu_function relu_function;
@@ -96,7 +97,7 @@ enum nnp_status nnp_relu_output(
 			.negative_slope = negative_slope,
 		};
 
-		pthreadpool_compute_1d_tiled(threadpool,
+		nnp_compute_1d_tiled(threadpool,
 			(pthreadpool_function_1d_tiled_t) compute_inplace_relu_output,
 			&inplace_relu_context,
 			elements, round_down(nnp_hwinfo.blocking.l1 / sizeof(float), simd_width));
@@ -113,7 +114,7 @@ enum nnp_status nnp_relu_output(
 			.negative_slope = negative_slope,
 		};
 
-		pthreadpool_compute_1d_tiled(threadpool,
+		nnp_compute_1d_tiled(threadpool,
 			(pthreadpool_function_1d_tiled_t) compute_outplace_relu_output,
 			&outplace_relu_context,
 			elements, round_down(nnp_hwinfo.blocking.l1 / sizeof(float), simd_width));
@@ -0,0 +1,501 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include <pthread.h>
+
+#include <nnpack.h>
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/numa.h>
+#include <nnpack/scheduler.h>
+
+
+__thread struct nnp_scheduler_job* nnp_scheduler_current_job = NULL;
+
+enum loop_type {
+	loop_type_1d,
+	loop_type_1d_tiled,
+	loop_type_2d,
+	loop_type_2d_tiled,
+};
+
+/* Rows of a loop run by workers of one NUMA node, unless the workers of other nodes run out of tiles */
+struct loop_partition {
+	/* Index of the next tile to take, may exceed end_tile after all tiles of the partition are taken */
+	_Alignas(64) atomic_size_t next_tile;
+	size_t end_tile;
+};
+
+/* A parallel loop in progress. It lives on the stack of the job thread, which waits until all workers leave it. */
+struct scheduler_loop {
+	enum loop_type type;
+	union {
+		pthreadpool_function_1d_t function_1d;
+		pthreadpool_function_1d_tiled_t function_1d_tiled;
+		pthreadpool_function_2d_t function_2d;
+		pthreadpool_function_2d_tiled_t function_2d_tiled;
+	};
+	void* argument;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+	size_t tiles_j;
+	size_t tiles_count;
+	size_t partitions_count;
+	struct loop_partition partitions[NNP_NUMA_MAX_NODES];
+	atomic_size_t completed_tiles;
+};
+
+struct nnp_scheduler_job {
+	struct nnp_scheduler* scheduler;
+	/* Next job in the list of jobs of the scheduler, ordered by decreasing priority */
+	struct nnp_scheduler_job* next;
+	/* Job which was bound to the thread before this job */
+	struct nnp_scheduler_job* previous_job;
+	uint32_t priority;
+	size_t min_threads;
+	/* Parallel loop in progress, or NULL */
+	struct scheduler_loop* loop;
+	/* The number of workers assigned to the loop by the last split of workers */
+	size_t target_threads;
+	/* The number of workers running tiles of the loop */
+	size_t active_threads;
+	/* Signaled when the loop is completed and no workers run it */
+	pthread_cond_t completion_condition;
+};
+
+struct scheduler_worker {
+	pthread_t thread;
+	struct nnp_scheduler* scheduler;
+	/* NUMA node of the worker, and the loop partition it runs first */
+	size_t node;
+};
+
+struct nnp_scheduler {
+	pthread_mutex_t mutex;
+	/* Signaled when a parallel loop starts, or the scheduler is destroyed */
+	pthread_cond_t work_condition;
+	struct nnp_scheduler_job* jobs;
+	/* Incremented on every split of workers. Workers return to the scheduler to rebalance when it changes. */
+	atomic_uint generation;
+	bool shutdown;
+	size_t threads_count;
+	size_t started_threads_count;
+	/* The number of NUMA nodes which workers are bound to, or 1 if workers are not bound */
+	size_t nodes_count;
+	struct scheduler_worker workers[];
+};
+
+static void run_tile(const struct scheduler_loop loop[restrict static 1], size_t tile) {
+	const size_t tile_index_i = tile / loop->tiles_j;
+	const size_t tile_index_j = tile % loop->tiles_j;
+	const size_t index_i = tile_index_i * loop->tile_i;
+	const size_t index_j = tile_index_j * loop->tile_j;
+	switch (loop->type) {
+		case loop_type_1d:
+			loop->function_1d(loop->argument, index_j);
+			break;
+		case loop_type_1d_tiled:
+			loop->function_1d_tiled(loop->argument, index_j, min(loop->range_j - index_j, loop->tile_j));
+			break;
+		case loop_type_2d:
+			loop->function_2d(loop->argument, index_i, index_j);
+			break;
+		case loop_type_2d_tiled:
+			loop->function_2d_tiled(loop->argument, index_i, index_j,
+				min(loop->range_i - index_i, loop->tile_i), min(loop->range_j - index_j, loop->tile_j));
+			break;
+	}
+}
+
+static bool has_tiles(const struct nnp_scheduler_job job[restrict static 1]) {
+	const struct scheduler_loop* loop = job->loop;
+	if (loop != NULL) {
+		for (size_t partition = 0; partition < loop->partitions_count; partition++) {
+			if (atomic_load_explicit(&loop->partitions[partition].next_tile, memory_order_relaxed) < loop->partitions[partition].end_tile) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/*
+ * Splits workers between jobs with parallel loops in progress: every job gets its minimum, in the order of priorities,
+ * and the rest of the workers are split in proportion to priorities. Must be called with the mutex locked.
+ */
+static void split_threads(struct nnp_scheduler scheduler[restrict static 1]) {
+	size_t free_threads = scheduler->threads_count;
+	uint64_t priority_sum = 0;
+	for (struct nnp_scheduler_job* job = scheduler->jobs; job != NULL; job = job->next) {
+		job->target_threads = 0;
+		if (job->loop != NULL) {
+			job->target_threads = min(job->min_threads, free_threads);
+			free_threads -= job->target_threads;
+			priority_sum += job->priority;
+		}
+	}
+
+	if (priority_sum != 0) {
+		size_t extra_threads = free_threads;
+		for (struct nnp_scheduler_job* job = scheduler->jobs; job != NULL; job = job->next) {
+			if (job->loop != NULL) {
+				const size_t job_extra_threads = (size_t) ((uint64_t) extra_threads * job->priority / priority_sum);
+				job->target_threads += job_extra_threads;
+				free_threads -= job_extra_threads;
+			}
+		}
+		/* Remainders of the proportional split go to the jobs with the highest priority */
+		for (struct nnp_scheduler_job* job = scheduler->jobs; job != NULL && free_threads != 0; job = job->next) {
+			if (job->loop != NULL && job->priority != 0) {
+				job->target_threads += 1;
+				free_threads -= 1;
+			}
+		}
+	}
+
+	atomic_fetch_add_explicit(&scheduler->generation, 1, memory_order_relaxed);
+}
+
+/*
+ * Chooses the job which lacks the most workers relative to its share. Jobs which already have their share still get
+ * otherwise idle workers. Must be called with the mutex locked.
+ */
+static struct nnp_scheduler_job* pick_job(struct nnp_scheduler scheduler[restrict static 1]) {
+	struct nnp_scheduler_job* best_job = NULL;
+	for (struct nnp_scheduler_job* job = scheduler->jobs; job != NULL; job = job->next) {
+		if (has_tiles(job)) {
+			if (best_job == NULL ||
+				(ptrdiff_t) (job->target_threads - job->active_threads) >
+					(ptrdiff_t) (best_job->target_threads - best_job->active_threads))
+			{
+				best_job = job;
+			}
+		}
+	}
+	return best_job;
+}
+
+static void* worker_thread_main(void* argument) {
+	struct scheduler_worker* worker = argument;
+	struct nnp_scheduler* scheduler = worker->scheduler;
+	if (scheduler->nodes_count > 1) {
+		nnp_numa_bind_thread(worker->node);
+	}
+
+	pthread_mutex_lock(&scheduler->mutex);
+	for (;;) {
+		struct nnp_scheduler_job* job = pick_job(scheduler);
+		if (job == NULL) {
+			if (scheduler->shutdown) {
+				break;
+			}
+			pthread_cond_wait(&scheduler->work_condition, &scheduler->mutex);
+			continue;
+		}
+
+		struct scheduler_loop* loop = job->loop;
+		job->active_threads += 1;
+		const unsigned int generation = atomic_load_explicit(&scheduler->generation, memory_order_relaxed);
+		pthread_mutex_unlock(&scheduler->mutex);
+
+		/*
+		 * Run tiles of the partition of the worker's node, then of other partitions, until they run out,
+		 * or the workers are split again
+		 */
+		for (size_t i = 0; i < loop->partitions_count; i++) {
+			struct loop_partition* partition = &loop->partitions[(worker->node + i) % loop->partitions_count];
+			while (atomic_load_explicit(&scheduler->generation, memory_order_relaxed) == generation) {
+				const size_t tile = atomic_fetch_add_explicit(&partition->next_tile, 1, memory_order_relaxed);
+				if (tile >= partition->end_tile) {
+					break;
+				}
+				run_tile(loop, tile);
+				atomic_fetch_add_explicit(&loop->completed_tiles, 1, memory_order_release);
+			}
+		}
+
+		pthread_mutex_lock(&scheduler->mutex);
+		job->active_threads -= 1;
+		if (job->active_threads == 0 &&
+			atomic_load_explicit(&loop->completed_tiles, memory_order_acquire) == loop->tiles_count)
+		{
+			pthread_cond_signal(&job->completion_condition);
+		}
+	}
+	pthread_mutex_unlock(&scheduler->mutex);
+	return NULL;
+}
+
+static void compute_loop(struct nnp_scheduler_job job[restrict static 1], struct scheduler_loop loop[restrict static 1]) {
+	loop->tiles_j = divide_round_up(loop->range_j, loop->tile_j);
+	loop->tiles_count = divide_round_up(loop->range_i, loop->tile_i) * loop->tiles_j;
+	if (loop->tiles_count == 0) {
+		return;
+	}
+
+	/* Split rows between NUMA nodes, so the data of a row stays with the workers of one node across loops */
+	struct nnp_scheduler* scheduler = job->scheduler;
+	const size_t rows_count = loop->tiles_count / loop->tiles_j;
+	loop->partitions_count = scheduler->nodes_count;
+	for (size_t partition = 0; partition < loop->partitions_count; partition++) {
+		atomic_init(&loop->partitions[partition].next_tile, partition * rows_count / loop->partitions_count * loop->tiles_j);
+		loop->partitions[partition].end_tile = (partition + 1) * rows_count / loop->partitions_count * loop->tiles_j;
+	}
+	atomic_init(&loop->completed_tiles, 0);
+
+	pthread_mutex_lock(&scheduler->mutex);
+	job->loop = loop;
+	split_threads(scheduler);
+	pthread_cond_broadcast(&scheduler->work_condition);
+
+	while (job->active_threads != 0 ||
+		atomic_load_explicit(&loop->completed_tiles, memory_order_acquire) != loop->tiles_count)
+	{
+		pthread_cond_wait(&job->completion_condition, &scheduler->mutex);
+	}
+
+	job->loop = NULL;
+	split_threads(scheduler);
+	pthread_mutex_unlock(&scheduler->mutex);
+}
+
+void nnp_scheduler_compute_1d(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range)
+{
+	struct scheduler_loop loop = {
+		.type = loop_type_1d,
+		.function_1d = function,
+		.argument = argument,
+		.range_i = 1,
+		.range_j = range,
+		.tile_i = 1,
+		.tile_j = 1,
+	};
+	compute_loop(job, &loop);
+}
+
+void nnp_scheduler_compute_1d_tiled(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	struct scheduler_loop loop = {
+		.type = loop_type_1d_tiled,
+		.function_1d_tiled = function,
+		.argument = argument,
+		.range_i = 1,
+		.range_j = range,
+		.tile_i = 1,
+		.tile_j = tile,
+	};
+	compute_loop(job, &loop);
+}
+
+void nnp_scheduler_compute_2d(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j)
+{
+	struct scheduler_loop loop = {
+		.type = loop_type_2d,
+		.function_2d = function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = 1,
+		.tile_j = 1,
+	};
+	compute_loop(job, &loop);
+}
+
+void nnp_scheduler_compute_2d_tiled(
+	struct nnp_scheduler_job* job,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	struct scheduler_loop loop = {
+		.type = loop_type_2d_tiled,
+		.function_2d_tiled = function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+	};
+	compute_loop(job, &loop);
+}
+
+size_t nnp_scheduler_partitions_count(const struct nnp_scheduler_job* job) {
+	return job->scheduler->nodes_count;
+}
+
+size_t nnp_scheduler_threads_count(const struct nnp_scheduler_job* job) {
+	struct nnp_scheduler* scheduler = job->scheduler;
+	pthread_mutex_lock(&scheduler->mutex);
+
+	/* Repeat the steps of split_threads, with the job counted as if it had a parallel loop in progress */
+	size_t free_threads = scheduler->threads_count;
+	size_t job_threads = 0;
+	uint64_t priority_sum = 0;
+	for (const struct nnp_scheduler_job* other_job = scheduler->jobs; other_job != NULL; other_job = other_job->next) {
+		if (other_job->loop != NULL || other_job == job) {
+			const size_t min_threads = min(other_job->min_threads, free_threads);
+			if (other_job == job) {
+				job_threads = min_threads;
+			}
+			free_threads -= min_threads;
+			priority_sum += other_job->priority;
+		}
+	}
+
+	if (priority_sum != 0) {
+		const size_t extra_threads = free_threads;
+		for (const struct nnp_scheduler_job* other_job = scheduler->jobs; other_job != NULL; other_job = other_job->next) {
+			if (other_job->loop != NULL || other_job == job) {
+				const size_t other_job_extra_threads = (size_t) ((uint64_t) extra_threads * other_job->priority / priority_sum);
+				if (other_job == job) {
+					job_threads += other_job_extra_threads;
+				}
+				free_threads -= other_job_extra_threads;
+			}
+		}
+		for (const struct nnp_scheduler_job* other_job = scheduler->jobs; other_job != NULL && free_threads != 0; other_job = other_job->next) {
+			if ((other_job->loop != NULL || other_job == job) && other_job->priority != 0) {
+				if (other_job == job) {
+					job_threads += 1;
+				}
+				free_threads -= 1;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&scheduler->mutex);
+	return max(job_threads, 1);
+}
+
+enum nnp_status nnp_scheduler_create(
+	size_t threads_count,
+	nnp_scheduler_t* scheduler_out)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (threads_count == 0) {
+		return nnp_status_invalid_threads_count;
+	}
+
+	struct nnp_scheduler* scheduler = calloc(1, sizeof(struct nnp_scheduler) + threads_count * sizeof(struct scheduler_worker));
+	if (scheduler == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	scheduler->threads_count = threads_count;
+	scheduler->nodes_count = min(nnp_numa_nodes_count(), threads_count);
+	atomic_init(&scheduler->generation, 0);
+	pthread_mutex_init(&scheduler->mutex, NULL);
+	pthread_cond_init(&scheduler->work_condition, NULL);
+
+	for (size_t thread = 0; thread < threads_count; thread++) {
+		/* Workers are split between nodes in contiguous groups of equal size */
+		struct scheduler_worker* worker = &scheduler->workers[thread];
+		worker->scheduler = scheduler;
+		worker->node = thread * scheduler->nodes_count / threads_count;
+		if (pthread_create(&worker->thread, NULL, worker_thread_main, worker) != 0) {
+			nnp_scheduler_destroy(scheduler);
+			return nnp_status_system_error;
+		}
+		scheduler->started_threads_count += 1;
+	}
+
+	*scheduler_out = scheduler;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_scheduler_begin_job(
+	nnp_scheduler_t scheduler,
+	uint32_t priority,
+	size_t min_threads,
+	nnp_scheduler_job_t* job_out)
+{
+	if (min_threads == 0 || min_threads > scheduler->threads_count) {
+		return nnp_status_invalid_threads_count;
+	}
+
+	struct nnp_scheduler_job* job = calloc(1, sizeof(struct nnp_scheduler_job));
+	if (job == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	job->scheduler = scheduler;
+	job->priority = priority;
+	job->min_threads = min_threads;
+	pthread_cond_init(&job->completion_condition, NULL);
+
+	/* Insert after the jobs with the same or higher priority, so minimums of earlier jobs are met first */
+	pthread_mutex_lock(&scheduler->mutex);
+	struct nnp_scheduler_job** link = &scheduler->jobs;
+	while (*link != NULL && (*link)->priority >= priority) {
+		link = &(*link)->next;
+	}
+	job->next = *link;
+	*link = job;
+	pthread_mutex_unlock(&scheduler->mutex);
+
+	job->previous_job = nnp_scheduler_current_job;
+	nnp_scheduler_current_job = job;
+
+	*job_out = job;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_scheduler_end_job(nnp_scheduler_job_t job) {
+	struct nnp_scheduler* scheduler = job->scheduler;
+	pthread_mutex_lock(&scheduler->mutex);
+	struct nnp_scheduler_job** link = &scheduler->jobs;
+	while (*link != job) {
+		link = &(*link)->next;
+	}
+	*link = job->next;
+	pthread_mutex_unlock(&scheduler->mutex);
+
+	nnp_scheduler_current_job = job->previous_job;
+
+	pthread_cond_destroy(&job->completion_condition);
+	free(job);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_scheduler_destroy(nnp_scheduler_t scheduler) {
+	if (scheduler != NULL) {
+		pthread_mutex_lock(&scheduler->mutex);
+		scheduler->shutdown = true;
+		pthread_cond_broadcast(&scheduler->work_condition);
+		pthread_mutex_unlock(&scheduler->mutex);
+		for (size_t thread = 0; thread < scheduler->started_threads_count; thread++) {
+			pthread_join(scheduler->workers[thread].thread, NULL);
+		}
+
+		pthread_cond_destroy(&scheduler->work_condition);
+		pthread_mutex_destroy(&scheduler->mutex);
+		free(scheduler);
+	}
+	return nnp_status_success;
+}
@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <nnpack.h>
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+
+
+/*
+ * Layout of a shared memory object: struct shared_kernel_header, followed by the transformed kernel, followed by the
+ * original kernel. The object is named by a hash, and the original kernel tells apart kernels with the same hash.
+ * Processes create and validate the object while holding an exclusive lock on it, and the creator sets the ready flag
+ * after the kernel is transformed. An object without the ready flag was left by a process which died, and is redone.
+ */
+
+/* The last character is the layout version: version 2 added the original kernel */
+#define SHARED_KERNEL_MAGIC "NNPKERN2"
+#define SHARED_KERNEL_ALIGNMENT 64
+
+#if NNP_ARCH_X86_64
+	#define SHARED_KERNEL_ARCHITECTURE 1
+#elif NNP_ARCH_PSIMD
+	#define SHARED_KERNEL_ARCHITECTURE 2
+#endif
+
+struct shared_kernel_header {
+	char magic[8];
+	uint32_t architecture;
+	uint32_t simd_width;
+	uint32_t algorithm;
+	uint32_t tile_elements;
+	uint64_t input_channels;
+	uint64_t output_channels;
+	uint32_t kernel_height;
+	uint32_t kernel_width;
+	uint64_t data_size;
+	uint32_t ready;
+	uint32_t reserved;
+};
+
+struct nnp_shared_kernel {
+	void* mapping;
+	size_t mapping_size;
+	/* POSIX shared memory object name: slash, "nnp", and 96-bit hash in hex, short enough for all systems */
+	char name[32];
+};
+
+/* Two 64-bit hashes with different mixing, of which 96 bits are used to name the object */
+struct kernel_hash {
+	uint64_t fnv;
+	uint64_t mix;
+};
+
+static void update_kernel_hash(struct kernel_hash hash[restrict static 1], const void* data, size_t size) {
+	const uint8_t* bytes = data;
+	uint64_t fnv = hash->fnv;
+	uint64_t mix = hash->mix;
+	for (size_t i = 0; i < size; i++) {
+		fnv = (fnv ^ bytes[i]) * UINT64_C(0x100000001B3);
+		mix = (mix + bytes[i]) * UINT64_C(0x9E3779B97F4A7C15);
+		mix ^= mix >> 29;
+	}
+	hash->fnv = fnv;
+	hash->mix = mix;
+}
+
+/* Location of the original kernel in the shared memory object, after the transformed kernel */
+static inline size_t get_kernel_offset(const struct shared_kernel_header header[restrict static 1]) {
+	return SHARED_KERNEL_ALIGNMENT + round_up(header->data_size, SHARED_KERNEL_ALIGNMENT);
+}
+
+static inline size_t get_kernel_size(const struct shared_kernel_header header[restrict static 1]) {
+	return header->output_channels * header->input_channels * header->kernel_height * header->kernel_width * sizeof(float);
+}
+
+/* Locks or unlocks the shared memory object, and retries if interrupted by a signal */
+static bool lock_object(int fd, int operation) {
+	int result;
+	do {
+		result = flock(fd, operation);
+	} while (result != 0 && errno == EINTR);
+	return result == 0;
+}
+
+static enum nnp_status create_object(
+	int fd,
+	const struct shared_kernel_header header[restrict static 1],
+	size_t mapping_size,
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	const float kernel[],
+	pthreadpool_t threadpool)
+{
+	if (ftruncate(fd, (off_t) mapping_size) != 0) {
+		return nnp_status_io_error;
+	}
+
+	void* mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		return nnp_status_io_error;
+	}
+
+	struct shared_kernel_header* object_header = mapping;
+	*object_header = *header;
+	object_header->ready = 0;
+
+	size_t data_size = header->data_size;
+	const enum nnp_status status = nnp_convolution_inference_transform_kernel(
+		algorithm, input_channels, output_channels, kernel_size,
+		kernel, (char*) mapping + SHARED_KERNEL_ALIGNMENT, &data_size,
+		threadpool);
+	memcpy((char*) mapping + get_kernel_offset(header), kernel, get_kernel_size(header));
+	if (status == nnp_status_success) {
+		object_header->ready = 1;
+	}
+
+	munmap(mapping, mapping_size);
+	return status;
+}
+
+enum nnp_status nnp_convolution_inference_share_kernel(
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	const float kernel[],
+	nnp_shared_kernel_t* shared_kernel_out,
+	pthreadpool_t threadpool)
+{
+	struct nnp_shared_kernel* shared_kernel = NULL;
+	int fd = -1;
+	enum nnp_status status = nnp_status_success;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	/* Validates parameters and checks that the algorithm is implemented for the host CPU */
+	size_t data_size = 0;
+	status = nnp_convolution_inference_transform_kernel(
+		algorithm, input_channels, output_channels, kernel_size,
+		kernel, NULL, &data_size,
+		threadpool);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	struct shared_kernel_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SHARED_KERNEL_MAGIC, sizeof(header.magic));
+	header.architecture = SHARED_KERNEL_ARCHITECTURE;
+	header.simd_width = nnp_hwinfo.simd_width;
+	header.algorithm = algorithm;
+	header.tile_elements = data_size / (input_channels * output_channels * sizeof(float));
+	header.input_channels = input_channels;
+	header.output_channels = output_channels;
+	header.kernel_height = kernel_size.height;
+	header.kernel_width = kernel_size.width;
+	header.data_size = data_size;
+	header.ready = 1;
+
+	/* Header without the ready flag identifies the layout, and is hashed together with the kernel */
+	struct kernel_hash hash = {
+		.fnv = UINT64_C(0xCBF29CE484222325),
+		.mix = UINT64_C(0x2545F4914F6CDD1D),
+	};
+	update_kernel_hash(&hash, &header, offsetof(struct shared_kernel_header, ready));
+	update_kernel_hash(&hash, kernel, get_kernel_size(&header));
+
+	shared_kernel = calloc(1, sizeof(struct nnp_shared_kernel));
+	if (shared_kernel == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	snprintf(shared_kernel->name, sizeof(shared_kernel->name), "/nnp%016llx%08x",
+		(unsigned long long) hash.fnv, (unsigned int) (hash.mix >> 32));
+	shared_kernel->mapping_size = get_kernel_offset(&header) + get_kernel_size(&header);
+
+	fd = shm_open(shared_kernel->name, O_RDWR | O_CREAT, 0644);
+	if (fd == -1) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	/* Processes which request the same kernel wait here until the first one transforms it */
+	if (!lock_object(fd, LOCK_EX)) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	struct stat object_stat;
+	if (fstat(fd, &object_stat) != 0) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	bool ready = false;
+	if ((size_t) object_stat.st_size >= sizeof(struct shared_kernel_header)) {
+		struct shared_kernel_header object_header;
+		if (pread(fd, &object_header, sizeof(object_header), 0) != (ssize_t) sizeof(object_header)) {
+			status = nnp_status_io_error;
+			goto cleanup;
+		}
+		if (object_header.ready) {
+			if (memcmp(&object_header, &header, sizeof(header)) != 0 ||
+				(size_t) object_stat.st_size < shared_kernel->mapping_size)
+			{
+				/* A complete object for a different layout with the same hash: it may be mapped by other processes */
+				status = nnp_status_io_error;
+				goto cleanup;
+			}
+			ready = true;
+		}
+	}
+
+	if (!ready) {
+		/* New object, or an object left incomplete by a process which died */
+		status = create_object(fd, &header, shared_kernel->mapping_size,
+			algorithm, input_channels, output_channels, kernel_size, kernel,
+			threadpool);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+	}
+
+	void* mapping = mmap(NULL, shared_kernel->mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+	shared_kernel->mapping = mapping;
+
+	if (memcmp((const char*) mapping + get_kernel_offset(&header), kernel, get_kernel_size(&header)) != 0) {
+		/* A complete object for a different kernel with the same hash and layout */
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	*shared_kernel_out = shared_kernel;
+	shared_kernel = NULL;
+
+cleanup:
+	if (fd != -1) {
+		/* The mapping holds a reference to the open file, so closing the descriptor would not release the lock */
+		flock(fd, LOCK_UN);
+		close(fd);
+	}
+	nnp_shared_kernel_release(shared_kernel);
+	return status;
+}
+
+enum nnp_status nnp_shared_kernel_get_data(
+	nnp_shared_kernel_t shared_kernel,
+	const void** transformed_kernel)
+{
+	*transformed_kernel = (const char*) shared_kernel->mapping + SHARED_KERNEL_ALIGNMENT;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_shared_kernel_remove(nnp_shared_kernel_t shared_kernel) {
+	if (shm_unlink(shared_kernel->name) != 0 && errno != ENOENT) {
+		return nnp_status_io_error;
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_shared_kernel_release(nnp_shared_kernel_t shared_kernel) {
+	if (shared_kernel != NULL) {
+		if (shared_kernel->mapping != NULL) {
+			munmap(shared_kernel->mapping, shared_kernel->mapping_size);
+		}
+		free(shared_kernel);
+	}
+	return nnp_status_success;
+}
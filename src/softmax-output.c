@@ -1,4 +1,5 @@
 #include <string.h>
+#include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -6,8 +7,12 @@
 #include <nnpack.h>
 #include <nnpack/softmax.h>
 #include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/hwinfo.h>
 
 #include <nnpack/validation.h>
+#include <nnpack/workspace.h>
+#include <nnpack/scheduler.h>
 
 
 struct NNP_CACHE_ALIGN inplace_softmax_context {
@@ -51,11 +56,156 @@ static void compute_outplace_softmax_output(
     softmax_function(channels, input[sample], output[sample]);
 }
 
-enum nnp_status nnp_softmax_output(
+/*
+ * Split-row softmax processes every row in blocks, so that a single wide row is parallelized across threads:
+ * 1. Every block computes its maximum m[b] and sum of exp(x - m[b]).
+ * 2. Partial results of every row are reduced to the row maximum M and sum of m[b]-rescaled partial sums.
+ * 3. Every block computes y := exp(x - M) / sum.
+ * The first pass reads a block twice, but the block fits into L1 cache.
+ */
+struct NNP_CACHE_ALIGN softmax_partial_context {
+    nnp_softmax_partial_function partial_function;
+    size_t channels;
+    size_t block_size;
+    size_t blocks;
+    const float* input;
+    float* block_max;
+    float* block_sum;
+};
+
+static void compute_softmax_partial(
+    const struct softmax_partial_context context[restrict static 1],
+    size_t sample, size_t block)
+{
+    const nnp_softmax_partial_function partial_function = context->partial_function;
+    const size_t channels                               = context->channels;
+    const size_t block_size                             = context->block_size;
+    const size_t blocks                                 = context->blocks;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*block_max)[blocks] =
+        (float(*)[blocks]) context->block_max;
+    float (*block_sum)[blocks] =
+        (float(*)[blocks]) context->block_sum;
+
+    const size_t block_start = block * block_size;
+    partial_function(min(block_size, channels - block_start), &input[sample][block_start],
+        &block_max[sample][block], &block_sum[sample][block]);
+}
+
+struct NNP_CACHE_ALIGN softmax_scale_context {
+    nnp_softmax_scale_function scale_function;
+    size_t channels;
+    size_t block_size;
+    const float* input;
+    float* output;
+    const float* row_max;
+    const float* row_scale;
+};
+
+static void compute_softmax_scale(
+    const struct softmax_scale_context context[restrict static 1],
+    size_t sample, size_t block)
+{
+    const nnp_softmax_scale_function scale_function = context->scale_function;
+    const size_t channels                           = context->channels;
+    const size_t block_size                         = context->block_size;
+    const float* row_max                            = context->row_max;
+    const float* row_scale                          = context->row_scale;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*output)[channels] =
+        (float(*)[channels]) context->output;
+
+    const size_t block_start = block * block_size;
+    scale_function(min(block_size, channels - block_start), &input[sample][block_start], &output[sample][block_start],
+        row_scale[sample], row_max[sample]);
+}
+
+static enum nnp_status compute_split_row_softmax_output(
     size_t batch_size,
     size_t channels,
+    size_t block_size,
     const float* input,
     float* output,
+    void* memory_block,
+    pthreadpool_t threadpool)
+{
+    const size_t blocks = divide_round_up(channels, block_size);
+    const size_t partials_size = batch_size * blocks * sizeof(float);
+    const size_t rows_size = batch_size * sizeof(float);
+
+    float* block_max = memory_block;
+    float* block_sum = memory_block + partials_size;
+    float* row_max = memory_block + 2 * partials_size;
+    float* row_scale = memory_block + 2 * partials_size + rows_size;
+
+    struct softmax_partial_context softmax_partial_context = {
+    #if NNP_ARCH_X86_64
+        .partial_function = nnp_softmax_partial__avx2,
+    #elif NNP_ARCH_PSIMD
+        .partial_function = nnp_softmax_partial__psimd,
+    #endif
+        .channels = channels,
+        .block_size = block_size,
+        .blocks = blocks,
+        .input = input,
+        .block_max = block_max,
+        .block_sum = block_sum,
+    };
+    nnp_compute_2d(threadpool,
+        (pthreadpool_function_2d_t) compute_softmax_partial,
+        &softmax_partial_context,
+        batch_size, blocks);
+
+    for (size_t sample = 0; sample < batch_size; sample++) {
+        float max = block_max[sample * blocks];
+        for (size_t block = 1; block < blocks; block++) {
+            max = maxf(max, block_max[sample * blocks + block]);
+        }
+        float sum = 0.0f;
+        for (size_t block = 0; block < blocks; block++) {
+            sum += block_sum[sample * blocks + block] * expf(block_max[sample * blocks + block] - max);
+        }
+        row_max[sample] = max;
+        row_scale[sample] = 1.0f / sum;
+    }
+
+    struct softmax_scale_context softmax_scale_context = {
+    #if NNP_ARCH_X86_64
+        .scale_function = nnp_softmax_scale__avx2,
+    #elif NNP_ARCH_PSIMD
+        .scale_function = nnp_softmax_scale__psimd,
+    #endif
+        .channels = channels,
+        .block_size = block_size,
+        .input = input,
+        .output = output,
+        .row_max = row_max,
+        .row_scale = row_scale,
+    };
+    nnp_compute_2d(threadpool,
+        (pthreadpool_function_2d_t) compute_softmax_scale,
+        &softmax_scale_context,
+        batch_size, blocks);
+
+    return nnp_status_success;
+}
+
+static size_t get_split_row_softmax_memory_size(size_t batch_size, size_t channels, size_t block_size) {
+    const size_t blocks = divide_round_up(channels, block_size);
+    return 2 * batch_size * blocks * sizeof(float) + 2 * batch_size * sizeof(float);
+}
+
+enum nnp_status nnp_softmax_output_with_workspace(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    float* output,
+    void* workspace_buffer,
+    size_t* workspace_size,
     pthreadpool_t threadpool)
 {
     enum nnp_status status = validate_softmax_arguments(batch_size, channels);
@@ -63,6 +213,44 @@ enum nnp_status nnp_softmax_output(
         return status;
     }
 
+    const size_t block_size = round_down(nnp_hwinfo.blocking.l1 / (2 * sizeof(float)), 16);
+    if (workspace_buffer == NULL && workspace_size != NULL) {
+        /* Query of the workspace size: split-row softmax may be used with any threadpool */
+        *workspace_size = (channels >= 2 * block_size) ?
+            get_split_row_softmax_memory_size(batch_size, channels, block_size) : 0;
+        return nnp_status_success;
+    }
+
+    /*
+     * With fewer rows than threads, parallelization over rows leaves threads idle, and a single wide row
+     * (e.g. output layer of a language model) would run on one thread. Split rows into L1-sized blocks instead.
+     */
+    const size_t threads_count = nnp_get_threads_count(threadpool);
+    if ((batch_size < threads_count) && (channels >= 2 * block_size)) {
+        const size_t memory_size = get_split_row_softmax_memory_size(batch_size, channels, block_size);
+        if (workspace_buffer == NULL) {
+            void* memory_block = allocate_memory(memory_size);
+            if (memory_block == NULL) {
+                return nnp_status_out_of_memory;
+            }
+            status = compute_split_row_softmax_output(batch_size, channels, block_size,
+                input, output, memory_block, threadpool);
+            release_memory(memory_block, memory_size);
+            return status;
+        }
+
+        if (*workspace_size < memory_size) {
+            return nnp_status_insufficient_buffer;
+        }
+
+        if (((uintptr_t) workspace_buffer) % 64 != 0) {
+            return nnp_status_misaligned_buffer;
+        }
+
+        return compute_split_row_softmax_output(batch_size, channels, block_size,
+            input, output, workspace_buffer, threadpool);
+    }
+
     if (input == output) {
         /* In-place softmax */
         struct inplace_softmax_context inplace_softmax_context = {
@@ -74,7 +262,7 @@ enum nnp_status nnp_softmax_output(
             .channels = channels,
             .data = output,
         };
-        pthreadpool_compute_1d(threadpool,
+        nnp_compute_1d(threadpool,
             (pthreadpool_function_1d_t) compute_inplace_softmax_output,
             &inplace_softmax_context,
             batch_size);
@@ -90,7 +278,7 @@ enum nnp_status nnp_softmax_output(
             .input = input,
             .output = output,
         };
-        pthreadpool_compute_1d(threadpool,
+        nnp_compute_1d(threadpool,
             (pthreadpool_function_1d_t) compute_outplace_softmax_output,
             &outplace_softmax_context,
             batch_size);
@@ -98,3 +286,189 @@ enum nnp_status nnp_softmax_output(
 
     return nnp_status_success;
 }
+
+enum nnp_status nnp_softmax_output(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    float* output,
+    pthreadpool_t threadpool)
+{
+    return nnp_softmax_output_with_workspace(batch_size, channels, input, output, NULL, NULL, threadpool);
+}
+
+struct NNP_CACHE_ALIGN softmax_input_gradient_context {
+    nnp_softmax_gradient_function gradient_function;
+    size_t channels;
+    const float* grad_output;
+    const float* output;
+    float* grad_input;
+};
+
+static void compute_softmax_input_gradient(
+    const struct softmax_input_gradient_context context[restrict static 1],
+    size_t sample)
+{
+    const nnp_softmax_gradient_function gradient_function = context->gradient_function;
+    const size_t channels                                 = context->channels;
+
+    const float (*grad_output)[channels] =
+        (const float(*)[channels]) context->grad_output;
+    const float (*output)[channels] =
+        (const float(*)[channels]) context->output;
+    float (*grad_input)[channels] =
+        (float(*)[channels]) context->grad_input;
+
+    gradient_function(channels, output[sample], grad_output[sample], grad_input[sample]);
+}
+
+enum nnp_status nnp_softmax_input_gradient(
+    size_t batch_size,
+    size_t channels,
+    const float* grad_output,
+    const float* output,
+    float* grad_input,
+    pthreadpool_t threadpool)
+{
+    enum nnp_status status = validate_softmax_arguments(batch_size, channels);
+    if (status != nnp_status_success) {
+        return status;
+    }
+
+    struct softmax_input_gradient_context softmax_input_gradient_context = {
+    #if NNP_ARCH_X86_64
+        .gradient_function = nnp_softmax_gradient__avx2,
+    #elif NNP_ARCH_PSIMD
+        .gradient_function = nnp_softmax_gradient__psimd,
+    #endif
+        .channels = channels,
+        .grad_output = grad_output,
+        .output = output,
+        .grad_input = grad_input,
+    };
+    nnp_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_softmax_input_gradient,
+        &softmax_input_gradient_context,
+        batch_size);
+
+    return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN log_softmax_context {
+    nnp_log_softmax_function log_softmax_function;
+    size_t channels;
+    const float* input;
+    float* output;
+};
+
+static void compute_log_softmax_output(
+    const struct log_softmax_context context[restrict static 1],
+    size_t sample)
+{
+    const nnp_log_softmax_function log_softmax_function = context->log_softmax_function;
+    const size_t channels                               = context->channels;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*output)[channels] =
+        (float(*)[channels]) context->output;
+
+    log_softmax_function(channels, input[sample], output[sample]);
+}
+
+enum nnp_status nnp_log_softmax_output(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    float* output,
+    pthreadpool_t threadpool)
+{
+    enum nnp_status status = validate_softmax_arguments(batch_size, channels);
+    if (status != nnp_status_success) {
+        return status;
+    }
+
+    /* Log-softmax micro-kernels load every input element before storing the output element, so in-place is fine */
+    struct log_softmax_context log_softmax_context = {
+    #if NNP_ARCH_X86_64
+        .log_softmax_function = nnp_log_softmax__avx2,
+    #elif NNP_ARCH_PSIMD
+        .log_softmax_function = nnp_log_softmax__psimd,
+    #endif
+        .channels = channels,
+        .input = input,
+        .output = output,
+    };
+    nnp_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_log_softmax_output,
+        &log_softmax_context,
+        batch_size);
+
+    return nnp_status_success;
+}
+
+struct NNP_CACHE_ALIGN softmax_cross_entropy_context {
+    nnp_softmax_cross_entropy_function cross_entropy_function;
+    size_t channels;
+    const float* input;
+    const uint32_t* labels;
+    float* loss;
+    float* grad_input;
+};
+
+static void compute_softmax_cross_entropy(
+    const struct softmax_cross_entropy_context context[restrict static 1],
+    size_t sample)
+{
+    const nnp_softmax_cross_entropy_function cross_entropy_function = context->cross_entropy_function;
+    const size_t channels                                           = context->channels;
+    const uint32_t* labels                                          = context->labels;
+    float* loss                                                     = context->loss;
+
+    const float (*input)[channels] =
+        (const float(*)[channels]) context->input;
+    float (*grad_input)[channels] =
+        (float(*)[channels]) context->grad_input;
+
+    loss[sample] = cross_entropy_function(channels, input[sample], labels[sample], grad_input[sample]);
+}
+
+enum nnp_status nnp_softmax_cross_entropy_loss_and_gradient(
+    size_t batch_size,
+    size_t channels,
+    const float* input,
+    const uint32_t* labels,
+    float* loss,
+    float* grad_input,
+    pthreadpool_t threadpool)
+{
+    enum nnp_status status = validate_softmax_arguments(batch_size, channels);
+    if (status != nnp_status_success) {
+        return status;
+    }
+
+    for (size_t sample = 0; sample < batch_size; sample++) {
+        if (labels[sample] >= channels) {
+            return nnp_status_invalid_label;
+        }
+    }
+
+    struct softmax_cross_entropy_context softmax_cross_entropy_context = {
+    #if NNP_ARCH_X86_64
+        .cross_entropy_function = nnp_softmax_cross_entropy__avx2,
+    #elif NNP_ARCH_PSIMD
+        .cross_entropy_function = nnp_softmax_cross_entropy__psimd,
+    #endif
+        .channels = channels,
+        .input = input,
+        .labels = labels,
+        .loss = loss,
+        .grad_input = grad_input,
+    };
+    nnp_compute_1d(threadpool,
+        (pthreadpool_function_1d_t) compute_softmax_cross_entropy,
+        &softmax_cross_entropy_context,
+        batch_size);
+
+    return nnp_status_success;
+}
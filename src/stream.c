@@ -0,0 +1,253 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__)
+	#include <sys/eventfd.h>
+#endif
+
+#include <nnpack.h>
+#include <nnpack/hwinfo.h>
+
+
+struct network_run_arguments {
+	nnp_network_t network;
+	const float* input;
+	float* output;
+};
+
+struct stream_operation {
+	struct stream_operation* next;
+	nnp_stream_function function;
+	void* context;
+	nnp_stream_callback callback;
+	void* callback_context;
+	/* Arguments of an operation enqueued by nnp_stream_enqueue_network_run */
+	struct network_run_arguments network_run;
+};
+
+struct nnp_stream {
+	pthreadpool_t threadpool;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	/* Signaled when an operation is enqueued, or the stream is destroyed */
+	pthread_cond_t operation_condition;
+	/* Signaled when all enqueued operations are completed */
+	pthread_cond_t completion_condition;
+	/* FIFO queue of operations which did not start yet */
+	struct stream_operation* head;
+	struct stream_operation* tail;
+	/* The number of enqueued operations which did not complete yet, including the running one */
+	size_t pending_count;
+	/* Status of the first operation which failed since the last nnp_stream_synchronize call */
+	enum nnp_status status;
+	bool shutdown;
+	int event_fd;
+};
+
+static void signal_completion(const struct nnp_stream stream[restrict static 1]) {
+#if defined(__linux__)
+	if (stream->event_fd != -1) {
+		const uint64_t increment = 1;
+		/* Fails only if the counter would overflow, i.e. if the reader never reads it */
+		ssize_t bytes_written = write(stream->event_fd, &increment, sizeof(increment));
+		(void) bytes_written;
+	}
+#endif
+}
+
+/* Runs operations of the stream in order until the stream is destroyed and its queue is empty */
+static void* stream_thread_main(void* argument) {
+	struct nnp_stream* stream = argument;
+
+	pthread_mutex_lock(&stream->mutex);
+	for (;;) {
+		while (stream->head == NULL && !stream->shutdown) {
+			pthread_cond_wait(&stream->operation_condition, &stream->mutex);
+		}
+		struct stream_operation* operation = stream->head;
+		if (operation == NULL) {
+			break;
+		}
+		stream->head = operation->next;
+		if (stream->head == NULL) {
+			stream->tail = NULL;
+		}
+		pthread_mutex_unlock(&stream->mutex);
+
+		const enum nnp_status status = operation->function(operation->context, stream->threadpool);
+		if (operation->callback != NULL) {
+			operation->callback(operation->callback_context, status);
+		}
+		signal_completion(stream);
+		free(operation);
+
+		pthread_mutex_lock(&stream->mutex);
+		if (status != nnp_status_success && stream->status == nnp_status_success) {
+			stream->status = status;
+		}
+		if (--stream->pending_count == 0) {
+			pthread_cond_broadcast(&stream->completion_condition);
+		}
+	}
+	pthread_mutex_unlock(&stream->mutex);
+	return NULL;
+}
+
+enum nnp_status nnp_stream_create(
+	pthreadpool_t threadpool,
+	nnp_stream_t* stream_out)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	struct nnp_stream* stream = calloc(1, sizeof(struct nnp_stream));
+	if (stream == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	enum nnp_status status;
+	stream->threadpool = threadpool;
+	stream->status = nnp_status_success;
+	stream->event_fd = -1;
+	pthread_mutex_init(&stream->mutex, NULL);
+	pthread_cond_init(&stream->operation_condition, NULL);
+	pthread_cond_init(&stream->completion_condition, NULL);
+
+#if defined(__linux__)
+	stream->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (stream->event_fd == -1) {
+		status = (errno == ENOMEM) ? nnp_status_out_of_memory : nnp_status_system_error;
+		goto error;
+	}
+#endif
+
+	if (pthread_create(&stream->thread, NULL, stream_thread_main, stream) != 0) {
+		status = nnp_status_system_error;
+		goto error;
+	}
+
+	*stream_out = stream;
+	return nnp_status_success;
+
+error:
+	if (stream->event_fd != -1) {
+		close(stream->event_fd);
+	}
+	pthread_cond_destroy(&stream->completion_condition);
+	pthread_cond_destroy(&stream->operation_condition);
+	pthread_mutex_destroy(&stream->mutex);
+	free(stream);
+	return status;
+}
+
+static void enqueue_operation(struct nnp_stream stream[restrict static 1], struct stream_operation operation[restrict static 1]) {
+	pthread_mutex_lock(&stream->mutex);
+	if (stream->tail == NULL) {
+		stream->head = operation;
+	} else {
+		stream->tail->next = operation;
+	}
+	stream->tail = operation;
+	stream->pending_count += 1;
+	pthread_cond_signal(&stream->operation_condition);
+	pthread_mutex_unlock(&stream->mutex);
+}
+
+enum nnp_status nnp_stream_enqueue(
+	nnp_stream_t stream,
+	nnp_stream_function function,
+	void* context,
+	nnp_stream_callback callback,
+	void* callback_context)
+{
+	struct stream_operation* operation = calloc(1, sizeof(struct stream_operation));
+	if (operation == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	operation->function = function;
+	operation->context = context;
+	operation->callback = callback;
+	operation->callback_context = callback_context;
+
+	enqueue_operation(stream, operation);
+	return nnp_status_success;
+}
+
+static enum nnp_status run_network(const struct network_run_arguments arguments[restrict static 1], pthreadpool_t threadpool) {
+	return nnp_network_run(arguments->network, arguments->input, arguments->output, threadpool);
+}
+
+enum nnp_status nnp_stream_enqueue_network_run(
+	nnp_stream_t stream,
+	nnp_network_t network,
+	const float input[],
+	float output[],
+	nnp_stream_callback callback,
+	void* callback_context)
+{
+	struct stream_operation* operation = calloc(1, sizeof(struct stream_operation));
+	if (operation == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	operation->network_run = (struct network_run_arguments) {
+		.network = network,
+		.input = input,
+		.output = output,
+	};
+	operation->function = (nnp_stream_function) run_network;
+	operation->context = &operation->network_run;
+	operation->callback = callback;
+	operation->callback_context = callback_context;
+
+	enqueue_operation(stream, operation);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_stream_synchronize(nnp_stream_t stream) {
+	pthread_mutex_lock(&stream->mutex);
+	while (stream->pending_count != 0) {
+		pthread_cond_wait(&stream->completion_condition, &stream->mutex);
+	}
+	const enum nnp_status status = stream->status;
+	stream->status = nnp_status_success;
+	pthread_mutex_unlock(&stream->mutex);
+	return status;
+}
+
+enum nnp_status nnp_stream_get_event_fd(
+	nnp_stream_t stream,
+	int* event_fd)
+{
+	if (stream->event_fd == -1) {
+		return nnp_status_unsupported_hardware;
+	}
+	*event_fd = stream->event_fd;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_stream_destroy(nnp_stream_t stream) {
+	if (stream != NULL) {
+		pthread_mutex_lock(&stream->mutex);
+		stream->shutdown = true;
+		pthread_cond_signal(&stream->operation_condition);
+		pthread_mutex_unlock(&stream->mutex);
+		pthread_join(stream->thread, NULL);
+
+		if (stream->event_fd != -1) {
+			close(stream->event_fd);
+		}
+		pthread_cond_destroy(&stream->completion_condition);
+		pthread_cond_destroy(&stream->operation_condition);
+		pthread_mutex_destroy(&stream->mutex);
+		free(stream);
+	}
+	return nnp_status_success;
+}
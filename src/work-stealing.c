@@ -0,0 +1,219 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/scheduler.h>
+
+
+/*
+ * Work-stealing tiled loops on a pthreadpool. Tiles are numbered in row-major order, and every thread starts with a
+ * contiguous range of tiles. The owner takes tiles from the front of its range. When the range is empty, the thread
+ * steals the back half of the range of another thread, and continues with it as its own range, so the stolen tiles
+ * may be stolen again. Both ends of a range are packed in one 64-bit word and updated with compare-and-swap.
+ */
+
+#define RANGE_ALIGNMENT 64
+/* Maximum number of threads with their own ranges. Loops on larger thread pools use the static split of pthreadpool. */
+#define MAX_THREADS 64
+
+struct thread_range {
+	/* Index of the first tile in the low half, and of the tile after the last one in the high half */
+	_Alignas(RANGE_ALIGNMENT) atomic_uint_fast64_t range;
+};
+
+enum loop_type {
+	loop_type_1d_tiled,
+	loop_type_2d_tiled,
+};
+
+struct work_stealing_context {
+	enum loop_type type;
+	union {
+		pthreadpool_function_1d_tiled_t function_1d_tiled;
+		pthreadpool_function_2d_tiled_t function_2d_tiled;
+	};
+	void* argument;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+	size_t tiles_j;
+	size_t threads_count;
+	struct thread_range* ranges;
+};
+
+static inline uint64_t pack_range(uint32_t start, uint32_t end) {
+	return ((uint64_t) end << 32) | (uint64_t) start;
+}
+
+static inline uint32_t range_start(uint64_t range) {
+	return (uint32_t) range;
+}
+
+static inline uint32_t range_end(uint64_t range) {
+	return (uint32_t) (range >> 32);
+}
+
+static void run_tile(const struct work_stealing_context context[restrict static 1], size_t tile) {
+	const size_t index_i = tile / context->tiles_j * context->tile_i;
+	const size_t index_j = tile % context->tiles_j * context->tile_j;
+	switch (context->type) {
+		case loop_type_1d_tiled:
+			context->function_1d_tiled(context->argument, index_j, min(context->range_j - index_j, context->tile_j));
+			break;
+		case loop_type_2d_tiled:
+			context->function_2d_tiled(context->argument, index_i, index_j,
+				min(context->range_i - index_i, context->tile_i), min(context->range_j - index_j, context->tile_j));
+			break;
+	}
+}
+
+/* Takes the tile at the front of the thread's own range. Returns false if the range is empty. */
+static bool pop_tile(struct thread_range thread_range[restrict static 1], uint32_t tile[restrict static 1]) {
+	uint64_t range = atomic_load_explicit(&thread_range->range, memory_order_relaxed);
+	for (;;) {
+		const uint32_t start = range_start(range);
+		const uint32_t end = range_end(range);
+		if (start >= end) {
+			return false;
+		}
+		if (atomic_compare_exchange_weak_explicit(&thread_range->range, &range, pack_range(start + 1, end),
+			memory_order_acquire, memory_order_relaxed))
+		{
+			*tile = start;
+			return true;
+		}
+	}
+}
+
+/* Moves the back half of the victim's range, rounded up, to the thief. Returns false if the victim has no tiles. */
+static bool steal_half(
+	struct thread_range victim[restrict static 1],
+	struct thread_range thief[restrict static 1])
+{
+	uint64_t range = atomic_load_explicit(&victim->range, memory_order_relaxed);
+	for (;;) {
+		const uint32_t start = range_start(range);
+		const uint32_t end = range_end(range);
+		if (start >= end) {
+			return false;
+		}
+		const uint32_t middle = end - (end - start + 1) / 2;
+		if (atomic_compare_exchange_weak_explicit(&victim->range, &range, pack_range(start, middle),
+			memory_order_acquire, memory_order_relaxed))
+		{
+			/* Thief's range is empty, so other threads only read it, and their stale values fail to swap */
+			atomic_store_explicit(&thief->range, pack_range(middle, end), memory_order_release);
+			return true;
+		}
+	}
+}
+
+static void run_thread(const struct work_stealing_context context[restrict static 1], size_t thread) {
+	struct thread_range* own_range = &context->ranges[thread];
+	const size_t threads_count = context->threads_count;
+	for (;;) {
+		uint32_t tile;
+		while (pop_tile(own_range, &tile)) {
+			run_tile(context, tile);
+		}
+
+		/* Scan other threads, starting from the next one, and finish when none has tiles left */
+		bool stolen = false;
+		for (size_t i = 1; i < threads_count && !stolen; i++) {
+			const size_t victim = (thread + i) % threads_count;
+			stolen = steal_half(&context->ranges[victim], own_range);
+		}
+		if (!stolen) {
+			return;
+		}
+	}
+}
+
+static void compute_work_stealing(
+	pthreadpool_t threadpool,
+	struct work_stealing_context context[restrict static 1])
+{
+	context->tiles_j = divide_round_up(context->range_j, context->tile_j);
+	const size_t tiles_count = divide_round_up(context->range_i, context->tile_i) * context->tiles_j;
+	const size_t threads_count = min((threadpool == NULL) ? 1 : pthreadpool_get_threads_count(threadpool), tiles_count);
+
+	if (threads_count <= 1) {
+		for (size_t tile = 0; tile < tiles_count; tile++) {
+			run_tile(context, tile);
+		}
+		return;
+	}
+
+	if (tiles_count > UINT32_MAX || threads_count > MAX_THREADS) {
+		/* Tile indices do not fit into packed ranges, or too many threads: fall back to the static split of pthreadpool */
+		switch (context->type) {
+			case loop_type_1d_tiled:
+				pthreadpool_compute_1d_tiled(threadpool, context->function_1d_tiled, context->argument,
+					context->range_j, context->tile_j);
+				break;
+			case loop_type_2d_tiled:
+				pthreadpool_compute_2d_tiled(threadpool, context->function_2d_tiled, context->argument,
+					context->range_i, context->range_j, context->tile_i, context->tile_j);
+				break;
+		}
+		return;
+	}
+
+	/* Ranges live on the stack of the calling thread, which waits for the loop to complete */
+	struct thread_range ranges[MAX_THREADS];
+	for (size_t thread = 0; thread < threads_count; thread++) {
+		const uint32_t start = (uint32_t) (thread * tiles_count / threads_count);
+		const uint32_t end = (uint32_t) ((thread + 1) * tiles_count / threads_count);
+		atomic_init(&ranges[thread].range, pack_range(start, end));
+	}
+	context->threads_count = threads_count;
+	context->ranges = ranges;
+
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) run_thread,
+		context,
+		threads_count);
+}
+
+void nnp_work_stealing_compute_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	struct work_stealing_context context = {
+		.type = loop_type_1d_tiled,
+		.function_1d_tiled = function,
+		.argument = argument,
+		.range_i = 1,
+		.range_j = range,
+		.tile_i = 1,
+		.tile_j = tile,
+	};
+	compute_work_stealing(threadpool, &context);
+}
+
+void nnp_work_stealing_compute_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	struct work_stealing_context context = {
+		.type = loop_type_2d_tiled,
+		.function_2d_tiled = function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+	};
+	compute_work_stealing(threadpool, &context);
+}
@@ -0,0 +1,322 @@
+from vecmath.exp import simd_exp
+
+
+# The smallest x for which expf(x) is non-zero. Arguments of simd_exp are clamped to it, because simd_exp does not
+# handle underflow itself, and all exponents below are computed for non-positive arguments, so they never overflow.
+zero_cutoff = float.fromhex("-0x1.9FE368p+6")
+
+selu_alpha = float.fromhex("0x1.AC5AFAp+0")
+selu_lambda = float.fromhex("0x1.0CFABEp+0")
+gelu_sqrt_2_over_pi = float.fromhex("0x1.988454p-1")
+gelu_cubic_coefficient = float.fromhex("0x1.6E4E26p-5")
+
+# Taylor coefficients of expm1(x) = x + x^2 * (c2 + x * (c3 + ... + x * c8))
+expm1_coefficients = [
+    float.fromhex("0x1.000000p-1"),
+    float.fromhex("0x1.555556p-3"),
+    float.fromhex("0x1.555556p-5"),
+    float.fromhex("0x1.111112p-7"),
+    float.fromhex("0x1.6C16C2p-10"),
+    float.fromhex("0x1.A01A02p-13"),
+    float.fromhex("0x1.A01A02p-16"),
+]
+
+_CMP_LT_OQ = 0x11
+_CMP_GT_OQ = 0x1E
+
+
+def exp_nonpositive(ymm_x):
+    # Does not modify ymm_x
+    ymm_t = YMMRegister()
+    VMAXPS(ymm_t, ymm_x, Constant.float32x8(zero_cutoff))
+    return simd_exp([ymm_t])[0]
+
+
+def expm1_nonpositive(ymm_x):
+    # Near zero exp(x) - 1 loses precision to cancellation, and a Taylor polynomial of degree 8 is used instead
+    ymm_e = exp_nonpositive(ymm_x)
+    VSUBPS(ymm_e, ymm_e, Constant.float32x8(1.0))
+
+    ymm_p = YMMRegister()
+    VMOVAPS(ymm_p, Constant.float32x8(expm1_coefficients[-1]))
+    for coefficient in reversed(expm1_coefficients[:-1]):
+        VFMADD213PS(ymm_p, ymm_x, Constant.float32x8(coefficient))
+    VMULPS(ymm_p, ymm_p, ymm_x)
+    VFMADD213PS(ymm_p, ymm_x, ymm_x)
+
+    ymm_mask = YMMRegister()
+    VCMPPS(ymm_mask, ymm_x, Constant.float32x8(-0.5), _CMP_LT_OQ)
+    VBLENDVPS(ymm_p, ymm_p, ymm_e, ymm_mask)
+    return ymm_p
+
+
+def reciprocal(ymm_x):
+    ymm_r = YMMRegister()
+    VMOVAPS(ymm_r, Constant.float32x8(1.0))
+    VDIVPS(ymm_r, ymm_r, ymm_x)
+    return ymm_r
+
+
+def sigmoid(ymm_x):
+    # With e = exp(-|x|) and r = 1 / (1 + e): sigmoid(|x|) = r, sigmoid(-|x|) = e * r, sigmoid'(x) = e * r * r
+    ymm_minus_abs_x = YMMRegister()
+    VORPS(ymm_minus_abs_x, ymm_x, Constant.uint32x8(0x80000000))
+    ymm_e = exp_nonpositive(ymm_minus_abs_x)
+
+    ymm_r = YMMRegister()
+    VADDPS(ymm_r, ymm_e, Constant.float32x8(1.0))
+    ymm_r = reciprocal(ymm_r)
+
+    ymm_er = YMMRegister()
+    VMULPS(ymm_er, ymm_e, ymm_r)
+
+    ymm_s = YMMRegister()
+    VBLENDVPS(ymm_s, ymm_r, ymm_er, ymm_x)
+
+    ymm_ds = YMMRegister()
+    VMULPS(ymm_ds, ymm_er, ymm_r)
+    return ymm_s, ymm_ds
+
+
+def sigmoid_forward(ymm_x, ymm_alpha):
+    ymm_s, _ = sigmoid(ymm_x)
+    return ymm_s
+
+
+def sigmoid_derivative(ymm_x, ymm_alpha):
+    _, ymm_ds = sigmoid(ymm_x)
+    return ymm_ds
+
+
+def tanh(ymm_x):
+    # With m = expm1(-2|x|) and r = 1 / (2 + m): tanh(|x|) = -m * r, tanh'(x) = 4 * (1 + m) * r * r
+    ymm_t = YMMRegister()
+    VANDPS(ymm_t, ymm_x, Constant.uint32x8(0x7FFFFFFF))
+    VMULPS(ymm_t, ymm_t, Constant.float32x8(-2.0))
+    ymm_m = expm1_nonpositive(ymm_t)
+
+    ymm_r = YMMRegister()
+    VADDPS(ymm_r, ymm_m, Constant.float32x8(2.0))
+    ymm_r = reciprocal(ymm_r)
+
+    # ymm_minus_y = -tanh(|x|), ymm_y = tanh(|x|)
+    ymm_minus_y, ymm_y = YMMRegister(), YMMRegister()
+    VMULPS(ymm_minus_y, ymm_m, ymm_r)
+    VXORPS(ymm_y, ymm_minus_y, Constant.uint32x8(0x80000000))
+    VBLENDVPS(ymm_y, ymm_y, ymm_minus_y, ymm_x)
+
+    ymm_dy = YMMRegister()
+    VADDPS(ymm_dy, ymm_m, Constant.float32x8(1.0))
+    VMULPS(ymm_dy, ymm_dy, ymm_r)
+    VMULPS(ymm_dy, ymm_dy, ymm_r)
+    VMULPS(ymm_dy, ymm_dy, Constant.float32x8(4.0))
+    return ymm_y, ymm_dy
+
+
+def tanh_forward(ymm_x, ymm_alpha):
+    ymm_y, _ = tanh(ymm_x)
+    return ymm_y
+
+
+def tanh_derivative(ymm_x, ymm_alpha):
+    _, ymm_dy = tanh(ymm_x)
+    return ymm_dy
+
+
+def elu_forward(ymm_x, ymm_alpha):
+    ymm_zero = YMMRegister()
+    VXORPS(ymm_zero, ymm_zero, ymm_zero)
+
+    ymm_negative_x = YMMRegister()
+    VMINPS(ymm_negative_x, ymm_x, ymm_zero)
+    ymm_y = expm1_nonpositive(ymm_negative_x)
+    VMULPS(ymm_y, ymm_y, ymm_alpha)
+
+    ymm_mask = YMMRegister()
+    VCMPPS(ymm_mask, ymm_x, ymm_zero, _CMP_GT_OQ)
+    VBLENDVPS(ymm_y, ymm_y, ymm_x, ymm_mask)
+    return ymm_y
+
+
+def elu_derivative(ymm_x, ymm_alpha):
+    ymm_zero = YMMRegister()
+    VXORPS(ymm_zero, ymm_zero, ymm_zero)
+
+    ymm_negative_x = YMMRegister()
+    VMINPS(ymm_negative_x, ymm_x, ymm_zero)
+    ymm_dy = exp_nonpositive(ymm_negative_x)
+    VMULPS(ymm_dy, ymm_dy, ymm_alpha)
+
+    ymm_mask = YMMRegister()
+    VCMPPS(ymm_mask, ymm_x, ymm_zero, _CMP_GT_OQ)
+    VBLENDVPS(ymm_dy, ymm_dy, Constant.float32x8(1.0), ymm_mask)
+    return ymm_dy
+
+
+def selu_forward(ymm_x, ymm_alpha):
+    # alpha argument is ignored: SELU uses fixed alpha and lambda
+    ymm_selu_alpha = YMMRegister()
+    VMOVAPS(ymm_selu_alpha, Constant.float32x8(selu_alpha))
+    ymm_y = elu_forward(ymm_x, ymm_selu_alpha)
+    VMULPS(ymm_y, ymm_y, Constant.float32x8(selu_lambda))
+    return ymm_y
+
+
+def selu_derivative(ymm_x, ymm_alpha):
+    # alpha argument is ignored: SELU uses fixed alpha and lambda
+    ymm_selu_alpha = YMMRegister()
+    VMOVAPS(ymm_selu_alpha, Constant.float32x8(selu_alpha))
+    ymm_dy = elu_derivative(ymm_x, ymm_selu_alpha)
+    VMULPS(ymm_dy, ymm_dy, Constant.float32x8(selu_lambda))
+    return ymm_dy
+
+
+def gelu(ymm_x):
+    # GELU (tanh approximation) is 0.5 x (1 + tanh(u)) = x sigmoid(2u), where u = sqrt(2/pi) (x + 0.044715 x^3)
+    ymm_x2 = YMMRegister()
+    VMULPS(ymm_x2, ymm_x, ymm_x)
+
+    ymm_two_u = YMMRegister()
+    VMOVAPS(ymm_two_u, Constant.float32x8(gelu_cubic_coefficient))
+    VFMADD213PS(ymm_two_u, ymm_x2, Constant.float32x8(1.0))
+    VMULPS(ymm_two_u, ymm_two_u, ymm_x)
+    VMULPS(ymm_two_u, ymm_two_u, Constant.float32x8(2.0 * gelu_sqrt_2_over_pi))
+
+    ymm_s, ymm_ds = sigmoid(ymm_two_u)
+
+    ymm_y = YMMRegister()
+    VMULPS(ymm_y, ymm_x, ymm_s)
+
+    # GELU'(x) = sigmoid(2u) + x * sigmoid'(2u) * 2u'
+    ymm_dy = YMMRegister()
+    VMOVAPS(ymm_dy, Constant.float32x8(3.0 * gelu_cubic_coefficient))
+    VFMADD213PS(ymm_dy, ymm_x2, Constant.float32x8(1.0))
+    VMULPS(ymm_dy, ymm_dy, Constant.float32x8(2.0 * gelu_sqrt_2_over_pi))
+    VMULPS(ymm_dy, ymm_dy, ymm_ds)
+    VFMADD213PS(ymm_dy, ymm_x, ymm_s)
+    return ymm_y, ymm_dy
+
+
+def gelu_forward(ymm_x, ymm_alpha):
+    ymm_y, _ = gelu(ymm_x)
+    return ymm_y
+
+
+def gelu_derivative(ymm_x, ymm_alpha):
+    _, ymm_dy = gelu(ymm_x)
+    return ymm_dy
+
+
+def swish_forward(ymm_x, ymm_alpha):
+    ymm_s, _ = sigmoid(ymm_x)
+    VMULPS(ymm_s, ymm_s, ymm_x)
+    return ymm_s
+
+
+def swish_derivative(ymm_x, ymm_alpha):
+    # swish'(x) = sigmoid(x) + x * sigmoid'(x)
+    ymm_s, ymm_ds = sigmoid(ymm_x)
+    VFMADD213PS(ymm_ds, ymm_x, ymm_s)
+    return ymm_ds
+
+
+def generate_activation(name, forward, derivative):
+    arg_input = Argument(ptr(const_float_), "input")
+    arg_output = Argument(ptr(float_), "output")
+    arg_length = Argument(size_t, "length")
+    arg_alpha = Argument(float_, "alpha")
+    with Function("nnp_{name}_forward__avx2".format(name=name),
+        (arg_input, arg_output, arg_length, arg_alpha),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_input = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_input, arg_input)
+
+        reg_output = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_output, arg_output)
+
+        reg_length = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_length, arg_length)
+
+        ymm_alpha = YMMRegister()
+        LOAD.ARGUMENT(ymm_alpha.as_xmm, arg_alpha)
+        VBROADCASTSS(ymm_alpha, ymm_alpha.as_xmm)
+
+        loop = Loop()
+
+        TEST(reg_length, reg_length)
+        JZ(loop.end)
+        with loop:
+            # Load (unaligned!) data and update input pointer
+            ymm_x = YMMRegister()
+            VMOVUPS(ymm_x, [reg_input])
+            ADD(reg_input, YMMRegister.size)
+
+            ymm_y = forward(ymm_x, ymm_alpha)
+
+            # Store (aligned!) data and update output pointer. Output may alias input.
+            VMOVAPS([reg_output], ymm_y)
+            ADD(reg_output, YMMRegister.size)
+
+            SUB(reg_length, YMMRegister.size / float_.size)
+            JNZ(loop.begin)
+
+        RETURN()
+
+    arg_output_gradient = Argument(ptr(const_float_), "output_gradient")
+    arg_input = Argument(ptr(const_float_), "input")
+    arg_input_gradient = Argument(ptr(float_), "input_gradient")
+    arg_length = Argument(size_t, "length")
+    arg_alpha = Argument(float_, "alpha")
+    with Function("nnp_{name}_backward__avx2".format(name=name),
+        (arg_output_gradient, arg_input, arg_input_gradient, arg_length, arg_alpha),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_output_gradient = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_output_gradient, arg_output_gradient)
+
+        reg_input = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_input, arg_input)
+
+        reg_input_gradient = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_input_gradient, arg_input_gradient)
+
+        reg_length = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_length, arg_length)
+
+        ymm_alpha = YMMRegister()
+        LOAD.ARGUMENT(ymm_alpha.as_xmm, arg_alpha)
+        VBROADCASTSS(ymm_alpha, ymm_alpha.as_xmm)
+
+        loop = Loop()
+
+        TEST(reg_length, reg_length)
+        JZ(loop.end)
+        with loop:
+            # Load (unaligned!) data and update input pointer
+            ymm_x = YMMRegister()
+            VMOVUPS(ymm_x, [reg_input])
+            ADD(reg_input, YMMRegister.size)
+
+            ymm_dy = derivative(ymm_x, ymm_alpha)
+
+            # Multiply by (unaligned!) gradient and update output gradient pointer
+            VMULPS(ymm_dy, ymm_dy, [reg_output_gradient])
+            ADD(reg_output_gradient, YMMRegister.size)
+
+            # Store (aligned!) gradient and update input gradient pointer
+            VMOVAPS([reg_input_gradient], ymm_dy)
+            ADD(reg_input_gradient, YMMRegister.size)
+
+            SUB(reg_length, YMMRegister.size / float_.size)
+            JNZ(loop.begin)
+
+        RETURN()
+
+
+generate_activation("sigmoid", sigmoid_forward, sigmoid_derivative)
+generate_activation("tanh", tanh_forward, tanh_derivative)
+generate_activation("elu", elu_forward, elu_derivative)
+generate_activation("selu", selu_forward, selu_derivative)
+generate_activation("gelu", gelu_forward, gelu_derivative)
+generate_activation("swish", swish_forward, swish_derivative)
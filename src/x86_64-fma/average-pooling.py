@@ -0,0 +1,229 @@
+from common import _MM_SHUFFLE
+
+
+def generate_avgpool(pool, stride):
+    assert (pool, stride) in [(2, 2), (3, 2), (3, 1)]
+
+    # Offsets (in columns) of the 8-wide vectors loaded from every row of the input tile.
+    # With stride 2, vectors at offsets 0 and 8 provide the first and the second elements of every pool after
+    # de-interleaving, and vectors at offsets 2 and 10 provide the third element of every 3-wide pool.
+    # With stride 1, vectors at offsets 0, 1, and 2 provide the first, second, and third element of every pool.
+    column_offsets = {
+        (2, 2): [0, 8],
+        (3, 2): [0, 8, 2, 10],
+        (3, 1): [0, 1, 2],
+    }[(pool, stride)]
+
+    arg_src_pointer = Argument(ptr(const_float_), name="src_pointer")
+    arg_dst_pointer = Argument(ptr(float_), name="dst_pointer")
+    arg_src_stride = Argument(size_t, name="src_stride")
+    arg_src_row_offset = Argument(uint32_t, name="src_row_offset")
+    arg_src_row_count = Argument(uint32_t, name="src_row_count")
+    arg_src_column_offset = Argument(uint32_t, name="src_column_offset")
+    arg_src_column_count = Argument(uint32_t, name="src_column_count")
+    arg_dst_column_count = Argument(uint32_t, name="dst_column_count")
+    arg_dst_scale = Argument(ptr(const_float_), name="dst_scale")
+    with Function("nnp_avgpool_{pool}x{pool}_{stride}x{stride}__avx2".format(pool=pool, stride=stride),
+        (arg_src_pointer, arg_dst_pointer, arg_src_stride,
+        arg_src_row_offset, arg_src_row_count, arg_src_column_offset, arg_src_column_count,
+        arg_dst_column_count, arg_dst_scale),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_src_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_ptr, arg_src_pointer)
+
+        reg_dst_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_dst_ptr, arg_dst_pointer)
+
+        reg_src_stride = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_stride, arg_src_stride)
+
+        reg_src_row_index = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_index, arg_src_row_offset)
+
+        reg_src_row_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_count, arg_src_row_count)
+
+        reg_src_column_start = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_start, arg_src_column_offset)
+
+        reg_src_column_end = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_end, arg_src_column_count)
+        ADD(reg_src_column_end, reg_src_column_start)
+
+        reg_dst_column_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_dst_column_count, arg_dst_column_count)
+
+        ymm_src_column_start, ymm_src_column_end, ymm_dst_column_count = YMMRegister(), YMMRegister(), YMMRegister()
+        VMOVD(ymm_src_column_start.as_xmm, reg_src_column_start)
+        VMOVD(ymm_src_column_end.as_xmm, reg_src_column_end)
+        VMOVD(ymm_dst_column_count.as_xmm, reg_dst_column_count)
+        VPBROADCASTD(ymm_src_column_start, ymm_src_column_start.as_xmm)
+        VPBROADCASTD(ymm_src_column_end, ymm_src_column_end.as_xmm)
+        VPBROADCASTD(ymm_dst_column_count, ymm_dst_column_count.as_xmm)
+
+        # Mask for every loaded vector: lane is loaded if src_column_offset <= column < src_column_offset + src_column_count
+        ymm_src_masks = [YMMRegister() for column_offset in column_offsets]
+        for column_offset, ymm_src_mask in zip(column_offsets, ymm_src_masks):
+            ymm_columns = YMMRegister()
+            VMOVDQA(ymm_columns, Constant.uint32x8(*range(column_offset, column_offset + 8)))
+
+            ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns = YMMRegister(), YMMRegister()
+            VPCMPGTD(ymm_src_column_start_gt_columns, ymm_src_column_start, ymm_columns)
+            VPCMPGTD(ymm_src_column_end_gt_columns, ymm_src_column_end, ymm_columns)
+
+            VPANDN(ymm_src_mask, ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns)
+
+        ymm_dst_mask_columns_0_to_8 = YMMRegister()
+        VPCMPGTD(ymm_dst_mask_columns_0_to_8, ymm_dst_column_count, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+        # data points to the first element, which is loaded into lane `reg_column_start`
+        # However, VMASKMOVPS expects pointer to the first lane, even if it is not loaded.
+        # Adjust the pointer by subtracting column_offset, in bytes
+        SHL(reg_src_column_start, 2)
+        SUB(reg_src_ptr, reg_src_column_start.as_qword)
+
+        # Multiply stride by sizeof(float) to convert from elements to bytes
+        SHL(reg_src_stride, 2)
+
+        # Vertical sums over the rows of the pool are accumulated in registers.
+        # VMASKMOVPS zeroes the lanes which are not loaded, so padding contributes zeroes to the sums.
+        ymm_sum = [YMMRegister() for column_offset in column_offsets]
+        for ymm_sum_columns in ymm_sum:
+            VXORPS(ymm_sum_columns, ymm_sum_columns, ymm_sum_columns)
+
+        NEG(reg_src_row_index)
+
+        for row in range(pool):
+            with Block() as load_row:
+                if row != 0:
+                    INC(reg_src_row_index)
+                CMP(reg_src_row_index, reg_src_row_count)
+                JAE(load_row.end)
+
+                for column_offset, ymm_src_mask, ymm_sum_columns in zip(column_offsets, ymm_src_masks, ymm_sum):
+                    ymm_row = YMMRegister()
+                    VMASKMOVPS(ymm_row, ymm_src_mask, [reg_src_ptr + column_offset * float_.size])
+                    VADDPS(ymm_sum_columns, ymm_sum_columns, ymm_row)
+
+                if row != pool - 1:
+                    ADD(reg_src_ptr, reg_src_stride)
+
+        ymm_out = YMMRegister()
+        if stride == 2:
+            # ymm_sum[0] = ( x7  x6  x5  x4  x3  x2  x1 x0 )
+            # ymm_sum[1] = ( x15 x14 x13 x12 x11 x10 x9 x8 )
+
+            # ymm_even = ( x14 x12 x6 x4 x10 x8 x2 x0 )
+            # ymm_odd  = ( x15 x13 x7 x5 x11 x9 x3 x1 )
+            ymm_even, ymm_odd = YMMRegister(), YMMRegister()
+            VSHUFPS(ymm_even, ymm_sum[0], ymm_sum[1], _MM_SHUFFLE(2, 0, 2, 0))
+            VSHUFPS(ymm_odd, ymm_sum[0], ymm_sum[1], _MM_SHUFFLE(3, 1, 3, 1))
+            VADDPS(ymm_out, ymm_even, ymm_odd)
+
+            if pool == 3:
+                # ymm_sum[2] = ( x9  x8  x7  x6  x5  x4  x3 x2 )
+                # ymm_sum[3] = ( x17 x16 x15 x14 x13 x12 x11 x10 )
+
+                # ymm_next = ( x16 x14 x8 x6 x12 x10 x4 x2 )
+                ymm_next = YMMRegister()
+                VSHUFPS(ymm_next, ymm_sum[2], ymm_sum[3], _MM_SHUFFLE(2, 0, 2, 0))
+                VADDPS(ymm_out, ymm_out, ymm_next)
+
+            # ymm_out = ( y7 y6 y5 y4 y3 y2 y1 y0 )
+            VPERMPD(ymm_out, ymm_out, _MM_SHUFFLE(3, 1, 2, 0))
+        else:
+            # ymm_out = ( y7 y6 y5 y4 y3 y2 y1 y0 )
+            VADDPS(ymm_out, ymm_sum[0], ymm_sum[1])
+            VADDPS(ymm_out, ymm_out, ymm_sum[2])
+
+        reg_dst_scale = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_dst_scale, arg_dst_scale)
+        VMULPS(ymm_out, ymm_out, [reg_dst_scale])
+
+        VMASKMOVPS([reg_dst_ptr], ymm_dst_mask_columns_0_to_8, ymm_out)
+
+        RETURN()
+
+
+generate_avgpool(pool=2, stride=2)
+generate_avgpool(pool=3, stride=2)
+generate_avgpool(pool=3, stride=1)
+
+
+arg_n = Argument(size_t, "n")
+arg_v = Argument(ptr(const_float_), "v")
+with Function("nnp_ssum__avx2", (arg_n, arg_v), float_,
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_n = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_n, arg_n)
+
+    reg_v = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_v, arg_v)
+
+    unroll_loop = Loop()
+    vector_loop = Loop()
+    final_block = Block()
+
+    simd_width = YMMRegister.size / float_.size
+    unroll_factor = 4
+
+    # Initialize reduction registers with zeroes
+    ymm_sums = [YMMRegister() for _ in range(unroll_factor)]
+    for ymm_sum in ymm_sums:
+        VXORPS(ymm_sum, ymm_sum, ymm_sum)
+
+    # Unrolled vectorized loop
+    SUB(reg_n, simd_width * unroll_factor)
+    JB(unroll_loop.end)
+    with unroll_loop:
+        for i, ymm_sum in enumerate(ymm_sums):
+            VADDPS(ymm_sum, ymm_sum, [reg_v + i * YMMRegister.size])
+
+        SUB(reg_v, -unroll_factor * YMMRegister.size)
+        SUB(reg_n, simd_width * unroll_factor)
+        JAE(unroll_loop.begin)
+
+    VADDPS(ymm_sums[0], ymm_sums[0], ymm_sums[1])
+    VADDPS(ymm_sums[2], ymm_sums[2], ymm_sums[3])
+    VADDPS(ymm_sums[0], ymm_sums[0], ymm_sums[2])
+    ymm_sum = ymm_sums[0]
+
+    ADD(reg_n, simd_width * unroll_factor)
+    JZ(final_block.end)
+
+    # Vectorized loop without unrolling
+    SUB(reg_n, simd_width)
+    JB(vector_loop.end)
+    with vector_loop:
+        VADDPS(ymm_sum, ymm_sum, [reg_v])
+
+        ADD(reg_v, YMMRegister.size)
+        SUB(reg_n, simd_width)
+        JAE(vector_loop.begin)
+    ADD(reg_n, simd_width)
+    JZ(final_block.end)
+
+    # Process remainder: 0 < reg_n < simd_width
+    with final_block:
+        ymm_mask = YMMRegister()
+        VMOVD(ymm_mask.as_xmm, reg_n.as_dword)
+        VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+        VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_v])
+        VADDPS(ymm_sum, ymm_sum, ymm_x)
+
+    ymm_temp = YMMRegister()
+    VPERM2F128(ymm_temp, ymm_sum, ymm_sum, 0x01)
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+    VPERMILPS(ymm_temp, ymm_sum, _MM_SHUFFLE(1, 0, 3, 2))
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+    VPERMILPS(ymm_temp, ymm_sum, _MM_SHUFFLE(2, 3, 0, 1))
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+    RETURN(ymm_sum.as_xmm)
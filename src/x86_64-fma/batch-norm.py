@@ -0,0 +1,295 @@
+from common import _MM_SHUFFLE
+
+
+simd_width = YMMRegister.size // float_.size
+
+
+def horizontal_sum(ymm_sum):
+    ymm_temp = YMMRegister()
+    VPERM2F128(ymm_temp, ymm_sum, ymm_sum, 0x01)
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+    VPERMILPS(ymm_temp, ymm_sum, _MM_SHUFFLE(1, 0, 3, 2))
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+    VPERMILPS(ymm_temp, ymm_sum, _MM_SHUFFLE(2, 3, 0, 1))
+    VADDPS(ymm_sum, ymm_sum, ymm_temp)
+
+
+def remainder_mask(reg_n):
+    ymm_mask = YMMRegister()
+    VMOVD(ymm_mask.as_xmm, reg_n.as_dword)
+    VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+    VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+    return ymm_mask
+
+
+def elementwise_loop(reg_n, vector_body, final_body):
+    vector_loop = Loop()
+    final_block = Block()
+
+    SUB(reg_n, simd_width)
+    JB(vector_loop.end)
+    with vector_loop:
+        vector_body()
+
+        SUB(reg_n, simd_width)
+        JAE(vector_loop.begin)
+    ADD(reg_n, simd_width)
+    JZ(final_block.end)
+
+    # Process remainder: 0 < reg_n < simd_width
+    with final_block:
+        final_body(remainder_mask(reg_n))
+
+
+arg_length = Argument(size_t, "length")
+arg_input = Argument(ptr(const_float_), "input")
+arg_shift = Argument(float_, "shift")
+arg_moments = Argument(ptr(float_), "moments")
+with Function("nnp_batch_norm_moments__avx2",
+    (arg_length, arg_input, arg_shift, arg_moments),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    ymm_shift = YMMRegister()
+    LOAD.ARGUMENT(ymm_shift.as_xmm, arg_shift)
+    VBROADCASTSS(ymm_shift, ymm_shift.as_xmm)
+
+    ymm_sum, ymm_sum_squares = YMMRegister(), YMMRegister()
+    VXORPS(ymm_sum.as_xmm, ymm_sum.as_xmm, ymm_sum.as_xmm)
+    VXORPS(ymm_sum_squares.as_xmm, ymm_sum_squares.as_xmm, ymm_sum_squares.as_xmm)
+
+    def vector_body():
+        ymm_x = YMMRegister()
+        VMOVUPS(ymm_x, [reg_input])
+        ADD(reg_input, YMMRegister.size)
+        VSUBPS(ymm_x, ymm_x, ymm_shift)
+
+        VADDPS(ymm_sum, ymm_sum, ymm_x)
+        VFMADD231PS(ymm_sum_squares, ymm_x, ymm_x)
+
+    def final_body(ymm_mask):
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+        VSUBPS(ymm_x, ymm_x, ymm_shift)
+        # Lanes past the end hold -shift after subtraction, and must not contribute to the sums
+        VANDPS(ymm_x, ymm_x, ymm_mask)
+
+        VADDPS(ymm_sum, ymm_sum, ymm_x)
+        VFMADD231PS(ymm_sum_squares, ymm_x, ymm_x)
+
+    elementwise_loop(reg_length, vector_body, final_body)
+
+    horizontal_sum(ymm_sum)
+    horizontal_sum(ymm_sum_squares)
+
+    reg_moments = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_moments, arg_moments)
+    VMOVSS([reg_moments], ymm_sum.as_xmm)
+    VMOVSS([reg_moments + float_.size], ymm_sum_squares.as_xmm)
+
+    RETURN()
+
+
+arg_length = Argument(size_t, "length")
+arg_input = Argument(ptr(const_float_), "input")
+arg_output = Argument(ptr(float_), "output")
+arg_mean = Argument(float_, "mean")
+arg_scale = Argument(float_, "scale")
+arg_bias = Argument(float_, "bias")
+with Function("nnp_batch_norm_affine__avx2",
+    (arg_length, arg_input, arg_output, arg_mean, arg_scale, arg_bias),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    reg_output = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_output, arg_output)
+
+    ymm_mean = YMMRegister()
+    LOAD.ARGUMENT(ymm_mean.as_xmm, arg_mean)
+    VBROADCASTSS(ymm_mean, ymm_mean.as_xmm)
+
+    ymm_scale = YMMRegister()
+    LOAD.ARGUMENT(ymm_scale.as_xmm, arg_scale)
+    VBROADCASTSS(ymm_scale, ymm_scale.as_xmm)
+
+    ymm_bias = YMMRegister()
+    LOAD.ARGUMENT(ymm_bias.as_xmm, arg_bias)
+    VBROADCASTSS(ymm_bias, ymm_bias.as_xmm)
+
+    def vector_body():
+        ymm_x = YMMRegister()
+        VMOVUPS(ymm_x, [reg_input])
+        ADD(reg_input, YMMRegister.size)
+
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+        VFMADD213PS(ymm_x, ymm_scale, ymm_bias)
+
+        VMOVUPS([reg_output], ymm_x)
+        ADD(reg_output, YMMRegister.size)
+
+    def final_body(ymm_mask):
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+        VFMADD213PS(ymm_x, ymm_scale, ymm_bias)
+
+        VMASKMOVPS([reg_output], ymm_mask, ymm_x)
+
+    elementwise_loop(reg_length, vector_body, final_body)
+
+    RETURN()
+
+
+arg_length = Argument(size_t, "length")
+arg_grad_output = Argument(ptr(const_float_), "grad_output")
+arg_input = Argument(ptr(const_float_), "input")
+arg_mean = Argument(float_, "mean")
+arg_moments = Argument(ptr(float_), "moments")
+with Function("nnp_batch_norm_gradient_moments__avx2",
+    (arg_length, arg_grad_output, arg_input, arg_mean, arg_moments),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+
+    reg_grad_output = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_grad_output, arg_grad_output)
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    ymm_mean = YMMRegister()
+    LOAD.ARGUMENT(ymm_mean.as_xmm, arg_mean)
+    VBROADCASTSS(ymm_mean, ymm_mean.as_xmm)
+
+    ymm_sum, ymm_sum_products = YMMRegister(), YMMRegister()
+    VXORPS(ymm_sum.as_xmm, ymm_sum.as_xmm, ymm_sum.as_xmm)
+    VXORPS(ymm_sum_products.as_xmm, ymm_sum_products.as_xmm, ymm_sum_products.as_xmm)
+
+    def vector_body():
+        ymm_dy = YMMRegister()
+        VMOVUPS(ymm_dy, [reg_grad_output])
+        ADD(reg_grad_output, YMMRegister.size)
+
+        ymm_x = YMMRegister()
+        VMOVUPS(ymm_x, [reg_input])
+        ADD(reg_input, YMMRegister.size)
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+
+        VADDPS(ymm_sum, ymm_sum, ymm_dy)
+        VFMADD231PS(ymm_sum_products, ymm_dy, ymm_x)
+
+    def final_body(ymm_mask):
+        # Lanes past the end load zero gradient, and contribute nothing to either sum
+        ymm_dy = YMMRegister()
+        VMASKMOVPS(ymm_dy, ymm_mask, [reg_grad_output])
+
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+
+        VADDPS(ymm_sum, ymm_sum, ymm_dy)
+        VFMADD231PS(ymm_sum_products, ymm_dy, ymm_x)
+
+    elementwise_loop(reg_length, vector_body, final_body)
+
+    horizontal_sum(ymm_sum)
+    horizontal_sum(ymm_sum_products)
+
+    reg_moments = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_moments, arg_moments)
+    VMOVSS([reg_moments], ymm_sum.as_xmm)
+    VMOVSS([reg_moments + float_.size], ymm_sum_products.as_xmm)
+
+    RETURN()
+
+
+arg_length = Argument(size_t, "length")
+arg_grad_output = Argument(ptr(const_float_), "grad_output")
+arg_input = Argument(ptr(const_float_), "input")
+arg_grad_input = Argument(ptr(float_), "grad_input")
+arg_mean = Argument(float_, "mean")
+arg_grad_output_scale = Argument(float_, "grad_output_scale")
+arg_input_scale = Argument(float_, "input_scale")
+arg_bias = Argument(float_, "bias")
+with Function("nnp_batch_norm_gradient__avx2",
+    (arg_length, arg_grad_output, arg_input, arg_grad_input, arg_mean, arg_grad_output_scale, arg_input_scale, arg_bias),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+
+    reg_grad_output = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_grad_output, arg_grad_output)
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    reg_grad_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_grad_input, arg_grad_input)
+
+    ymm_mean = YMMRegister()
+    LOAD.ARGUMENT(ymm_mean.as_xmm, arg_mean)
+    VBROADCASTSS(ymm_mean, ymm_mean.as_xmm)
+
+    ymm_grad_output_scale = YMMRegister()
+    LOAD.ARGUMENT(ymm_grad_output_scale.as_xmm, arg_grad_output_scale)
+    VBROADCASTSS(ymm_grad_output_scale, ymm_grad_output_scale.as_xmm)
+
+    ymm_input_scale = YMMRegister()
+    LOAD.ARGUMENT(ymm_input_scale.as_xmm, arg_input_scale)
+    VBROADCASTSS(ymm_input_scale, ymm_input_scale.as_xmm)
+
+    ymm_bias = YMMRegister()
+    LOAD.ARGUMENT(ymm_bias.as_xmm, arg_bias)
+    VBROADCASTSS(ymm_bias, ymm_bias.as_xmm)
+
+    def vector_body():
+        ymm_dx = YMMRegister()
+        VMOVAPS(ymm_dx, ymm_bias)
+
+        ymm_dy = YMMRegister()
+        VMOVUPS(ymm_dy, [reg_grad_output])
+        ADD(reg_grad_output, YMMRegister.size)
+        VFMADD231PS(ymm_dx, ymm_dy, ymm_grad_output_scale)
+
+        ymm_x = YMMRegister()
+        VMOVUPS(ymm_x, [reg_input])
+        ADD(reg_input, YMMRegister.size)
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+        VFMADD231PS(ymm_dx, ymm_x, ymm_input_scale)
+
+        VMOVUPS([reg_grad_input], ymm_dx)
+        ADD(reg_grad_input, YMMRegister.size)
+
+    def final_body(ymm_mask):
+        ymm_dx = YMMRegister()
+        VMOVAPS(ymm_dx, ymm_bias)
+
+        ymm_dy = YMMRegister()
+        VMASKMOVPS(ymm_dy, ymm_mask, [reg_grad_output])
+        VFMADD231PS(ymm_dx, ymm_dy, ymm_grad_output_scale)
+
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+        VSUBPS(ymm_x, ymm_x, ymm_mean)
+        VFMADD231PS(ymm_dx, ymm_x, ymm_input_scale)
+
+        VMASKMOVPS([reg_grad_input], ymm_mask, ymm_dx)
+
+    elementwise_loop(reg_length, vector_body, final_body)
+
+    RETURN()
@@ -0,0 +1,114 @@
+simd_width = YMMRegister.size // float_.size
+
+
+def remainder_mask(reg_n):
+    ymm_mask = YMMRegister()
+    VMOVD(ymm_mask.as_xmm, reg_n.as_dword)
+    VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+    VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+    return ymm_mask
+
+
+def elementwise_kernel(name, operands, compute):
+    """Generates a streaming kernel over operands named in the list.
+
+    Operand names ending with "*" are pointers to a single value, which is broadcast to all elements.
+    compute(ymm_operands) combines loaded operands into the output register.
+    """
+
+    arg_length = Argument(size_t, "length")
+    arg_operands = [Argument(ptr(const_float_), operand.rstrip("*")) for operand in operands]
+    arg_output = Argument(ptr(float_), "output")
+    with Function(name, tuple([arg_length] + arg_operands + [arg_output]),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_length = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_length, arg_length)
+
+        # Pointers to streamed operands, and registers with broadcast operands
+        operand_sources = []
+        for operand, arg_operand in zip(operands, arg_operands):
+            reg_operand = GeneralPurposeRegister64()
+            LOAD.ARGUMENT(reg_operand, arg_operand)
+            if operand.endswith("*"):
+                ymm_operand = YMMRegister()
+                VBROADCASTSS(ymm_operand, [reg_operand])
+                operand_sources.append(ymm_operand)
+            else:
+                operand_sources.append(reg_operand)
+
+        reg_output = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_output, arg_output)
+
+        def load_operands(ymm_mask=None):
+            ymm_operands = []
+            for source in operand_sources:
+                if isinstance(source, YMMRegister):
+                    ymm_operands.append(source)
+                else:
+                    ymm_operand = YMMRegister()
+                    if ymm_mask is None:
+                        VMOVUPS(ymm_operand, [source])
+                    else:
+                        VMASKMOVPS(ymm_operand, ymm_mask, [source])
+                    ymm_operands.append(ymm_operand)
+            return ymm_operands
+
+        vector_loop = Loop()
+        final_block = Block()
+
+        SUB(reg_length, simd_width)
+        JB(vector_loop.end)
+        with vector_loop:
+            ymm_output = compute(load_operands())
+
+            VMOVUPS([reg_output], ymm_output)
+            ADD(reg_output, YMMRegister.size)
+            for source in operand_sources:
+                if not isinstance(source, YMMRegister):
+                    ADD(source, YMMRegister.size)
+
+            SUB(reg_length, simd_width)
+            JAE(vector_loop.begin)
+        ADD(reg_length, simd_width)
+        JZ(final_block.end)
+
+        # Process remainder: 0 < reg_length < simd_width
+        with final_block:
+            ymm_mask = remainder_mask(reg_length)
+            ymm_output = compute(load_operands(ymm_mask))
+            VMASKMOVPS([reg_output], ymm_mask, ymm_output)
+
+        RETURN()
+
+
+def add(ymm_operands):
+    ymm_a, ymm_b = ymm_operands
+    ymm_output = YMMRegister()
+    VADDPS(ymm_output, ymm_a, ymm_b)
+    return ymm_output
+
+
+def multiply(ymm_operands):
+    ymm_a, ymm_b = ymm_operands
+    ymm_output = YMMRegister()
+    VMULPS(ymm_output, ymm_a, ymm_b)
+    return ymm_output
+
+
+def multiply_add(ymm_operands):
+    ymm_a, ymm_b, ymm_c = ymm_operands
+    ymm_output = YMMRegister()
+    VMOVAPS(ymm_output, ymm_c)
+    VFMADD231PS(ymm_output, ymm_a, ymm_b)
+    return ymm_output
+
+
+elementwise_kernel("nnp_add__avx2", ["a", "b"], add)
+elementwise_kernel("nnp_add_scalar__avx2", ["a", "b*"], add)
+elementwise_kernel("nnp_multiply__avx2", ["a", "b"], multiply)
+elementwise_kernel("nnp_multiply_scalar__avx2", ["a", "b*"], multiply)
+elementwise_kernel("nnp_multiply_add__avx2", ["a", "b", "c"], multiply_add)
+elementwise_kernel("nnp_multiply_add_scalar__avx2", ["a", "b", "c*"], multiply_add)
+elementwise_kernel("nnp_multiply_scalar_add__avx2", ["a", "b*", "c"], multiply_add)
+elementwise_kernel("nnp_multiply_scalar_add_scalar__avx2", ["a", "b*", "c*"], multiply_add)
@@ -0,0 +1,307 @@
+from vecmath.exp import simd_exp
+from vecmath.log import simd_log
+
+
+def load_group_mask(reg_length):
+    # Lane i of the group is processed if i < length
+    ymm_mask = YMMRegister()
+    VMOVD(ymm_mask.as_xmm, reg_length.as_dword)
+    VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+    VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+    return ymm_mask
+
+
+def initial_window_counters(reg_channels, reg_half_window):
+    # Channels [0, min(half_window + 1, channels)) form the window of channel 0.
+    # The other channels enter the window one per step, and channels start leaving it after half_window steps.
+    reg_initial_count = GeneralPurposeRegister64()
+    MOV(reg_initial_count, reg_half_window)
+    INC(reg_initial_count)
+    CMP(reg_initial_count, reg_channels)
+    CMOVA(reg_initial_count, reg_channels)
+
+    reg_adds = GeneralPurposeRegister64()
+    MOV(reg_adds, reg_channels)
+    SUB(reg_adds, reg_initial_count)
+
+    reg_skips = GeneralPurposeRegister64()
+    MOV(reg_skips, reg_half_window)
+    return reg_initial_count, reg_adds, reg_skips
+
+
+def slide_window(reg_adds, reg_skips, add_lead, subtract_trail):
+    with Block() as add_block:
+        TEST(reg_adds, reg_adds)
+        JZ(add_block.end)
+        add_lead()
+        DEC(reg_adds)
+
+    # reg_skips counts down the steps before channels start leaving the window, and stays at zero afterwards
+    with Block() as subtract_block:
+        SUB(reg_skips, 1)
+        JAE(subtract_block.end)
+        subtract_trail()
+        XOR(reg_skips.as_dword, reg_skips.as_dword)
+
+
+def lrn_power(ymm_sum, ymm_alpha_over_n, ymm_minus_beta, ymm_k):
+    # scale := k + alpha_over_n * sum, power := exp(minus_beta * log(scale))
+    ymm_scale = YMMRegister()
+    VMOVAPS(ymm_scale, ymm_k)
+    VFMADD231PS(ymm_scale, ymm_sum, ymm_alpha_over_n)
+
+    ymm_log = simd_log([ymm_scale])[0]
+    VMULPS(ymm_log, ymm_log, ymm_minus_beta)
+    ymm_power = simd_exp([ymm_log])[0]
+    return ymm_scale, ymm_power
+
+
+def load_broadcast(arg):
+    ymm = YMMRegister()
+    LOAD.ARGUMENT(ymm.as_xmm, arg)
+    VBROADCASTSS(ymm, ymm.as_xmm)
+    return ymm
+
+
+def accumulate_squares(ymm_sum, ymm_mask, reg_pointer, reg_stride, reg_count):
+    with Loop() as loop:
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_pointer])
+        VFMADD231PS(ymm_sum, ymm_x, ymm_x)
+        ADD(reg_pointer, reg_stride)
+
+        DEC(reg_count)
+        JNZ(loop.begin)
+
+
+arg_input = Argument(ptr(const_float_), name="input")
+arg_output = Argument(ptr(float_), name="output")
+arg_channels = Argument(size_t, name="channels")
+arg_image_size = Argument(size_t, name="image_size")
+arg_length = Argument(size_t, name="length")
+arg_half_window = Argument(size_t, name="half_window")
+arg_alpha_over_n = Argument(float_, name="alpha_over_n")
+arg_minus_beta = Argument(float_, name="minus_beta")
+arg_k = Argument(float_, name="k")
+with Function("nnp_lrn_forward__avx2",
+    (arg_input, arg_output, arg_channels, arg_image_size, arg_length, arg_half_window,
+        arg_alpha_over_n, arg_minus_beta, arg_k),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    reg_output = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_output, arg_output)
+
+    reg_channels = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_channels, arg_channels)
+
+    reg_stride = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_stride, arg_image_size)
+    SHL(reg_stride, 2)
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+    ymm_mask = load_group_mask(reg_length)
+
+    reg_half_window = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_half_window, arg_half_window)
+
+    ymm_alpha_over_n = load_broadcast(arg_alpha_over_n)
+    ymm_minus_beta = load_broadcast(arg_minus_beta)
+    ymm_k = load_broadcast(arg_k)
+
+    reg_initial_count, reg_adds, reg_skips = initial_window_counters(reg_channels, reg_half_window)
+
+    # Sum of squares over the window of channel 0
+    ymm_sum = YMMRegister()
+    VXORPS(ymm_sum.as_xmm, ymm_sum.as_xmm, ymm_sum.as_xmm)
+    reg_lead = GeneralPurposeRegister64()
+    MOV(reg_lead, reg_input)
+    accumulate_squares(ymm_sum, ymm_mask, reg_lead, reg_stride, reg_initial_count)
+
+    reg_trail = GeneralPurposeRegister64()
+    MOV(reg_trail, reg_input)
+
+    with Loop() as channel_loop:
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+        ADD(reg_input, reg_stride)
+
+        ymm_scale, ymm_power = lrn_power(ymm_sum, ymm_alpha_over_n, ymm_minus_beta, ymm_k)
+        VMULPS(ymm_x, ymm_x, ymm_power)
+
+        VMASKMOVPS([reg_output], ymm_mask, ymm_x)
+        ADD(reg_output, reg_stride)
+
+        def add_lead():
+            ymm_lead = YMMRegister()
+            VMASKMOVPS(ymm_lead, ymm_mask, [reg_lead])
+            VFMADD231PS(ymm_sum, ymm_lead, ymm_lead)
+            ADD(reg_lead, reg_stride)
+
+        def subtract_trail():
+            ymm_trail = YMMRegister()
+            VMASKMOVPS(ymm_trail, ymm_mask, [reg_trail])
+            VFNMADD231PS(ymm_sum, ymm_trail, ymm_trail)
+            ADD(reg_trail, reg_stride)
+
+        slide_window(reg_adds, reg_skips, add_lead, subtract_trail)
+
+        DEC(reg_channels)
+        JNZ(channel_loop.begin)
+
+    RETURN()
+
+
+arg_grad_output = Argument(ptr(const_float_), name="grad_output")
+arg_input = Argument(ptr(const_float_), name="input")
+arg_grad_input = Argument(ptr(float_), name="grad_input")
+arg_scratch = Argument(ptr(float_), name="scratch")
+arg_channels = Argument(size_t, name="channels")
+arg_image_size = Argument(size_t, name="image_size")
+arg_length = Argument(size_t, name="length")
+arg_half_window = Argument(size_t, name="half_window")
+arg_alpha_over_n = Argument(float_, name="alpha_over_n")
+arg_minus_beta = Argument(float_, name="minus_beta")
+arg_k = Argument(float_, name="k")
+with Function("nnp_lrn_backward__avx2",
+    (arg_grad_output, arg_input, arg_grad_input, arg_scratch, arg_channels, arg_image_size, arg_length, arg_half_window,
+        arg_alpha_over_n, arg_minus_beta, arg_k),
+    target=uarch.default + isa.fma3 + isa.avx2):
+
+    reg_grad_output = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_grad_output, arg_grad_output)
+
+    reg_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_input, arg_input)
+
+    reg_grad_input = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_grad_input, arg_grad_input)
+
+    reg_scratch = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_scratch, arg_scratch)
+
+    reg_channels = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_channels, arg_channels)
+
+    reg_stride = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_stride, arg_image_size)
+    SHL(reg_stride, 2)
+
+    reg_length = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_length, arg_length)
+    ymm_mask = load_group_mask(reg_length)
+
+    reg_half_window = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_half_window, arg_half_window)
+
+    ymm_alpha_over_n = load_broadcast(arg_alpha_over_n)
+    ymm_minus_beta = load_broadcast(arg_minus_beta)
+    ymm_k = load_broadcast(arg_k)
+
+    # First pass: grad_input := grad_output * scale^(-beta), scratch := grad_output * input * scale^(-beta - 1)
+    reg_initial_count, reg_adds, reg_skips = initial_window_counters(reg_channels, reg_half_window)
+
+    ymm_sum = YMMRegister()
+    VXORPS(ymm_sum.as_xmm, ymm_sum.as_xmm, ymm_sum.as_xmm)
+    reg_lead = GeneralPurposeRegister64()
+    MOV(reg_lead, reg_input)
+    accumulate_squares(ymm_sum, ymm_mask, reg_lead, reg_stride, reg_initial_count)
+
+    reg_trail = GeneralPurposeRegister64()
+    MOV(reg_trail, reg_input)
+
+    reg_input_channel = GeneralPurposeRegister64()
+    MOV(reg_input_channel, reg_input)
+    reg_grad_input_channel = GeneralPurposeRegister64()
+    MOV(reg_grad_input_channel, reg_grad_input)
+    reg_scratch_channel = GeneralPurposeRegister64()
+    MOV(reg_scratch_channel, reg_scratch)
+    reg_channel_count = GeneralPurposeRegister64()
+    MOV(reg_channel_count, reg_channels)
+
+    with Loop() as channel_loop:
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input_channel])
+        ADD(reg_input_channel, reg_stride)
+
+        ymm_dy = YMMRegister()
+        VMASKMOVPS(ymm_dy, ymm_mask, [reg_grad_output])
+        ADD(reg_grad_output, reg_stride)
+
+        ymm_scale, ymm_power = lrn_power(ymm_sum, ymm_alpha_over_n, ymm_minus_beta, ymm_k)
+
+        VMULPS(ymm_dy, ymm_dy, ymm_power)
+        VMASKMOVPS([reg_grad_input_channel], ymm_mask, ymm_dy)
+        ADD(reg_grad_input_channel, reg_stride)
+
+        VMULPS(ymm_dy, ymm_dy, ymm_x)
+        VDIVPS(ymm_dy, ymm_dy, ymm_scale)
+        VMOVAPS([reg_scratch_channel], ymm_dy)
+        ADD(reg_scratch_channel, YMMRegister.size)
+
+        def add_lead():
+            ymm_lead = YMMRegister()
+            VMASKMOVPS(ymm_lead, ymm_mask, [reg_lead])
+            VFMADD231PS(ymm_sum, ymm_lead, ymm_lead)
+            ADD(reg_lead, reg_stride)
+
+        def subtract_trail():
+            ymm_trail = YMMRegister()
+            VMASKMOVPS(ymm_trail, ymm_mask, [reg_trail])
+            VFNMADD231PS(ymm_sum, ymm_trail, ymm_trail)
+            ADD(reg_trail, reg_stride)
+
+        slide_window(reg_adds, reg_skips, add_lead, subtract_trail)
+
+        DEC(reg_channel_count)
+        JNZ(channel_loop.begin)
+
+    # Second pass: grad_input += -2 * alpha_over_n * beta * input * (window sum of scratch)
+    ymm_coefficient = YMMRegister()
+    VMULPS(ymm_coefficient, ymm_alpha_over_n, ymm_minus_beta)
+    VADDPS(ymm_coefficient, ymm_coefficient, ymm_coefficient)
+
+    reg_initial_count, reg_adds, reg_skips = initial_window_counters(reg_channels, reg_half_window)
+
+    ymm_scratch_sum = YMMRegister()
+    VXORPS(ymm_scratch_sum.as_xmm, ymm_scratch_sum.as_xmm, ymm_scratch_sum.as_xmm)
+    reg_scratch_lead = GeneralPurposeRegister64()
+    MOV(reg_scratch_lead, reg_scratch)
+    with Loop() as initial_loop:
+        VADDPS(ymm_scratch_sum, ymm_scratch_sum, [reg_scratch_lead])
+        ADD(reg_scratch_lead, YMMRegister.size)
+
+        DEC(reg_initial_count)
+        JNZ(initial_loop.begin)
+
+    with Loop() as channel_loop:
+        ymm_x = YMMRegister()
+        VMASKMOVPS(ymm_x, ymm_mask, [reg_input])
+        ADD(reg_input, reg_stride)
+
+        ymm_dx = YMMRegister()
+        VMASKMOVPS(ymm_dx, ymm_mask, [reg_grad_input])
+
+        VMULPS(ymm_x, ymm_x, ymm_scratch_sum)
+        VFMADD231PS(ymm_dx, ymm_x, ymm_coefficient)
+
+        VMASKMOVPS([reg_grad_input], ymm_mask, ymm_dx)
+        ADD(reg_grad_input, reg_stride)
+
+        def add_lead():
+            VADDPS(ymm_scratch_sum, ymm_scratch_sum, [reg_scratch_lead])
+            ADD(reg_scratch_lead, YMMRegister.size)
+
+        def subtract_trail():
+            VSUBPS(ymm_scratch_sum, ymm_scratch_sum, [reg_scratch])
+            ADD(reg_scratch, YMMRegister.size)
+
+        slide_window(reg_adds, reg_skips, add_lead, subtract_trail)
+
+        DEC(reg_channels)
+        JNZ(channel_loop.begin)
+
+    RETURN()
@@ -131,3 +131,311 @@ with Function("nnp_maxpool_2x2_2x2__avx2",
     VMASKMOVPS([reg_dst_ptr], ymm_dst_mask_columns_0_to_8, ymm_out)
 
     RETURN()
+
+
+def generate_maxpool_3x3(stride):
+    assert stride in [1, 2]
+
+    # Offsets (in columns) of the 8-wide vectors loaded from every row of the input tile.
+    # With stride 2, vectors at offsets 0 and 8 provide the first and the second elements of every pool after
+    # de-interleaving, and vectors at offsets 2 and 10 provide the third element of every pool.
+    # With stride 1, vectors at offsets 0, 1, and 2 provide the first, second, and third element of every pool.
+    column_offsets = [0, 8, 2, 10] if stride == 2 else [0, 1, 2]
+
+    arg_src_pointer = Argument(ptr(const_float_), name="src_pointer")
+    arg_dst_pointer = Argument(ptr(float_), name="dst_pointer")
+    arg_src_stride = Argument(size_t, name="src_stride")
+    arg_src_row_offset = Argument(uint32_t, name="src_row_offset")
+    arg_src_row_count = Argument(uint32_t, name="src_row_count")
+    arg_src_column_offset = Argument(uint32_t, name="src_column_offset")
+    arg_src_column_count = Argument(uint32_t, name="src_column_count")
+    arg_dst_column_count = Argument(uint32_t, name="dst_column_count")
+    with Function("nnp_maxpool_3x3_{stride}x{stride}__avx2".format(stride=stride),
+        (arg_src_pointer, arg_dst_pointer, arg_src_stride,
+        arg_src_row_offset, arg_src_row_count, arg_src_column_offset, arg_src_column_count,
+        arg_dst_column_count),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_src_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_ptr, arg_src_pointer)
+
+        reg_dst_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_dst_ptr, arg_dst_pointer)
+
+        reg_src_stride = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_stride, arg_src_stride)
+
+        reg_src_row_index = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_index, arg_src_row_offset)
+
+        reg_src_row_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_count, arg_src_row_count)
+
+        reg_src_column_start = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_start, arg_src_column_offset)
+
+        reg_src_column_end = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_end, arg_src_column_count)
+        ADD(reg_src_column_end, reg_src_column_start)
+
+        reg_dst_column_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_dst_column_count, arg_dst_column_count)
+
+        ymm_src_column_start, ymm_src_column_end, ymm_dst_column_count = YMMRegister(), YMMRegister(), YMMRegister()
+        VMOVD(ymm_src_column_start.as_xmm, reg_src_column_start)
+        VMOVD(ymm_src_column_end.as_xmm, reg_src_column_end)
+        VMOVD(ymm_dst_column_count.as_xmm, reg_dst_column_count)
+        VPBROADCASTD(ymm_src_column_start, ymm_src_column_start.as_xmm)
+        VPBROADCASTD(ymm_src_column_end, ymm_src_column_end.as_xmm)
+        VPBROADCASTD(ymm_dst_column_count, ymm_dst_column_count.as_xmm)
+
+        # Mask for every loaded vector: lane is loaded if src_column_offset <= column < src_column_offset + src_column_count
+        ymm_src_masks = [YMMRegister() for column_offset in column_offsets]
+        for column_offset, ymm_src_mask in zip(column_offsets, ymm_src_masks):
+            ymm_columns = YMMRegister()
+            VMOVDQA(ymm_columns, Constant.uint32x8(*range(column_offset, column_offset + 8)))
+
+            ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns = YMMRegister(), YMMRegister()
+            VPCMPGTD(ymm_src_column_start_gt_columns, ymm_src_column_start, ymm_columns)
+            VPCMPGTD(ymm_src_column_end_gt_columns, ymm_src_column_end, ymm_columns)
+
+            VPANDN(ymm_src_mask, ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns)
+
+        ymm_dst_mask_columns_0_to_8 = YMMRegister()
+        VPCMPGTD(ymm_dst_mask_columns_0_to_8, ymm_dst_column_count, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+        # data points to the first element, which is loaded into lane `reg_column_start`
+        # However, VMASKMOVPS expects pointer to the first lane, even if it is not loaded.
+        # Adjust the pointer by subtracting column_offset, in bytes
+        SHL(reg_src_column_start, 2)
+        SUB(reg_src_ptr, reg_src_column_start.as_qword)
+
+        # Multiply stride by sizeof(float) to convert from elements to bytes
+        SHL(reg_src_stride, 2)
+
+        ymm_minus_inf = YMMRegister()
+        VMOVAPS(ymm_minus_inf, Constant.float32x8(-float("inf")))
+
+        # Vertical maximum over the 3 rows of the pool is accumulated in registers
+        ymm_max = [YMMRegister() for column_offset in column_offsets]
+        for ymm_max_columns in ymm_max:
+            VMOVAPS(ymm_max_columns, ymm_minus_inf)
+
+        NEG(reg_src_row_index)
+
+        for row in range(3):
+            with Block() as load_row:
+                if row != 0:
+                    INC(reg_src_row_index)
+                CMP(reg_src_row_index, reg_src_row_count)
+                JAE(load_row.end)
+
+                for column_offset, ymm_src_mask, ymm_max_columns in zip(column_offsets, ymm_src_masks, ymm_max):
+                    ymm_row = YMMRegister()
+                    VMASKMOVPS(ymm_row, ymm_src_mask, [reg_src_ptr + column_offset * float_.size])
+                    VBLENDVPS(ymm_row, ymm_minus_inf, ymm_row, ymm_src_mask)
+                    VMAXPS(ymm_max_columns, ymm_max_columns, ymm_row)
+
+                if row != 2:
+                    ADD(reg_src_ptr, reg_src_stride)
+
+        ymm_out = YMMRegister()
+        if stride == 2:
+            # ymm_max[0] = ( x7  x6  x5  x4  x3  x2  x1 x0 )
+            # ymm_max[1] = ( x15 x14 x13 x12 x11 x10 x9 x8 )
+            # ymm_max[2] = ( x9  x8  x7  x6  x5  x4  x3 x2 )
+            # ymm_max[3] = ( x17 x16 x15 x14 x13 x12 x11 x10 )
+
+            # ymm_even = ( x14 x12 x6 x4 x10 x8 x2 x0 )
+            # ymm_odd  = ( x15 x13 x7 x5 x11 x9 x3 x1 )
+            # ymm_next = ( x16 x14 x8 x6 x12 x10 x4 x2 )
+            ymm_even, ymm_odd, ymm_next = YMMRegister(), YMMRegister(), YMMRegister()
+            VSHUFPS(ymm_even, ymm_max[0], ymm_max[1], _MM_SHUFFLE(2, 0, 2, 0))
+            VSHUFPS(ymm_odd, ymm_max[0], ymm_max[1], _MM_SHUFFLE(3, 1, 3, 1))
+            VSHUFPS(ymm_next, ymm_max[2], ymm_max[3], _MM_SHUFFLE(2, 0, 2, 0))
+
+            # ymm_out = ( y7 y6 y3 y2 y5 y4 y1 y0 )
+            VMAXPS(ymm_out, ymm_even, ymm_odd)
+            VMAXPS(ymm_out, ymm_out, ymm_next)
+            VPERMPD(ymm_out, ymm_out, _MM_SHUFFLE(3, 1, 2, 0))
+        else:
+            # ymm_out = ( y7 y6 y5 y4 y3 y2 y1 y0 )
+            VMAXPS(ymm_out, ymm_max[0], ymm_max[1])
+            VMAXPS(ymm_out, ymm_out, ymm_max[2])
+
+        VMASKMOVPS([reg_dst_ptr], ymm_dst_mask_columns_0_to_8, ymm_out)
+
+        RETURN()
+
+
+generate_maxpool_3x3(stride=2)
+generate_maxpool_3x3(stride=1)
+
+
+def generate_maxpool_with_mask(pool, stride):
+    assert (pool, stride) in [(2, 2), (3, 2), (3, 1)]
+
+    # Offsets (in columns) of the 8-wide vectors loaded from every row of the input tile (see generate_maxpool_3x3)
+    column_offsets = {
+        (2, 2): [0, 8],
+        (3, 2): [0, 8, 2, 10],
+        (3, 1): [0, 1, 2],
+    }[(pool, stride)]
+
+    arg_src_pointer = Argument(ptr(const_float_), name="src_pointer")
+    arg_dst_pointer = Argument(ptr(float_), name="dst_pointer")
+    arg_dst_mask_pointer = Argument(ptr(uint8_t), name="dst_mask_pointer")
+    arg_src_stride = Argument(size_t, name="src_stride")
+    arg_src_row_offset = Argument(uint32_t, name="src_row_offset")
+    arg_src_row_count = Argument(uint32_t, name="src_row_count")
+    arg_src_column_offset = Argument(uint32_t, name="src_column_offset")
+    arg_src_column_count = Argument(uint32_t, name="src_column_count")
+    arg_dst_column_count = Argument(uint32_t, name="dst_column_count")
+    with Function("nnp_maxpool_{pool}x{pool}_{stride}x{stride}_mask__avx2".format(pool=pool, stride=stride),
+        (arg_src_pointer, arg_dst_pointer, arg_dst_mask_pointer, arg_src_stride,
+        arg_src_row_offset, arg_src_row_count, arg_src_column_offset, arg_src_column_count,
+        arg_dst_column_count),
+        target=uarch.default + isa.fma3 + isa.avx2):
+
+        reg_src_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_ptr, arg_src_pointer)
+
+        reg_src_stride = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_src_stride, arg_src_stride)
+
+        reg_src_row_index = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_index, arg_src_row_offset)
+
+        reg_src_row_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_row_count, arg_src_row_count)
+
+        reg_src_column_start = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_start, arg_src_column_offset)
+
+        reg_src_column_end = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_src_column_end, arg_src_column_count)
+        ADD(reg_src_column_end, reg_src_column_start)
+
+        reg_dst_column_count = GeneralPurposeRegister32()
+        LOAD.ARGUMENT(reg_dst_column_count, arg_dst_column_count)
+
+        ymm_src_column_start, ymm_src_column_end, ymm_dst_column_count = YMMRegister(), YMMRegister(), YMMRegister()
+        VMOVD(ymm_src_column_start.as_xmm, reg_src_column_start)
+        VMOVD(ymm_src_column_end.as_xmm, reg_src_column_end)
+        VMOVD(ymm_dst_column_count.as_xmm, reg_dst_column_count)
+        VPBROADCASTD(ymm_src_column_start, ymm_src_column_start.as_xmm)
+        VPBROADCASTD(ymm_src_column_end, ymm_src_column_end.as_xmm)
+        VPBROADCASTD(ymm_dst_column_count, ymm_dst_column_count.as_xmm)
+
+        # Mask for every loaded vector: lane is loaded if src_column_offset <= column < src_column_offset + src_column_count
+        ymm_src_masks = [YMMRegister() for column_offset in column_offsets]
+        for column_offset, ymm_src_mask in zip(column_offsets, ymm_src_masks):
+            ymm_columns = YMMRegister()
+            VMOVDQA(ymm_columns, Constant.uint32x8(*range(column_offset, column_offset + 8)))
+
+            ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns = YMMRegister(), YMMRegister()
+            VPCMPGTD(ymm_src_column_start_gt_columns, ymm_src_column_start, ymm_columns)
+            VPCMPGTD(ymm_src_column_end_gt_columns, ymm_src_column_end, ymm_columns)
+
+            VPANDN(ymm_src_mask, ymm_src_column_start_gt_columns, ymm_src_column_end_gt_columns)
+
+        ymm_dst_mask_columns_0_to_8 = YMMRegister()
+        VPCMPGTD(ymm_dst_mask_columns_0_to_8, ymm_dst_column_count, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+        # data points to the first element, which is loaded into lane `reg_column_start`
+        # However, VMASKMOVPS expects pointer to the first lane, even if it is not loaded.
+        # Adjust the pointer by subtracting column_offset, in bytes
+        SHL(reg_src_column_start, 2)
+        SUB(reg_src_ptr, reg_src_column_start.as_qword)
+
+        # Multiply stride by sizeof(float) to convert from elements to bytes
+        SHL(reg_src_stride, 2)
+
+        ymm_minus_inf = YMMRegister()
+        VMOVAPS(ymm_minus_inf, Constant.float32x8(-float("inf")))
+
+        # Running maximum and its index (i * pool + j) within the pool.
+        # Elements of the pool are visited in row-major order and replace the maximum only if they are strictly greater,
+        # so the index of the first maximal element is recorded.
+        ymm_max, ymm_index = YMMRegister(), YMMRegister()
+        VMOVAPS(ymm_max, ymm_minus_inf)
+        VPXOR(ymm_index, ymm_index, ymm_index)
+
+        NEG(reg_src_row_index)
+
+        for row in range(pool):
+            with Block() as load_row:
+                if row != 0:
+                    INC(reg_src_row_index)
+                CMP(reg_src_row_index, reg_src_row_count)
+                JAE(load_row.end)
+
+                ymm_rows = [YMMRegister() for column_offset in column_offsets]
+                for column_offset, ymm_src_mask, ymm_row in zip(column_offsets, ymm_src_masks, ymm_rows):
+                    VMASKMOVPS(ymm_row, ymm_src_mask, [reg_src_ptr + column_offset * float_.size])
+                    VBLENDVPS(ymm_row, ymm_minus_inf, ymm_row, ymm_src_mask)
+
+                if stride == 2:
+                    # ymm_columns[0] = ( x14 x12 x6 x4 x10 x8 x2 x0 )
+                    # ymm_columns[1] = ( x15 x13 x7 x5 x11 x9 x3 x1 )
+                    # ymm_columns[2] = ( x16 x14 x8 x6 x12 x10 x4 x2 )
+                    ymm_columns = [YMMRegister() for column in range(pool)]
+                    VSHUFPS(ymm_columns[0], ymm_rows[0], ymm_rows[1], _MM_SHUFFLE(2, 0, 2, 0))
+                    VSHUFPS(ymm_columns[1], ymm_rows[0], ymm_rows[1], _MM_SHUFFLE(3, 1, 3, 1))
+                    if pool == 3:
+                        VSHUFPS(ymm_columns[2], ymm_rows[2], ymm_rows[3], _MM_SHUFFLE(2, 0, 2, 0))
+                else:
+                    ymm_columns = ymm_rows
+
+                for column, ymm_column in enumerate(ymm_columns):
+                    ymm_greater = YMMRegister()
+                    VCMPPS(ymm_greater, ymm_column, ymm_max, 0x1E)  # _CMP_GT_OQ
+                    VBLENDVPS(ymm_max, ymm_max, ymm_column, ymm_greater)
+                    VBLENDVPS(ymm_index, ymm_index, Constant.uint32x8(row * pool + column), ymm_greater)
+
+                if row != pool - 1:
+                    ADD(reg_src_ptr, reg_src_stride)
+
+        if stride == 2:
+            # ( y7 y6 y3 y2 y5 y4 y1 y0 ) -> ( y7 y6 y5 y4 y3 y2 y1 y0 )
+            VPERMPD(ymm_max, ymm_max, _MM_SHUFFLE(3, 1, 2, 0))
+            VPERMQ(ymm_index, ymm_index, _MM_SHUFFLE(3, 1, 2, 0))
+
+        reg_dst_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_dst_ptr, arg_dst_pointer)
+        VMASKMOVPS([reg_dst_ptr], ymm_dst_mask_columns_0_to_8, ymm_max)
+
+        # Pack 32-bit indices into bytes
+        xmm_index_hi = XMMRegister()
+        VEXTRACTI128(xmm_index_hi, ymm_index, 1)
+        xmm_index = XMMRegister()
+        VPACKUSDW(xmm_index, ymm_index.as_xmm, xmm_index_hi)
+        VPACKUSWB(xmm_index, xmm_index, xmm_index)
+
+        reg_index = GeneralPurposeRegister64()
+        VMOVQ(reg_index, xmm_index)
+
+        reg_dst_mask_ptr = GeneralPurposeRegister64()
+        LOAD.ARGUMENT(reg_dst_mask_ptr, arg_dst_mask_pointer)
+
+        store_partial = Block()
+        CMP(reg_dst_column_count, 8)
+        JB(store_partial.begin)
+        MOV([reg_dst_mask_ptr], reg_index)
+        RETURN()
+
+        with store_partial:
+            store_loop = Loop()
+            with store_loop:
+                MOV([reg_dst_mask_ptr], reg_index.as_low_byte)
+                SHR(reg_index, 8)
+                INC(reg_dst_mask_ptr)
+                DEC(reg_dst_column_count)
+                JNZ(store_loop.begin)
+
+        RETURN()
+
+
+generate_maxpool_with_mask(pool=2, stride=2)
+generate_maxpool_with_mask(pool=3, stride=2)
+generate_maxpool_with_mask(pool=3, stride=1)
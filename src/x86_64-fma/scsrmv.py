@@ -0,0 +1,110 @@
+# Sparse matrix-dense vector multiplication y = A * x for a range of rows of A in CSR format.
+# Non-zero elements of a row are processed 8 at a time: VGATHERDPS gathers the input elements at column indices of
+# the non-zeroes, and the last incomplete group of non-zeroes is processed with masked loads and gather.
+
+simd_width = YMMRegister.size / float_.size
+
+arg_rows = Argument(size_t, "rows")
+arg_row_offsets = Argument(ptr(const_uint32_t), "row_offsets")
+arg_column_indices = Argument(ptr(const_uint32_t), "column_indices")
+arg_values = Argument(ptr(const_float_), "values")
+arg_x = Argument(ptr(const_float_), "x")
+arg_y = Argument(ptr(float_), "y")
+with Function("nnp_scsrmv__avx2",
+	(arg_rows, arg_row_offsets, arg_column_indices, arg_values, arg_x, arg_y),
+	target=uarch.default + isa.fma3 + isa.avx2):
+
+	reg_rows = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_rows, arg_rows)
+
+	reg_row_offsets = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_row_offsets, arg_row_offsets)
+
+	reg_column_indices = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_column_indices, arg_column_indices)
+
+	reg_values = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_values, arg_values)
+
+	reg_x = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_x, arg_x)
+
+	reg_y = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_y, arg_y)
+
+	# Start of the first row: column indices and values of the following rows are consecutive
+	reg_offset = GeneralPurposeRegister64()
+	MOV(reg_offset.as_dword, [reg_row_offsets])
+	LEA(reg_column_indices, [reg_column_indices + reg_offset * 4])
+	LEA(reg_values, [reg_values + reg_offset * 4])
+
+	row_loop = Loop()
+	with row_loop:
+		# Number of non-zeroes in the row
+		reg_n = GeneralPurposeRegister64()
+		MOV(reg_n.as_dword, [reg_row_offsets + uint32_t.size])
+		SUB(reg_n.as_dword, [reg_row_offsets])
+		ADD(reg_row_offsets, uint32_t.size)
+
+		ymm_acc = YMMRegister()
+		VXORPS(ymm_acc, ymm_acc, ymm_acc)
+
+		nonzero_loop = Loop()
+		tail_block = Block()
+
+		SUB(reg_n, simd_width)
+		JB(nonzero_loop.end)
+
+		with nonzero_loop:
+			ymm_column_indices = YMMRegister()
+			VMOVDQU(ymm_column_indices, [reg_column_indices])
+			ADD(reg_column_indices, YMMRegister.size)
+
+			# VGATHERDPS clears the mask, so it is re-initialized on every iteration
+			ymm_mask = YMMRegister()
+			VPCMPEQD(ymm_mask, ymm_mask, ymm_mask)
+			ymm_x = YMMRegister()
+			VXORPS(ymm_x, ymm_x, ymm_x)
+			VGATHERDPS(ymm_x, [reg_x + ymm_column_indices * 4], ymm_mask)
+
+			VFMADD231PS(ymm_acc, ymm_x, [reg_values])
+			ADD(reg_values, YMMRegister.size)
+
+			SUB(reg_n, simd_width)
+			JAE(nonzero_loop.begin)
+
+		ADD(reg_n, simd_width)
+		JZ(tail_block.end)
+
+		with tail_block:
+			ymm_tail_mask = YMMRegister()
+			VMOVD(ymm_tail_mask.as_xmm, reg_n.as_dword)
+			VPBROADCASTD(ymm_tail_mask, ymm_tail_mask.as_xmm)
+			VPCMPGTD(ymm_tail_mask, ymm_tail_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+			ymm_column_indices = YMMRegister()
+			VPMASKMOVD(ymm_column_indices, ymm_tail_mask, [reg_column_indices])
+			ymm_values = YMMRegister()
+			VMASKMOVPS(ymm_values, ymm_tail_mask, [reg_values])
+			LEA(reg_column_indices, [reg_column_indices + reg_n * 4])
+			LEA(reg_values, [reg_values + reg_n * 4])
+
+			ymm_x = YMMRegister()
+			VXORPS(ymm_x, ymm_x, ymm_x)
+			VGATHERDPS(ymm_x, [reg_x + ymm_column_indices * 4], ymm_tail_mask)
+
+			VFMADD231PS(ymm_acc, ymm_x, ymm_values)
+
+		# Reduce the SIMD register into a single element
+		xmm_tmp = XMMRegister()
+		VEXTRACTF128(xmm_tmp, ymm_acc, 1)
+		VADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, xmm_tmp)
+		VHADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+		VHADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+		VMOVSS([reg_y], ymm_acc.as_xmm)
+		ADD(reg_y, float_.size)
+
+		DEC(reg_rows)
+		JNZ(row_loop.begin)
+
+	RETURN()
@@ -0,0 +1,106 @@
+simd_width = YMMRegister.size / float_.size
+
+# Number of output dot products computed per call for each number of input vectors.
+# The products are accumulated in m * n <= 12 YMM registers.
+fusion_factors = {2: 6, 3: 4, 4: 3}
+
+for batch_size, max_fusion_factor in sorted(fusion_factors.items()):
+	for fusion_factor in range(1, max_fusion_factor + 1):
+		arg_x = Argument(ptr(const_float_), "x")
+		arg_stride_x = Argument(size_t, "stride_x")
+		arg_y = Argument(ptr(const_float_), "y")
+		arg_stride_y = Argument(size_t, "stride_y")
+		arg_sum = Argument(ptr(float_), "sum")
+		arg_stride_sum = Argument(size_t, "stride_sum")
+		arg_n = Argument(size_t, "n")
+		with Function("nnp_sdot{batch_size}xf{fusion_factor}__avx2".format(batch_size=batch_size, fusion_factor=fusion_factor),
+			(arg_x, arg_stride_x, arg_y, arg_stride_y, arg_sum, arg_stride_sum, arg_n),
+			target=uarch.default + isa.fma3 + isa.avx2):
+
+			reg_xs = [GeneralPurposeRegister64() for m in range(batch_size)]
+			LOAD.ARGUMENT(reg_xs[0], arg_x)
+
+			reg_stride_x = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_stride_x, arg_stride_x)
+			SHL(reg_stride_x, 2)
+
+			for m in range(1, batch_size):
+				LEA(reg_xs[m], [reg_xs[m - 1] + reg_stride_x * 1])
+
+			reg_ys = [GeneralPurposeRegister64() for n in range(fusion_factor)]
+			LOAD.ARGUMENT(reg_ys[0], arg_y)
+
+			reg_stride_y = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_stride_y, arg_stride_y)
+			SHL(reg_stride_y, 2)
+
+			for n in range(1, fusion_factor):
+				LEA(reg_ys[n], [reg_ys[n - 1] + reg_stride_y * 1])
+
+			reg_n = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_n, arg_n)
+
+			ymm_accs = [[YMMRegister() for n in range(fusion_factor)] for m in range(batch_size)]
+			VZEROALL()
+
+			main_loop = Loop()
+			end_block = Block()
+
+			SUB(reg_n, YMMRegister.size / float_.size)
+			JB(main_loop.end)
+
+			with main_loop:
+				# Each row of y is loaded once and multiplied by all input vectors
+				for n, reg_y in enumerate(reg_ys):
+					ymm_y = YMMRegister()
+					VMOVUPS(ymm_y, [reg_y])
+					ADD(reg_y, YMMRegister.size)
+
+					for m, reg_x in enumerate(reg_xs):
+						VFMADD231PS(ymm_accs[m][n], ymm_y, [reg_x])
+
+				for reg_x in reg_xs:
+					ADD(reg_x, YMMRegister.size)
+
+				SUB(reg_n, YMMRegister.size / float_.size)
+				JAE(main_loop.begin)
+
+			ADD(reg_n, YMMRegister.size / float_.size)
+			JE(end_block.end)
+
+			with end_block:
+				ymm_mask = YMMRegister()
+				VMOVD(ymm_mask.as_xmm, reg_n.as_dword)
+				VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+				VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+				for m, reg_x in enumerate(reg_xs):
+					ymm_x = YMMRegister()
+					VMASKMOVPS(ymm_x, ymm_mask, [reg_x])
+
+					for n, reg_y in enumerate(reg_ys):
+						ymm_y = YMMRegister()
+						VMASKMOVPS(ymm_y, ymm_mask, [reg_y])
+						VFMADD231PS(ymm_accs[m][n], ymm_x, ymm_y)
+
+			reg_sum = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_sum, arg_sum)
+
+			reg_stride_sum = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_stride_sum, arg_stride_sum)
+			SHL(reg_stride_sum, 2)
+
+			# Reduce the SIMD registers into a single elements
+			xmm_tmp = XMMRegister()
+			for m in range(batch_size):
+				if m != 0:
+					ADD(reg_sum, reg_stride_sum)
+
+				for n, ymm_acc in enumerate(ymm_accs[m]):
+					VEXTRACTF128(xmm_tmp, ymm_acc, 1)
+					VADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, xmm_tmp)
+					VHADDPS(ymm_acc, ymm_acc, ymm_acc)
+					VHADDPS(ymm_acc, ymm_acc, ymm_acc)
+					VMOVSS([reg_sum + n * float_.size], ymm_acc.as_xmm)
+
+			RETURN()
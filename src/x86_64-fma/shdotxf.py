@@ -0,0 +1,112 @@
+# Dot products of a single-precision vector with fusion_factor rows of a 16-bit floating-point matrix.
+# - nnp_shdotxf*: rows in IEEE half precision, converted with F16C VCVTPH2PS.
+# - nnp_sbdotxf*: rows in bfloat16, converted by zero-extension and shift into the upper half of fp32.
+
+simd_width = YMMRegister.size / float_.size
+
+for storage in ["fp16", "bf16"]:
+	for fusion_factor in range(1, 8 + 1):
+		arg_x = Argument(ptr(const_float_), "x")
+		arg_y = Argument(ptr(const_uint16_t), "y")
+		arg_stride_y = Argument(size_t, "stride_y")
+		arg_sum = Argument(ptr(float_), "sum")
+		arg_n = Argument(size_t, "n")
+		if storage == "fp16":
+			function_name = "nnp_shdotxf{fusion_factor}__avx2".format(fusion_factor=fusion_factor)
+			target = uarch.default + isa.fma3 + isa.avx2 + isa.f16c
+		else:
+			function_name = "nnp_sbdotxf{fusion_factor}__avx2".format(fusion_factor=fusion_factor)
+			target = uarch.default + isa.fma3 + isa.avx2
+		with Function(function_name,
+			(arg_x, arg_y, arg_stride_y, arg_sum, arg_n),
+			target=target):
+
+			def convert(xmm_or_ymm_y, source):
+				if storage == "fp16":
+					VCVTPH2PS(xmm_or_ymm_y, source)
+				else:
+					VPMOVZXWD(xmm_or_ymm_y, source)
+					VPSLLD(xmm_or_ymm_y, xmm_or_ymm_y, 16)
+
+			reg_x = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_x, arg_x)
+
+			reg_ys = [GeneralPurposeRegister64() for m in range(fusion_factor)]
+			LOAD.ARGUMENT(reg_ys[0], arg_y)
+
+			# Stride of 16-bit matrix is in elements
+			reg_stride_y = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_stride_y, arg_stride_y)
+			ADD(reg_stride_y, reg_stride_y)
+
+			reg_n = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_n, arg_n)
+
+			ymm_accs = [YMMRegister() for m in range(fusion_factor)]
+			VZEROALL()
+
+			for m in range(1, fusion_factor):
+				LEA(reg_ys[m], [reg_ys[m - 1] + reg_stride_y * 1])
+
+			main_loop = Loop()
+
+			SUB(reg_n, simd_width)
+			JB(main_loop.end)
+
+			with main_loop:
+				ymm_x = YMMRegister()
+				VMOVUPS(ymm_x, [reg_x])
+				ADD(reg_x, YMMRegister.size)
+
+				for reg_y, ymm_acc in zip(reg_ys, ymm_accs):
+					ymm_y = YMMRegister()
+					convert(ymm_y, [reg_y])
+					VFMADD231PS(ymm_acc, ymm_x, ymm_y)
+					ADD(reg_y, simd_width * uint16_t.size)
+
+				SUB(reg_n, simd_width)
+				JAE(main_loop.begin)
+
+			ADD(reg_n, simd_width)
+
+			# Reduce the SIMD registers into a single elements before processing the remainder:
+			# scalar VEX-encoded instructions in the remainder loop would clear the upper halves of accumulators
+			xmm_tmp = XMMRegister()
+			for ymm_acc in ymm_accs:
+				VEXTRACTF128(xmm_tmp, ymm_acc, 1)
+				VADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, xmm_tmp)
+				VHADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+				VHADDPS(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+
+			remainder_loop = Loop()
+
+			TEST(reg_n, reg_n)
+			JZ(remainder_loop.end)
+
+			with remainder_loop:
+				xmm_x = XMMRegister()
+				VMOVSS(xmm_x, [reg_x])
+				ADD(reg_x, float_.size)
+
+				for reg_y, ymm_acc in zip(reg_ys, ymm_accs):
+					reg_element = GeneralPurposeRegister32()
+					MOVZX(reg_element, word[reg_y])
+					ADD(reg_y, uint16_t.size)
+
+					xmm_y = XMMRegister()
+					VMOVD(xmm_y, reg_element)
+					if storage == "fp16":
+						VCVTPH2PS(xmm_y, xmm_y)
+					else:
+						VPSLLD(xmm_y, xmm_y, 16)
+					VFMADD231SS(ymm_acc.as_xmm, xmm_x, xmm_y)
+
+				SUB(reg_n, 1)
+				JNZ(remainder_loop.begin)
+
+			reg_sum = GeneralPurposeRegister64()
+			LOAD.ARGUMENT(reg_sum, arg_sum)
+			for i, ymm_acc in enumerate(ymm_accs):
+				VMOVSS([reg_sum + i * float_.size], ymm_acc.as_xmm)
+
+			RETURN()
@@ -5,11 +5,14 @@
 #include <nnpack/simd.h>
 #include <nnpack/utils.h>
 #include <nnpack/softmax.h>
+#include <nnpack/blas.h>
 
 float max__avx(size_t n, const float v[restrict static n]);
 float sum_exp_minus_c__avx2(size_t n, const float v[restrict static n], float c);
 void inplace_scaled_exp_minus_c__avx2(size_t n, const float v[restrict static n], float scale, float c);
 void outplace_scaled_exp_minus_c__avx2(size_t n, const float x[restrict static n], float y[restrict static n], float scale, float c);
+void outplace_minus_c__avx2(size_t n, const float x[static n], float y[static n], float c);
+void outplace_scaled_minus_c__avx2(size_t n, const float x[restrict static n], const float s[restrict static n], float y[restrict static n], float c);
 
 void nnp_inplace_softmax__avx2(
 	size_t n,
@@ -31,3 +34,63 @@ void nnp_outplace_softmax__avx2(
 	const float scale = 1.0f / sum;
 	outplace_scaled_exp_minus_c__avx2(n, x, y, scale, c);
 }
+
+void nnp_softmax_partial__avx2(
+	size_t n,
+	const float x[restrict static n],
+	float max[restrict static 1],
+	float sum_exp[restrict static 1])
+{
+	const float c = max__avx(n, x);
+	*max = c;
+	*sum_exp = sum_exp_minus_c__avx2(n, x, c);
+}
+
+void nnp_softmax_scale__avx2(
+	size_t n,
+	const float x[static n],
+	float y[static n],
+	float scale,
+	float c)
+{
+	if (x == y) {
+		inplace_scaled_exp_minus_c__avx2(n, y, scale, c);
+	} else {
+		outplace_scaled_exp_minus_c__avx2(n, x, y, scale, c);
+	}
+}
+
+void nnp_log_softmax__avx2(
+	size_t n,
+	const float x[static n],
+	float y[static n])
+{
+	const float c = max__avx(n, x);
+	const float sum = sum_exp_minus_c__avx2(n, x, c);
+	outplace_minus_c__avx2(n, x, y, c + logf(sum));
+}
+
+void nnp_softmax_gradient__avx2(
+	size_t n,
+	const float y[restrict static n],
+	const float g[restrict static n],
+	float dx[restrict static n])
+{
+	float dot;
+	nnp_sdotxf1__avx2(g, y, 0, &dot, n);
+	outplace_scaled_minus_c__avx2(n, g, y, dx, dot);
+}
+
+float nnp_softmax_cross_entropy__avx2(
+	size_t n,
+	const float x[restrict static n],
+	uint32_t label,
+	float g[restrict static n])
+{
+	const float c = max__avx(n, x);
+	const float sum = sum_exp_minus_c__avx2(n, x, c);
+	const float loss = c + logf(sum) - x[label];
+	outplace_scaled_exp_minus_c__avx2(n, x, g, 1.0f / sum, c);
+	g[label] -= 1.0f;
+	return loss;
+}
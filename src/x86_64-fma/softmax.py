@@ -307,3 +307,126 @@ with Function("outplace_scaled_exp_minus_c__avx2", (arg_n, arg_x, arg_y, arg_sca
     scaled_exp_minus_c(reg_n, reg_x, reg_y, ymm_scale, ymm_c)
 
     RETURN()
+
+
+def scaled_minus_c(reg_n, reg_x, reg_s, reg_y, ymm_c):
+    # y[i] := (x[i] - c) * s[i], or y[i] := x[i] - c if reg_s is None
+    unroll_loop = Loop()
+    vector_loop = Loop()
+    final_block = Block()
+
+    simd_width = YMMRegister.size / float_.size
+    unroll_factor = 4
+
+    # Unrolled vectorized loop
+    SUB(reg_n, simd_width * unroll_factor)
+    JB(unroll_loop.end)
+    with unroll_loop:
+        ymm_ys = [YMMRegister() for _ in range(unroll_factor)]
+        for i, ymm_y in enumerate(ymm_ys):
+            VMOVUPS(ymm_y, [reg_x + i * YMMRegister.size])
+            VSUBPS(ymm_y, ymm_y, ymm_c)
+            if reg_s is not None:
+                VMULPS(ymm_y, ymm_y, [reg_s + i * YMMRegister.size])
+        SUB(reg_x, -unroll_factor * YMMRegister.size)
+        if reg_s is not None:
+            SUB(reg_s, -unroll_factor * YMMRegister.size)
+
+        for i, ymm_y in enumerate(ymm_ys):
+            VMOVUPS([reg_y + i * YMMRegister.size], ymm_y)
+        SUB(reg_y, -unroll_factor * YMMRegister.size)
+
+        SUB(reg_n, simd_width * unroll_factor)
+        JAE(unroll_loop.begin)
+    ADD(reg_n, simd_width * unroll_factor)
+    JZ(final_block.end)
+
+    # Vectorized loop without unrolling
+    SUB(reg_n, simd_width)
+    JB(vector_loop.end)
+    with vector_loop:
+        ymm_y = YMMRegister()
+        VMOVUPS(ymm_y, [reg_x])
+        ADD(reg_x, YMMRegister.size)
+        VSUBPS(ymm_y, ymm_y, ymm_c)
+        if reg_s is not None:
+            VMULPS(ymm_y, ymm_y, [reg_s])
+            ADD(reg_s, YMMRegister.size)
+
+        VMOVUPS([reg_y], ymm_y)
+        ADD(reg_y, YMMRegister.size)
+
+        SUB(reg_n, simd_width)
+        JAE(vector_loop.begin)
+    ADD(reg_n, simd_width)
+    JZ(final_block.end)
+
+    # Process remainder: 0 < reg_n < simd_width
+    with final_block:
+        ymm_mask = YMMRegister()
+        VMOVD(ymm_mask.as_xmm, reg_n.as_dword)
+        VPBROADCASTD(ymm_mask, ymm_mask.as_xmm)
+        VPCMPGTD(ymm_mask, ymm_mask, Constant.uint32x8(0, 1, 2, 3, 4, 5, 6, 7))
+
+        ymm_y = YMMRegister()
+        VMASKMOVPS(ymm_y, ymm_mask, [reg_x])
+        VSUBPS(ymm_y, ymm_y, ymm_c)
+        if reg_s is not None:
+            ymm_s = YMMRegister()
+            VMASKMOVPS(ymm_s, ymm_mask, [reg_s])
+            VMULPS(ymm_y, ymm_y, ymm_s)
+
+        VMASKMOVPS([reg_y], ymm_mask, ymm_y)
+
+
+arg_n = Argument(size_t, "n")
+arg_x = Argument(ptr(const_float_), "x")
+arg_y = Argument(ptr(float_), "y")
+arg_c = Argument(float_, "c")
+with Function("outplace_minus_c__avx2", (arg_n, arg_x, arg_y, arg_c),
+    target=uarch.default + isa.avx2):
+
+    reg_n = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_n, arg_n)
+
+    reg_x = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_x, arg_x)
+
+    reg_y = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_y, arg_y)
+
+    ymm_c = YMMRegister()
+    LOAD.ARGUMENT(ymm_c.as_xmm, arg_c)
+    VBROADCASTSS(ymm_c, ymm_c.as_xmm)
+
+    scaled_minus_c(reg_n, reg_x, None, reg_y, ymm_c)
+
+    RETURN()
+
+arg_n = Argument(size_t, "n")
+arg_x = Argument(ptr(const_float_), "x")
+arg_s = Argument(ptr(const_float_), "s")
+arg_y = Argument(ptr(float_), "y")
+arg_c = Argument(float_, "c")
+with Function("outplace_scaled_minus_c__avx2", (arg_n, arg_x, arg_s, arg_y, arg_c),
+    target=uarch.default + isa.avx2):
+
+    reg_n = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_n, arg_n)
+
+    reg_x = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_x, arg_x)
+
+    reg_s = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_s, arg_s)
+
+    reg_y = GeneralPurposeRegister64()
+    LOAD.ARGUMENT(reg_y, arg_y)
+
+    ymm_c = YMMRegister()
+    LOAD.ARGUMENT(ymm_c.as_xmm, arg_c)
+    VBROADCASTSS(ymm_c, ymm_c.as_xmm)
+
+    scaled_minus_c(reg_n, reg_x, reg_s, reg_y, ymm_c)
+
+    RETURN()
@@ -0,0 +1,105 @@
+# Dot products of an unsigned 8-bit vector x (with zero point) with fusion_factor rows of a signed 8-bit matrix y.
+# Elements are widened to 16 bits, and the zero point is subtracted from x, before VPMADDWD multiplication:
+# VPMADDUBSW would saturate the sum of two 255 * (-128) products in 16 bits, while VPMADDWD accumulates exactly.
+
+simd_width = YMMRegister.size / int16_t.size
+
+for fusion_factor in range(1, 8 + 1):
+	arg_x = Argument(ptr(const_uint8_t), "x")
+	arg_y = Argument(ptr(const_int8_t), "y")
+	arg_stride_y = Argument(size_t, "stride_y")
+	arg_sum = Argument(ptr(int32_t), "sum")
+	arg_n = Argument(size_t, "n")
+	arg_x_zero_point = Argument(uint8_t, "x_zero_point")
+	with Function("nnp_u8s8dotxf{fusion_factor}__avx2".format(fusion_factor=fusion_factor),
+		(arg_x, arg_y, arg_stride_y, arg_sum, arg_n, arg_x_zero_point),
+		target=uarch.default + isa.avx2):
+
+		reg_x = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_x, arg_x)
+
+		reg_ys = [GeneralPurposeRegister64() for m in range(fusion_factor)]
+		LOAD.ARGUMENT(reg_ys[0], arg_y)
+
+		reg_stride_y = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_stride_y, arg_stride_y)
+
+		reg_n = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_n, arg_n)
+
+		reg_x_zero_point = GeneralPurposeRegister32()
+		LOAD.ARGUMENT(reg_x_zero_point, arg_x_zero_point)
+
+		ymm_x_zero_point = YMMRegister()
+		VMOVD(ymm_x_zero_point.as_xmm, reg_x_zero_point)
+		VPBROADCASTW(ymm_x_zero_point, ymm_x_zero_point.as_xmm)
+
+		ymm_accs = [YMMRegister() for m in range(fusion_factor)]
+		for ymm_acc in ymm_accs:
+			VPXOR(ymm_acc, ymm_acc, ymm_acc)
+
+		for m in range(1, fusion_factor):
+			LEA(reg_ys[m], [reg_ys[m - 1] + reg_stride_y * 1])
+
+		main_loop = Loop()
+
+		SUB(reg_n, simd_width)
+		JB(main_loop.end)
+
+		with main_loop:
+			ymm_x = YMMRegister()
+			VPMOVZXBW(ymm_x, [reg_x])
+			VPSUBW(ymm_x, ymm_x, ymm_x_zero_point)
+			ADD(reg_x, simd_width * uint8_t.size)
+
+			for reg_y, ymm_acc in zip(reg_ys, ymm_accs):
+				ymm_y = YMMRegister()
+				VPMOVSXBW(ymm_y, [reg_y])
+				VPMADDWD(ymm_y, ymm_y, ymm_x)
+				VPADDD(ymm_acc, ymm_acc, ymm_y)
+				ADD(reg_y, simd_width * int8_t.size)
+
+			SUB(reg_n, simd_width)
+			JAE(main_loop.begin)
+
+		ADD(reg_n, simd_width)
+
+		# Reduce the SIMD registers into a single elements before processing the remainder:
+		# scalar VEX-encoded instructions in the remainder loop would clear the upper halves of accumulators
+		xmm_tmp = XMMRegister()
+		for ymm_acc in ymm_accs:
+			VEXTRACTI128(xmm_tmp, ymm_acc, 1)
+			VPADDD(ymm_acc.as_xmm, ymm_acc.as_xmm, xmm_tmp)
+			VPHADDD(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+			VPHADDD(ymm_acc.as_xmm, ymm_acc.as_xmm, ymm_acc.as_xmm)
+
+		remainder_loop = Loop()
+
+		TEST(reg_n, reg_n)
+		JZ(remainder_loop.end)
+
+		with remainder_loop:
+			reg_x_element = GeneralPurposeRegister32()
+			MOVZX(reg_x_element, byte[reg_x])
+			SUB(reg_x_element, reg_x_zero_point)
+			ADD(reg_x, uint8_t.size)
+
+			for reg_y, ymm_acc in zip(reg_ys, ymm_accs):
+				reg_y_element = GeneralPurposeRegister32()
+				MOVSX(reg_y_element, byte[reg_y])
+				IMUL(reg_y_element, reg_x_element)
+				ADD(reg_y, int8_t.size)
+
+				xmm_product = XMMRegister()
+				VMOVD(xmm_product, reg_y_element)
+				VPADDD(ymm_acc.as_xmm, ymm_acc.as_xmm, xmm_product)
+
+			SUB(reg_n, 1)
+			JNZ(remainder_loop.begin)
+
+		reg_sum = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_sum, arg_sum)
+		for i, ymm_acc in enumerate(ymm_accs):
+			VMOVD([reg_sum + i * int32_t.size], ymm_acc.as_xmm)
+
+		RETURN()
@@ -0,0 +1,56 @@
+# Matrix multiplication of panels of 16-bit elements into 32-bit accumulators.
+# Panels hold pairs of consecutive elements along the reduction dimension, so VPMADDWD multiplies a broadcasted pair
+# of a row of A by pairs of 8 columns of B, and sums the two products of each column exactly in 32 bits.
+
+simd_width = YMMRegister.size / int32_t.size
+mr = 4
+nr = 2 * simd_width
+
+arg_k = Argument(size_t, "k")
+arg_a = Argument(ptr(const_int16_t), "a")
+arg_b = Argument(ptr(const_int16_t), "b")
+arg_c = Argument(ptr(int32_t), "c")
+with Function("nnp_u8s8gemm_{mr}x{nr}__avx2".format(mr=mr, nr=nr),
+	(arg_k, arg_a, arg_b, arg_c),
+	target=uarch.default + isa.avx2):
+
+	reg_k = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_k, arg_k)
+
+	reg_a = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_a, arg_a)
+
+	reg_b = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_b, arg_b)
+
+	ymm_c = [[YMMRegister() for n in range(0, nr, simd_width)] for m in range(mr)]
+	for ymm_c_m in ymm_c:
+		for ymm_c_mn in ymm_c_m:
+			VPXOR(ymm_c_mn, ymm_c_mn, ymm_c_mn)
+
+	ymm_b = [YMMRegister() for n in range(0, nr, simd_width)]
+	ymm_a_m = YMMRegister()
+	ymm_product = YMMRegister()
+	with Loop() as loop:
+		for n, ymm_b_n in enumerate(ymm_b):
+			VMOVDQA(ymm_b_n, [reg_b + n * YMMRegister.size])
+		ADD(reg_b, nr * 2 * int16_t.size)
+
+		for m in range(mr):
+			VPBROADCASTD(ymm_a_m, [reg_a + m * 2 * int16_t.size])
+			for n in range(nr // simd_width):
+				VPMADDWD(ymm_product, ymm_a_m, ymm_b[n])
+				VPADDD(ymm_c[m][n], ymm_c[m][n], ymm_product)
+		ADD(reg_a, mr * 2 * int16_t.size)
+
+		DEC(reg_k)
+		JNE(loop.begin)
+
+	reg_c = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_c, arg_c)
+
+	for m in range(mr):
+		for n in range(nr // simd_width):
+			VMOVDQU([reg_c + (m * nr + n * simd_width) * int32_t.size], ymm_c[m][n])
+
+	RETURN()
@@ -0,0 +1,71 @@
+from peachpy import *
+from peachpy.x86_64 import *
+
+mantissa_mask = 0x007FFFFF
+one_bits = 0x3F800000
+magic_bits = 0x4B000000
+magic_bias = float.fromhex("+0x1.0000FEp+23")
+sqrt2 = float.fromhex("+0x1.6A09E6p+0")
+ln2_hi = float.fromhex("+0x1.630000p-1")
+ln2_lo = float.fromhex("-0x1.BD0106p-13")
+
+c0 = float.fromhex("+0x1.204376p-4")
+c1 = float.fromhex("-0x1.D7A370p-4")
+c2 = float.fromhex("+0x1.DE4A34p-4")
+c3 = float.fromhex("-0x1.FCBA9Ep-4")
+c4 = float.fromhex("+0x1.23D37Ep-3")
+c5 = float.fromhex("-0x1.555CA0p-3")
+c6 = float.fromhex("+0x1.999D58p-3")
+c7 = float.fromhex("-0x1.FFFFF8p-3")
+c8 = float.fromhex("+0x1.555554p-2")
+
+_CMP_GT_OQ = 0x1E
+
+
+def simd_log(ymm_xs):
+    """Natural logarithm of positive normalized inputs. Inputs are not modified."""
+    assert isinstance(ymm_xs, list) and all(isinstance(ymm_x, YMMRegister) for ymm_x in ymm_xs)
+
+    ymm_ys = [YMMRegister() for _ in ymm_xs]
+    for ymm_x, ymm_y in zip(ymm_xs, ymm_ys):
+        # e := float(exponent bits) via the 2**23 magic number
+        ymm_e = YMMRegister()
+        VPSRLD(ymm_e, ymm_x, 23)
+        VPOR(ymm_e, ymm_e, Constant.uint32x8(magic_bits))
+        VSUBPS(ymm_e, ymm_e, Constant.float32x8(magic_bias))
+
+        # m := mantissa in [1, 2)
+        ymm_m = YMMRegister()
+        VPAND(ymm_m, ymm_x, Constant.uint32x8(mantissa_mask))
+        VPOR(ymm_m, ymm_m, Constant.uint32x8(one_bits))
+
+        # Move m to [sqrt(1/2), sqrt(2))
+        ymm_mask = YMMRegister()
+        VCMPPS(ymm_mask, ymm_m, Constant.float32x8(sqrt2), _CMP_GT_OQ)
+        ymm_half_m = YMMRegister()
+        VMULPS(ymm_half_m, ymm_m, Constant.float32x8(0.5))
+        VBLENDVPS(ymm_m, ymm_m, ymm_half_m, ymm_mask)
+        VANDPS(ymm_mask, ymm_mask, Constant.float32x8(1.0))
+        VADDPS(ymm_e, ymm_e, ymm_mask)
+
+        # f := m - 1, z := f * f
+        ymm_f = ymm_m
+        VSUBPS(ymm_f, ymm_m, Constant.float32x8(1.0))
+        ymm_z = YMMRegister()
+        VMULPS(ymm_z, ymm_f, ymm_f)
+
+        # q := polynomial(f) * f * z
+        ymm_q = YMMRegister()
+        VMOVAPS(ymm_q, Constant.float32x8(c0))
+        for c in [c1, c2, c3, c4, c5, c6, c7, c8]:
+            VFMADD213PS(ymm_q, ymm_f, Constant.float32x8(c))
+        VMULPS(ymm_q, ymm_q, ymm_f)
+        VMULPS(ymm_q, ymm_q, ymm_z)
+
+        # y := (f + (q + e * ln2_lo - 0.5 * z)) + e * ln2_hi
+        VFMADD231PS(ymm_q, ymm_e, Constant.float32x8(ln2_lo))
+        VFNMADD231PS(ymm_q, ymm_z, Constant.float32x8(0.5))
+        VADDPS(ymm_y, ymm_f, ymm_q)
+        VFMADD231PS(ymm_y, ymm_e, Constant.float32x8(ln2_hi))
+
+    return ymm_ys
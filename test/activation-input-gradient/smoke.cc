@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/activation.h>
+
+/*
+ * Test gradient of sigmoid with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SIGMOID, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Sigmoid);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(SIGMOID, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Sigmoid)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testInputGradient();
+}
+
+/*
+ * Test gradient of hyperbolic tangent with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(TANH, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Tanh);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(TANH, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Tanh)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testInputGradient();
+}
+
+/*
+ * Test gradient of ELU with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(ELU, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::ELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.alpha(0.5f)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(ELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::ELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.alpha(0.5f)
+		.testInputGradient();
+}
+
+/*
+ * Test gradient of SELU with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SELU, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::SELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(SELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::SELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testInputGradient();
+}
+
+/*
+ * Test gradient of GELU with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(GELU, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::GELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(GELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::GELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testInputGradient();
+}
+
+/*
+ * Test gradient of swish with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SWISH, small_batch) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Swish);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(SWISH, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Swish)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testInputGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/activation.h>
+
+/*
+ * Test sigmoid with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SIGMOID, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Sigmoid);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SIGMOID, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Sigmoid);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(SIGMOID, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Sigmoid)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testOutput();
+}
+
+/*
+ * Test hyperbolic tangent with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(TANH, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Tanh);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(TANH, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Tanh);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(TANH, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Tanh)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testOutput();
+}
+
+/*
+ * Test ELU with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(ELU, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::ELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.alpha(0.5f)
+				.testOutput();
+		}
+	}
+}
+
+TEST(ELU, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::ELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.alpha(0.5f)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(ELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::ELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.alpha(0.5f)
+		.testOutput();
+}
+
+/*
+ * Test SELU with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SELU, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::SELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SELU, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::SELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(SELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::SELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testOutput();
+}
+
+/*
+ * Test GELU with small batch and channels, which exercise unaligned prologue and epilogue.
+ * The error limit is looser: for negative inputs GELU is about x exp(2u) with |2u| up to ~90,
+ * so rounding errors in 2u are amplified in the output.
+ */
+
+TEST(GELU, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::GELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.errorLimit(5.0e-5f)
+				.testOutput();
+		}
+	}
+}
+
+TEST(GELU, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::GELU);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.errorLimit(5.0e-5f)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(GELU, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::GELU)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.errorLimit(5.0e-5f)
+		.testOutput();
+}
+
+/*
+ * Test swish with small batch and channels, which exercise unaligned prologue and epilogue
+ */
+
+TEST(SWISH, out_of_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Swish);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SWISH, in_place) {
+	auto tester = ActivationTester();
+	tester.activation(ActivationTester::Activation::Swish);
+	for (size_t channels = 1; channels <= 33; channels += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(SWISH, multithreaded) {
+	ActivationTester()
+		.activation(ActivationTester::Activation::Swish)
+		.multithreading(true)
+		.batchSize(16)
+		.channels(4099)
+		.testOutput();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,373 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/pooling.h>
+
+/*
+ * Test that 2x2 stride 2 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(AveragePooling2x2s2, few_horizontal_pools) {
+	for (size_t imageWidth = 2; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(2, imageWidth)
+			.poolingSize(2, 2)
+			.poolingStride(2, 2)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(AveragePooling2x2s2, few_vertical_pools) {
+	for (size_t imageHeight = 2; imageHeight <= 40; imageHeight++) {
+		PoolingTester()
+			.inputSize(imageHeight, 2)
+			.poolingSize(2, 2)
+			.poolingStride(2, 2)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works with implicit padding included in the divisor
+ */
+
+TEST(AveragePooling2x2s2, implicit_padding_included) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.paddingMode(nnp_pooling_padding_mode_include)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works with implicit padding excluded in the divisor
+ */
+
+TEST(AveragePooling2x2s2, implicit_padding_excluded) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.paddingMode(nnp_pooling_padding_mode_exclude)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation can handle small non-unit batch_size and number of channels
+ */
+
+TEST(AveragePooling2x2s2, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(13, 13)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		for (size_t channels = 2; channels <= 5; channels++) {
+			tester.batchSize(batchSize)
+				.channels(channels)
+				.testAverageOutput();
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(AveragePooling3x3s2, few_horizontal_pools) {
+	for (size_t imageWidth = 3; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(AveragePooling3x3s2, few_vertical_pools) {
+	for (size_t imageHeight = 3; imageHeight <= 40; imageHeight++) {
+		PoolingTester()
+			.inputSize(imageHeight, 3)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works with implicit padding included in the divisor
+ */
+
+TEST(AveragePooling3x3s2, implicit_padding_included) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.paddingMode(nnp_pooling_padding_mode_include)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works with implicit padding excluded in the divisor
+ */
+
+TEST(AveragePooling3x3s2, implicit_padding_excluded) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.paddingMode(nnp_pooling_padding_mode_exclude)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation can handle small non-unit batch_size and number of channels
+ */
+
+TEST(AveragePooling3x3s2, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(13, 13)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		for (size_t channels = 2; channels <= 5; channels++) {
+			tester.batchSize(batchSize)
+				.channels(channels)
+				.testAverageOutput();
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(AveragePooling3x3s1, few_horizontal_pools) {
+	for (size_t imageWidth = 3; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(1, 1)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(AveragePooling3x3s1, few_vertical_pools) {
+	for (size_t imageHeight = 3; imageHeight <= 40; imageHeight++) {
+		PoolingTester()
+			.inputSize(imageHeight, 3)
+			.poolingSize(3, 3)
+			.poolingStride(1, 1)
+			.errorLimit(1.0e-6)
+			.iterations(10)
+			.testAverageOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works with implicit padding included in the divisor
+ */
+
+TEST(AveragePooling3x3s1, implicit_padding_included) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.paddingMode(nnp_pooling_padding_mode_include)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works with implicit padding excluded in the divisor
+ */
+
+TEST(AveragePooling3x3s1, implicit_padding_excluded) {
+	PoolingTester tester;
+	tester.inputSize(17, 17)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.paddingMode(nnp_pooling_padding_mode_exclude)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation can handle small non-unit batch_size and number of channels
+ */
+
+TEST(AveragePooling3x3s1, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(13, 13)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		for (size_t channels = 2; channels <= 5; channels++) {
+			tester.batchSize(batchSize)
+				.channels(channels)
+				.testAverageOutput();
+		}
+	}
+}
+
+/*
+ * Test that general implementation works for pool sizes and strides without specialized kernels
+ */
+
+TEST(AveragePoolingGeneric, pooling_size_and_stride) {
+	for (size_t poolingHeight = 1; poolingHeight <= 5; poolingHeight++) {
+		for (size_t poolingWidth = 1; poolingWidth <= 5; poolingWidth++) {
+			for (size_t strideHeight = 1; strideHeight <= poolingHeight; strideHeight++) {
+				for (size_t strideWidth = 1; strideWidth <= poolingWidth; strideWidth++) {
+					PoolingTester()
+						.inputSize(19, 29)
+						.poolingSize(poolingHeight, poolingWidth)
+						.poolingStride(strideHeight, strideWidth)
+						.errorLimit(1.0e-6)
+						.iterations(3)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that general implementation works with implicit padding, both included and excluded in the divisor
+ */
+
+TEST(AveragePoolingGeneric, implicit_padding) {
+	PoolingTester tester;
+	tester.inputSize(23, 23)
+		.poolingSize(5, 5)
+		.poolingStride(3, 3)
+		.errorLimit(1.0e-6)
+		.iterations(3);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.paddingMode(nnp_pooling_padding_mode_include)
+						.testAverageOutput();
+					tester.paddingMode(nnp_pooling_padding_mode_exclude)
+						.testAverageOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that input smaller than the pool is rejected
+ */
+
+TEST(AveragePoolingGeneric, input_smaller_than_pool) {
+	float input[4] = { 0.0f };
+	float output[4] = { 0.0f };
+	EXPECT_EQ(nnp_status_invalid_input_size,
+		nnp_average_pooling_output(1, 1, nnp_size { 2, 2 }, nnp_padding { 0, 0, 0, 0 }, nnp_size { 3, 3 }, nnp_size { 2, 2 },
+			nnp_pooling_padding_mode_include, input, output, nullptr));
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
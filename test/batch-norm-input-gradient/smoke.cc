@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/batch-norm.h>
+
+/*
+ * Test training-mode batch normalization gradient with small images, which exercise remainders of the vector kernels
+ */
+
+TEST(BATCH_NORM_INPUT_GRADIENT, small_images) {
+	auto tester = BatchNormTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.inputSize(3, width)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(BATCH_NORM_INPUT_GRADIENT, without_affine) {
+	BatchNormTester()
+		.affine(false)
+		.batchSize(4)
+		.channels(5)
+		.inputSize(7, 9)
+		.testInputGradient();
+}
+
+TEST(BATCH_NORM_INPUT_GRADIENT, large_mean) {
+	BatchNormTester()
+		.inputOffset(1000.0f)
+		.batchSize(8)
+		.channels(4)
+		.inputSize(13, 13)
+		.testInputGradient();
+}
+
+TEST(BATCH_NORM_INPUT_GRADIENT, multithreaded) {
+	BatchNormTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.inputSize(15, 17)
+		.testInputGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
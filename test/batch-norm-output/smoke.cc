@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/batch-norm.h>
+
+/*
+ * Test training-mode batch normalization with small images, which exercise remainders of the vector kernels
+ */
+
+TEST(BATCH_NORM_OUTPUT, out_of_place) {
+	auto tester = BatchNormTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.inputSize(3, width)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(BATCH_NORM_OUTPUT, in_place) {
+	auto tester = BatchNormTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.inputSize(3, width)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(BATCH_NORM_OUTPUT, without_affine) {
+	BatchNormTester()
+		.affine(false)
+		.batchSize(4)
+		.channels(5)
+		.inputSize(7, 9)
+		.testOutput();
+}
+
+/*
+ * Mean of order 1000 is representable in single precision only up to ~3e-5,
+ * and normalization by standard deviation amplifies this rounding error in the output.
+ */
+TEST(BATCH_NORM_OUTPUT, large_mean) {
+	BatchNormTester()
+		.errorLimit(5.0e-4)
+		.inputOffset(1000.0f)
+		.batchSize(8)
+		.channels(4)
+		.inputSize(13, 13)
+		.testOutput();
+}
+
+TEST(BATCH_NORM_OUTPUT, multithreaded) {
+	BatchNormTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.inputSize(15, 17)
+		.testOutput();
+}
+
+/*
+ * Test folding of inference-mode batch normalization into convolution and fully connected layers
+ */
+
+TEST(FOLD_BATCH_NORM, convolution) {
+	BatchNormTester()
+		.batchSize(2)
+		.inputChannels(5)
+		.channels(7)
+		.inputSize(9, 11)
+		.kernelSize(3, 3)
+		.testFoldConvolution();
+}
+
+TEST(FOLD_BATCH_NORM, convolution_without_affine) {
+	BatchNormTester()
+		.affine(false)
+		.batchSize(2)
+		.inputChannels(5)
+		.channels(7)
+		.inputSize(9, 11)
+		.kernelSize(3, 3)
+		.testFoldConvolution();
+}
+
+TEST(FOLD_BATCH_NORM, fully_connected) {
+	BatchNormTester()
+		.batchSize(4)
+		.inputChannels(33)
+		.channels(17)
+		.inputSize(1, 1)
+		.kernelSize(1, 1)
+		.testFoldConvolution();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -24,6 +24,14 @@ TEST(FT8x8_REUSE, single_tile) {
 		.testInference(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(FT8x8_PRECOMPUTED, single_tile) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
 TEST(FT16x16_RECOMPUTE, single_tile) {
 	ConvolutionTester()
 		.inputSize(16, 16)
@@ -40,6 +48,14 @@ TEST(FT16x16_REUSE, single_tile) {
 		.testInference(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(FT16x16_PRECOMPUTED, single_tile) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
 TEST(WT8x8_RECOMPUTE, single_tile) {
 	ConvolutionTester()
 		.inputSize(8, 8)
@@ -56,6 +72,14 @@ TEST(WT8x8_REUSE, single_tile) {
 		.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(WT8x8_PRECOMPUTED, single_tile) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
 /*
  * Test that the implementation handles extraction of input subtile
  */
@@ -120,6 +144,13 @@ TEST(FT8x8_REUSE, multi_tile) {
 		.testInference(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(FT8x8_PRECOMPUTED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
 TEST(FT16x16_RECOMPUTE, multi_tile) {
 	ConvolutionTester()
 		.inputSize(29, 29)
@@ -134,6 +165,13 @@ TEST(FT16x16_REUSE, multi_tile) {
 		.testInference(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(FT16x16_PRECOMPUTED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
 TEST(WT8x8_RECOMPUTE, multi_tile) {
 	ConvolutionTester()
 		.inputSize(13, 13)
@@ -148,6 +186,38 @@ TEST(WT8x8_REUSE, multi_tile) {
 		.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+TEST(WT8x8_PRECOMPUTED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+}
+
+/*
+ * Test that the implementation works with kernels from the shared memory cache
+ */
+
+TEST(FT8x8_SHARED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.errorLimit(1.0e-5)
+		.testInferenceSharedKernel(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16_SHARED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.errorLimit(1.0e-5)
+		.testInferenceSharedKernel(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(WT8x8_SHARED, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.errorLimit(1.0e-3)
+		.testInferenceSharedKernel(nnp_convolution_algorithm_wt8x8);
+}
+
 /*
  * Test that the implementation handles implicit padding of input
  */
@@ -278,6 +348,16 @@ TEST(FT8x8_REUSE, few_input_channels) {
 	}
 }
 
+TEST(FT8x8_PRECOMPUTED, few_input_channels) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.errorLimit(1.0e-5);
+	for (size_t inputChannels = 2; inputChannels <= 5; inputChannels++) {
+		tester.inputChannels(inputChannels)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+	}
+}
+
 TEST(FT16x16_RECOMPUTE, few_input_channels) {
 	ConvolutionTester tester;
 	tester.inputSize(16, 16)
@@ -298,6 +378,16 @@ TEST(FT16x16_REUSE, few_input_channels) {
 	}
 }
 
+TEST(FT16x16_PRECOMPUTED, few_input_channels) {
+	ConvolutionTester tester;
+	tester.inputSize(16, 16)
+		.errorLimit(1.0e-5);
+	for (size_t inputChannels = 2; inputChannels <= 5; inputChannels++) {
+		tester.inputChannels(inputChannels)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_precomputed);
+	}
+}
+
 TEST(WT8x8_RECOMPUTE, few_input_channels) {
 	ConvolutionTester tester;
 	tester.inputSize(8, 8)
@@ -318,6 +408,16 @@ TEST(WT8x8_REUSE, few_input_channels) {
 	}
 }
 
+TEST(WT8x8_PRECOMPUTED, few_input_channels) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.errorLimit(1.0e-3);
+	for (size_t inputChannels = 2; inputChannels <= 5; inputChannels++) {
+		tester.inputChannels(inputChannels)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_precomputed);
+	}
+}
+
 /*
  * Test that the implementation can handle small non-unit number of output channels
  */
@@ -464,6 +564,238 @@ TEST(WT8x8_REUSE, non_square_image) {
 		.testInference(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_reuse);
 }
 
+/*
+ * Test that fused ReLU and 2x2 max-pooling handles multi-tile outputs of odd and even size
+ */
+
+TEST(FT8x8_RECOMPUTE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(17, 16)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_recompute);
+}
+
+TEST(FT8x8_REUSE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(17, 16)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_reuse);
+}
+
+TEST(FT16x16_RECOMPUTE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(31, 30)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_recompute);
+}
+
+TEST(FT16x16_REUSE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(31, 30)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_reuse);
+}
+
+TEST(WT8x8_RECOMPUTE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(17, 16)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-3)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_recompute);
+}
+
+TEST(WT8x8_REUSE, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(17, 16)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-3)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_reuse);
+}
+
+/*
+ * Test that fused ReLU and 2x2 max-pooling handles output tiles of odd size, which are rounded down to even size
+ */
+
+TEST(FT8x8_RECOMPUTE, relu_max_pooling_even_kernel) {
+	ConvolutionTester()
+		.inputSize(19, 18)
+		.kernelSize(2, 4)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_recompute);
+}
+
+TEST(FT8x8_REUSE, relu_max_pooling_even_kernel) {
+	ConvolutionTester()
+		.inputSize(19, 18)
+		.kernelSize(2, 4)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft8x8, nnp_convolution_kernel_transform_strategy_reuse);
+}
+
+TEST(FT16x16_RECOMPUTE, relu_max_pooling_even_kernel) {
+	ConvolutionTester()
+		.inputSize(19, 18)
+		.kernelSize(2, 4)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_recompute);
+}
+
+TEST(FT16x16_REUSE, relu_max_pooling_even_kernel) {
+	ConvolutionTester()
+		.inputSize(19, 18)
+		.kernelSize(2, 4)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_ft16x16, nnp_convolution_kernel_transform_strategy_reuse);
+}
+
+/*
+ * Test that automatic choice of algorithm accounts for output tiles of fused ReLU and 2x2 max-pooling
+ */
+
+TEST(AUTO, relu_max_pooling) {
+	ConvolutionTester()
+		.inputSize(12, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-3)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_auto);
+}
+
+/* 8x8 kernel leaves 1x1 output tiles in 8x8 transforms, too few for a pool, though they take as few tiles as 16x16 */
+TEST(AUTO, relu_max_pooling_large_kernel) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(8, 8)
+		.inputChannels(3)
+		.outputChannels(5)
+		.errorLimit(1.0e-5)
+		.testInferenceReluMaxPooling(nnp_convolution_algorithm_auto);
+}
+
+/*
+ * Test that fused ReLU and 2x2 max-pooling handles implicit padding of input
+ */
+
+TEST(WT8x8_RECOMPUTE, relu_max_pooling_implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(12, 12)
+		.errorLimit(1.0e-3);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+			tester.inputPadding(paddingTop, 1, paddingLeft, 1)
+				.testInferenceReluMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_recompute);
+		}
+	}
+}
+
+TEST(WT8x8_REUSE, relu_max_pooling_implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(12, 12)
+		.errorLimit(1.0e-3);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+			tester.inputPadding(paddingTop, 1, paddingLeft, 1)
+				.testInferenceReluMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_convolution_kernel_transform_strategy_reuse);
+		}
+	}
+}
+
+/*
+ * Test that 8-bit quantized implementation matches the quantized reference
+ */
+
+TEST(IM2COL_U8S8, single_pixel) {
+	ConvolutionTester()
+		.inputSize(3, 3)
+		.kernelSize(3, 3)
+		.inputChannels(17)
+		.outputChannels(5)
+		.iterations(10)
+		.testInferenceU8S8();
+}
+
+TEST(IM2COL_U8S8, output_channels_tail) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 10)
+		.kernelSize(3, 3)
+		.inputChannels(3)
+		.iterations(10);
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testInferenceU8S8();
+	}
+}
+
+TEST(IM2COL_U8S8, implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.kernelSize(3, 3)
+		.inputChannels(5)
+		.outputChannels(7);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testInferenceU8S8();
+				}
+			}
+		}
+	}
+}
+
+TEST(IM2COL_U8S8, non_square_kernel) {
+	ConvolutionTester()
+		.inputSize(9, 10)
+		.kernelSize(2, 3)
+		.inputChannels(19)
+		.outputChannels(13)
+		.testInferenceU8S8();
+}
+
+TEST(IM2COL_U8S8, multiple_pixel_blocks) {
+	ConvolutionTester()
+		.inputSize(33, 35)
+		.inputPadding(1, 1, 1, 1)
+		.kernelSize(3, 3)
+		.inputChannels(256)
+		.outputChannels(19)
+		.multithreading(true)
+		.testInferenceU8S8();
+}
+
+/* 4096 input channels times 4x4 kernel elements is the longest supported reduction, 65536 */
+TEST(IM2COL_U8S8, max_reduction_size) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.inputPadding(1, 1, 1, 1)
+		.kernelSize(4, 4)
+		.inputChannels(4096)
+		.outputChannels(5)
+		.extremeValues(true)
+		.testInferenceU8S8();
+}
+
+TEST(IM2COL_U8S8, reduction_size_over_limit) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.kernelSize(4, 4)
+		.inputChannels(4097)
+		.outputChannels(5)
+		.expectedStatus(nnp_status_unsupported_input_channels)
+		.testInferenceU8S8();
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
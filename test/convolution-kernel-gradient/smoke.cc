@@ -275,6 +275,36 @@ TEST(WT8x8, DISABLED_non_square_image) {
 		.testKernelGradient(nnp_convolution_algorithm_wt8x8);
 }
 
+/*
+ * Test that the implementation can handle large batch with few channels (batch-parallel reduction)
+ */
+
+TEST(FT8x8, few_channels_large_batch) {
+	/* 3 input and 4 output channels give 2 matrix multiplication tiles, so 4 threads split the batch into shards */
+	ConvolutionTester tester;
+	tester.threadsCount(4)
+		.inputSize(12, 12)
+		.inputChannels(3)
+		.outputChannels(4)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 7; batchSize <= 67; batchSize += 20) {
+		tester.batchSize(batchSize).testKernelGradient(nnp_convolution_algorithm_ft8x8);
+	}
+}
+
+TEST(FT16x16, few_channels_large_batch) {
+	/* 3 input and 4 output channels give 2 matrix multiplication tiles, so 4 threads split the batch into shards */
+	ConvolutionTester tester;
+	tester.threadsCount(4)
+		.inputSize(20, 20)
+		.inputChannels(3)
+		.outputChannels(4)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 7; batchSize <= 67; batchSize += 20) {
+		tester.batchSize(batchSize).testKernelGradient(nnp_convolution_algorithm_ft16x16);
+	}
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -82,6 +82,17 @@ TEST(WT8x8, multi_tile) {
 		.testOutput(nnp_convolution_algorithm_wt8x8);
 }
 
+TEST(WT8x8, multithreaded) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(7)
+		.errorLimit(1.0e-3)
+		.multithreading(true)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+
 /*
  * Test that the implementation handles implicit padding of input
  */
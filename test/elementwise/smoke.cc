@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/elementwise.h>
+
+/*
+ * Test operations on tensors of the same shape with small images, which exercise remainders of the vector kernels
+ */
+
+TEST(ADD, small_images) {
+	auto tester = ElementwiseTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.imageSize(3, width)
+				.batchSize(batch)
+				.testAdd();
+		}
+	}
+}
+
+/*
+ * Test every combination of broadcast dimensions which leaves every output dimension matched by an operand
+ */
+
+TEST(ADD, broadcast) {
+	auto tester = ElementwiseTester();
+	tester.batchSize(2)
+		.channels(3)
+		.imageSize(5, 7);
+	for (unsigned aBroadcast = 0; aBroadcast < 8; aBroadcast++) {
+		for (unsigned bBroadcast = 0; bBroadcast < 8; bBroadcast++) {
+			if ((aBroadcast & bBroadcast) == 0) {
+				tester.aBroadcast(aBroadcast)
+					.bBroadcast(bBroadcast)
+					.testAdd();
+			}
+		}
+	}
+}
+
+TEST(ADD, residual_inplace) {
+	ElementwiseTester()
+		.batchSize(4)
+		.channels(16)
+		.imageSize(14, 14)
+		.inplace(true)
+		.testAdd();
+}
+
+TEST(ADD, multithreaded) {
+	ElementwiseTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.imageSize(15, 17)
+		.bBroadcast(ElementwiseTester::BroadcastImage)
+		.testAdd();
+}
+
+TEST(MULTIPLY, small_images) {
+	auto tester = ElementwiseTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.imageSize(3, width)
+				.batchSize(batch)
+				.testMultiply();
+		}
+	}
+}
+
+TEST(MULTIPLY, broadcast) {
+	auto tester = ElementwiseTester();
+	tester.batchSize(2)
+		.channels(3)
+		.imageSize(5, 7);
+	for (unsigned aBroadcast = 0; aBroadcast < 8; aBroadcast++) {
+		for (unsigned bBroadcast = 0; bBroadcast < 8; bBroadcast++) {
+			if ((aBroadcast & bBroadcast) == 0) {
+				tester.aBroadcast(aBroadcast)
+					.bBroadcast(bBroadcast)
+					.testMultiply();
+			}
+		}
+	}
+}
+
+TEST(MULTIPLY, gate_inplace) {
+	ElementwiseTester()
+		.batchSize(4)
+		.channels(16)
+		.imageSize(14, 14)
+		.bBroadcast(ElementwiseTester::BroadcastImage)
+		.inplace(true)
+		.testMultiply();
+}
+
+TEST(MULTIPLY, multithreaded) {
+	ElementwiseTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.imageSize(15, 17)
+		.testMultiply();
+}
+
+TEST(MULTIPLY_ADD, small_images) {
+	auto tester = ElementwiseTester();
+	tester.channels(3);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.imageSize(3, width)
+				.batchSize(batch)
+				.testMultiplyAdd();
+		}
+	}
+}
+
+TEST(MULTIPLY_ADD, broadcast) {
+	auto tester = ElementwiseTester();
+	tester.batchSize(2)
+		.channels(3)
+		.imageSize(5, 7);
+	for (unsigned aBroadcast = 0; aBroadcast < 8; aBroadcast++) {
+		for (unsigned bBroadcast = 0; bBroadcast < 8; bBroadcast++) {
+			for (unsigned cBroadcast = 0; cBroadcast < 8; cBroadcast++) {
+				if ((aBroadcast & bBroadcast & cBroadcast) == 0) {
+					tester.aBroadcast(aBroadcast)
+						.bBroadcast(bBroadcast)
+						.cBroadcast(cBroadcast)
+						.testMultiplyAdd();
+				}
+			}
+		}
+	}
+}
+
+TEST(MULTIPLY_ADD, channel_scale_bias_inplace) {
+	ElementwiseTester()
+		.batchSize(4)
+		.channels(16)
+		.imageSize(14, 14)
+		.bBroadcast(ElementwiseTester::BroadcastBatch | ElementwiseTester::BroadcastImage)
+		.cBroadcast(ElementwiseTester::BroadcastBatch | ElementwiseTester::BroadcastImage)
+		.inplace(true)
+		.testMultiplyAdd();
+}
+
+TEST(MULTIPLY_ADD, multithreaded) {
+	ElementwiseTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.imageSize(15, 17)
+		.bBroadcast(ElementwiseTester::BroadcastBatch)
+		.testMultiplyAdd();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/fully-connected.h>
+
+/*
+ * Test that implementation works for output channels which do not fill a tile of fused dot products
+ */
+
+TEST(SDOTXF, output_channels_tail) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testInference();
+	}
+}
+
+/*
+ * Test that implementation works with bias and ReLU activation applied to the output
+ */
+
+TEST(SDOTXF, relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.testInference();
+}
+
+TEST(SDOTXF, leaky_relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.negativeSlope(0.01f)
+		.testInference();
+}
+
+/*
+ * Test that implementation with half-precision and bfloat16 kernels matches reference on the rounded kernel
+ */
+
+TEST(SHDOTXF, output_channels_tail) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testInferenceF16();
+	}
+}
+
+TEST(SHDOTXF, many_channels) {
+	FullyConnectedTester()
+		.inputChannels(1021)
+		.outputChannels(67)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceF16();
+}
+
+TEST(SHDOTXF, relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.testInferenceF16();
+}
+
+TEST(SBDOTXF, output_channels_tail) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testInferenceBF16();
+	}
+}
+
+TEST(SBDOTXF, many_channels) {
+	FullyConnectedTester()
+		.inputChannels(1021)
+		.outputChannels(67)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceBF16();
+}
+
+TEST(SBDOTXF, relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.testInferenceBF16();
+}
+
+/*
+ * Test that 8-bit quantized implementation matches the quantized reference
+ */
+
+TEST(U8S8DOTXF, input_channels_tail) {
+	FullyConnectedTester tester;
+	tester.outputChannels(19)
+		.iterations(10);
+	for (size_t inputChannels = 1; inputChannels <= 33; inputChannels += 1) {
+		tester.inputChannels(inputChannels)
+			.testInferenceU8S8();
+	}
+}
+
+TEST(U8S8DOTXF, leaky_relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.activation(nnp_activation_relu)
+		.negativeSlope(0.01f)
+		.testInferenceU8S8();
+}
+
+/* 65536 input channels is the longest supported reduction */
+TEST(U8S8DOTXF, max_reduction_size) {
+	FullyConnectedTester()
+		.inputChannels(65536)
+		.outputChannels(5)
+		.extremeValues(true)
+		.testInferenceU8S8();
+}
+
+TEST(U8S8DOTXF, reduction_size_over_limit) {
+	FullyConnectedTester()
+		.inputChannels(65537)
+		.outputChannels(5)
+		.expectedStatus(nnp_status_unsupported_input_channels)
+		.testInferenceU8S8();
+}
+
+/*
+ * Test that implementation with sparse kernel matches reference on the dense kernel
+ */
+
+TEST(SCSRMV, output_channels_tail) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.sparsity(0.5f)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t outputChannels = 1; outputChannels <= 35; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testInferenceSparse();
+	}
+}
+
+TEST(SCSRMV, non_zeroes_tail) {
+	FullyConnectedTester tester;
+	tester.outputChannels(19)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t inputChannels = 1; inputChannels <= 33; inputChannels += 1) {
+		tester.inputChannels(inputChannels)
+			.testInferenceSparse();
+	}
+}
+
+TEST(SCSRMV, high_sparsity) {
+	FullyConnectedTester()
+		.inputChannels(1021)
+		.outputChannels(67)
+		.sparsity(0.95f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceSparse();
+}
+
+TEST(SCSRMV, empty_rows) {
+	FullyConnectedTester()
+		.inputChannels(29)
+		.outputChannels(45)
+		.sparsity(1.0f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceSparse();
+}
+
+TEST(SCSRMV, relu) {
+	FullyConnectedTester()
+		.inputChannels(123)
+		.outputChannels(45)
+		.sparsity(0.8f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.testInferenceSparse();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/fully-connected.h>
+
+/*
+ * Test that implementation works for a single register block
+ */
+
+TEST(MRxNR_4x24, single_block) {
+	FullyConnectedTester()
+		.batchSize(4)
+		.inputChannels(24)
+		.outputChannels(4)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testKernelGradient();
+}
+
+/*
+ * Test that implementation works for partial register blocks
+ */
+
+TEST(MRxNR_4x24, partial_blocks) {
+	FullyConnectedTester tester;
+	tester.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 9; batchSize += 1) {
+		for (size_t channels = 1; channels <= 25; channels += 3) {
+			tester.batchSize(batchSize)
+				.inputChannels(channels)
+				.outputChannels(channels + 2)
+				.testKernelGradient();
+		}
+	}
+}
+
+/*
+ * Test that implementation works for many channels (multiple cache blocks)
+ */
+
+TEST(MRxNR_4x24, many_channels) {
+	FullyConnectedTester()
+		.batchSize(64)
+		.inputChannels(1024)
+		.outputChannels(1200)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.multithreading(true)
+		.testKernelGradient();
+}
+
+/*
+ * Test that implementation works for a large minibatch
+ */
+
+TEST(MRxNR_4x24, large_batch) {
+	FullyConnectedTester()
+		.batchSize(1027)
+		.inputChannels(56)
+		.outputChannels(72)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.multithreading(true)
+		.testKernelGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -127,6 +127,243 @@ TEST(MRxNR_4x24, many_output_channels) {
 		.testOutput();
 }
 
+/*
+ * Test that implementation works for minibatches larger than the small-batch threshold (matrix-matrix multiplication path)
+ */
+
+TEST(MRxNR_4x24, large_batch) {
+	FullyConnectedTester tester;
+	tester.inputChannels(13)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 9; batchSize <= 16; batchSize += 1) {
+		tester.batchSize(batchSize)
+			.testOutput();
+	}
+}
+
+TEST(MRxNR_4x24, large_batch_many_channels) {
+	FullyConnectedTester()
+		.batchSize(12)
+		.inputChannels(1024)
+		.outputChannels(1200)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.multithreading(true)
+		.testOutput();
+}
+
+/*
+ * Test that implementation works for small minibatches (fused dot product path)
+ */
+
+TEST(SMALL_BATCH, output_channels_subblock) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 8; batchSize += 1) {
+		for (size_t outputChannels = 1; outputChannels <= 8; outputChannels += 1) {
+			tester.batchSize(batchSize)
+				.outputChannels(outputChannels)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SMALL_BATCH, input_channels_tail) {
+	FullyConnectedTester tester;
+	tester.outputChannels(24)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 8; batchSize += 1) {
+		for (size_t inputChannels = 1; inputChannels <= 17; inputChannels += 1) {
+			tester.batchSize(batchSize)
+				.inputChannels(inputChannels)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SMALL_BATCH, many_channels) {
+	FullyConnectedTester tester;
+	tester.inputChannels(1024)
+		.outputChannels(1000)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.multithreading(true);
+	for (size_t batchSize = 2; batchSize <= 8; batchSize += 1) {
+		tester.batchSize(batchSize)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that implementation works with a kernel packed ahead of time
+ */
+
+TEST(MRxNR_4x24, prepacked_kernel) {
+	FullyConnectedTester tester;
+	tester.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 8; batchSize += 1) {
+		tester.batchSize(batchSize)
+			.inputChannels(13)
+			.outputChannels(35)
+			.testOutputPrepacked();
+	}
+}
+
+TEST(MRxNR_4x24, prepacked_kernel_many_input_channels) {
+	FullyConnectedTester()
+		.batchSize(4)
+		.inputChannels(1024)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testOutputPrepacked();
+}
+
+TEST(MRxNR_4x24, prepacked_kernel_many_output_channels) {
+	FullyConnectedTester()
+		.batchSize(7)
+		.inputChannels(1024)
+		.outputChannels(1200)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.multithreading(true)
+		.testOutputPrepacked();
+}
+
+/*
+ * Test that implementation works with bias and ReLU activation applied to the output
+ */
+
+TEST(MRxNR_4x24, relu) {
+	FullyConnectedTester()
+		.batchSize(13)
+		.inputChannels(1024)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.testOutput();
+}
+
+TEST(MRxNR_4x24, leaky_relu) {
+	FullyConnectedTester()
+		.batchSize(13)
+		.inputChannels(1024)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.negativeSlope(0.01f)
+		.testOutput();
+}
+
+TEST(MRxNR_4x24, prepacked_kernel_relu) {
+	FullyConnectedTester()
+		.batchSize(13)
+		.inputChannels(1024)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.negativeSlope(0.01f)
+		.testOutputPrepacked();
+}
+
+TEST(SMALL_BATCH, relu) {
+	FullyConnectedTester tester;
+	tester.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu);
+	for (size_t batchSize = 1; batchSize <= 8; batchSize += 1) {
+		tester.batchSize(batchSize)
+			.testOutput();
+	}
+}
+
+TEST(SMALL_BATCH, leaky_relu) {
+	FullyConnectedTester tester;
+	tester.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.activation(nnp_activation_relu)
+		.negativeSlope(0.01f);
+	for (size_t batchSize = 1; batchSize <= 8; batchSize += 1) {
+		tester.batchSize(batchSize)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that 8-bit quantized implementation matches the quantized reference
+ */
+
+TEST(U8S8GEMM, output_channels_tail) {
+	FullyConnectedTester tester;
+	tester.inputChannels(37)
+		.batchSize(3)
+		.iterations(10);
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels += 1) {
+		tester.outputChannels(outputChannels)
+			.testOutputU8S8();
+	}
+}
+
+TEST(U8S8GEMM, many_channels) {
+	FullyConnectedTester()
+		.batchSize(5)
+		.inputChannels(1021)
+		.outputChannels(67)
+		.iterations(10)
+		.testOutputU8S8();
+}
+
+TEST(U8S8GEMM, relu) {
+	FullyConnectedTester()
+		.batchSize(4)
+		.inputChannels(123)
+		.outputChannels(45)
+		.iterations(10)
+		.activation(nnp_activation_relu)
+		.testOutputU8S8();
+}
+
+TEST(U8S8GEMM, multithreaded) {
+	FullyConnectedTester()
+		.batchSize(37)
+		.inputChannels(1021)
+		.outputChannels(67)
+		.multithreading(true)
+		.testOutputU8S8();
+}
+
+/* 65536 input channels is the longest supported reduction */
+TEST(U8S8GEMM, max_reduction_size) {
+	FullyConnectedTester()
+		.batchSize(21)
+		.inputChannels(65536)
+		.outputChannels(5)
+		.extremeValues(true)
+		.testOutputU8S8();
+}
+
+TEST(U8S8GEMM, reduction_size_over_limit) {
+	FullyConnectedTester()
+		.batchSize(3)
+		.inputChannels(65537)
+		.outputChannels(5)
+		.expectedStatus(nnp_status_unsupported_input_channels)
+		.testOutputU8S8();
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
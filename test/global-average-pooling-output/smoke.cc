@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/pooling.h>
+
+/*
+ * Test that implementation works for a single-channel image of various sizes
+ */
+
+TEST(GlobalAveragePooling, image_size) {
+	for (size_t imageHeight = 1; imageHeight <= 9; imageHeight++) {
+		for (size_t imageWidth = 1; imageWidth <= 9; imageWidth++) {
+			PoolingTester()
+				.inputSize(imageHeight, imageWidth)
+				.errorLimit(1.0e-6)
+				.iterations(10)
+				.testGlobalAverageOutput();
+		}
+	}
+}
+
+/*
+ * Test that implementation works for large images
+ */
+
+TEST(GlobalAveragePooling, large_image) {
+	PoolingTester()
+		.inputSize(56, 56)
+		.errorLimit(1.0e-5)
+		.iterations(10)
+		.testGlobalAverageOutput();
+}
+
+/*
+ * Test that implementation can handle non-unit batch_size and number of channels
+ */
+
+TEST(GlobalAveragePooling, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(7, 7)
+		.errorLimit(1.0e-6)
+		.iterations(10);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		for (size_t channels = 2; channels <= 5; channels++) {
+			tester.batchSize(batchSize)
+				.channels(channels)
+				.testGlobalAverageOutput();
+		}
+	}
+}
+
+/*
+ * Test that implementation works with multi-threading
+ */
+
+TEST(GlobalAveragePooling, multithreading) {
+	PoolingTester()
+		.multithreading(true)
+		.batchSize(4)
+		.channels(1024)
+		.inputSize(7, 7)
+		.errorLimit(1.0e-6)
+		.testGlobalAverageOutput();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
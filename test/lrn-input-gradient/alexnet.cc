@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/lrn.h>
+#include <models/alexnet.h>
+
+/*
+ * AlexNet norm1 layer
+ */
+
+TEST(LRN_INPUT_GRADIENT, norm1) {
+	AlexNet::norm1()
+		.batchSize(128)
+		.testInputGradient();
+}
+
+/*
+ * AlexNet norm2 layer
+ */
+
+TEST(LRN_INPUT_GRADIENT, norm2) {
+	AlexNet::norm2()
+		.batchSize(128)
+		.testInputGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/lrn.h>
+
+/*
+ * Test local response normalization gradient with small images, which exercise partial pixel groups of the vector kernels
+ */
+
+TEST(LRN_INPUT_GRADIENT, small_images) {
+	auto tester = LRNTester();
+	tester.channels(7)
+		.alpha(1.0f)
+		.k(1.0f);
+	for (size_t width = 1; width <= 17; width += 1) {
+		for (size_t batch = 1; batch <= 3; batch += 1) {
+			tester.inputSize(3, width)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+/*
+ * Test windows which are wider than the number of channels, or clipped at both ends
+ */
+
+TEST(LRN_INPUT_GRADIENT, window_size) {
+	auto tester = LRNTester();
+	tester.inputSize(5, 5)
+		.alpha(1.0f)
+		.k(1.0f);
+	for (size_t localSize = 1; localSize <= 9; localSize += 2) {
+		for (size_t channels = 1; channels <= 12; channels += 1) {
+			tester.localSize(localSize)
+				.channels(channels)
+				.testInputGradient();
+		}
+	}
+}
+
+TEST(LRN_INPUT_GRADIENT, strong_normalization) {
+	LRNTester()
+		.batchSize(2)
+		.channels(16)
+		.inputSize(6, 7)
+		.inputRange(10.0f)
+		.alpha(2.0f)
+		.beta(1.5f)
+		.k(0.5f)
+		.testInputGradient();
+}
+
+TEST(LRN_INPUT_GRADIENT, negative_beta) {
+	LRNTester()
+		.channels(16)
+		.inputSize(6, 7)
+		.alpha(1.0f)
+		.beta(-0.5f)
+		.k(1.0f)
+		.testInputGradient();
+}
+
+TEST(LRN_INPUT_GRADIENT, inplace) {
+	LRNTester()
+		.batchSize(3)
+		.channels(16)
+		.inputSize(9, 11)
+		.alpha(1.0f)
+		.k(1.0f)
+		.testInputGradientInplace();
+}
+
+TEST(LRN_INPUT_GRADIENT, multithreaded) {
+	LRNTester()
+		.multithreading(true)
+		.batchSize(16)
+		.channels(32)
+		.inputSize(15, 17)
+		.alpha(1.0f)
+		.k(1.0f)
+		.testInputGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
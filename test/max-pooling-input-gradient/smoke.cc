@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/pooling.h>
+
+/*
+ * Test that 2x2 stride 2 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(MaxPoolingInputGradient2x2s2, few_horizontal_pools) {
+	for (size_t imageWidth = 2; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(2, imageWidth)
+			.poolingSize(2, 2)
+			.poolingStride(2, 2)
+			.iterations(10)
+			.testInputGradient();
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(MaxPoolingInputGradient2x2s2, few_vertical_pools) {
+	for (size_t imageHeight = 2; imageHeight <= 40; imageHeight++) {
+		PoolingTester()
+			.inputSize(imageHeight, 2)
+			.poolingSize(2, 2)
+			.poolingStride(2, 2)
+			.iterations(10)
+			.testInputGradient();
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works with implicit padding
+ */
+
+TEST(MaxPoolingInputGradient2x2s2, implicit_padding) {
+	for (size_t paddingTop = 0; paddingTop <= 1; paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight <= 1; paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft <= 1; paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom <= 1; paddingBottom++) {
+					PoolingTester()
+						.inputSize(24, 24)
+						.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.poolingSize(2, 2)
+						.poolingStride(2, 2)
+						.iterations(5)
+						.testInputGradient();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 2x2 stride 2 implementation works with multi-channel inputs and batches
+ */
+
+TEST(MaxPoolingInputGradient2x2s2, multi_channel) {
+	PoolingTester()
+		.batchSize(2)
+		.channels(3)
+		.inputSize(13, 13)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(5)
+		.testInputGradient();
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for overlapping pools with implicit padding
+ */
+
+TEST(MaxPoolingInputGradient3x3s2, few_horizontal_pools) {
+	for (size_t imageWidth = 3; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2)
+			.iterations(10)
+			.testInputGradient();
+	}
+}
+
+TEST(MaxPoolingInputGradient3x3s2, implicit_padding) {
+	for (size_t paddingTop = 0; paddingTop <= 2; paddingTop++) {
+		for (size_t paddingLeft = 0; paddingLeft <= 2; paddingLeft++) {
+			PoolingTester()
+				.inputSize(27, 27)
+				.inputPadding(paddingTop, 1, paddingLeft, 1)
+				.poolingSize(3, 3)
+				.poolingStride(2, 2)
+				.iterations(5)
+				.testInputGradient();
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for overlapping pools with implicit padding
+ */
+
+TEST(MaxPoolingInputGradient3x3s1, few_horizontal_pools) {
+	for (size_t imageWidth = 3; imageWidth <= 40; imageWidth++) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(1, 1)
+			.iterations(10)
+			.testInputGradient();
+	}
+}
+
+TEST(MaxPoolingInputGradient3x3s1, implicit_padding) {
+	PoolingTester()
+		.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.iterations(5)
+		.testInputGradient();
+}
+
+/*
+ * Test that generic implementation works for pooling sizes without specialized micro-kernels
+ */
+
+TEST(MaxPoolingInputGradientGeneric, pooling_size) {
+	for (size_t poolingHeight = 1; poolingHeight <= 5; poolingHeight++) {
+		for (size_t poolingWidth = 1; poolingWidth <= 5; poolingWidth++) {
+			/* Padding must be smaller than the pool */
+			const size_t paddingHeight = std::min<size_t>(poolingHeight - 1, 1);
+			const size_t paddingWidth = std::min<size_t>(poolingWidth - 1, 1);
+			PoolingTester()
+				.inputSize(19, 21)
+				.inputPadding(paddingHeight, paddingWidth, paddingWidth, paddingHeight)
+				.poolingSize(poolingHeight, poolingWidth)
+				.poolingStride(std::min<size_t>(poolingHeight, 2), std::min<size_t>(poolingWidth, 3))
+				.iterations(3)
+				.testInputGradient();
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
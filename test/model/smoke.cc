@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+
+static const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+static const struct nnp_padding samePadding = { 1, 1, 1, 1 };
+
+/*
+ * Small VGG-style network: every type of layer, with kernels in the layouts of inference functions
+ */
+
+static NetworkTester smallVGG() {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 16, 16 }, samePadding, nnp_size { 3, 3 }, nnp_convolution_algorithm_wt8x8)
+		.relu(8 * 16 * 16)
+		.maxPooling(8, nnp_size { 16, 16 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.convolution(8, 16, nnp_size { 8, 8 }, samePadding, nnp_size { 3, 3 }, nnp_convolution_algorithm_wt8x8)
+		.relu(16 * 8 * 8)
+		.maxPooling(16, nnp_size { 8, 8 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.fullyConnected(16 * 4 * 4, 32)
+		.relu(32)
+		.fullyConnected(32, 10)
+		.softmax(10);
+	return tester;
+}
+
+TEST(MODEL, single_image) {
+	smallVGG()
+		.batchSize(1)
+		.errorLimit(1.0e-3)
+		.iterations(3)
+		.testModel();
+}
+
+TEST(MODEL, batch) {
+	smallVGG()
+		.batchSize(5)
+		.errorLimit(1.0e-3)
+		.testModel();
+}
+
+TEST(MODEL, multithreaded) {
+	smallVGG()
+		.batchSize(4)
+		.errorLimit(1.0e-3)
+		.multithreading(true)
+		.testModel();
+}
+
+TEST(MODEL, wide_fully_connected) {
+	auto tester = NetworkTester();
+	tester.fullyConnected(1000, 100)
+		.relu(100, 0.01f)
+		.fullyConnected(100, 1000)
+		.testModel();
+}
+
+TEST(MODEL, convolution_without_bias) {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 8, 8 }, samePadding, nnp_size { 3, 3 }, nnp_convolution_algorithm_wt8x8, false)
+		.relu(8 * 8 * 8)
+		.fullyConnected(8 * 8 * 8, 10)
+		.errorLimit(1.0e-3)
+		.testModel();
+}
+
+/*
+ * Files which are not valid models are rejected by the loader
+ */
+
+TEST(MODEL, corrupted_magic) {
+	smallVGG().testCorruptedModel(0);
+}
+
+TEST(MODEL, corrupted_layer) {
+	/* Type of the first layer follows the 48-byte header */
+	smallVGG().testCorruptedModel(48);
+}
+
+TEST(MODEL, truncated_header) {
+	smallVGG().testTruncatedModel(16);
+}
+
+TEST(MODEL, truncated_weights) {
+	smallVGG().testTruncatedModel(4096);
+}
+
+TEST(MODEL, missing_file) {
+	nnp_model_t model = nullptr;
+	ASSERT_EQ(nnp_status_io_error, nnp_model_load("/nonexistent/nnpack.model", &model));
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -6,6 +6,7 @@
 #include <testers/fully-connected.h>
 #include <testers/pooling.h>
 #include <testers/relu.h>
+#include <testers/lrn.h>
 
 namespace AlexNet {
 
@@ -21,6 +22,43 @@ namespace AlexNet {
 			.imageSize(55, 55));
 	}
 
+	/*
+	 * AlexNet norm1 layer:
+	 *   channels   = 64
+	 *   image size = 55x55
+	 *   local size = 5
+	 *   alpha      = 1.0e-4
+	 *   beta       = 0.75
+	 *   k          = 2
+	 */
+	inline LRNTester norm1() {
+		return std::move(LRNTester()
+			.multithreading(true)
+			.channels(64)
+			.inputSize(55, 55)
+			.localSize(5)
+			.alpha(1.0e-4f)
+			.beta(0.75f)
+			.k(2.0f));
+	}
+
+	/*
+	 * AlexNet pool1 layer:
+	 *   channels         = 64
+	 *   input size       = 55x55
+	 *   implicit padding = 0
+	 *   pooling size     = 3x3
+	 *   pooling stride   = 2x2
+	 */
+	inline PoolingTester pool1() {
+		return std::move(PoolingTester()
+			.multithreading(true)
+			.channels(64)
+			.inputSize(55, 55)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2));
+	}
+
 	/*
 	 * AlexNet conv2 layer:
 	 *   input channels   = 64
@@ -51,6 +89,43 @@ namespace AlexNet {
 			.imageSize(27, 27));
 	}
 
+	/*
+	 * AlexNet norm2 layer:
+	 *   channels   = 192
+	 *   image size = 27x27
+	 *   local size = 5
+	 *   alpha      = 1.0e-4
+	 *   beta       = 0.75
+	 *   k          = 2
+	 */
+	inline LRNTester norm2() {
+		return std::move(LRNTester()
+			.multithreading(true)
+			.channels(192)
+			.inputSize(27, 27)
+			.localSize(5)
+			.alpha(1.0e-4f)
+			.beta(0.75f)
+			.k(2.0f));
+	}
+
+	/*
+	 * AlexNet pool2 layer:
+	 *   channels         = 192
+	 *   input size       = 27x27
+	 *   implicit padding = 0
+	 *   pooling size     = 3x3
+	 *   pooling stride   = 2x2
+	 */
+	inline PoolingTester pool2() {
+		return std::move(PoolingTester()
+			.multithreading(true)
+			.channels(192)
+			.inputSize(27, 27)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2));
+	}
+
 	/*
 	 * AlexNet conv3 layer:
 	 *   input channels   = 192
@@ -129,6 +204,23 @@ namespace AlexNet {
 			.inputPadding(1, 1, 1, 1));
 	}
 
+	/*
+	 * AlexNet pool5 layer:
+	 *   channels         = 256
+	 *   input size       = 13x13
+	 *   implicit padding = 0
+	 *   pooling size     = 3x3
+	 *   pooling stride   = 2x2
+	 */
+	inline PoolingTester pool5() {
+		return std::move(PoolingTester()
+			.multithreading(true)
+			.channels(256)
+			.inputSize(13, 13)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2));
+	}
+
 	/*
 	 * AlexNet fc6 layer:
 	 *   input channels = 12544
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+
+static const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+static const struct nnp_padding samePadding = { 1, 1, 1, 1 };
+
+/*
+ * Small VGG-style network: every type of layer, with in-place ReLU and softmax layers
+ */
+
+static NetworkTester smallVGG() {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 16, 16 }, samePadding, nnp_size { 3, 3 })
+		.relu(8 * 16 * 16)
+		.maxPooling(8, nnp_size { 16, 16 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.convolution(8, 16, nnp_size { 8, 8 }, samePadding, nnp_size { 3, 3 })
+		.relu(16 * 8 * 8)
+		.maxPooling(16, nnp_size { 8, 8 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.fullyConnected(16 * 4 * 4, 32)
+		.relu(32)
+		.fullyConnected(32, 10)
+		.softmax(10);
+	return tester;
+}
+
+TEST(NETWORK, single_image) {
+	smallVGG()
+		.batchSize(1)
+		.iterations(3)
+		.testOutput();
+}
+
+TEST(NETWORK, small_batch) {
+	smallVGG()
+		.batchSize(3)
+		.testOutput();
+}
+
+TEST(NETWORK, large_batch) {
+	smallVGG()
+		.batchSize(16)
+		.testOutput();
+}
+
+TEST(NETWORK, multithreaded) {
+	smallVGG()
+		.batchSize(4)
+		.multithreading(true)
+		.iterations(3)
+		.testOutput();
+}
+
+TEST(NETWORK, single_layer) {
+	auto tester = NetworkTester();
+	tester.convolution(4, 4, nnp_size { 9, 9 }, samePadding, nnp_size { 3, 3 })
+		.testOutput();
+}
+
+TEST(NETWORK, leading_relu) {
+	auto tester = NetworkTester();
+	tester.relu(4 * 9 * 9, 0.01f)
+		.convolution(4, 4, nnp_size { 9, 9 }, samePadding, nnp_size { 3, 3 })
+		.relu(4 * 9 * 9, 0.01f)
+		.testOutput();
+}
+
+TEST(NETWORK, wide_softmax) {
+	auto tester = NetworkTester();
+	tester.fullyConnected(16, 10000)
+		.softmax(10000)
+		.multithreading(true)
+		.testOutput();
+}
+
+/*
+ * Deep chains of layers need only two activation buffers
+ */
+
+TEST(NETWORK, activations_reuse) {
+	auto tester = NetworkTester();
+	for (size_t i = 0; i < 6; i++) {
+		tester.convolution(8, 8, nnp_size { 12, 12 }, samePadding, nnp_size { 3, 3 });
+	}
+	tester.testActivationsReuse();
+	tester.testOutput();
+}
+
+TEST(NETWORK, mismatched_layers) {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 16, 16 }, samePadding, nnp_size { 3, 3 })
+		.fullyConnected(8 * 15 * 15, 10)
+		.testInvalidLayer();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
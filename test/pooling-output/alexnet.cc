@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/pooling.h>
+#include <models/alexnet.h>
+
+/*
+ * AlexNet pool1 layer
+ */
+
+TEST(MaxPooling3x3s2, pool1) {
+	AlexNet::pool1()
+		.batchSize(128)
+		.testOutput();
+}
+
+/*
+ * AlexNet pool2 layer
+ */
+
+TEST(MaxPooling3x3s2, pool2) {
+	AlexNet::pool2()
+		.batchSize(128)
+		.testOutput();
+}
+
+/*
+ * AlexNet pool5 layer
+ */
+
+TEST(MaxPooling3x3s2, pool5) {
+	AlexNet::pool5()
+		.batchSize(128)
+		.testOutput();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -77,7 +77,7 @@ TEST(MaxPooling2x2, indivisible_size) {
  * Test that implementation works for a single-channel image with implicit padding
  */
 
-TEST(MaxPooling2x2, DISABLED_implicit_padding) {
+TEST(MaxPooling2x2, implicit_padding) {
 	PoolingTester tester;
 	tester.inputSize(24, 24)
 		.poolingSize(2, 2)
@@ -127,6 +127,248 @@ TEST(MaxPooling2x2, few_channels) {
 	}
 }
 
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with a single-pool
+ */
+
+TEST(MaxPooling3x3s2, single_pool) {
+	PoolingTester()
+		.inputSize(3, 3)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(100)
+		.testOutput();
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(MaxPooling3x3s2, few_horizontal_pools) {
+	for (size_t imageWidth = 4; imageWidth <= 50; imageWidth += 1) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2)
+			.iterations(100)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(MaxPooling3x3s2, few_vertical_pools) {
+	for (size_t imageHeight = 4; imageHeight <= 50; imageHeight += 1) {
+		PoolingTester()
+			.inputSize(imageHeight, 3)
+			.poolingSize(3, 3)
+			.poolingStride(2, 2)
+			.iterations(100)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with multiple horizontal and vertical pools
+ */
+
+TEST(MaxPooling3x3s2, large_image) {
+	PoolingTester()
+		.inputSize(55, 55)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(100)
+		.testOutput();
+}
+
+/*
+ * Test that 3x3 stride 2 implementation works for a single-channel image with implicit padding
+ */
+
+TEST(MaxPooling3x3s2, implicit_padding) {
+	PoolingTester tester;
+	tester.inputSize(27, 27)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 2 implementation can handle small non-unit batch_size and number of channels
+ */
+
+TEST(MaxPooling3x3s2, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(13, 13)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(100);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		for (size_t channels = 2; channels <= 5; channels++) {
+			tester.batchSize(batchSize)
+				.channels(channels)
+				.testOutput();
+		}
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with a single-pool
+ */
+
+TEST(MaxPooling3x3s1, single_pool) {
+	PoolingTester()
+		.inputSize(3, 3)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.iterations(100)
+		.testOutput();
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with few horizontal pools
+ */
+
+TEST(MaxPooling3x3s1, few_horizontal_pools) {
+	for (size_t imageWidth = 4; imageWidth <= 50; imageWidth += 1) {
+		PoolingTester()
+			.inputSize(3, imageWidth)
+			.poolingSize(3, 3)
+			.poolingStride(1, 1)
+			.iterations(100)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with few vertical pools
+ */
+
+TEST(MaxPooling3x3s1, few_vertical_pools) {
+	for (size_t imageHeight = 4; imageHeight <= 50; imageHeight += 1) {
+		PoolingTester()
+			.inputSize(imageHeight, 3)
+			.poolingSize(3, 3)
+			.poolingStride(1, 1)
+			.iterations(100)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with multiple horizontal and vertical pools
+ */
+
+TEST(MaxPooling3x3s1, large_image) {
+	PoolingTester()
+		.inputSize(28, 28)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.iterations(100)
+		.testOutput();
+}
+
+/*
+ * Test that 3x3 stride 1 implementation works for a single-channel image with implicit padding
+ */
+
+TEST(MaxPooling3x3s1, implicit_padding) {
+	PoolingTester tester;
+	tester.inputSize(28, 28)
+		.poolingSize(3, 3)
+		.poolingStride(1, 1)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that general implementation works for pool sizes and strides without specialized kernels
+ */
+
+TEST(MaxPoolingGeneric, pooling_size_and_stride) {
+	for (size_t poolingHeight = 1; poolingHeight <= 5; poolingHeight++) {
+		for (size_t poolingWidth = 1; poolingWidth <= 5; poolingWidth++) {
+			for (size_t strideHeight = 1; strideHeight <= poolingHeight; strideHeight++) {
+				for (size_t strideWidth = 1; strideWidth <= poolingWidth; strideWidth++) {
+					PoolingTester()
+						.inputSize(19, 29)
+						.poolingSize(poolingHeight, poolingWidth)
+						.poolingStride(strideHeight, strideWidth)
+						.iterations(3)
+						.testOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that general implementation works with implicit padding
+ */
+
+TEST(MaxPoolingGeneric, implicit_padding) {
+	PoolingTester tester;
+	tester.inputSize(23, 23)
+		.poolingSize(5, 5)
+		.poolingStride(3, 3)
+		.iterations(3);
+	for (size_t paddingTop = 0; paddingTop < tester.kernelHeight(); paddingTop++) {
+		for (size_t paddingRight = 0; paddingRight < tester.kernelWidth(); paddingRight++) {
+			for (size_t paddingLeft = 0; paddingLeft < tester.kernelWidth(); paddingLeft++) {
+				for (size_t paddingBottom = 0; paddingBottom < tester.kernelHeight(); paddingBottom++) {
+					tester.inputPadding(paddingTop, paddingRight, paddingLeft, paddingBottom)
+						.testOutput();
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Test that input smaller than the pool, even with implicit padding, is rejected
+ */
+
+TEST(MaxPoolingGeneric, input_smaller_than_pool) {
+	const nnp_size inputSize = { 2, 2 };
+	const nnp_size poolingSize = { 3, 3 };
+	const nnp_size poolingStride = { 2, 2 };
+	float input[4] = { 0.0f };
+	float output[4] = { 0.0f };
+	uint8_t mask[4] = { 0 };
+	EXPECT_EQ(nnp_status_invalid_input_size,
+		nnp_max_pooling_output(1, 1, inputSize, nnp_padding { 0, 0, 0, 0 }, poolingSize, poolingStride,
+			input, output, nullptr));
+	EXPECT_EQ(nnp_status_invalid_input_size,
+		nnp_max_pooling_output_with_mask(1, 1, inputSize, nnp_padding { 0, 0, 0, 0 }, poolingSize, poolingStride,
+			input, output, mask, nullptr));
+
+	/* With one row and column of padding the input fits exactly one pool */
+	EXPECT_EQ(nnp_status_success,
+		nnp_max_pooling_output(1, 1, inputSize, nnp_padding { 1, 0, 0, 1 }, poolingSize, poolingStride,
+			input, output, nullptr));
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <nnpack.h>
+#include <nnpack/workspace.h>
+#include <nnpack/scheduler.h>
+#include <nnpack/numa.h>
+#include <nnpack/system.h>
+
+#include <testers/convolution.h>
+#include <testers/network.h>
+
+static const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+static const struct nnp_padding samePadding = { 1, 1, 1, 1 };
+
+static NetworkTester smallVGG() {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 16, 16 }, samePadding, nnp_size { 3, 3 })
+		.relu(8 * 16 * 16)
+		.maxPooling(8, nnp_size { 16, 16 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.fullyConnected(8 * 8 * 8, 32)
+		.relu(32)
+		.fullyConnected(32, 10)
+		.softmax(10);
+	return tester;
+}
+
+TEST(SCHEDULER, single_job) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.testSchedulerOutput(1, 4);
+}
+
+TEST(SCHEDULER, single_worker) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.testSchedulerOutput(2, 1);
+}
+
+TEST(SCHEDULER, concurrent_jobs) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.testSchedulerOutput(4, 4);
+}
+
+TEST(SCHEDULER, more_jobs_than_workers) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(3)
+		.testSchedulerOutput(8, 2);
+}
+
+TEST(SCHEDULER, convolution_output) {
+	nnp_scheduler_t scheduler = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_create(4, &scheduler));
+
+	nnp_scheduler_job_t job = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_begin_job(scheduler, 1, 4, &job));
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(37)
+		.errorLimit(1.0e-3)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_end_job(job));
+
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(scheduler));
+}
+
+TEST(SCHEDULER, softmax_output_split_rows) {
+	/* A single row wide enough for split-row softmax, which runs only with more threads than rows */
+	const size_t channels = 1 << 16;
+	std::vector<float> input(channels, 1.0f);
+	std::vector<float> output(channels);
+	size_t workspaceSize = 0;
+	ASSERT_EQ(nnp_status_success,
+		nnp_softmax_output_with_workspace(1, channels, input.data(), output.data(), nullptr, &workspaceSize, nullptr));
+	ASSERT_NE(0, workspaceSize);
+
+	/* Split-row softmax needs the workspace, so an empty workspace tells which path was chosen */
+	char emptyWorkspace;
+	size_t emptyWorkspaceSize = 0;
+	EXPECT_EQ(nnp_status_success,
+		nnp_softmax_output_with_workspace(1, channels, input.data(), output.data(),
+			&emptyWorkspace, &emptyWorkspaceSize, nullptr));
+
+	nnp_scheduler_t scheduler = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_create(4, &scheduler));
+
+	nnp_scheduler_job_t job = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_begin_job(scheduler, 1, 4, &job));
+	EXPECT_EQ(nnp_status_insufficient_buffer,
+		nnp_softmax_output_with_workspace(1, channels, input.data(), output.data(),
+			&emptyWorkspace, &emptyWorkspaceSize, nullptr));
+	EXPECT_EQ(nnp_status_success,
+		nnp_softmax_output(1, channels, input.data(), output.data(), nullptr));
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_end_job(job));
+
+	for (float y : output) {
+		ASSERT_LT(std::abs(y * float(channels) - 1.0f), 1.0e-4f);
+	}
+
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(scheduler));
+}
+
+TEST(SCHEDULER, invalid_threads_count) {
+	nnp_scheduler_t scheduler = nullptr;
+	ASSERT_EQ(nnp_status_invalid_threads_count, nnp_scheduler_create(0, &scheduler));
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_create(2, &scheduler));
+
+	nnp_scheduler_job_t job = nullptr;
+	EXPECT_EQ(nnp_status_invalid_threads_count, nnp_scheduler_begin_job(scheduler, 1, 0, &job));
+	EXPECT_EQ(nnp_status_invalid_threads_count, nnp_scheduler_begin_job(scheduler, 1, 3, &job));
+
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(scheduler));
+}
+
+TEST(SCHEDULER, nested_jobs) {
+	nnp_scheduler_t outerScheduler = nullptr;
+	nnp_scheduler_t innerScheduler = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_create(2, &outerScheduler));
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_create(3, &innerScheduler));
+
+	nnp_scheduler_job_t outerJob = nullptr;
+	nnp_scheduler_job_t innerJob = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_begin_job(outerScheduler, 1, 1, &outerJob));
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_begin_job(innerScheduler, 0, 3, &innerJob));
+	smallVGG().batchSize(1).testOutput();
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_end_job(innerJob));
+	smallVGG().batchSize(1).testOutput();
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_end_job(outerJob));
+
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(innerScheduler));
+	ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(outerScheduler));
+}
+
+static void countTiles(std::vector<size_t>* counts, size_t startI, size_t startJ, size_t tileI, size_t tileJ) {
+	const size_t rangeJ = counts->size() / 7;
+	for (size_t i = startI; i < startI + tileI; i++) {
+		for (size_t j = startJ; j < startJ + tileJ; j++) {
+			(*counts)[i * rangeJ + j] += 1;
+		}
+	}
+}
+
+TEST(WORK_STEALING, null_threadpool) {
+	/* 7x29 elements in 3x4 tiles, with partial tiles at the edges */
+	std::vector<size_t> counts(7 * 29);
+	nnp_work_stealing_compute_2d_tiled(nullptr,
+		(pthreadpool_function_2d_tiled_t) countTiles, &counts,
+		7, 29, 3, 4);
+	for (size_t count : counts) {
+		ASSERT_EQ(1, count);
+	}
+}
+
+TEST(WORK_STEALING, threadpool) {
+	pthreadpool_t threadpool = pthreadpool_create(4);
+	ASSERT_NE(nullptr, threadpool);
+	std::vector<size_t> counts(7 * 29);
+	nnp_work_stealing_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) countTiles, &counts,
+		7, 29, 1, 2);
+	pthreadpool_destroy(threadpool);
+	for (size_t count : counts) {
+		ASSERT_EQ(1, count);
+	}
+}
+
+TEST(WORK_STEALING, large_threadpool) {
+	/* More threads than the loops have ranges for: the loop falls back to the static split */
+	pthreadpool_t threadpool = pthreadpool_create(80);
+	ASSERT_NE(nullptr, threadpool);
+	std::vector<size_t> counts(7 * 29);
+	nnp_work_stealing_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) countTiles, &counts,
+		7, 29, 1, 1);
+	pthreadpool_destroy(threadpool);
+	for (size_t count : counts) {
+		ASSERT_EQ(1, count);
+	}
+}
+
+TEST(NUMA, place_memory) {
+	const size_t memorySize = 4 << 20;
+	float* memory = static_cast<float*>(nnp_numa_allocate_memory(memorySize));
+	ASSERT_NE(nullptr, memory);
+
+	/* Ranges which are not aligned to pages, as partitions of transform buffers are */
+	const size_t nodesCount = nnp_numa_nodes_count();
+	const size_t partitionSize = memorySize / nodesCount - 100;
+	for (size_t node = 0; node < nodesCount; node++) {
+		char* partition = reinterpret_cast<char*>(memory) + 100 + node * partitionSize;
+		EXPECT_TRUE(nnp_numa_place_memory(partition, partitionSize, node));
+	}
+	EXPECT_FALSE(nnp_numa_place_memory(memory, memorySize, nodesCount));
+
+	std::fill(memory, memory + memorySize / sizeof(float), 1.0f);
+	release_memory(memory, memorySize);
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
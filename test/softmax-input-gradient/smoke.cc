@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/softmax.h>
+
+/*
+ * Test that input gradient implementation works for a small number of channels
+ */
+
+TEST(INPUT_GRADIENT, few_channels) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 1; channels <= 96; channels += 1) {
+		tester.channels(channels)
+			.testInputGradient();
+	}
+}
+
+/*
+ * Test that input gradient implementation works for a moderate number of channels with small batch
+ */
+
+TEST(INPUT_GRADIENT, small_batch) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 100; channels <= 115; channels += 1) {
+		for (size_t batch = 2; batch <= 5; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testInputGradient();
+		}
+	}
+}
+
+/*
+ * Test that input gradient implementation works for ImageNet classifier
+ */
+
+TEST(INPUT_GRADIENT, imagenet) {
+	SoftmaxTester()
+		.channels(1000)
+		.batchSize(16)
+		.iterations(10)
+		.testInputGradient();
+}
+
+/*
+ * Test that fused cross-entropy loss and gradient implementation works for a small number of channels
+ */
+
+TEST(CROSS_ENTROPY, few_channels) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 1; channels <= 96; channels += 1) {
+		tester.channels(channels)
+			.testCrossEntropyLossAndGradient();
+	}
+}
+
+/*
+ * Test that fused cross-entropy loss and gradient implementation works for a moderate number of channels with small batch
+ */
+
+TEST(CROSS_ENTROPY, small_batch) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 100; channels <= 115; channels += 1) {
+		for (size_t batch = 2; batch <= 5; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testCrossEntropyLossAndGradient();
+		}
+	}
+}
+
+/*
+ * Test that fused cross-entropy loss and gradient implementation works for ImageNet classifier
+ */
+
+TEST(CROSS_ENTROPY, imagenet) {
+	SoftmaxTester()
+		.channels(1000)
+		.batchSize(16)
+		.iterations(10)
+		.testCrossEntropyLossAndGradient();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -50,6 +50,64 @@ TEST(IN_PLACE, small_batch) {
 	}
 }
 
+/*
+ * Test that implementation works for wide rows split between threads
+ */
+
+TEST(SPLIT_ROW, out_of_place) {
+	auto tester = SoftmaxTester();
+	tester.multithreading(true);
+	for (size_t channels = 32767; channels <= 32769; channels += 1) {
+		for (size_t batch = 1; batch <= 2; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutput();
+		}
+	}
+}
+
+TEST(SPLIT_ROW, in_place) {
+	auto tester = SoftmaxTester();
+	tester.multithreading(true);
+	for (size_t channels = 32767; channels <= 32769; channels += 1) {
+		for (size_t batch = 1; batch <= 2; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testOutputInplace();
+		}
+	}
+}
+
+TEST(SPLIT_ROW, language_model) {
+	SoftmaxTester()
+		.multithreading(true)
+		.channels(100000)
+		.testOutput();
+}
+
+/*
+ * Test that log-softmax implementation works for a small number of channels and with small batch
+ */
+
+TEST(LOG_SOFTMAX, few_channels) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 1; channels <= 96; channels += 1) {
+		tester.channels(channels)
+			.testLogOutput();
+	}
+}
+
+TEST(LOG_SOFTMAX, small_batch) {
+	auto tester = SoftmaxTester();
+	for (size_t channels = 100; channels <= 115; channels += 1) {
+		for (size_t batch = 2; batch <= 5; batch += 1) {
+			tester.channels(channels)
+				.batchSize(batch)
+				.testLogOutput();
+		}
+	}
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+#if defined(__linux__)
+	#include <sys/resource.h>
+#endif
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+
+static const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+static const struct nnp_padding samePadding = { 1, 1, 1, 1 };
+
+static NetworkTester smallVGG() {
+	auto tester = NetworkTester();
+	tester.convolution(3, 8, nnp_size { 16, 16 }, samePadding, nnp_size { 3, 3 })
+		.relu(8 * 16 * 16)
+		.maxPooling(8, nnp_size { 16, 16 }, noPadding, nnp_size { 2, 2 }, nnp_size { 2, 2 })
+		.fullyConnected(8 * 8 * 8, 32)
+		.relu(32)
+		.fullyConnected(32, 10)
+		.softmax(10);
+	return tester;
+}
+
+TEST(STREAM, single_stream) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.testStreamOutput(1);
+}
+
+TEST(STREAM, single_stream_multithreaded) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.multithreading(true)
+		.testStreamOutput(1);
+}
+
+TEST(STREAM, shared_threadpool) {
+	smallVGG()
+		.batchSize(2)
+		.iterations(5)
+		.multithreading(true)
+		.testStreamOutput(4);
+}
+
+/*
+ * Operations of a stream run in order, and failures are reported by nnp_stream_synchronize
+ */
+
+struct Operation {
+	std::mutex* mutex;
+	std::vector<size_t>* log;
+	size_t index;
+	enum nnp_status status;
+};
+
+static enum nnp_status logOperation(void* context, pthreadpool_t threadpool) {
+	const Operation* operation = static_cast<const Operation*>(context);
+	std::lock_guard<std::mutex> lock(*operation->mutex);
+	operation->log->push_back(operation->index);
+	return operation->status;
+}
+
+TEST(STREAM, order) {
+	nnp_stream_t stream = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_stream_create(nullptr, &stream));
+
+	std::mutex mutex;
+	std::vector<size_t> log;
+	std::vector<Operation> operations(100);
+	for (size_t i = 0; i < operations.size(); i++) {
+		operations[i] = Operation { &mutex, &log, i, nnp_status_success };
+		ASSERT_EQ(nnp_status_success, nnp_stream_enqueue(stream, logOperation, &operations[i], nullptr, nullptr));
+	}
+	ASSERT_EQ(nnp_status_success, nnp_stream_synchronize(stream));
+
+	ASSERT_EQ(operations.size(), log.size());
+	for (size_t i = 0; i < log.size(); i++) {
+		EXPECT_EQ(i, log[i]);
+	}
+
+	ASSERT_EQ(nnp_status_success, nnp_stream_destroy(stream));
+}
+
+TEST(STREAM, failed_operation) {
+	nnp_stream_t stream = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_stream_create(nullptr, &stream));
+
+	std::mutex mutex;
+	std::vector<size_t> log;
+	Operation operations[3] = {
+		{ &mutex, &log, 0, nnp_status_success },
+		{ &mutex, &log, 1, nnp_status_invalid_batch_size },
+		{ &mutex, &log, 2, nnp_status_invalid_channels },
+	};
+	for (Operation& operation : operations) {
+		ASSERT_EQ(nnp_status_success, nnp_stream_enqueue(stream, logOperation, &operation, nullptr, nullptr));
+	}
+
+	/* Later operations still run, and the first failure is reported */
+	EXPECT_EQ(nnp_status_invalid_batch_size, nnp_stream_synchronize(stream));
+	EXPECT_EQ(3u, log.size());
+	EXPECT_EQ(nnp_status_success, nnp_stream_synchronize(stream));
+
+	ASSERT_EQ(nnp_status_success, nnp_stream_destroy(stream));
+}
+
+TEST(STREAM, destroy_completes_operations) {
+	nnp_stream_t stream = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_stream_create(nullptr, &stream));
+
+	std::mutex mutex;
+	std::vector<size_t> log;
+	std::vector<Operation> operations(10);
+	for (size_t i = 0; i < operations.size(); i++) {
+		operations[i] = Operation { &mutex, &log, i, nnp_status_success };
+		ASSERT_EQ(nnp_status_success, nnp_stream_enqueue(stream, logOperation, &operations[i], nullptr, nullptr));
+	}
+	ASSERT_EQ(nnp_status_success, nnp_stream_destroy(stream));
+	EXPECT_EQ(operations.size(), log.size());
+}
+
+#if defined(__linux__)
+TEST(STREAM, event_fd) {
+	nnp_stream_t stream = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_stream_create(nullptr, &stream));
+
+	int eventFd = -1;
+	ASSERT_EQ(nnp_status_success, nnp_stream_get_event_fd(stream, &eventFd));
+
+	std::mutex mutex;
+	std::vector<size_t> log;
+	std::vector<Operation> operations(5);
+	for (size_t i = 0; i < operations.size(); i++) {
+		operations[i] = Operation { &mutex, &log, i, nnp_status_success };
+		ASSERT_EQ(nnp_status_success, nnp_stream_enqueue(stream, logOperation, &operations[i], nullptr, nullptr));
+	}
+	ASSERT_EQ(nnp_status_success, nnp_stream_synchronize(stream));
+
+	/* The counter of the eventfd is the number of completed operations */
+	uint64_t completedCount = 0;
+	ASSERT_EQ((ssize_t) sizeof(completedCount), read(eventFd, &completedCount, sizeof(completedCount)));
+	EXPECT_EQ(operations.size(), completedCount);
+
+	ASSERT_EQ(nnp_status_success, nnp_stream_destroy(stream));
+}
+
+TEST(STREAM, event_fd_limit) {
+	/* Lower the descriptor limit to the lowest free descriptor, so that creation of the eventfd fails */
+	struct rlimit oldLimit;
+	ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &oldLimit));
+	const int freeFd = dup(0);
+	ASSERT_NE(-1, freeFd);
+	close(freeFd);
+	struct rlimit newLimit = oldLimit;
+	newLimit.rlim_cur = (rlim_t) freeFd;
+	ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &newLimit));
+
+	nnp_stream_t stream = nullptr;
+	const enum nnp_status status = nnp_stream_create(nullptr, &stream);
+
+	ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &oldLimit));
+	EXPECT_EQ(nnp_status_system_error, status);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
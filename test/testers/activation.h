@@ -0,0 +1,338 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+class ActivationTester {
+public:
+	enum class Activation {
+		Sigmoid,
+		Tanh,
+		ELU,
+		SELU,
+		GELU,
+		Swish,
+	};
+
+	ActivationTester() :
+		iterations_(1),
+		errorLimit_(1.0e-5),
+		multithreading_(false),
+		activation_(Activation::Sigmoid),
+		alpha_(1.0f),
+		inputRange_(10.0f),
+		batchSize_(1),
+		channels_(1)
+	{
+		this->threadpool = nullptr;
+	}
+
+	ActivationTester(const ActivationTester&) = delete;
+
+	inline ActivationTester(ActivationTester&& tester) :
+		iterations_(tester.iterations_),
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		activation_(tester.activation_),
+		alpha_(tester.alpha_),
+		inputRange_(tester.inputRange_),
+		batchSize_(tester.batchSize_),
+		channels_(tester.channels_),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	ActivationTester& operator=(const ActivationTester&) = delete;
+
+	~ActivationTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline ActivationTester& iterations(size_t iterations) {
+		this->iterations_ = iterations;
+		return *this;
+	}
+
+	inline size_t iterations() const {
+		return this->iterations_;
+	}
+
+	inline ActivationTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline ActivationTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline ActivationTester& activation(Activation activation) {
+		this->activation_ = activation;
+		return *this;
+	}
+
+	inline Activation activation() const {
+		return this->activation_;
+	}
+
+	inline ActivationTester& alpha(float alpha) {
+		this->alpha_ = alpha;
+		return *this;
+	}
+
+	inline float alpha() const {
+		return this->alpha_;
+	}
+
+	/* Inputs are uniformly distributed in [-inputRange, +inputRange] */
+	inline ActivationTester& inputRange(float inputRange) {
+		this->inputRange_ = inputRange;
+		return *this;
+	}
+
+	inline float inputRange() const {
+		return this->inputRange_;
+	}
+
+	inline ActivationTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	inline ActivationTester& channels(size_t channels) {
+		this->channels_ = channels;
+		return *this;
+	}
+
+	inline size_t channels() const {
+		return this->channels_;
+	}
+
+	void testOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), +inputRange()), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels());
+		std::vector<float> output(batchSize() * channels());
+		std::vector<float> referenceOutput(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			computeReferenceOutput(input.data(), referenceOutput.data());
+
+			enum nnp_status status = computeOutput(input.data(), output.data());
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testOutputInplace() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), +inputRange()), std::mt19937(seed));
+
+		std::vector<float> data(batchSize() * channels());
+		std::vector<float> referenceData(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(data.begin(), data.end(), std::ref(rng));
+			std::copy(data.cbegin(), data.cend(), referenceData.begin());
+
+			computeReferenceOutput(referenceData.data(), referenceData.data());
+
+			enum nnp_status status = computeOutput(data.data(), data.data());
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceData.cbegin(), referenceData.cend(), data.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), +inputRange()), std::mt19937(seed));
+		auto gradientRng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed + 1));
+
+		std::vector<float> outputGradient(batchSize() * channels());
+		std::vector<float> input(batchSize() * channels());
+		std::vector<float> inputGradient(batchSize() * channels());
+		std::vector<float> referenceInputGradient(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(gradientRng));
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(inputGradient.begin(), inputGradient.end(), std::nanf(""));
+			std::fill(referenceInputGradient.begin(), referenceInputGradient.end(), std::nanf(""));
+
+			computeReferenceInputGradient(outputGradient.data(), input.data(), referenceInputGradient.data());
+
+			enum nnp_status status = computeInputGradient(outputGradient.data(), input.data(), inputGradient.data());
+			ASSERT_EQ(nnp_status_success, status);
+
+			/*
+			 * Derivatives of GELU and swish cross zero, where relative error is not meaningful.
+			 * Error is measured relative to the larger of the input gradient and the output gradient,
+			 * i.e. as absolute error for derivatives below 1.
+			 */
+			float maxError = 0.0f;
+			for (size_t i = 0; i < inputGradient.size(); i++) {
+				const float error = std::abs(referenceInputGradient[i] - inputGradient[i]) /
+					std::max(FLT_MIN, std::max(std::abs(referenceInputGradient[i]), std::abs(outputGradient[i])));
+				maxError = std::max(maxError, std::isnan(error) ? INFINITY : error);
+			}
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	inline static float relativeError(float reference, float actual) {
+		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
+	}
+
+	void computeReferenceOutput(const float* input, float* output) const {
+		switch (activation()) {
+			case Activation::Sigmoid:
+				nnp_sigmoid_output__reference(batchSize(), channels(), input, output, this->threadpool);
+				break;
+			case Activation::Tanh:
+				nnp_tanh_output__reference(batchSize(), channels(), input, output, this->threadpool);
+				break;
+			case Activation::ELU:
+				nnp_elu_output__reference(batchSize(), channels(), input, output, alpha(), this->threadpool);
+				break;
+			case Activation::SELU:
+				nnp_selu_output__reference(batchSize(), channels(), input, output, this->threadpool);
+				break;
+			case Activation::GELU:
+				nnp_gelu_output__reference(batchSize(), channels(), input, output, this->threadpool);
+				break;
+			case Activation::Swish:
+				nnp_swish_output__reference(batchSize(), channels(), input, output, this->threadpool);
+				break;
+		}
+	}
+
+	enum nnp_status computeOutput(const float* input, float* output) const {
+		switch (activation()) {
+			case Activation::Sigmoid:
+				return nnp_sigmoid_output(batchSize(), channels(), input, output, this->threadpool);
+			case Activation::Tanh:
+				return nnp_tanh_output(batchSize(), channels(), input, output, this->threadpool);
+			case Activation::ELU:
+				return nnp_elu_output(batchSize(), channels(), input, output, alpha(), this->threadpool);
+			case Activation::SELU:
+				return nnp_selu_output(batchSize(), channels(), input, output, this->threadpool);
+			case Activation::GELU:
+				return nnp_gelu_output(batchSize(), channels(), input, output, this->threadpool);
+			case Activation::Swish:
+				return nnp_swish_output(batchSize(), channels(), input, output, this->threadpool);
+		}
+		return nnp_status_invalid_activation;
+	}
+
+	void computeReferenceInputGradient(const float* outputGradient, const float* input, float* inputGradient) const {
+		switch (activation()) {
+			case Activation::Sigmoid:
+				nnp_sigmoid_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+				break;
+			case Activation::Tanh:
+				nnp_tanh_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+				break;
+			case Activation::ELU:
+				nnp_elu_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, alpha(), this->threadpool);
+				break;
+			case Activation::SELU:
+				nnp_selu_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+				break;
+			case Activation::GELU:
+				nnp_gelu_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+				break;
+			case Activation::Swish:
+				nnp_swish_input_gradient__reference(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+				break;
+		}
+	}
+
+	enum nnp_status computeInputGradient(const float* outputGradient, const float* input, float* inputGradient) const {
+		switch (activation()) {
+			case Activation::Sigmoid:
+				return nnp_sigmoid_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+			case Activation::Tanh:
+				return nnp_tanh_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+			case Activation::ELU:
+				return nnp_elu_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, alpha(), this->threadpool);
+			case Activation::SELU:
+				return nnp_selu_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+			case Activation::GELU:
+				return nnp_gelu_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+			case Activation::Swish:
+				return nnp_swish_input_gradient(batchSize(), channels(),
+					outputGradient, input, inputGradient, this->threadpool);
+		}
+		return nnp_status_invalid_activation;
+	}
+
+	size_t iterations_;
+	float errorLimit_;
+	bool multithreading_;
+	Activation activation_;
+	float alpha_;
+	float inputRange_;
+
+	size_t batchSize_;
+	size_t channels_;
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+class BatchNormTester {
+public:
+	BatchNormTester() :
+		iterations_(1),
+		errorLimit_(1.0e-5),
+		multithreading_(false),
+		batchSize_(1),
+		channels_(1),
+		inputChannels_(1),
+		epsilon_(1.0e-5f),
+		inputOffset_(0.0f),
+		affine_(true)
+	{
+		inputSize(4, 4);
+		kernelSize(3, 3);
+
+		this->threadpool = nullptr;
+	}
+
+	BatchNormTester(const BatchNormTester&) = delete;
+
+	inline BatchNormTester(BatchNormTester&& tester) :
+		iterations_(tester.iterations_),
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		batchSize_(tester.batchSize_),
+		channels_(tester.channels_),
+		inputChannels_(tester.inputChannels_),
+		inputSize_(tester.inputSize_),
+		kernelSize_(tester.kernelSize_),
+		epsilon_(tester.epsilon_),
+		inputOffset_(tester.inputOffset_),
+		affine_(tester.affine_),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	BatchNormTester& operator=(const BatchNormTester&) = delete;
+
+	~BatchNormTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline BatchNormTester& iterations(size_t iterations) {
+		this->iterations_ = iterations;
+		return *this;
+	}
+
+	inline size_t iterations() const {
+		return this->iterations_;
+	}
+
+	inline BatchNormTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline BatchNormTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline BatchNormTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	/* Number of normalized channels, i.e. output channels of the folded convolution */
+	inline BatchNormTester& channels(size_t channels) {
+		this->channels_ = channels;
+		return *this;
+	}
+
+	inline size_t channels() const {
+		return this->channels_;
+	}
+
+	/* Input channels of the folded convolution */
+	inline BatchNormTester& inputChannels(size_t inputChannels) {
+		this->inputChannels_ = inputChannels;
+		return *this;
+	}
+
+	inline size_t inputChannels() const {
+		return this->inputChannels_;
+	}
+
+	inline BatchNormTester& inputSize(size_t height, size_t width) {
+		this->inputSize_.height = height;
+		this->inputSize_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size inputSize() const {
+		return this->inputSize_;
+	}
+
+	inline size_t imageSize() const {
+		return this->inputSize_.height * this->inputSize_.width;
+	}
+
+	inline BatchNormTester& kernelSize(size_t height, size_t width) {
+		this->kernelSize_.height = height;
+		this->kernelSize_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size kernelSize() const {
+		return this->kernelSize_;
+	}
+
+	inline struct nnp_size outputSize() const {
+		struct nnp_size outputSize;
+		outputSize.height = this->inputSize_.height - this->kernelSize_.height + 1;
+		outputSize.width = this->inputSize_.width - this->kernelSize_.width + 1;
+		return outputSize;
+	}
+
+	inline BatchNormTester& epsilon(float epsilon) {
+		this->epsilon_ = epsilon;
+		return *this;
+	}
+
+	inline float epsilon() const {
+		return this->epsilon_;
+	}
+
+	/* Inputs are uniformly distributed in [inputOffset - 1, inputOffset + 1] */
+	inline BatchNormTester& inputOffset(float inputOffset) {
+		this->inputOffset_ = inputOffset;
+		return *this;
+	}
+
+	inline float inputOffset() const {
+		return this->inputOffset_;
+	}
+
+	/* If false, scale and shift are passed as NULL */
+	inline BatchNormTester& affine(bool affine) {
+		this->affine_ = affine;
+		return *this;
+	}
+
+	inline bool affine() const {
+		return this->affine_;
+	}
+
+	void testOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(inputOffset() - 1.0f, inputOffset() + 1.0f), std::mt19937(seed));
+		auto parameterRng = std::bind(std::uniform_real_distribution<float>(0.5f, 2.0f), std::mt19937(seed + 1));
+
+		std::vector<float> input(batchSize() * channels() * imageSize());
+		std::vector<float> scale(channels()), shift(channels());
+		std::vector<float> output(input.size()), referenceOutput(input.size());
+		std::vector<float> mean(channels()), referenceMean(channels());
+		std::vector<float> variance(channels()), referenceVariance(channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(scale.begin(), scale.end(), std::ref(parameterRng));
+			std::generate(shift.begin(), shift.end(), std::ref(parameterRng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_batch_norm_output__reference(batchSize(), channels(), inputSize(),
+				input.data(), scalePointer(scale), shiftPointer(shift), epsilon(),
+				referenceOutput.data(), referenceMean.data(), referenceVariance.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_batch_norm_output(batchSize(), channels(), inputSize(),
+				input.data(), scalePointer(scale), shiftPointer(shift), epsilon(),
+				output.data(), mean.data(), variance.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+			EXPECT_LT(maxError(referenceMean, mean), errorLimit());
+			EXPECT_LT(maxError(referenceVariance, variance), errorLimit());
+		}
+	}
+
+	void testOutputInplace() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(inputOffset() - 1.0f, inputOffset() + 1.0f), std::mt19937(seed));
+		auto parameterRng = std::bind(std::uniform_real_distribution<float>(0.5f, 2.0f), std::mt19937(seed + 1));
+
+		std::vector<float> data(batchSize() * channels() * imageSize()), referenceData(data.size());
+		std::vector<float> scale(channels()), shift(channels());
+		std::vector<float> mean(channels()), referenceMean(channels());
+		std::vector<float> variance(channels()), referenceVariance(channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(data.begin(), data.end(), std::ref(rng));
+			std::copy(data.cbegin(), data.cend(), referenceData.begin());
+			std::generate(scale.begin(), scale.end(), std::ref(parameterRng));
+			std::generate(shift.begin(), shift.end(), std::ref(parameterRng));
+
+			nnp_batch_norm_output__reference(batchSize(), channels(), inputSize(),
+				referenceData.data(), scalePointer(scale), shiftPointer(shift), epsilon(),
+				referenceData.data(), referenceMean.data(), referenceVariance.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_batch_norm_output(batchSize(), channels(), inputSize(),
+				data.data(), scalePointer(scale), shiftPointer(shift), epsilon(),
+				data.data(), mean.data(), variance.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceData, data), errorLimit());
+			EXPECT_LT(maxError(referenceMean, mean), errorLimit());
+			EXPECT_LT(maxError(referenceVariance, variance), errorLimit());
+		}
+	}
+
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(inputOffset() - 1.0f, inputOffset() + 1.0f), std::mt19937(seed));
+		auto gradientRng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed + 1));
+		auto parameterRng = std::bind(std::uniform_real_distribution<float>(0.5f, 2.0f), std::mt19937(seed + 2));
+
+		std::vector<float> input(batchSize() * channels() * imageSize()), output(input.size());
+		std::vector<float> outputGradient(input.size());
+		std::vector<float> inputGradient(input.size()), referenceInputGradient(input.size());
+		std::vector<float> scale(channels()), mean(channels()), variance(channels());
+		std::vector<float> scaleGradient(channels()), referenceScaleGradient(channels());
+		std::vector<float> shiftGradient(channels()), referenceShiftGradient(channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(gradientRng));
+			std::generate(scale.begin(), scale.end(), std::ref(parameterRng));
+			std::fill(inputGradient.begin(), inputGradient.end(), std::nanf(""));
+
+			nnp_batch_norm_output__reference(batchSize(), channels(), inputSize(),
+				input.data(), scalePointer(scale), nullptr, epsilon(),
+				output.data(), mean.data(), variance.data(),
+				this->threadpool);
+
+			nnp_batch_norm_input_gradient__reference(batchSize(), channels(), inputSize(),
+				outputGradient.data(), input.data(), scalePointer(scale), mean.data(), variance.data(), epsilon(),
+				referenceInputGradient.data(), referenceScaleGradient.data(), referenceShiftGradient.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_batch_norm_input_gradient(batchSize(), channels(), inputSize(),
+				outputGradient.data(), input.data(), scalePointer(scale), mean.data(), variance.data(), epsilon(),
+				inputGradient.data(), scaleGradient.data(), shiftGradient.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceInputGradient, inputGradient), errorLimit());
+
+			/*
+			 * Gradients of scale and shift are sums over the batch and image, and their error is measured
+			 * relative to the sum of absolute values of the terms, which bounds the error of any summation order.
+			 */
+			for (size_t channel = 0; channel < channels(); channel++) {
+				const double inverseStd = 1.0 / std::sqrt(double(variance[channel]) + double(epsilon()));
+				double absoluteSumShiftGradient = 0.0, absoluteSumScaleGradient = 0.0;
+				for (size_t sample = 0; sample < batchSize(); sample++) {
+					for (size_t i = 0; i < imageSize(); i++) {
+						const size_t index = (sample * channels() + channel) * imageSize() + i;
+						absoluteSumShiftGradient += std::abs(double(outputGradient[index]));
+						absoluteSumScaleGradient += std::abs(double(outputGradient[index]) *
+							(double(input[index]) - double(mean[channel])) * inverseStd);
+					}
+				}
+				EXPECT_LT(std::abs(referenceShiftGradient[channel] - shiftGradient[channel]) / absoluteSumShiftGradient, errorLimit());
+				EXPECT_LT(std::abs(referenceScaleGradient[channel] - scaleGradient[channel]) / absoluteSumScaleGradient, errorLimit());
+			}
+		}
+	}
+
+	/*
+	 * Compares batch normalization applied to the output of a convolution with the output of the same convolution
+	 * after folding batch normalization into its kernel and bias.
+	 */
+	void testFoldConvolution() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+		auto parameterRng = std::bind(std::uniform_real_distribution<float>(0.5f, 2.0f), std::mt19937(seed + 1));
+
+		const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+		const size_t outputImageSize = outputSize().height * outputSize().width;
+
+		std::vector<float> input(batchSize() * inputChannels() * imageSize());
+		std::vector<float> kernel(channels() * inputChannels() * kernelSize().height * kernelSize().width);
+		std::vector<float> bias(channels());
+		std::vector<float> mean(channels()), variance(channels()), scale(channels()), shift(channels());
+		std::vector<float> output(batchSize() * channels() * outputImageSize), referenceOutput(output.size());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(mean.begin(), mean.end(), std::ref(rng));
+			std::generate(variance.begin(), variance.end(), std::ref(parameterRng));
+			std::generate(scale.begin(), scale.end(), std::ref(parameterRng));
+			std::generate(shift.begin(), shift.end(), std::ref(rng));
+
+			nnp_convolution_output__reference(
+				batchSize(), inputChannels(), channels(),
+				inputSize(), inputPadding, kernelSize(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < channels(); channel++) {
+					const double gamma = affine() ? double(scale[channel]) : 1.0;
+					const double beta = affine() ? double(shift[channel]) : 0.0;
+					const double inverseStd = 1.0 / std::sqrt(double(variance[channel]) + double(epsilon()));
+					float* referenceOutputImage = &referenceOutput[(sample * channels() + channel) * outputImageSize];
+					for (size_t i = 0; i < outputImageSize; i++) {
+						referenceOutputImage[i] = float(gamma * (double(referenceOutputImage[i]) - double(mean[channel])) * inverseStd + beta);
+					}
+				}
+			}
+
+			enum nnp_status status = nnp_convolution_fold_batch_norm(
+				inputChannels(), channels(), kernelSize(),
+				kernel.data(), bias.data(),
+				mean.data(), variance.data(), scalePointer(scale), shiftPointer(shift), epsilon());
+			ASSERT_EQ(nnp_status_success, status);
+
+			nnp_convolution_output__reference(
+				batchSize(), inputChannels(), channels(),
+				inputSize(), inputPadding, kernelSize(),
+				input.data(), kernel.data(), bias.data(), output.data(),
+				this->threadpool);
+
+			EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+		}
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	inline const float* scalePointer(const std::vector<float>& scale) const {
+		return affine() ? scale.data() : nullptr;
+	}
+
+	inline const float* shiftPointer(const std::vector<float>& shift) const {
+		return affine() ? shift.data() : nullptr;
+	}
+
+	/* Normalized outputs are of order 1, and their error is measured as absolute error for values below 1 */
+	static float maxError(const std::vector<float>& reference, const std::vector<float>& actual) {
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++) {
+			const float error = std::abs(reference[i] - actual[i]) / std::max(1.0f, std::abs(reference[i]));
+			maxError = std::max(maxError, std::isnan(error) ? INFINITY : error);
+		}
+		return maxError;
+	}
+
+	size_t iterations_;
+	float errorLimit_;
+	bool multithreading_;
+
+	size_t batchSize_;
+	size_t channels_;
+	size_t inputChannels_;
+	struct nnp_size inputSize_;
+	struct nnp_size kernelSize_;
+	float epsilon_;
+	float inputOffset_;
+	bool affine_;
+};
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 
 #include <cmath>
 #include <cfloat>
@@ -14,6 +15,8 @@
 #include <nnpack.h>
 #include <nnpack/reference.h>
 
+#include <AlignedAllocator.h>
+
 class ConvolutionTester {
 public:
 	ConvolutionTester() :
@@ -22,7 +25,9 @@ public:
 		multithreading_(false),
 		batchSize_(1),
 		inputChannels_(1),
-		outputChannels_(1)
+		outputChannels_(1),
+		extremeValues_(false),
+		expectedStatus_(nnp_status_success)
 	{
 		inputSize(4, 4);
 		kernelSize(3, 3);
@@ -43,6 +48,8 @@ public:
 		inputSize_(tester.inputSize_),
 		kernelSize_(tester.kernelSize_),
 		inputPadding_(tester.inputPadding_),
+		extremeValues_(tester.extremeValues_),
+		expectedStatus_(tester.expectedStatus_),
 		threadpool(tester.threadpool)
 	{
 		tester.threadpool = nullptr;
@@ -90,6 +97,42 @@ public:
 		return this->multithreading_;
 	}
 
+	/*
+	 * Runs the tests on a thread pool with exactly threadsCount threads, rather than one thread per core,
+	 * so that the choice between parallelization strategies does not depend on the host.
+	 */
+	inline ConvolutionTester& threadsCount(size_t threadsCount) {
+		this->multithreading_ = true;
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+		}
+		this->threadpool = pthreadpool_create(threadsCount);
+		return *this;
+	}
+
+	/*
+	 * Quantized tests use the largest inputs and kernel elements of one sign per output channel, rather than random
+	 * values, so accumulators reach their largest magnitudes.
+	 */
+	inline ConvolutionTester& extremeValues(bool extremeValues) {
+		this->extremeValues_ = extremeValues;
+		return *this;
+	}
+
+	inline bool extremeValues() const {
+		return this->extremeValues_;
+	}
+
+	/* Quantized tests only check that the implementation returns expectedStatus if it is not success */
+	inline ConvolutionTester& expectedStatus(enum nnp_status expectedStatus) {
+		this->expectedStatus_ = expectedStatus;
+		return *this;
+	}
+
+	inline enum nnp_status expectedStatus() const {
+		return this->expectedStatus_;
+	}
+
 	inline ConvolutionTester& batchSize(size_t batchSize) {
 		this->batchSize_ = batchSize;
 		return *this;
@@ -316,21 +359,254 @@ public:
 				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
 				this->threadpool);
 
+			/* Precomputed strategy takes the kernel transformed by nnp_convolution_inference_transform_kernel */
+			const float* kernelData = kernel.data();
+			std::vector<float, AlignedAllocator<float, 64>> transformedKernel;
+			if (kernel_transform_strategy == nnp_convolution_kernel_transform_strategy_precomputed) {
+				size_t transformedKernelSize = 0;
+				enum nnp_status status = nnp_convolution_inference_transform_kernel(
+					algorithm,
+					inputChannels(), outputChannels(), kernelSize(),
+					kernel.data(), nullptr, &transformedKernelSize,
+					this->threadpool);
+				ASSERT_EQ(nnp_status_success, status);
+
+				transformedKernel.resize(transformedKernelSize / sizeof(float));
+				status = nnp_convolution_inference_transform_kernel(
+					algorithm,
+					inputChannels(), outputChannels(), kernelSize(),
+					kernel.data(), transformedKernel.data(), &transformedKernelSize,
+					this->threadpool);
+				ASSERT_EQ(nnp_status_success, status);
+				kernelData = transformedKernel.data();
+			}
+
 			enum nnp_status status = nnp_convolution_inference(
 				algorithm,
 				kernel_transform_strategy,
 				inputChannels(), outputChannels(),
 				inputSize(), inputPadding(), kernelSize(),
-				input.data(), kernel.data(), bias.data(), output.data(),
+				input.data(), kernelData, bias.data(), output.data(),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	/* Checks inference with a kernel from the shared memory cache, and that a second request maps the same transform */
+	void testInferenceSharedKernel(enum nnp_convolution_algorithm algorithm) const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(outputChannels() * outputHeight() * outputWidth());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_convolution_output__reference(
+				1, inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+
+			nnp_shared_kernel_t sharedKernel = nullptr;
+			enum nnp_status status = nnp_convolution_inference_share_kernel(
+				algorithm,
+				inputChannels(), outputChannels(), kernelSize(),
+				kernel.data(), &sharedKernel,
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			nnp_shared_kernel_t cachedKernel = nullptr;
+			status = nnp_convolution_inference_share_kernel(
+				algorithm,
+				inputChannels(), outputChannels(), kernelSize(),
+				kernel.data(), &cachedKernel,
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const void* transformedKernel = nullptr;
+			ASSERT_EQ(nnp_status_success, nnp_shared_kernel_get_data(sharedKernel, &transformedKernel));
+			const void* cachedTransformedKernel = nullptr;
+			ASSERT_EQ(nnp_status_success, nnp_shared_kernel_get_data(cachedKernel, &cachedTransformedKernel));
+
+			size_t transformedKernelSize = 0;
+			status = nnp_convolution_inference_transform_kernel(
+				algorithm,
+				inputChannels(), outputChannels(), kernelSize(),
+				kernel.data(), nullptr, &transformedKernelSize,
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+			EXPECT_EQ(0, memcmp(transformedKernel, cachedTransformedKernel, transformedKernelSize));
+
+			status = nnp_convolution_inference(
+				algorithm,
+				nnp_convolution_kernel_transform_strategy_precomputed,
+				inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), static_cast<const float*>(transformedKernel), bias.data(), output.data(),
 				this->threadpool, nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
+			ASSERT_EQ(nnp_status_success, nnp_shared_kernel_remove(sharedKernel));
+			ASSERT_EQ(nnp_status_success, nnp_shared_kernel_release(sharedKernel));
+			ASSERT_EQ(nnp_status_success, nnp_shared_kernel_release(cachedKernel));
+
 			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
 				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
 			EXPECT_LT(maxError, errorLimit());
 		}
 	}
 
+	void testInferenceReluMaxPooling(enum nnp_convolution_algorithm algorithm, enum nnp_convolution_kernel_transform_strategy kernel_transform_strategy=nnp_convolution_kernel_transform_strategy_recompute) const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+		/* Kernel with both signs makes about half of convolution outputs negative, so ReLU is exercised */
+		auto kernelRng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed + 1));
+
+		const size_t pooledHeight = (outputHeight() + 1) / 2;
+		const size_t pooledWidth = (outputWidth() + 1) / 2;
+
+		std::vector<float> input(inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(outputChannels() * pooledHeight * pooledWidth);
+		std::vector<float> referenceConvolutionOutput(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceReluOutput(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(outputChannels() * pooledHeight * pooledWidth);
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(kernelRng));
+			std::generate(bias.begin(), bias.end(), std::ref(kernelRng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_convolution_output__reference(
+				1, inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), kernel.data(), bias.data(), referenceConvolutionOutput.data(),
+				this->threadpool);
+			nnp_relu_output__reference(
+				1, outputChannels() * outputHeight() * outputWidth(),
+				referenceConvolutionOutput.data(), referenceReluOutput.data(), 0.0f,
+				this->threadpool);
+			nnp_max_pooling_output__reference(
+				1, outputChannels(),
+				outputSize(), nnp_padding { 0, 0, 0, 0 }, nnp_size { 2, 2 }, nnp_size { 2, 2 },
+				referenceReluOutput.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_convolution_inference_relu_max_pooling(
+				algorithm,
+				kernel_transform_strategy,
+				inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), kernel.data(), bias.data(), output.data(),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			/* Zero outputs of ReLU are compared in absolute terms */
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); },
+				[](float reference, float actual)->float {
+					return std::abs(reference - actual) / std::max(1.0f, std::abs(reference));
+				});
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	/*
+	 * Quantized outputs are compared with the reference with tolerance of one quantization step:
+	 * implementation requantizes in single precision, and reference in double precision.
+	 */
+	void testInferenceU8S8() const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		std::mt19937 rng(seed);
+		auto u8rng = std::bind(std::uniform_int_distribution<int>(0, 255), std::ref(rng));
+		auto s8rng = std::bind(std::uniform_int_distribution<int>(-128, 127), std::ref(rng));
+		auto scaleRng = std::bind(std::uniform_real_distribution<float>(0.5f, 1.5f), std::ref(rng));
+
+		std::vector<uint8_t> input(inputChannels() * inputHeight() * inputWidth());
+		std::vector<int8_t> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+		std::vector<float> kernelScales(outputChannels());
+		std::vector<float> bias(outputChannels());
+
+		std::vector<uint8_t> output(outputChannels() * outputHeight() * outputWidth());
+		std::vector<uint8_t> referenceOutput(outputChannels() * outputHeight() * outputWidth());
+
+		const size_t dotProductLength = inputChannels() * kernelHeight() * kernelWidth();
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			if (extremeValues()) {
+				/* Even output channels get the largest positive, and odd output channels the largest negative sums */
+				std::fill(input.begin(), input.end(), 255);
+				for (size_t oc = 0; oc < outputChannels(); oc++) {
+					std::fill_n(kernel.begin() + oc * dotProductLength, dotProductLength, oc % 2 == 0 ? 127 : -128);
+				}
+			} else {
+				std::generate(input.begin(), input.end(), std::ref(u8rng));
+				std::generate(kernel.begin(), kernel.end(), std::ref(s8rng));
+			}
+			std::generate(kernelScales.begin(), kernelScales.end(), [&]() { return 0.01f * scaleRng(); });
+			std::generate(bias.begin(), bias.end(), [&]() { return scaleRng() - 1.0f; });
+			std::fill(output.begin(), output.end(), 0xA5);
+
+			/*
+			 * Output scale keeps most outputs within the 8-bit range: random dot products grow as sqrt of their length,
+			 * and extreme ones linearly, up to 255 * 128 * dotProductLength in magnitude.
+			 */
+			const nnp_quantization inputQuantization = { 0.02f, extremeValues() ? uint8_t(0) : uint8_t(u8rng()) };
+			const float outputScale = extremeValues() ?
+				0.02f * 0.015f * 255.0f * 128.0f * float(dotProductLength) / 100.0f : 0.05f * std::sqrt(float(dotProductLength));
+			const nnp_quantization outputQuantization = { outputScale, 128 };
+
+			enum nnp_status status = nnp_convolution_inference_u8s8(
+				inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), inputQuantization,
+				kernel.data(), kernelScales.data(), bias.data(),
+				output.data(), outputQuantization,
+				nnp_activation_relu, 0.0f,
+				this->threadpool, nullptr);
+			ASSERT_EQ(expectedStatus(), status);
+			if (status != nnp_status_success) {
+				return;
+			}
+
+			nnp_convolution_output_u8s8__reference(
+				1, inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(),
+				input.data(), inputQuantization,
+				kernel.data(), kernelScales.data(), bias.data(),
+				referenceOutput.data(), outputQuantization,
+				nnp_activation_relu, 0.0f,
+				this->threadpool);
+
+			for (size_t i = 0; i < output.size(); i++) {
+				EXPECT_LE(std::abs(int(output[i]) - int(referenceOutput[i])), 1) << "at position " << i;
+			}
+		}
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
@@ -349,4 +625,6 @@ private:
 	struct nnp_size inputSize_;
 	struct nnp_padding inputPadding_;
 	struct nnp_size kernelSize_;
+	bool extremeValues_;
+	enum nnp_status expectedStatus_;
 };
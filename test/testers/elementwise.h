@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+class ElementwiseTester {
+public:
+	/* Flags of operand dimensions which are broadcast from 1 */
+	enum Broadcast : unsigned {
+		BroadcastNone = 0,
+		BroadcastBatch = 1,
+		BroadcastChannels = 2,
+		BroadcastImage = 4,
+	};
+
+	ElementwiseTester() :
+		iterations_(1),
+		errorLimit_(1.0e-6),
+		multithreading_(false),
+		batchSize_(1),
+		channels_(1),
+		aBroadcast_(BroadcastNone),
+		bBroadcast_(BroadcastNone),
+		cBroadcast_(BroadcastNone),
+		inplace_(false)
+	{
+		imageSize(4, 4);
+
+		this->threadpool = nullptr;
+	}
+
+	ElementwiseTester(const ElementwiseTester&) = delete;
+
+	inline ElementwiseTester(ElementwiseTester&& tester) :
+		iterations_(tester.iterations_),
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		batchSize_(tester.batchSize_),
+		channels_(tester.channels_),
+		imageSize_(tester.imageSize_),
+		aBroadcast_(tester.aBroadcast_),
+		bBroadcast_(tester.bBroadcast_),
+		cBroadcast_(tester.cBroadcast_),
+		inplace_(tester.inplace_),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	ElementwiseTester& operator=(const ElementwiseTester&) = delete;
+
+	~ElementwiseTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline ElementwiseTester& iterations(size_t iterations) {
+		this->iterations_ = iterations;
+		return *this;
+	}
+
+	inline size_t iterations() const {
+		return this->iterations_;
+	}
+
+	inline ElementwiseTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline ElementwiseTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline ElementwiseTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	inline ElementwiseTester& channels(size_t channels) {
+		this->channels_ = channels;
+		return *this;
+	}
+
+	inline size_t channels() const {
+		return this->channels_;
+	}
+
+	inline ElementwiseTester& imageSize(size_t height, size_t width) {
+		this->imageSize_.height = height;
+		this->imageSize_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size imageSize() const {
+		return this->imageSize_;
+	}
+
+	inline ElementwiseTester& aBroadcast(unsigned aBroadcast) {
+		this->aBroadcast_ = aBroadcast;
+		return *this;
+	}
+
+	inline unsigned aBroadcast() const {
+		return this->aBroadcast_;
+	}
+
+	inline ElementwiseTester& bBroadcast(unsigned bBroadcast) {
+		this->bBroadcast_ = bBroadcast;
+		return *this;
+	}
+
+	inline unsigned bBroadcast() const {
+		return this->bBroadcast_;
+	}
+
+	inline ElementwiseTester& cBroadcast(unsigned cBroadcast) {
+		this->cBroadcast_ = cBroadcast;
+		return *this;
+	}
+
+	inline unsigned cBroadcast() const {
+		return this->cBroadcast_;
+	}
+
+	/* If true, output overwrites operand a, which must not be broadcast */
+	inline ElementwiseTester& inplace(bool inplace) {
+		this->inplace_ = inplace;
+		return *this;
+	}
+
+	inline bool inplace() const {
+		return this->inplace_;
+	}
+
+	void testAdd() const {
+		test(Operation::Add);
+	}
+
+	void testMultiply() const {
+		test(Operation::Multiply);
+	}
+
+	void testMultiplyAdd() const {
+		test(Operation::MultiplyAdd);
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	enum class Operation {
+		Add,
+		Multiply,
+		MultiplyAdd,
+	};
+
+	inline struct nnp_tensor_shape shape(unsigned broadcast) const {
+		struct nnp_tensor_shape shape;
+		shape.batch_size = (broadcast & BroadcastBatch) ? 1 : batchSize();
+		shape.channels = (broadcast & BroadcastChannels) ? 1 : channels();
+		shape.image_size.height = (broadcast & BroadcastImage) ? 1 : imageSize().height;
+		shape.image_size.width = (broadcast & BroadcastImage) ? 1 : imageSize().width;
+		return shape;
+	}
+
+	static inline size_t elements(struct nnp_tensor_shape shape) {
+		return shape.batch_size * shape.channels * shape.image_size.height * shape.image_size.width;
+	}
+
+	void test(Operation operation) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		const struct nnp_tensor_shape aShape = shape(aBroadcast());
+		const struct nnp_tensor_shape bShape = shape(bBroadcast());
+		const struct nnp_tensor_shape cShape = shape(cBroadcast());
+		std::vector<float> a(elements(aShape)), b(elements(bShape)), c(elements(cShape));
+		std::vector<float> output(batchSize() * channels() * imageSize().height * imageSize().width);
+		std::vector<float> referenceOutput(output.size());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(a.begin(), a.end(), std::ref(rng));
+			std::generate(b.begin(), b.end(), std::ref(rng));
+			std::generate(c.begin(), c.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			/* In-place tests write the result over a, and keep a copy of a in output for the reference */
+			float* outputData = output.data();
+			if (inplace()) {
+				ASSERT_EQ(a.size(), output.size());
+				std::copy(a.cbegin(), a.cend(), output.begin());
+				outputData = a.data();
+			}
+
+			enum nnp_status status = nnp_status_success;
+			switch (operation) {
+				case Operation::Add:
+					nnp_add__reference(batchSize(), channels(), imageSize(),
+						aShape, inplace() ? output.data() : a.data(), bShape, b.data(),
+						referenceOutput.data(), this->threadpool);
+					status = nnp_add(batchSize(), channels(), imageSize(),
+						aShape, a.data(), bShape, b.data(),
+						outputData, this->threadpool);
+					break;
+				case Operation::Multiply:
+					nnp_multiply__reference(batchSize(), channels(), imageSize(),
+						aShape, inplace() ? output.data() : a.data(), bShape, b.data(),
+						referenceOutput.data(), this->threadpool);
+					status = nnp_multiply(batchSize(), channels(), imageSize(),
+						aShape, a.data(), bShape, b.data(),
+						outputData, this->threadpool);
+					break;
+				case Operation::MultiplyAdd:
+					nnp_multiply_add__reference(batchSize(), channels(), imageSize(),
+						aShape, inplace() ? output.data() : a.data(), bShape, b.data(), cShape, c.data(),
+						referenceOutput.data(), this->threadpool);
+					status = nnp_multiply_add(batchSize(), channels(), imageSize(),
+						aShape, a.data(), bShape, b.data(), cShape, c.data(),
+						outputData, this->threadpool);
+					break;
+			}
+			ASSERT_EQ(nnp_status_success, status);
+
+			if (inplace()) {
+				EXPECT_LT(maxError(referenceOutput, a), errorLimit());
+			} else {
+				EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+			}
+		}
+	}
+
+	static float maxError(const std::vector<float>& reference, const std::vector<float>& actual) {
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++) {
+			const float error = std::abs(reference[i] - actual[i]) / std::max(1.0f, std::abs(reference[i]));
+			maxError = std::max(maxError, std::isnan(error) ? INFINITY : error);
+		}
+		return maxError;
+	}
+
+	size_t iterations_;
+	float errorLimit_;
+	bool multithreading_;
+
+	size_t batchSize_;
+	size_t channels_;
+	struct nnp_size imageSize_;
+	unsigned aBroadcast_;
+	unsigned bBroadcast_;
+	unsigned cBroadcast_;
+	bool inplace_;
+};
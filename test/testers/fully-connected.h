@@ -13,6 +13,9 @@
 
 #include <nnpack.h>
 #include <nnpack/reference.h>
+#include <nnpack/fp16.h>
+
+#include <AlignedAllocator.h>
 
 class FullyConnectedTester {
 public:
@@ -22,7 +25,12 @@ public:
 		multithreading_(false),
 		batchSize_(1),
 		inputChannels_(1),
-		outputChannels_(1)
+		outputChannels_(1),
+		activation_(nnp_activation_identity),
+		negativeSlope_(0.0f),
+		sparsity_(0.0f),
+		extremeValues_(false),
+		expectedStatus_(nnp_status_success)
 	{
 		this->threadpool = nullptr;
 	}
@@ -36,6 +44,11 @@ public:
 		batchSize_(tester.batchSize_),
 		inputChannels_(tester.inputChannels_),
 		outputChannels_(tester.outputChannels_),
+		activation_(tester.activation_),
+		negativeSlope_(tester.negativeSlope_),
+		sparsity_(tester.sparsity_),
+		extremeValues_(tester.extremeValues_),
+		expectedStatus_(tester.expectedStatus_),
 		threadpool(tester.threadpool)
 	{
 		tester.threadpool = nullptr;
@@ -110,12 +123,63 @@ public:
 		return this->outputChannels_;
 	}
 
+	inline FullyConnectedTester& activation(enum nnp_activation activation) {
+		this->activation_ = activation;
+		return *this;
+	}
+
+	inline enum nnp_activation activation() const {
+		return this->activation_;
+	}
+
+	inline FullyConnectedTester& negativeSlope(float negativeSlope) {
+		this->negativeSlope_ = negativeSlope;
+		return *this;
+	}
+
+	inline float negativeSlope() const {
+		return this->negativeSlope_;
+	}
+
+	inline FullyConnectedTester& sparsity(float sparsity) {
+		this->sparsity_ = sparsity;
+		return *this;
+	}
+
+	inline float sparsity() const {
+		return this->sparsity_;
+	}
+
+	/*
+	 * Quantized tests use the largest inputs and kernel elements of one sign per output channel, rather than random
+	 * values, so accumulators reach their largest magnitudes.
+	 */
+	inline FullyConnectedTester& extremeValues(bool extremeValues) {
+		this->extremeValues_ = extremeValues;
+		return *this;
+	}
+
+	inline bool extremeValues() const {
+		return this->extremeValues_;
+	}
+
+	/* Quantized tests only check that the implementation returns expectedStatus if it is not success */
+	inline FullyConnectedTester& expectedStatus(enum nnp_status expectedStatus) {
+		this->expectedStatus_ = expectedStatus;
+		return *this;
+	}
+
+	inline enum nnp_status expectedStatus() const {
+		return this->expectedStatus_;
+	}
+
 	void testOutput() const {
 		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
 		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
 
 		std::vector<float> input(batchSize() * inputChannels());
 		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> bias(outputChannels());
 
 		std::vector<float> output(batchSize() * outputChannels());
 		std::vector<float> referenceOutput(batchSize() * outputChannels());
@@ -125,14 +189,70 @@ public:
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
 			std::fill(output.begin(), output.end(), std::nanf(""));
 
-			nnp_fully_connected_output__reference(
-				batchSize(), inputChannels(), outputChannels(),
-				input.data(), kernel.data(), referenceOutput.data(),
+			enum nnp_status status;
+			if (activation() == nnp_activation_identity) {
+				/* Layers without activation are tested through the entry point without bias */
+				std::fill(bias.begin(), bias.end(), 0.0f);
+				computeReferenceOutput(batchSize(), input, kernel, bias, referenceOutput);
+				status = nnp_fully_connected_output(
+					batchSize(), inputChannels(), outputChannels(),
+					input.data(), kernel.data(), output.data(),
+					this->threadpool, nullptr);
+			} else {
+				generateBias(bias, rng);
+				computeReferenceOutput(batchSize(), input, kernel, bias, referenceOutput);
+				status = nnp_fully_connected_output_with_bias(
+					batchSize(), inputChannels(), outputChannels(),
+					input.data(), kernel.data(), bias.data(), output.data(),
+					activation(), negativeSlope(),
+					this->threadpool, nullptr);
+			}
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testOutputPrepacked() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels());
+		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(batchSize() * outputChannels());
+		std::vector<float> referenceOutput(batchSize() * outputChannels());
+
+		size_t packedKernelSize = 0;
+		enum nnp_status status = nnp_fully_connected_pack_kernel(
+			inputChannels(), outputChannels(),
+			kernel.data(), nullptr, &packedKernelSize,
+			this->threadpool);
+		ASSERT_EQ(nnp_status_success, status);
+		std::vector<float, AlignedAllocator<float, 64>> packedKernel(packedKernelSize / sizeof(float));
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			generateBias(bias, rng);
+			std::fill(packedKernel.begin(), packedKernel.end(), std::nanf(""));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			computeReferenceOutput(batchSize(), input, kernel, bias, referenceOutput);
+
+			status = nnp_fully_connected_pack_kernel(
+				inputChannels(), outputChannels(),
+				kernel.data(), packedKernel.data(), &packedKernelSize,
 				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
 
-			enum nnp_status status = nnp_fully_connected_output(
+			status = nnp_fully_connected_output_prepacked(
 				batchSize(), inputChannels(), outputChannels(),
-				input.data(), kernel.data(), output.data(),
+				input.data(), packedKernel.data(), bias.data(), output.data(),
+				activation(), negativeSlope(),
 				this->threadpool, nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
@@ -142,6 +262,70 @@ public:
 		}
 	}
 
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> gradOutput(batchSize() * outputChannels());
+		std::vector<float> kernel(outputChannels() * inputChannels());
+
+		std::vector<float> gradInput(batchSize() * inputChannels());
+		std::vector<float> referenceGradInput(batchSize() * inputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::fill(gradInput.begin(), gradInput.end(), std::nanf(""));
+
+			nnp_fully_connected_input_gradient__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				gradOutput.data(), kernel.data(), referenceGradInput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_fully_connected_input_gradient(
+				batchSize(), inputChannels(), outputChannels(),
+				gradOutput.data(), kernel.data(), gradInput.data(),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceGradInput.cbegin(), referenceGradInput.cend(), gradInput.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testKernelGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels());
+		std::vector<float> gradOutput(batchSize() * outputChannels());
+
+		std::vector<float> gradKernel(outputChannels() * inputChannels());
+		std::vector<float> referenceGradKernel(outputChannels() * inputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::fill(gradKernel.begin(), gradKernel.end(), std::nanf(""));
+
+			nnp_fully_connected_kernel_gradient__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				input.data(), gradOutput.data(), referenceGradKernel.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_fully_connected_kernel_gradient(
+				batchSize(), inputChannels(), outputChannels(),
+				input.data(), gradOutput.data(), gradKernel.data(),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceGradKernel.cbegin(), referenceGradKernel.cend(), gradKernel.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
 	void testInference() const {
 		ASSERT_EQ(1, batchSize());
 
@@ -150,6 +334,7 @@ public:
 
 		std::vector<float> input(inputChannels());
 		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> bias(outputChannels());
 
 		std::vector<float> output(outputChannels());
 		std::vector<float> referenceOutput(outputChannels());
@@ -159,14 +344,78 @@ public:
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
 			std::fill(output.begin(), output.end(), std::nanf(""));
 
-			nnp_fully_connected_output__reference(
-				1, inputChannels(), outputChannels(),
-				input.data(), kernel.data(), referenceOutput.data(),
-				this->threadpool);
+			enum nnp_status status;
+			if (activation() == nnp_activation_identity) {
+				/* Layers without activation are tested through the entry point without bias */
+				std::fill(bias.begin(), bias.end(), 0.0f);
+				computeReferenceOutput(1, input, kernel, bias, referenceOutput);
+				status = nnp_fully_connected_inference(
+					inputChannels(), outputChannels(),
+					input.data(), kernel.data(), output.data(),
+					this->threadpool);
+			} else {
+				generateBias(bias, rng);
+				computeReferenceOutput(1, input, kernel, bias, referenceOutput);
+				status = nnp_fully_connected_inference_with_bias(
+					inputChannels(), outputChannels(),
+					input.data(), kernel.data(), bias.data(), output.data(),
+					activation(), negativeSlope(),
+					this->threadpool);
+			}
+			ASSERT_EQ(nnp_status_success, status);
 
-			enum nnp_status status = nnp_fully_connected_inference(
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testInferenceF16() const {
+		testInferenceReducedPrecision(false);
+	}
+
+	void testInferenceBF16() const {
+		testInferenceReducedPrecision(true);
+	}
+
+	void testInferenceSparse() const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(inputChannels());
+		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(outputChannels());
+		std::vector<float> referenceOutput(outputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			/* Kernel elements are zeroed with probability sparsity(), the rest are in (0, 1] */
+			std::generate(kernel.begin(), kernel.end(), [&]() { return rng() < sparsity() ? 0.0f : 1.0f - rng(); });
+			generateBias(bias, rng);
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			computeReferenceOutput(1, input, kernel, bias, referenceOutput);
+
+			size_t sparseKernelSize = 0;
+			enum nnp_status status = nnp_fully_connected_pack_sparse_kernel(
+				inputChannels(), outputChannels(),
+				kernel.data(), nullptr, &sparseKernelSize);
+			ASSERT_EQ(nnp_status_success, status);
+
+			std::vector<uint32_t> sparseKernel(sparseKernelSize / sizeof(uint32_t));
+			status = nnp_fully_connected_pack_sparse_kernel(
+				inputChannels(), outputChannels(),
+				kernel.data(), sparseKernel.data(), &sparseKernelSize);
+			ASSERT_EQ(nnp_status_success, status);
+
+			status = nnp_fully_connected_inference_sparse(
 				inputChannels(), outputChannels(),
-				input.data(), kernel.data(), output.data(),
+				input.data(), sparseKernel.data(), bias.data(), output.data(),
+				activation(), negativeSlope(),
 				this->threadpool);
 			ASSERT_EQ(nnp_status_success, status);
 
@@ -176,10 +425,172 @@ public:
 		}
 	}
 
+	void testOutputU8S8() const {
+		testQuantized(false);
+	}
+
+	void testInferenceU8S8() const {
+		ASSERT_EQ(1, batchSize());
+		testQuantized(true);
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
 private:
+	/*
+	 * Input and kernel elements are in [0, 1), so the dot products are in [0, inputChannels).
+	 * Bias magnitude exceeds this range: it flips the sign of about half of outputs (to test activations),
+	 * but keeps all outputs far from zero, where relative error is ill-conditioned.
+	 */
+	template <class RNG>
+	void generateBias(std::vector<float>& bias, RNG& rng) const {
+		for (float& b : bias) {
+			const float sign = rng() < 0.5f ? -1.0f : 1.0f;
+			b = sign * (1.5f + 0.5f * rng()) * float(inputChannels());
+		}
+	}
+
+	void testInferenceReducedPrecision(bool bf16) const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(inputChannels());
+		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<uint16_t> kernel16(outputChannels() * inputChannels());
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(outputChannels());
+		std::vector<float> referenceOutput(outputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			generateBias(bias, rng);
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			/* Reference output uses the kernel rounded to 16 bits, so only the accumulation error is measured */
+			if (bf16) {
+				nnp_convert_fp32_to_bf16(kernel.size(), kernel.data(), kernel16.data());
+				std::transform(kernel16.cbegin(), kernel16.cend(), kernel.begin(), bf16_to_fp32);
+			} else {
+				nnp_convert_fp32_to_fp16(kernel.size(), kernel.data(), kernel16.data());
+				std::transform(kernel16.cbegin(), kernel16.cend(), kernel.begin(), fp16_to_fp32);
+			}
+			computeReferenceOutput(1, input, kernel, bias, referenceOutput);
+
+			enum nnp_status status = (bf16 ? nnp_fully_connected_inference_bf16f32 : nnp_fully_connected_inference_f16f32)(
+				inputChannels(), outputChannels(),
+				input.data(), kernel16.data(), bias.data(), output.data(),
+				activation(), negativeSlope(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	/*
+	 * Quantized outputs are compared with the reference with tolerance of one quantization step:
+	 * implementation requantizes in single precision, and reference in double precision.
+	 */
+	void testQuantized(bool inference) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		std::mt19937 rng(seed);
+		auto u8rng = std::bind(std::uniform_int_distribution<int>(0, 255), std::ref(rng));
+		auto s8rng = std::bind(std::uniform_int_distribution<int>(-128, 127), std::ref(rng));
+		auto scaleRng = std::bind(std::uniform_real_distribution<float>(0.5f, 1.5f), std::ref(rng));
+
+		std::vector<uint8_t> input(batchSize() * inputChannels());
+		std::vector<int8_t> kernel(outputChannels() * inputChannels());
+		std::vector<float> kernelScales(outputChannels());
+		std::vector<float> bias(outputChannels());
+
+		std::vector<uint8_t> output(batchSize() * outputChannels());
+		std::vector<uint8_t> referenceOutput(batchSize() * outputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			if (extremeValues()) {
+				/* Even output channels get the largest positive, and odd output channels the largest negative sums */
+				std::fill(input.begin(), input.end(), 255);
+				for (size_t oc = 0; oc < outputChannels(); oc++) {
+					std::fill_n(kernel.begin() + oc * inputChannels(), inputChannels(), oc % 2 == 0 ? 127 : -128);
+				}
+			} else {
+				std::generate(input.begin(), input.end(), std::ref(u8rng));
+				std::generate(kernel.begin(), kernel.end(), std::ref(s8rng));
+			}
+			std::generate(kernelScales.begin(), kernelScales.end(), [&]() { return 0.01f * scaleRng(); });
+			std::generate(bias.begin(), bias.end(), [&]() { return scaleRng() - 1.0f; });
+			std::fill(output.begin(), output.end(), 0xA5);
+
+			/*
+			 * Output scale keeps most outputs within the 8-bit range: random dot products grow as sqrt of their length,
+			 * and extreme ones linearly, up to 255 * 128 * inputChannels() in magnitude.
+			 */
+			const nnp_quantization inputQuantization = { 0.02f, extremeValues() ? uint8_t(0) : uint8_t(u8rng()) };
+			const float outputScale = extremeValues() ?
+				0.02f * 0.015f * 255.0f * 128.0f * float(inputChannels()) / 100.0f : 0.05f * std::sqrt(float(inputChannels()));
+			const nnp_quantization outputQuantization = { outputScale, 128 };
+
+			enum nnp_status status;
+			if (inference) {
+				status = nnp_fully_connected_inference_u8s8(
+					inputChannels(), outputChannels(),
+					input.data(), inputQuantization,
+					kernel.data(), kernelScales.data(), bias.data(),
+					output.data(), outputQuantization,
+					activation(), negativeSlope(),
+					this->threadpool);
+			} else {
+				status = nnp_fully_connected_output_u8s8(
+					batchSize(), inputChannels(), outputChannels(),
+					input.data(), inputQuantization,
+					kernel.data(), kernelScales.data(), bias.data(),
+					output.data(), outputQuantization,
+					activation(), negativeSlope(),
+					this->threadpool, nullptr);
+			}
+			ASSERT_EQ(expectedStatus(), status);
+			if (status != nnp_status_success) {
+				return;
+			}
+
+			nnp_fully_connected_output_u8s8__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				input.data(), inputQuantization,
+				kernel.data(), kernelScales.data(), bias.data(),
+				referenceOutput.data(), outputQuantization,
+				activation(), negativeSlope(),
+				this->threadpool);
+
+			for (size_t i = 0; i < output.size(); i++) {
+				EXPECT_LE(std::abs(int(output[i]) - int(referenceOutput[i])), 1) << "at position " << i;
+			}
+		}
+	}
+
+	void computeReferenceOutput(size_t batchSize,
+		const std::vector<float>& input, const std::vector<float>& kernel, const std::vector<float>& bias,
+		std::vector<float>& referenceOutput) const
+	{
+		nnp_fully_connected_output__reference(
+			batchSize, inputChannels(), outputChannels(),
+			input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+			this->threadpool);
+		if (activation() == nnp_activation_relu) {
+			nnp_relu_output__reference(
+				batchSize, outputChannels(),
+				referenceOutput.data(), referenceOutput.data(),
+				negativeSlope(),
+				this->threadpool);
+		}
+	}
+
 	inline static float relativeError(float reference, float actual) {
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
@@ -191,4 +602,9 @@ private:
 	size_t batchSize_;
 	size_t inputChannels_;
 	size_t outputChannels_;
+	enum nnp_activation activation_;
+	float negativeSlope_;
+	float sparsity_;
+	bool extremeValues_;
+	enum nnp_status expectedStatus_;
 };
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+class LRNTester {
+public:
+	LRNTester() :
+		iterations_(1),
+		errorLimit_(1.0e-5),
+		multithreading_(false),
+		batchSize_(1),
+		channels_(1),
+		localSize_(5),
+		alpha_(1.0e-4f),
+		beta_(0.75f),
+		k_(2.0f),
+		inputRange_(1.0f)
+	{
+		inputSize(4, 4);
+
+		this->threadpool = nullptr;
+	}
+
+	LRNTester(const LRNTester&) = delete;
+
+	inline LRNTester(LRNTester&& tester) :
+		iterations_(tester.iterations_),
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		batchSize_(tester.batchSize_),
+		channels_(tester.channels_),
+		inputSize_(tester.inputSize_),
+		localSize_(tester.localSize_),
+		alpha_(tester.alpha_),
+		beta_(tester.beta_),
+		k_(tester.k_),
+		inputRange_(tester.inputRange_),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	LRNTester& operator=(const LRNTester&) = delete;
+
+	~LRNTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline LRNTester& iterations(size_t iterations) {
+		this->iterations_ = iterations;
+		return *this;
+	}
+
+	inline size_t iterations() const {
+		return this->iterations_;
+	}
+
+	inline LRNTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline LRNTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline LRNTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	inline LRNTester& channels(size_t channels) {
+		this->channels_ = channels;
+		return *this;
+	}
+
+	inline size_t channels() const {
+		return this->channels_;
+	}
+
+	inline LRNTester& inputSize(size_t height, size_t width) {
+		this->inputSize_.height = height;
+		this->inputSize_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size inputSize() const {
+		return this->inputSize_;
+	}
+
+	inline size_t imageSize() const {
+		return this->inputSize_.height * this->inputSize_.width;
+	}
+
+	inline LRNTester& localSize(size_t localSize) {
+		this->localSize_ = localSize;
+		return *this;
+	}
+
+	inline size_t localSize() const {
+		return this->localSize_;
+	}
+
+	inline LRNTester& alpha(float alpha) {
+		this->alpha_ = alpha;
+		return *this;
+	}
+
+	inline float alpha() const {
+		return this->alpha_;
+	}
+
+	inline LRNTester& beta(float beta) {
+		this->beta_ = beta;
+		return *this;
+	}
+
+	inline float beta() const {
+		return this->beta_;
+	}
+
+	inline LRNTester& k(float k) {
+		this->k_ = k;
+		return *this;
+	}
+
+	inline float k() const {
+		return this->k_;
+	}
+
+	/* Inputs are uniformly distributed in [-inputRange, inputRange] */
+	inline LRNTester& inputRange(float inputRange) {
+		this->inputRange_ = inputRange;
+		return *this;
+	}
+
+	inline float inputRange() const {
+		return this->inputRange_;
+	}
+
+	void testOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), inputRange()), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels() * imageSize());
+		std::vector<float> output(input.size()), referenceOutput(input.size());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_lrn_output__reference(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_lrn_output(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				input.data(), output.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+		}
+	}
+
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), inputRange()), std::mt19937(seed));
+		auto gradientRng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed + 1));
+
+		std::vector<float> input(batchSize() * channels() * imageSize());
+		std::vector<float> outputGradient(input.size());
+		std::vector<float> inputGradient(input.size()), referenceInputGradient(input.size());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(gradientRng));
+			std::fill(inputGradient.begin(), inputGradient.end(), std::nanf(""));
+
+			nnp_lrn_input_gradient__reference(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				outputGradient.data(), input.data(), referenceInputGradient.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_lrn_input_gradient(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				outputGradient.data(), input.data(), inputGradient.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceInputGradient, inputGradient), errorLimit());
+		}
+	}
+
+	void testInputGradientInplace() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-inputRange(), inputRange()), std::mt19937(seed));
+		auto gradientRng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed + 1));
+
+		std::vector<float> input(batchSize() * channels() * imageSize());
+		std::vector<float> gradient(input.size()), referenceInputGradient(input.size());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(gradient.begin(), gradient.end(), std::ref(gradientRng));
+
+			nnp_lrn_input_gradient__reference(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				gradient.data(), input.data(), referenceInputGradient.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_lrn_input_gradient(batchSize(), channels(), inputSize(),
+				localSize(), alpha(), beta(), k(),
+				gradient.data(), input.data(), gradient.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceInputGradient, gradient), errorLimit());
+		}
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	/* Error is measured as absolute error for values below 1 */
+	static float maxError(const std::vector<float>& reference, const std::vector<float>& actual) {
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++) {
+			const float error = std::abs(reference[i] - actual[i]) / std::max(1.0f, std::abs(reference[i]));
+			maxError = std::max(maxError, std::isnan(error) ? INFINITY : error);
+		}
+		return maxError;
+	}
+
+	size_t iterations_;
+	float errorLimit_;
+	bool multithreading_;
+
+	size_t batchSize_;
+	size_t channels_;
+	struct nnp_size inputSize_;
+	size_t localSize_;
+	float alpha_;
+	float beta_;
+	float k_;
+	float inputRange_;
+};
@@ -0,0 +1,542 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+#include <unistd.h>
+
+class NetworkTester {
+public:
+	NetworkTester() :
+		iterations_(1),
+		errorLimit_(1.0e-4),
+		multithreading_(false),
+		batchSize_(1)
+	{
+		this->threadpool = nullptr;
+	}
+
+	NetworkTester(const NetworkTester&) = delete;
+
+	inline NetworkTester(NetworkTester&& tester) :
+		iterations_(tester.iterations_),
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		batchSize_(tester.batchSize_),
+		layers_(std::move(tester.layers_)),
+		weights_(std::move(tester.weights_)),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	NetworkTester& operator=(const NetworkTester&) = delete;
+
+	~NetworkTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline NetworkTester& iterations(size_t iterations) {
+		this->iterations_ = iterations;
+		return *this;
+	}
+
+	inline size_t iterations() const {
+		return this->iterations_;
+	}
+
+	inline NetworkTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline NetworkTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline NetworkTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	inline NetworkTester& convolution(
+		size_t inputChannels, size_t outputChannels,
+		struct nnp_size inputSize, struct nnp_padding inputPadding, struct nnp_size kernelSize,
+		enum nnp_convolution_algorithm algorithm = nnp_convolution_algorithm_auto,
+		bool hasBias = true)
+	{
+		struct nnp_layer layer = { nnp_layer_type_convolution };
+		layer.convolution.algorithm = algorithm;
+		layer.convolution.input_channels = inputChannels;
+		layer.convolution.output_channels = outputChannels;
+		layer.convolution.input_size = inputSize;
+		layer.convolution.input_padding = inputPadding;
+		layer.convolution.kernel_size = kernelSize;
+		layer.convolution.kernel = addWeights(outputChannels * inputChannels * kernelSize.height * kernelSize.width);
+		layer.convolution.bias = hasBias ? addWeights(outputChannels) : nullptr;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& fullyConnected(size_t inputChannels, size_t outputChannels) {
+		struct nnp_layer layer = { nnp_layer_type_fully_connected };
+		layer.fully_connected.input_channels = inputChannels;
+		layer.fully_connected.output_channels = outputChannels;
+		layer.fully_connected.kernel = addWeights(outputChannels * inputChannels);
+		layer.fully_connected.bias = addWeights(outputChannels);
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& maxPooling(
+		size_t channels,
+		struct nnp_size inputSize, struct nnp_padding inputPadding,
+		struct nnp_size poolingSize, struct nnp_size poolingStride)
+	{
+		struct nnp_layer layer = { nnp_layer_type_max_pooling };
+		layer.max_pooling.channels = channels;
+		layer.max_pooling.input_size = inputSize;
+		layer.max_pooling.input_padding = inputPadding;
+		layer.max_pooling.pooling_size = poolingSize;
+		layer.max_pooling.pooling_stride = poolingStride;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& relu(size_t channels, float negativeSlope = 0.0f) {
+		struct nnp_layer layer = { nnp_layer_type_relu };
+		layer.relu.channels = channels;
+		layer.relu.negative_slope = negativeSlope;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& softmax(size_t channels) {
+		struct nnp_layer layer = { nnp_layer_type_softmax };
+		layer.softmax.channels = channels;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline const std::vector<struct nnp_layer>& layers() const {
+		return this->layers_;
+	}
+
+	void testOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		nnp_network_t network = nullptr;
+		enum nnp_status status = nnp_network_create(batchSize(), layers().size(), layers().data(), &network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		std::vector<float> input(batchSize() * inputElements(layers().front()));
+		std::vector<float> output(batchSize() * outputElements(layers().back()));
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			const std::vector<float> referenceOutput = computeReferenceOutput(input);
+
+			status = nnp_network_run(network, input.data(), output.data(), this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+		}
+
+		ASSERT_EQ(nnp_status_success, nnp_network_destroy(network));
+	}
+
+	/* Checks that intermediate tensors which are not alive at the same time share memory */
+	void testActivationsReuse() const {
+		nnp_network_t network = nullptr;
+		enum nnp_status status = nnp_network_create(batchSize(), layers().size(), layers().data(), &network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		size_t activationsSize = 0;
+		status = nnp_network_get_memory_size(network, &activationsSize, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+
+		size_t separateBuffersSize = 0;
+		for (size_t i = 0; i + 1 < layers().size(); i++) {
+			separateBuffersSize += bufferSize(layers()[i]);
+		}
+		EXPECT_LT(activationsSize, separateBuffersSize);
+
+		ASSERT_EQ(nnp_status_success, nnp_network_destroy(network));
+	}
+
+	/*
+	 * Runs the network in several streams which share the thread pool. Every stream has its own network, and all
+	 * iterations are enqueued before waiting for completion.
+	 */
+	void testStreamOutput(size_t streamsCount) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		std::vector<nnp_stream_t> streams(streamsCount);
+		std::vector<nnp_network_t> networks(streamsCount);
+		for (size_t i = 0; i < streamsCount; i++) {
+			ASSERT_EQ(nnp_status_success, nnp_stream_create(this->threadpool, &streams[i]));
+			ASSERT_EQ(nnp_status_success, nnp_network_create(batchSize(), layers().size(), layers().data(), &networks[i]));
+		}
+
+		const size_t runsCount = streamsCount * iterations();
+		std::vector<std::vector<float>> inputs(runsCount, std::vector<float>(batchSize() * inputElements(layers().front())));
+		std::vector<std::vector<float>> outputs(runsCount, std::vector<float>(batchSize() * outputElements(layers().back()), std::nanf("")));
+		for (size_t run = 0; run < runsCount; run++) {
+			std::generate(inputs[run].begin(), inputs[run].end(), std::ref(rng));
+		}
+
+		std::atomic<size_t> completedCount(0);
+		const nnp_stream_callback countCompletion = [](void* context, enum nnp_status status) {
+			if (status == nnp_status_success) {
+				static_cast<std::atomic<size_t>*>(context)->fetch_add(1);
+			}
+		};
+		for (size_t run = 0; run < runsCount; run++) {
+			const size_t stream = run % streamsCount;
+			const enum nnp_status status = nnp_stream_enqueue_network_run(streams[stream], networks[stream],
+				inputs[run].data(), outputs[run].data(), countCompletion, &completedCount);
+			ASSERT_EQ(nnp_status_success, status);
+		}
+
+		for (size_t i = 0; i < streamsCount; i++) {
+			EXPECT_EQ(nnp_status_success, nnp_stream_synchronize(streams[i]));
+		}
+		EXPECT_EQ(runsCount, completedCount.load());
+
+		for (size_t run = 0; run < runsCount; run++) {
+			EXPECT_LT(maxError(computeReferenceOutput(inputs[run]), outputs[run]), errorLimit());
+		}
+
+		for (size_t i = 0; i < streamsCount; i++) {
+			ASSERT_EQ(nnp_status_success, nnp_stream_destroy(streams[i]));
+			ASSERT_EQ(nnp_status_success, nnp_network_destroy(networks[i]));
+		}
+	}
+
+	/* Runs the network concurrently on several threads, each in its own scheduler job with a different priority */
+	void testSchedulerOutput(size_t jobsCount, size_t threadsCount) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		nnp_scheduler_t scheduler = nullptr;
+		ASSERT_EQ(nnp_status_success, nnp_scheduler_create(threadsCount, &scheduler));
+
+		const size_t runsCount = jobsCount * iterations();
+		std::vector<std::vector<float>> inputs(runsCount, std::vector<float>(batchSize() * inputElements(layers().front())));
+		std::vector<std::vector<float>> outputs(runsCount, std::vector<float>(batchSize() * outputElements(layers().back()), std::nanf("")));
+		for (size_t run = 0; run < runsCount; run++) {
+			std::generate(inputs[run].begin(), inputs[run].end(), std::ref(rng));
+		}
+
+		std::vector<enum nnp_status> statuses(runsCount, nnp_status_success);
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < jobsCount; i++) {
+			threads.emplace_back([&, i]() {
+				nnp_scheduler_job_t job = nullptr;
+				nnp_network_t network = nullptr;
+				enum nnp_status status = nnp_scheduler_begin_job(scheduler, i + 1, 1, &job);
+				if (status == nnp_status_success) {
+					status = nnp_network_create(batchSize(), layers().size(), layers().data(), &network);
+				}
+				for (size_t run = i; run < runsCount; run += jobsCount) {
+					if (status == nnp_status_success) {
+						statuses[run] = nnp_network_run(network, inputs[run].data(), outputs[run].data(), nullptr);
+					} else {
+						statuses[run] = status;
+					}
+				}
+				nnp_network_destroy(network);
+				if (job != nullptr) {
+					nnp_scheduler_end_job(job);
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		for (size_t run = 0; run < runsCount; run++) {
+			ASSERT_EQ(nnp_status_success, statuses[run]);
+			EXPECT_LT(maxError(computeReferenceOutput(inputs[run]), outputs[run]), errorLimit());
+		}
+
+		ASSERT_EQ(nnp_status_success, nnp_scheduler_destroy(scheduler));
+	}
+
+	/* Saves the layers to a model file, and checks a network created from the loaded model */
+	void testModel() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		const std::string path = saveModel();
+		ASSERT_FALSE(path.empty());
+
+		nnp_model_t model = nullptr;
+		enum nnp_status status = nnp_model_load(path.c_str(), &model);
+		unlink(path.c_str());
+		ASSERT_EQ(nnp_status_success, status);
+
+		size_t modelLayersCount = 0;
+		const struct nnp_layer* modelLayers = nullptr;
+		status = nnp_model_get_layers(model, &modelLayersCount, &modelLayers);
+		ASSERT_EQ(nnp_status_success, status);
+		ASSERT_EQ(layers().size(), modelLayersCount);
+
+		nnp_network_t network = nullptr;
+		status = nnp_network_create(batchSize(), modelLayersCount, modelLayers, &network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		std::vector<float> input(batchSize() * inputElements(layers().front()));
+		std::vector<float> output(batchSize() * outputElements(layers().back()));
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			const std::vector<float> referenceOutput = computeReferenceOutput(input);
+
+			status = nnp_network_run(network, input.data(), output.data(), this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(maxError(referenceOutput, output), errorLimit());
+		}
+
+		ASSERT_EQ(nnp_status_success, nnp_network_destroy(network));
+		ASSERT_EQ(nnp_status_success, nnp_model_unload(model));
+	}
+
+	/* Saves the layers to a model file, overwrites a byte at the specified offset, and checks that loading fails */
+	void testCorruptedModel(long offset) const {
+		const std::string path = saveModel();
+		ASSERT_FALSE(path.empty());
+
+		FILE* file = fopen(path.c_str(), "r+b");
+		ASSERT_NE(nullptr, file);
+		ASSERT_EQ(0, fseek(file, offset, SEEK_SET));
+		ASSERT_EQ(0xFF, fputc(0xFF, file));
+		ASSERT_EQ(0, fclose(file));
+
+		nnp_model_t model = nullptr;
+		enum nnp_status status = nnp_model_load(path.c_str(), &model);
+		unlink(path.c_str());
+		ASSERT_EQ(nnp_status_invalid_model, status);
+	}
+
+	/* Saves the layers to a model file, cuts it to the specified size, and checks that loading fails */
+	void testTruncatedModel(off_t size) const {
+		const std::string path = saveModel();
+		ASSERT_FALSE(path.empty());
+		ASSERT_EQ(0, truncate(path.c_str(), size));
+
+		nnp_model_t model = nullptr;
+		enum nnp_status status = nnp_model_load(path.c_str(), &model);
+		unlink(path.c_str());
+		ASSERT_EQ(nnp_status_invalid_model, status);
+	}
+
+	void testInvalidLayer() const {
+		nnp_network_t network = nullptr;
+		enum nnp_status status = nnp_network_create(batchSize(), layers().size(), layers().data(), &network);
+		ASSERT_EQ(nnp_status_invalid_layer, status);
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	const float* addWeights(size_t count) {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1f, +0.1f), std::mt19937(seed + this->weights_.size()));
+
+		std::vector<float> weights(count);
+		std::generate(weights.begin(), weights.end(), std::ref(rng));
+		this->weights_.push_back(std::move(weights));
+		return this->weights_.back().data();
+	}
+
+	/* Saves the layers to a new temporary file, and returns its path, or an empty string on failure */
+	std::string saveModel() const {
+		char path[] = "/tmp/nnpack-model-XXXXXX";
+		const int fd = mkstemp(path);
+		if (fd == -1) {
+			return std::string();
+		}
+		close(fd);
+
+		const enum nnp_status status = nnp_model_save(path, layers().size(), layers().data(), this->threadpool);
+		if (status != nnp_status_success) {
+			unlink(path);
+			return std::string();
+		}
+		return std::string(path);
+	}
+
+	static struct nnp_size convolutionOutputSize(const struct nnp_convolution_layer& layer) {
+		return nnp_size {
+			layer.input_padding.left + layer.input_size.width + layer.input_padding.right - layer.kernel_size.width + 1,
+			layer.input_padding.top + layer.input_size.height + layer.input_padding.bottom - layer.kernel_size.height + 1
+		};
+	}
+
+	static struct nnp_size poolingOutputSize(const struct nnp_max_pooling_layer& layer) {
+		return nnp_size {
+			divide_round_up(layer.input_padding.left + layer.input_size.width + layer.input_padding.right - layer.pooling_size.width,
+				layer.pooling_stride.width) + 1,
+			divide_round_up(layer.input_padding.top + layer.input_size.height + layer.input_padding.bottom - layer.pooling_size.height,
+				layer.pooling_stride.height) + 1
+		};
+	}
+
+	static size_t inputElements(const struct nnp_layer& layer) {
+		switch (layer.type) {
+			case nnp_layer_type_convolution:
+				return layer.convolution.input_channels * layer.convolution.input_size.height * layer.convolution.input_size.width;
+			case nnp_layer_type_fully_connected:
+				return layer.fully_connected.input_channels;
+			case nnp_layer_type_max_pooling:
+				return layer.max_pooling.channels * layer.max_pooling.input_size.height * layer.max_pooling.input_size.width;
+			case nnp_layer_type_relu:
+				return layer.relu.channels;
+			case nnp_layer_type_softmax:
+				return layer.softmax.channels;
+		}
+		return 0;
+	}
+
+	static size_t outputElements(const struct nnp_layer& layer) {
+		switch (layer.type) {
+			case nnp_layer_type_convolution:
+			{
+				const struct nnp_size outputSize = convolutionOutputSize(layer.convolution);
+				return layer.convolution.output_channels * outputSize.height * outputSize.width;
+			}
+			case nnp_layer_type_fully_connected:
+				return layer.fully_connected.output_channels;
+			case nnp_layer_type_max_pooling:
+			{
+				const struct nnp_size outputSize = poolingOutputSize(layer.max_pooling);
+				return layer.max_pooling.channels * outputSize.height * outputSize.width;
+			}
+			case nnp_layer_type_relu:
+				return layer.relu.channels;
+			case nnp_layer_type_softmax:
+				return layer.softmax.channels;
+		}
+		return 0;
+	}
+
+	size_t bufferSize(const struct nnp_layer& layer) const {
+		return round_up(batchSize() * outputElements(layer) * sizeof(float), 64);
+	}
+
+	/* Runs the layers one by one, with a separate output buffer for every layer */
+	std::vector<float> computeReferenceOutput(const std::vector<float>& networkInput) const {
+		std::vector<float> input(networkInput);
+		for (const struct nnp_layer& layer : layers()) {
+			std::vector<float> output(batchSize() * outputElements(layer));
+			switch (layer.type) {
+				case nnp_layer_type_convolution:
+				{
+					/* Layers without bias are computed with zero bias */
+					const std::vector<float> zeroBias(layer.convolution.output_channels);
+					nnp_convolution_output__reference(
+						batchSize(), layer.convolution.input_channels, layer.convolution.output_channels,
+						layer.convolution.input_size, layer.convolution.input_padding, layer.convolution.kernel_size,
+						input.data(), layer.convolution.kernel,
+						layer.convolution.bias != nullptr ? layer.convolution.bias : zeroBias.data(),
+						output.data(),
+						this->threadpool);
+					break;
+				}
+				case nnp_layer_type_fully_connected:
+					nnp_fully_connected_output__reference(
+						batchSize(), layer.fully_connected.input_channels, layer.fully_connected.output_channels,
+						input.data(), layer.fully_connected.kernel, layer.fully_connected.bias, output.data(),
+						this->threadpool);
+					break;
+				case nnp_layer_type_max_pooling:
+					nnp_max_pooling_output__reference(
+						batchSize(), layer.max_pooling.channels,
+						layer.max_pooling.input_size, layer.max_pooling.input_padding,
+						layer.max_pooling.pooling_size, layer.max_pooling.pooling_stride,
+						input.data(), output.data(),
+						this->threadpool);
+					break;
+				case nnp_layer_type_relu:
+					nnp_relu_output__reference(
+						batchSize(), layer.relu.channels,
+						input.data(), output.data(), layer.relu.negative_slope,
+						this->threadpool);
+					break;
+				case nnp_layer_type_softmax:
+					nnp_softmax_output__reference(
+						batchSize(), layer.softmax.channels,
+						input.data(), output.data(),
+						this->threadpool);
+					break;
+			}
+			input = std::move(output);
+		}
+		return input;
+	}
+
+	/* Error is measured as absolute error for values below 1 */
+	static float maxError(const std::vector<float>& reference, const std::vector<float>& actual) {
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++) {
+			const float error = std::abs(reference[i] - actual[i]) / std::max(1.0f, std::abs(reference[i]));
+			maxError = std::max(maxError, std::isnan(error) ? INFINITY : error);
+		}
+		return maxError;
+	}
+
+	size_t iterations_;
+	float errorLimit_;
+	bool multithreading_;
+
+	size_t batchSize_;
+	std::vector<struct nnp_layer> layers_;
+	std::vector<std::vector<float>> weights_;
+};
@@ -22,7 +22,8 @@ public:
 		errorLimit_(1.0e-7),
 		multithreading_(false),
 		batchSize_(1),
-		channels_(1)
+		channels_(1),
+		paddingMode_(nnp_pooling_padding_mode_include)
 	{
 		inputSize(4, 4);
 		inputPadding(0, 0, 0, 0);
@@ -44,6 +45,7 @@ public:
 		inputPadding_(tester.inputPadding_),
 		poolingSize_(tester.poolingSize_),
 		poolingStride_(tester.poolingStride_),
+		paddingMode_(tester.paddingMode_),
 		threadpool(tester.threadpool)
 	{
 		tester.threadpool = nullptr;
@@ -163,11 +165,11 @@ public:
 	}
 
 	inline size_t outputHeight() const {
-		return divide_round_up(this->inputPadding_.top + this->inputSize_.height + this->inputPadding_.bottom, this->poolingSize_.height);
+		return divide_round_up(this->inputPadding_.top + this->inputSize_.height + this->inputPadding_.bottom - this->poolingSize_.height, this->poolingStride_.height) + 1;
 	}
 
 	inline size_t outputWidth() const {
-		return divide_round_up(this->inputPadding_.left + this->inputSize_.width + this->inputPadding_.right, this->poolingSize_.width);
+		return divide_round_up(this->inputPadding_.left + this->inputSize_.width + this->inputPadding_.right - this->poolingSize_.width, this->poolingStride_.width) + 1;
 	}
 
 	inline PoolingTester& inputPadding(size_t top, size_t right, size_t left, size_t bottom) {
@@ -182,6 +184,15 @@ public:
 		return this->inputPadding_;
 	}
 
+	inline PoolingTester& paddingMode(enum nnp_pooling_padding_mode paddingMode) {
+		this->paddingMode_ = paddingMode;
+		return *this;
+	}
+
+	inline enum nnp_pooling_padding_mode paddingMode() const {
+		return this->paddingMode_;
+	}
+
 	void testOutput() const {
 		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
 		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
@@ -213,11 +224,129 @@ public:
 		}
 	}
 
+	void testAverageOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels() * inputHeight() * inputWidth());
+		std::vector<float> output(batchSize() * channels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * channels() * outputHeight() * outputWidth());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_average_pooling_output__reference(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(), paddingMode(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_average_pooling_output(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(), paddingMode(),
+				input.data(), output.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testGlobalAverageOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels() * inputHeight() * inputWidth());
+		std::vector<float> output(batchSize() * channels());
+		std::vector<float> referenceOutput(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_global_average_pooling_output__reference(
+				batchSize(), channels(), inputSize(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_global_average_pooling_output(
+				batchSize(), channels(), inputSize(),
+				input.data(), output.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels() * inputHeight() * inputWidth());
+		std::vector<float> output(batchSize() * channels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * channels() * outputHeight() * outputWidth());
+		std::vector<uint8_t> mask(batchSize() * channels() * outputHeight() * outputWidth());
+		std::vector<float> gradOutput(batchSize() * channels() * outputHeight() * outputWidth());
+		std::vector<float> gradInput(batchSize() * channels() * inputHeight() * inputWidth());
+		std::vector<float> referenceGradInput(batchSize() * channels() * inputHeight() * inputWidth());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+			std::fill(gradInput.begin(), gradInput.end(), std::nanf(""));
+
+			nnp_max_pooling_output__reference(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			nnp_max_pooling_input_gradient__reference(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				input.data(), gradOutput.data(), referenceGradInput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_max_pooling_output_with_mask(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				input.data(), output.data(), mask.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			status = nnp_max_pooling_input_gradient(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				gradOutput.data(), mask.data(), gradInput.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxOutputError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxOutputError, errorLimit());
+
+			const float maxGradientError = std::inner_product(referenceGradInput.cbegin(), referenceGradInput.cend(), gradInput.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxGradientError, errorLimit());
+		}
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
 private:
 	inline static float relativeError(float reference, float actual) {
+		/* Pools which lie entirely in the padding produce -inf */
+		if (reference == actual) {
+			return 0.0f;
+		}
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
 
@@ -231,4 +360,5 @@ private:
 	struct nnp_padding inputPadding_;
 	struct nnp_size poolingSize_;
 	struct nnp_size poolingStride_;
+	enum nnp_pooling_padding_mode paddingMode_;
 };
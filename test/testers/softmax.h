@@ -135,7 +135,6 @@ public:
 
 		std::vector<float> data(batchSize() * channels());
 		std::vector<float> referenceData(batchSize() * channels());
-		const float negativeSlope = 0.2f;
 
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(data.begin(), data.end(), std::ref(rng));
@@ -158,6 +157,103 @@ public:
 		}
 	}
 
+	void testLogOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels());
+		std::vector<float> output(batchSize() * channels());
+		std::vector<float> referenceOutput(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_log_softmax_output__reference(
+				batchSize(), channels(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_log_softmax_output(
+				batchSize(), channels(),
+				input.data(), output.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(normalizedError(referenceOutput, output), errorLimit());
+		}
+	}
+
+	void testInputGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * channels());
+		std::vector<float> output(batchSize() * channels());
+		std::vector<float> gradOutput(batchSize() * channels());
+		std::vector<float> gradInput(batchSize() * channels());
+		std::vector<float> referenceGradInput(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::fill(gradInput.begin(), gradInput.end(), std::nanf(""));
+
+			nnp_softmax_output__reference(
+				batchSize(), channels(),
+				input.data(), output.data(),
+				this->threadpool);
+
+			nnp_softmax_input_gradient__reference(
+				batchSize(), channels(),
+				gradOutput.data(), output.data(), referenceGradInput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_softmax_input_gradient(
+				batchSize(), channels(),
+				gradOutput.data(), output.data(), gradInput.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(normalizedError(referenceGradInput, gradInput), errorLimit());
+		}
+	}
+
+	void testCrossEntropyLossAndGradient() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		std::mt19937 rng(seed);
+		auto inputRng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::ref(rng));
+		auto labelRng = std::bind(std::uniform_int_distribution<uint32_t>(0, channels() - 1), std::ref(rng));
+
+		std::vector<float> input(batchSize() * channels());
+		std::vector<uint32_t> labels(batchSize());
+		std::vector<float> loss(batchSize());
+		std::vector<float> referenceLoss(batchSize());
+		std::vector<float> gradInput(batchSize() * channels());
+		std::vector<float> referenceGradInput(batchSize() * channels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(inputRng));
+			std::generate(labels.begin(), labels.end(), std::ref(labelRng));
+			std::fill(loss.begin(), loss.end(), std::nanf(""));
+			std::fill(gradInput.begin(), gradInput.end(), std::nanf(""));
+
+			nnp_softmax_cross_entropy_loss_and_gradient__reference(
+				batchSize(), channels(),
+				input.data(), labels.data(), referenceLoss.data(), referenceGradInput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_softmax_cross_entropy_loss_and_gradient(
+				batchSize(), channels(),
+				input.data(), labels.data(), loss.data(), gradInput.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			EXPECT_LT(normalizedError(referenceLoss, loss), errorLimit());
+			EXPECT_LT(normalizedError(referenceGradInput, gradInput), errorLimit());
+		}
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
@@ -166,6 +262,24 @@ private:
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
 
+	/*
+	 * Maximum absolute error normalized by the maximum absolute reference value.
+	 * Gradients and log-probabilities may cancel to zero, where element-wise relative error is meaningless.
+	 */
+	inline static float normalizedError(const std::vector<float>& reference, const std::vector<float>& actual) {
+		float maxReference = FLT_MIN;
+		float maxError = 0.0f;
+		for (size_t i = 0; i < reference.size(); i++) {
+			maxReference = std::max(maxReference, std::abs(reference[i]));
+			/* Written as !(error <= maxError) to propagate NaN */
+			const float error = std::abs(reference[i] - actual[i]);
+			if (!(error <= maxError)) {
+				maxError = error;
+			}
+		}
+		return maxError / maxReference;
+	}
+
 	size_t iterations_;
 	float errorLimit_;
 	bool multithreading_;